@@ -15,6 +15,7 @@ from .nbi     import NBI
 from .state      import State
 from .orbits     import Orbits
 from .transcoef  import Transcoef
+from .wallload   import WallLoad
 from .dist import Dist_5D, Dist_6D, Dist_rho5D, Dist_rho6D, Dist_COM, Dist
 from .reaction import Reaction
 
@@ -48,7 +49,8 @@ HDF5TOOBJ = {
     "distrho5d" : Dist_rho5D,
     "distrho6d" : Dist_rho6D,
     "distcom" : Dist_COM,
-    "transcoef": Transcoef
+    "transcoef": Transcoef,
+    "wallload": WallLoad
 }
 """Dictionary connecting group names in HDF5 file to corresponding data objects.
 """
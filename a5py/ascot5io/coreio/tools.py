@@ -234,10 +234,24 @@ def combineoutput(fnt, fns, add=True):
                 s_sorted = np.argsort(sdata["ids"][:])
                 idx = np.argwhere(np.in1d(tdata['ids'][t_sorted],
                                           sdata['ids'][s_sorted])).ravel()
+
+                # Smallest time-step is retained from the target if the
+                # target already had a smaller one
+                keepmindt = np.zeros(idx.shape, dtype=bool)
+                if "mindt" in tdata and "mindt" in sdata:
+                    tmindt = tdata["mindt"][:][t_sorted][idx]
+                    keepmindt = np.logical_and(
+                        tdata["nstep"][:][t_sorted][idx] > 0,
+                        np.logical_or(tmindt < sdata["mindt"][:][s_sorted],
+                                      sdata["nstep"][:][s_sorted] == 0))
                 for field in tdata:
                     data = tdata[field][:][t_sorted]
-                    if field in ['time', 'mileage', 'cputime']:
+                    if field in ['time', 'mileage', 'cputime', 'nstep',
+                                 'nrej']:
                         data[idx] += sdata[field][:][s_sorted]
+                    elif field in ['mindt', 'mindtlim']:
+                        data[idx] = np.where(keepmindt, data[idx],
+                                             sdata[field][:][s_sorted])
                     else:
                         data[idx] = sdata[field][:][s_sorted]
                     tdata[field][:] = data
@@ -271,3 +285,28 @@ def combineoutput(fnt, fns, add=True):
 
                 tdata[field].resize((tsize+ssize, ))
                 tdata[field][tsize:] = sdata[field][:]
+
+        # Combine wall loads (angles are averages so they are combined
+        # weighted by the corresponding deposition)
+        if "wallload" in target and "wallload" in source:
+            tdata = target["wallload"]
+            sdata = source["wallload"]
+            ids = np.union1d(tdata["ids"][:], sdata["ids"][:])
+            summed = {}
+            for field in tdata:
+                summed[field] = np.zeros(ids.shape)
+            for data in [tdata, sdata]:
+                idx = np.searchsorted(ids, data["ids"][:])
+                for field in ["nmrk", "pdepo", "edepo", "edepo_mrk"]:
+                    summed[field][idx] += data[field][:]
+                summed["iangle"][idx] += data["iangle"][:] * data["edepo"][:]
+                summed["iangle_mrk"][idx] += \
+                    data["iangle_mrk"][:] * data["nmrk"][:]
+            summed["iangle"] = np.divide(
+                summed["iangle"], summed["edepo"],
+                out=np.zeros(ids.shape), where=summed["edepo"] > 0)
+            summed["iangle_mrk"] /= summed["nmrk"]
+            summed["ids"] = ids
+            for field in tdata:
+                tdata[field].resize((ids.size, ))
+                tdata[field][:] = summed[field]
@@ -47,10 +47,20 @@ class Opt(DataGroup):
         self._OPT_FIXEDSTEP_USE_USERDEFINED  = 0
         self._OPT_FIXEDSTEP_USERDEFINED      = 1.0e-8
         self._OPT_FIXEDSTEP_GYRODEFINED      = 20
+        self._OPT_FIXEDSTEP_CCOL_NSTEP       = 1
+        self._OPT_FIXEDSTEP_CCOL_TOL         = 0.0
         self._OPT_ADAPTIVE_TOL_ORBIT         = 1.0e-8
         self._OPT_ADAPTIVE_TOL_CCOL          = 1.0e-1
         self._OPT_ADAPTIVE_MAX_DRHO          = 0.1
         self._OPT_ADAPTIVE_MAX_DPHI          = 2.0
+        self._OPT_BFIELD_SINGLE_PRECISION    = 0
+        self._OPT_BFIELD_SPLINE_CACHE        = 0
+        self._OPT_MARKER_SORTING             = 0
+        self._OPT_SIMD_WIDTH                 = 0
+        self._OPT_CONVERGENCE_MODE           = 0
+        self._OPT_CONVERGENCE_TOLERANCE      = 0.05
+        self._OPT_CONVERGENCE_BATCH          = 100
+        self._OPT_CONVERGENCE_MIN_BATCHES    = 10
         self._OPT_ENDCOND_SIMTIMELIM         = 0
         self._OPT_ENDCOND_CPUTIMELIM         = 0
         self._OPT_ENDCOND_RHOLIM             = 0
@@ -77,6 +87,10 @@ class Opt(DataGroup):
         self._OPT_DISABLE_PITCH_CCOLL        = 0
         self._OPT_DISABLE_GCDIFF_CCOLL       = 0
         self._OPT_REVERSE_TIME               = 0
+        self._OPT_ENABLE_SPLITTING           = 0
+        self._OPT_SPLIT_RHO                  = 1.0
+        self._OPT_SPLIT_NUMBER               = 2
+        self._OPT_SPLIT_MAX_MARKERS          = 100000
         self._OPT_ENABLE_DIST_5D             = 0
         self._OPT_ENABLE_DIST_6D             = 0
         self._OPT_ENABLE_DIST_RHO5D          = 0
@@ -127,6 +141,7 @@ class Opt(DataGroup):
         self._OPT_DIST_MIN_PTOR              = -1.0e-18
         self._OPT_DIST_MAX_PTOR              = 1.0e-18
         self._OPT_DIST_NBIN_PTOR             = 200
+        self._OPT_ENABLE_WALLLOAD            = 0
         self._OPT_ENABLE_ORBITWRITE          = 0
         self._OPT_ORBITWRITE_MODE            = 1
         self._OPT_ORBITWRITE_NPOINT          = 100
@@ -195,6 +210,34 @@ class Opt(DataGroup):
         """
         return self._OPT_FIXEDSTEP_GYRODEFINED
 
+    @property
+    def _FIXEDSTEP_CCOL_NSTEP(self):
+        """Number of fixed time-steps between applications of the collision
+        operator
+
+        The collision operator is applied with the time accumulated since it
+        was last applied. Collision times are usually much longer than the
+        time-step needed to resolve the orbit, so in slowing-down simulations
+        collisions can be evaluated less often without losing accuracy, which
+        saves the plasma and collision coefficient evaluations. Collisions
+        during the last steps before a marker meets an end condition other
+        than the energy limits are not applied. Ignored in the adaptive
+        scheme.
+        """
+        return self._OPT_FIXEDSTEP_CCOL_NSTEP
+
+    @property
+    def _FIXEDSTEP_CCOL_TOL(self):
+        """Apply collisions earlier if the accumulated time-step times the
+        collision frequency exceeds this value (0 = off)
+
+        The collision frequency is the fastest of the slowing-down, energy
+        diffusion and pitch scattering rates, evaluated when collisions were
+        last applied. This shortens the interval set by FIXEDSTEP_CCOL_NSTEP
+        where collisions are frequent, e.g. for thermalizing markers.
+        """
+        return self._OPT_FIXEDSTEP_CCOL_TOL
+
     @property
     def _ADAPTIVE_TOL_ORBIT(self):
         """Relative error tolerance for orbit following in adaptive scheme
@@ -219,6 +262,99 @@ class Opt(DataGroup):
         """
         return self._OPT_ADAPTIVE_MAX_DPHI
 
+    @property
+    def _BFIELD_SINGLE_PRECISION(self):
+        """Store 3D magnetic field spline coefficients in single precision
+
+        Halves the memory used by B_3DS and B_STS fields which makes
+        evaluations of large fields faster. The interpolation is still done in
+        double precision and the initialization fails if the error this
+        introduces exceeds 1e-5 relative to the maximum field value. Other
+        field types ignore this option.
+        """
+        return self._OPT_BFIELD_SINGLE_PRECISION
+
+    @property
+    def _BFIELD_SPLINE_CACHE(self):
+        """Store 3D magnetic field spline coefficients in the input file
+
+        Evaluating the coefficients of large B_3DS and B_STS fields takes a
+        while. When this option is set, the coefficients are stored in the
+        /splinecache/ group of the input file on the first run and later runs
+        with the same field and precision read them from there. The cache is
+        keyed by the field QID and a hash of its data so it never goes stale,
+        but it can be deleted to save space. Other field types ignore this
+        option.
+        """
+        return self._OPT_BFIELD_SPLINE_CACHE
+
+    @property
+    def _MARKER_SORTING(self):
+        """Order markers by their position before simulation (0, 1, 2)
+
+        Markers that are simulated at the same time by a thread then sample
+        nearby parts of the input data, which improves the cache hit rate
+        with large 3D fields. The order in which markers are written is not
+        affected.
+
+        - 0 Markers are simulated in input order
+        - 1 Markers are ordered along a space-filling curve in (R, phi, z)
+        - 2 Markers are ordered along a space-filling curve in
+            (rho, theta, phi)
+        """
+        return self._OPT_MARKER_SORTING
+
+    @property
+    def _SIMD_WIDTH(self):
+        """Number of markers each thread simulates simultaneously (0 = auto)
+
+        Markers are integrated in groups whose size is at most the NSIMD value
+        the code was compiled with. If zero, the group size is chosen based on
+        the vector instruction set of the CPU. Once there are no markers left
+        to be simulated, the group shrinks as markers finish so that no time is
+        spent on empty slots. Ignored on GPU.
+        """
+        return self._OPT_SIMD_WIDTH
+
+    @property
+    def _CONVERGENCE_MODE(self):
+        """Stop taking new markers once an observable has converged (0, 1, 2)
+
+        Finished markers are grouped in batches of CONVERGENCE_BATCH markers
+        and the relative error of the observable is estimated from the
+        spread of the batch estimates. Once at least CONVERGENCE_MIN_BATCHES
+        batches are complete and the relative error is below
+        CONVERGENCE_TOLERANCE, the markers being simulated are finished and
+        the rest are left unsimulated. Those keep their input state and have
+        no end condition (NONE). The simulated markers are the first ones in
+        the input, so the markers should be in random order, and
+        MARKER_SORTING is ignored.
+
+        - 0 All markers are simulated
+        - 1 Fraction of marker weight lost to the wall
+        - 2 Power on the most loaded wall tile
+        """
+        return self._OPT_CONVERGENCE_MODE
+
+    @property
+    def _CONVERGENCE_TOLERANCE(self):
+        """Target relative error of the observable in CONVERGENCE_MODE
+        """
+        return self._OPT_CONVERGENCE_TOLERANCE
+
+    @property
+    def _CONVERGENCE_BATCH(self):
+        """Number of launched markers in a batch in CONVERGENCE_MODE
+        """
+        return self._OPT_CONVERGENCE_BATCH
+
+    @property
+    def _CONVERGENCE_MIN_BATCHES(self):
+        """Number of batches that must be complete before convergence is
+        checked in CONVERGENCE_MODE
+        """
+        return self._OPT_CONVERGENCE_MIN_BATCHES
+
     @property
     def _ENDCOND_SIMTIMELIM(self):
         """Terminate when marker time passes ENDCOND_LIM_SIMTIME or when marker
@@ -410,6 +546,49 @@ class Opt(DataGroup):
          """
          return self._OPT_REVERSE_TIME
 
+    @property
+    def _ENABLE_SPLITTING(self):
+        """Split markers moving outwards and roulette those moving inwards
+
+        Markers that cross the SPLIT_RHO surface outwards are split into
+        SPLIT_NUMBER markers that share the original weight. Markers crossing
+        it inwards are terminated with probability 1 - 1/SPLIT_NUMBER and
+        otherwise their weight is multiplied by SPLIT_NUMBER. This reduces the
+        variance of wall loads and edge distributions for a given number of
+        input markers without biasing them. The split markers are not
+        written in the end state, so take the wall loads from ENABLE_WALLLOAD
+        instead. Markers only diverge through collisions and atomic
+        reactions. Particles cross the surface back and forth during their
+        gyromotion, so splitting works best with guiding centers. Not
+        available in SIM_MODE=4 and cannot be combined with ENABLE_ORBITWRITE
+        or ENABLE_TRANSCOEF.
+
+        - 0 Markers are not split
+        - 1 Markers are split and rouletted at SPLIT_RHO
+        """
+        return self._OPT_ENABLE_SPLITTING
+
+    @property
+    def _SPLIT_RHO(self):
+        """Radial coordinate of the surface where markers are split
+        """
+        return self._OPT_SPLIT_RHO
+
+    @property
+    def _SPLIT_NUMBER(self):
+        """Number of markers a marker is split into
+        """
+        return self._OPT_SPLIT_NUMBER
+
+    @property
+    def _SPLIT_MAX_MARKERS(self):
+        """Maximum number of markers created by splitting in each process
+
+        Memory for these is allocated at the start of the simulation. Once
+        all have been created, markers are no longer split.
+        """
+        return self._OPT_SPLIT_MAX_MARKERS
+
 
     @property
     def _ENABLE_DIST_5D(self):
@@ -761,6 +940,19 @@ class Opt(DataGroup):
         """
         return self._OPT_DIST_NBIN_PTOR
 
+    @property
+    def _ENABLE_WALLLOAD(self):
+        """Accumulate wall loads during the simulation
+
+        Markers that hit the wall deposit their weight and energy on the wall
+        tile they hit, so wall loads are available without post-processing
+        the marker end states. Requires ENDCOND_WALLHIT.
+
+        - 0 Wall loads are not collected
+        - 1 Wall loads are collected
+        """
+        return self._OPT_ENABLE_WALLLOAD
+
     @property
     def _ENABLE_ORBITWRITE(self):
         """Enable diagnostics that store marker orbit
@@ -1301,6 +1493,12 @@ class Opt(DataGroup):
                     </xs:restriction>
                 </xs:simpleType>
 
+                <xs:simpleType name="IntegerNonNegative">
+                    <xs:restriction base="xs:integer">
+                    <xs:minInclusive value="0"/>
+                    </xs:restriction>
+                </xs:simpleType>
+
                 <xs:simpleType name="IntegerBinary">
                     <xs:restriction base="xs:integer">
                     <xs:minInclusive value="0"/>
@@ -1375,11 +1573,21 @@ class Opt(DataGroup):
                         <xs:element ref="FIXEDSTEP_USE_USERDEFINED"/>
                         <xs:element ref="FIXEDSTEP_USERDEFINED"/>
                         <xs:element ref="FIXEDSTEP_GYRODEFINED"/>
+                        <xs:element ref="FIXEDSTEP_CCOL_NSTEP"/>
+                        <xs:element ref="FIXEDSTEP_CCOL_TOL"/>
                         <xs:element ref="ADAPTIVE_TOL_ORBIT"/>
                         <xs:element ref="ADAPTIVE_TOL_CCOL"/>
                         <xs:element ref="ADAPTIVE_MAX_DRHO"/>
                         <xs:element ref="ADAPTIVE_MAX_DPHI"/>
                         <xs:element ref="RECORD_MODE"/>
+                        <xs:element ref="BFIELD_SINGLE_PRECISION"/>
+                        <xs:element ref="BFIELD_SPLINE_CACHE"/>
+                        <xs:element ref="MARKER_SORTING"/>
+                        <xs:element ref="SIMD_WIDTH"/>
+                        <xs:element ref="CONVERGENCE_MODE"/>
+                        <xs:element ref="CONVERGENCE_TOLERANCE"/>
+                        <xs:element ref="CONVERGENCE_BATCH"/>
+                        <xs:element ref="CONVERGENCE_MIN_BATCHES"/>
                     </xs:all>
                     </xs:complexType>
                 </xs:element>
@@ -1388,11 +1596,21 @@ class Opt(DataGroup):
             {doc('FIXEDSTEP_USE_USERDEFINED', 'IntegerBinary')}
             {doc('FIXEDSTEP_USERDEFINED',     'FloatPositive')}
             {doc('FIXEDSTEP_GYRODEFINED',     'IntegerPositive')}
+            {doc('FIXEDSTEP_CCOL_NSTEP',      'IntegerPositive')}
+            {doc('FIXEDSTEP_CCOL_TOL',        'FloatNonNegative')}
             {doc('ADAPTIVE_TOL_ORBIT',        'FloatPositive')}
             {doc('ADAPTIVE_TOL_CCOL',         'FloatPositive')}
             {doc('ADAPTIVE_MAX_DRHO',         'FloatPositive')}
             {doc('ADAPTIVE_MAX_DPHI',         'FloatPositive')}
             {doc('RECORD_MODE',               'IntegerBinary')}
+            {doc('BFIELD_SINGLE_PRECISION',   'IntegerBinary')}
+            {doc('BFIELD_SPLINE_CACHE',       'IntegerBinary')}
+            {doc('MARKER_SORTING',            'Integer012')}
+            {doc('SIMD_WIDTH',                'IntegerNonNegative')}
+            {doc('CONVERGENCE_MODE',          'Integer012')}
+            {doc('CONVERGENCE_TOLERANCE',     'FloatPositive')}
+            {doc('CONVERGENCE_BATCH',         'IntegerPositive')}
+            {doc('CONVERGENCE_MIN_BATCHES',   'IntegerPositive')}
 
                 <xs:element name="END_CONDITIONS">
                     <xs:annotation>
@@ -1457,6 +1675,10 @@ class Opt(DataGroup):
                         <xs:element ref="DISABLE_PITCH_CCOLL"/>
                         <xs:element ref="DISABLE_GCDIFF_CCOLL"/>
                         <xs:element ref="REVERSE_TIME"/>
+                        <xs:element ref="ENABLE_SPLITTING"/>
+                        <xs:element ref="SPLIT_RHO"/>
+                        <xs:element ref="SPLIT_NUMBER"/>
+                        <xs:element ref="SPLIT_MAX_MARKERS"/>
                     </xs:all>
                     </xs:complexType>
                 </xs:element>
@@ -1469,6 +1691,10 @@ class Opt(DataGroup):
             {doc('DISABLE_PITCH_CCOLL',        'IntegerBinary')}
             {doc('DISABLE_GCDIFF_CCOLL',       'IntegerBinary')}
             {doc('REVERSE_TIME',               'IntegerBinary')}
+            {doc('ENABLE_SPLITTING',           'IntegerBinary')}
+            {doc('SPLIT_RHO',                  'FloatNonNegative')}
+            {doc('SPLIT_NUMBER',               'IntegerPositive')}
+            {doc('SPLIT_MAX_MARKERS',          'IntegerNonNegative')}
 
                 <xs:element name="DISTRIBUTIONS">
                     <xs:annotation>
@@ -1528,6 +1754,7 @@ class Opt(DataGroup):
                         <xs:element ref="DIST_MIN_PTOR"/>
                         <xs:element ref="DIST_MAX_PTOR"/>
                         <xs:element ref="DIST_NBIN_PTOR"/>
+                        <xs:element ref="ENABLE_WALLLOAD"/>
                     </xs:all>
                     </xs:complexType>
                 </xs:element>
@@ -1581,6 +1808,7 @@ class Opt(DataGroup):
             {doc('DIST_MIN_PTOR',     'xs:float')}
             {doc('DIST_MAX_PTOR',     'xs:float')}
             {doc('DIST_NBIN_PTOR',    'IntegerPositive')}
+            {doc('ENABLE_WALLLOAD',   'IntegerBinary')}
 
                 <xs:element name="ORBIT_WRITE">
                     <xs:annotation>
@@ -29,6 +29,7 @@ class State(DataContainer):
     _HYBRID  = 0x800
     _NEUTRAL = 0x1000
     _IONIZED = 0x2000
+    _ROULETTE = 0x4000
 
     @property
     def ABORTED(self):
@@ -115,6 +116,12 @@ class State(DataContainer):
         """
         return State._IONIZED
 
+    @property
+    def ROULETTE(self):
+        """Marker terminated in Russian roulette when marker splitting is used.
+        """
+        return State._ROULETTE
+
     def write_hdf5(self):
         """Write state data in HDF5 file.
 
@@ -272,6 +279,9 @@ class State(DataContainer):
         add("anum", lambda : _val("anum").v)
         add("znum", lambda : _val("znum").v)
         add("walltile", lambda : _val("walltile").v)
+        add("nstep", lambda : _val("nstep").v)
+        add("nrej", lambda : _val("nrej").v)
+        add("mindtlim", lambda : _val("mindtlim").v)
         add("errormsg", lambda : _val("errormsg").v)
         add("errorline", lambda : _val("errorline").v)
         add("errormod", lambda : _val("errormod").v)
@@ -289,6 +299,7 @@ class State(DataContainer):
         add("time", lambda : _val("time"))
         add("cputime", lambda : _val("cputime"))
         add("mileage", lambda : _val("mileage"))
+        add("mindt", lambda : _val("mindt"))
         add("weight", lambda : _val("weight"))
 
         # Quantities that have to be evaluated separately (keep this in same
@@ -491,7 +502,7 @@ class State(DataContainer):
         """
         endcond = ["NONE", "ABORTED", "TLIM", "EMIN", "THERMAL", "WALL",
                    "RHOMIN", "RHOMAX", "POLMAX", "TORMAX", "CPUMAX", "HYBRID",
-                   "NEUTRAL", "IONIZED"]
+                   "NEUTRAL", "IONIZED", "ROULETTE"]
         string = ""
         for ec in endcond:
             if bitarr & getattr(State, "_" + ec):
@@ -516,6 +527,12 @@ class State(DataContainer):
             "time":     "Current laboratory time",
             "cputime":  "CPU time elapsed in simulation",
             "mileage":  "Laboratory time elapsed in simulation",
+            "nstep":    "Number of accepted time-steps",
+            "nrej":     "Number of rejected time-steps",
+            "mindt":    "Smallest accepted time-step",
+            "mindtlim": "What limited the smallest time-step (0: initial or "
+                        "fixed, 1: orbit tolerance, 2: collision tolerance, "
+                        "3: max drho, 4: max dphi)",
             "weight":   "How many physical particles a marker represents",
             "r":        "R coordinate",
             "z":        "z coordinate",
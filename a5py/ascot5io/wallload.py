@@ -0,0 +1,30 @@
+"""Wall load data IO module.
+"""
+import numpy as np
+import unyt
+
+from .coreio.treedata import DataContainer
+
+class WallLoad(DataContainer):
+    """Object representing wall loads accumulated during the simulation.
+
+    Only the wall tiles that were hit by at least one marker are stored.
+    """
+
+    def read(self):
+        """Read raw wall load data to dictionary.
+
+        Returns
+        -------
+        data : dict
+            Wall load data with units where tiles are sorted by their ID.
+        """
+        out = {}
+        with self as f:
+            idx = f["ids"][:].argsort()
+            for field in f:
+                unit = f[field].attrs["unit"]
+                if isinstance(unit, bytes): unit = unit.decode("utf-8")
+                out[field] = unyt.unyt_array(f[field][:][idx], unit)
+        out["ids"] = out["ids"].v.astype(int)
+        return out
@@ -347,6 +347,8 @@ struct_c__SA_B_3DS_offload_data._fields_ = [
     ('psi1', ctypes.c_double),
     ('axis_r', ctypes.c_double),
     ('axis_z', ctypes.c_double),
+    ('single_precision', ctypes.c_int32),
+    ('precomputed', ctypes.c_int32),
     ('offload_array_length', ctypes.c_int32),
     ('PADDING_1', ctypes.c_ubyte * 4),
 ]
@@ -376,6 +378,7 @@ struct_c__SA_interp3D_data._fields_ = [
     ('z_max', ctypes.c_double),
     ('z_grid', ctypes.c_double),
     ('c', ctypes.POINTER(ctypes.c_double)),
+    ('cf', ctypes.POINTER(ctypes.c_float)),
 ]
 
 struct_c__SA_B_3DS_data._pack_ = 1 # source:False
@@ -445,6 +448,8 @@ struct_c__SA_B_STS_offload_data._fields_ = [
     ('Bgrid_phi_max', ctypes.c_double),
     ('psi0', ctypes.c_double),
     ('psi1', ctypes.c_double),
+    ('single_precision', ctypes.c_int32),
+    ('precomputed', ctypes.c_int32),
     ('offload_array_length', ctypes.c_int32),
     ('n_axis', ctypes.c_int32),
     ('axis_min', ctypes.c_double),
@@ -566,6 +571,93 @@ B_TC_eval_B_dB.argtypes = [ctypes.c_double * 12, real, real, real, ctypes.POINTE
 B_TC_get_axis_rz = _libraries['libascot.so'].B_TC_get_axis_rz
 B_TC_get_axis_rz.restype = a5err
 B_TC_get_axis_rz.argtypes = [ctypes.c_double * 2, ctypes.POINTER(struct_c__SA_B_TC_data)]
+class struct_c__SA_B_3DST_offload_data(Structure):
+    pass
+
+struct_c__SA_B_3DST_offload_data._pack_ = 1 # source:False
+struct_c__SA_B_3DST_offload_data._fields_ = [
+    ('psigrid_n_r', ctypes.c_int32),
+    ('psigrid_n_z', ctypes.c_int32),
+    ('psigrid_r_min', ctypes.c_double),
+    ('psigrid_r_max', ctypes.c_double),
+    ('psigrid_z_min', ctypes.c_double),
+    ('psigrid_z_max', ctypes.c_double),
+    ('Bgrid_n_r', ctypes.c_int32),
+    ('Bgrid_n_z', ctypes.c_int32),
+    ('Bgrid_r_min', ctypes.c_double),
+    ('Bgrid_r_max', ctypes.c_double),
+    ('Bgrid_z_min', ctypes.c_double),
+    ('Bgrid_z_max', ctypes.c_double),
+    ('Bgrid_n_phi', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('Bgrid_phi_min', ctypes.c_double),
+    ('Bgrid_phi_max', ctypes.c_double),
+    ('Bgrid_n_t', ctypes.c_int32),
+    ('PADDING_1', ctypes.c_ubyte * 4),
+    ('Bgrid_t_min', ctypes.c_double),
+    ('Bgrid_t_max', ctypes.c_double),
+    ('slice_i0', ctypes.c_int32),
+    ('slice_n', ctypes.c_int32),
+    ('psi0', ctypes.c_double),
+    ('psi1', ctypes.c_double),
+    ('axis_r', ctypes.c_double),
+    ('axis_z', ctypes.c_double),
+    ('offload_array_length', ctypes.c_int32),
+    ('PADDING_2', ctypes.c_ubyte * 4),
+]
+
+B_3DST_offload_data = struct_c__SA_B_3DST_offload_data
+class struct_c__SA_B_3DST_data(Structure):
+    pass
+
+struct_c__SA_B_3DST_data._pack_ = 1 # source:False
+struct_c__SA_B_3DST_data._fields_ = [
+    ('psi0', ctypes.c_double),
+    ('psi1', ctypes.c_double),
+    ('axis_r', ctypes.c_double),
+    ('axis_z', ctypes.c_double),
+    ('n_t', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('t_min', ctypes.c_double),
+    ('t_max', ctypes.c_double),
+    ('slice_i0', ctypes.c_int32),
+    ('slice_n', ctypes.c_int32),
+    ('slice_size', ctypes.c_int32),
+    ('PADDING_1', ctypes.c_ubyte * 4),
+    ('psi', struct_c__SA_interp2D_data),
+    ('B_r', struct_c__SA_interp3D_data),
+    ('B_phi', struct_c__SA_interp3D_data),
+    ('B_z', struct_c__SA_interp3D_data),
+]
+
+B_3DST_data = struct_c__SA_B_3DST_data
+B_3DST_init_offload = _libraries['libascot.so'].B_3DST_init_offload
+B_3DST_init_offload.restype = ctypes.c_int32
+B_3DST_init_offload.argtypes = [ctypes.POINTER(struct_c__SA_B_3DST_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double))]
+B_3DST_free_offload = _libraries['libascot.so'].B_3DST_free_offload
+B_3DST_free_offload.restype = None
+B_3DST_free_offload.argtypes = [ctypes.POINTER(struct_c__SA_B_3DST_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double))]
+B_3DST_init = _libraries['libascot.so'].B_3DST_init
+B_3DST_init.restype = None
+B_3DST_init.argtypes = [ctypes.POINTER(struct_c__SA_B_3DST_data), ctypes.POINTER(struct_c__SA_B_3DST_offload_data), ctypes.POINTER(ctypes.c_double)]
+B_3DST_eval_psi = _libraries['libascot.so'].B_3DST_eval_psi
+B_3DST_eval_psi.restype = a5err
+B_3DST_eval_psi.argtypes = [ctypes.POINTER(ctypes.c_double), real, real, real, ctypes.POINTER(struct_c__SA_B_3DST_data)]
+B_3DST_eval_psi_dpsi = _libraries['libascot.so'].B_3DST_eval_psi_dpsi
+B_3DST_eval_psi_dpsi.restype = a5err
+B_3DST_eval_psi_dpsi.argtypes = [ctypes.c_double * 4, real, real, real, ctypes.POINTER(struct_c__SA_B_3DST_data)]
+B_3DST_eval_rho_drho = _libraries['libascot.so'].B_3DST_eval_rho_drho
+B_3DST_eval_rho_drho.restype = a5err
+B_3DST_eval_rho_drho.argtypes = [ctypes.c_double * 4, real, real, real, ctypes.POINTER(struct_c__SA_B_3DST_data)]
+B_3DST_eval_B = _libraries['libascot.so'].B_3DST_eval_B
+B_3DST_eval_B.restype = a5err
+B_3DST_eval_B.argtypes = [ctypes.c_double * 3, real, real, real, real, ctypes.POINTER(struct_c__SA_B_3DST_data)]
+B_3DST_eval_B_dB = _libraries['libascot.so'].B_3DST_eval_B_dB
+B_3DST_eval_B_dB.restype = a5err
+B_3DST_eval_B_dB.argtypes = [ctypes.c_double * 15, real, real, real, real, ctypes.POINTER(struct_c__SA_B_3DST_data)]
+B_3DST_get_axis_rz = _libraries['libascot.so'].B_3DST_get_axis_rz
+B_3DST_get_axis_rz.restype = a5err
+B_3DST_get_axis_rz.argtypes = [ctypes.c_double * 2, ctypes.POINTER(struct_c__SA_B_3DST_data)]
 
 # values for enumeration 'B_field_type'
 B_field_type__enumvalues = {
@@ -574,12 +666,14 @@ B_field_type__enumvalues = {
     2: 'B_field_type_3DS',
     3: 'B_field_type_STS',
     4: 'B_field_type_TC',
+    5: 'B_field_type_3DST',
 }
 B_field_type_GS = 0
 B_field_type_2DS = 1
 B_field_type_3DS = 2
 B_field_type_STS = 3
 B_field_type_TC = 4
+B_field_type_3DST = 5
 B_field_type = ctypes.c_uint32 # enum
 class struct_c__SA_B_field_offload_data(Structure):
     pass
@@ -593,8 +687,12 @@ struct_c__SA_B_field_offload_data._fields_ = [
     ('B3DS', B_3DS_offload_data),
     ('BSTS', B_STS_offload_data),
     ('BTC', B_TC_offload_data),
+    ('B3DST', B_3DST_offload_data),
+    ('single_precision', ctypes.c_int32),
+    ('spline_cache', ctypes.c_int32),
+    ('spline_hash', ctypes.c_char * 17),
+    ('PADDING_1', ctypes.c_ubyte * 3),
     ('offload_array_length', ctypes.c_int32),
-    ('PADDING_1', ctypes.c_ubyte * 4),
 ]
 
 B_field_offload_data = struct_c__SA_B_field_offload_data
@@ -610,6 +708,7 @@ struct_c__SA_B_field_data._fields_ = [
     ('B3DS', B_3DS_data),
     ('BSTS', B_STS_data),
     ('BTC', B_TC_data),
+    ('B3DST', B_3DST_data),
 ]
 
 B_field_data = struct_c__SA_B_field_data
@@ -628,9 +727,15 @@ B_field_eval_psi.argtypes = [ctypes.POINTER(ctypes.c_double), real, real, real,
 B_field_eval_psi_dpsi = _libraries['libascot.so'].B_field_eval_psi_dpsi
 B_field_eval_psi_dpsi.restype = a5err
 B_field_eval_psi_dpsi.argtypes = [ctypes.c_double * 4, real, real, real, real, ctypes.POINTER(struct_c__SA_B_field_data)]
+B_field_get_psilim = _libraries['libascot.so'].B_field_get_psilim
+B_field_get_psilim.restype = a5err
+B_field_get_psilim.argtypes = [ctypes.c_double * 2, ctypes.POINTER(struct_c__SA_B_field_data)]
 B_field_eval_rho = _libraries['libascot.so'].B_field_eval_rho
 B_field_eval_rho.restype = a5err
 B_field_eval_rho.argtypes = [ctypes.c_double * 2, real, ctypes.POINTER(struct_c__SA_B_field_data)]
+B_field_eval_psi_from_rho = _libraries['libascot.so'].B_field_eval_psi_from_rho
+B_field_eval_psi_from_rho.restype = a5err
+B_field_eval_psi_from_rho.argtypes = [ctypes.POINTER(ctypes.c_double), real, ctypes.POINTER(struct_c__SA_B_field_data)]
 B_field_eval_rho_drho = _libraries['libascot.so'].B_field_eval_rho_drho
 B_field_eval_rho_drho.restype = a5err
 B_field_eval_rho_drho.argtypes = [ctypes.c_double * 4, real, real, real, ctypes.POINTER(struct_c__SA_B_field_data)]
@@ -640,6 +745,9 @@ B_field_eval_B.argtypes = [ctypes.c_double * 3, real, real, real, real, ctypes.P
 B_field_eval_B_dB = _libraries['libascot.so'].B_field_eval_B_dB
 B_field_eval_B_dB.restype = a5err
 B_field_eval_B_dB.argtypes = [ctypes.c_double * 15, real, real, real, real, ctypes.POINTER(struct_c__SA_B_field_data)]
+B_field_eval_B_dB_simd = _libraries['libascot.so'].B_field_eval_B_dB_simd
+B_field_eval_B_dB_simd.restype = None
+B_field_eval_B_dB_simd.argtypes = [ctypes.c_int32, ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int64), ctypes.POINTER(ctypes.c_uint64), ctypes.POINTER(struct_c__SA_B_field_data)]
 B_field_get_axis_rz = _libraries['libascot.so'].B_field_get_axis_rz
 B_field_get_axis_rz.restype = a5err
 B_field_get_axis_rz.argtypes = [ctypes.c_double * 2, ctypes.POINTER(struct_c__SA_B_field_data), real]
@@ -770,6 +878,21 @@ E_field_init.argtypes = [ctypes.POINTER(struct_c__SA_E_field_data), ctypes.POINT
 E_field_eval_E = _libraries['libascot.so'].E_field_eval_E
 E_field_eval_E.restype = a5err
 E_field_eval_E.argtypes = [ctypes.c_double * 3, real, real, real, real, ctypes.POINTER(struct_c__SA_E_field_data), ctypes.POINTER(struct_c__SA_B_field_data)]
+
+# values for enumeration 'STEP_LIMITER'
+STEP_LIMITER__enumvalues = {
+    0: 'step_limiter_initial',
+    1: 'step_limiter_orbit',
+    2: 'step_limiter_collisions',
+    3: 'step_limiter_drho',
+    4: 'step_limiter_dphi',
+}
+step_limiter_initial = 0
+step_limiter_orbit = 1
+step_limiter_collisions = 2
+step_limiter_drho = 3
+step_limiter_dphi = 4
+STEP_LIMITER = ctypes.c_uint32 # enum
 class struct_c__SA_particle_state(Structure):
     pass
 
@@ -795,6 +918,10 @@ struct_c__SA_particle_state._fields_ = [
     ('time', ctypes.c_double),
     ('mileage', ctypes.c_double),
     ('cputime', ctypes.c_double),
+    ('nstep', ctypes.c_int64),
+    ('nrej', ctypes.c_int64),
+    ('mindt', ctypes.c_double),
+    ('mindtlim', ctypes.c_int64),
     ('rho', ctypes.c_double),
     ('theta', ctypes.c_double),
     ('id', ctypes.c_int64),
@@ -925,41 +1052,46 @@ class struct_c__SA_particle_simd_fo(Structure):
 
 struct_c__SA_particle_simd_fo._pack_ = 1 # source:False
 struct_c__SA_particle_simd_fo._fields_ = [
-    ('r', ctypes.c_double * 16),
-    ('phi', ctypes.c_double * 16),
-    ('z', ctypes.c_double * 16),
-    ('p_r', ctypes.c_double * 16),
-    ('p_phi', ctypes.c_double * 16),
-    ('p_z', ctypes.c_double * 16),
-    ('mass', ctypes.c_double * 16),
-    ('charge', ctypes.c_double * 16),
-    ('time', ctypes.c_double * 16),
-    ('znum', ctypes.c_int32 * 16),
-    ('anum', ctypes.c_int32 * 16),
-    ('B_r', ctypes.c_double * 16),
-    ('B_phi', ctypes.c_double * 16),
-    ('B_z', ctypes.c_double * 16),
-    ('B_r_dr', ctypes.c_double * 16),
-    ('B_phi_dr', ctypes.c_double * 16),
-    ('B_z_dr', ctypes.c_double * 16),
-    ('B_r_dphi', ctypes.c_double * 16),
-    ('B_phi_dphi', ctypes.c_double * 16),
-    ('B_z_dphi', ctypes.c_double * 16),
-    ('B_r_dz', ctypes.c_double * 16),
-    ('B_phi_dz', ctypes.c_double * 16),
-    ('B_z_dz', ctypes.c_double * 16),
-    ('bounces', ctypes.c_int32 * 16),
-    ('weight', ctypes.c_double * 16),
-    ('cputime', ctypes.c_double * 16),
-    ('rho', ctypes.c_double * 16),
-    ('theta', ctypes.c_double * 16),
-    ('id', ctypes.c_int64 * 16),
-    ('endcond', ctypes.c_int64 * 16),
-    ('walltile', ctypes.c_int64 * 16),
-    ('mileage', ctypes.c_double * 16),
-    ('running', ctypes.c_int64 * 16),
-    ('err', ctypes.c_uint64 * 16),
-    ('index', ctypes.c_int64 * 16),
+    ('r', ctypes.POINTER(ctypes.c_double)),
+    ('phi', ctypes.POINTER(ctypes.c_double)),
+    ('z', ctypes.POINTER(ctypes.c_double)),
+    ('p_r', ctypes.POINTER(ctypes.c_double)),
+    ('p_phi', ctypes.POINTER(ctypes.c_double)),
+    ('p_z', ctypes.POINTER(ctypes.c_double)),
+    ('mass', ctypes.POINTER(ctypes.c_double)),
+    ('charge', ctypes.POINTER(ctypes.c_double)),
+    ('time', ctypes.POINTER(ctypes.c_double)),
+    ('znum', ctypes.POINTER(ctypes.c_int32)),
+    ('anum', ctypes.POINTER(ctypes.c_int32)),
+    ('B_r', ctypes.POINTER(ctypes.c_double)),
+    ('B_phi', ctypes.POINTER(ctypes.c_double)),
+    ('B_z', ctypes.POINTER(ctypes.c_double)),
+    ('B_r_dr', ctypes.POINTER(ctypes.c_double)),
+    ('B_phi_dr', ctypes.POINTER(ctypes.c_double)),
+    ('B_z_dr', ctypes.POINTER(ctypes.c_double)),
+    ('B_r_dphi', ctypes.POINTER(ctypes.c_double)),
+    ('B_phi_dphi', ctypes.POINTER(ctypes.c_double)),
+    ('B_z_dphi', ctypes.POINTER(ctypes.c_double)),
+    ('B_r_dz', ctypes.POINTER(ctypes.c_double)),
+    ('B_phi_dz', ctypes.POINTER(ctypes.c_double)),
+    ('B_z_dz', ctypes.POINTER(ctypes.c_double)),
+    ('bounces', ctypes.POINTER(ctypes.c_int32)),
+    ('weight', ctypes.POINTER(ctypes.c_double)),
+    ('cputime', ctypes.POINTER(ctypes.c_double)),
+    ('rho', ctypes.POINTER(ctypes.c_double)),
+    ('theta', ctypes.POINTER(ctypes.c_double)),
+    ('id', ctypes.POINTER(ctypes.c_int64)),
+    ('endcond', ctypes.POINTER(ctypes.c_int64)),
+    ('walltile', ctypes.POINTER(ctypes.c_int64)),
+    ('mileage', ctypes.POINTER(ctypes.c_double)),
+    ('nstep', ctypes.POINTER(ctypes.c_int64)),
+    ('nrej', ctypes.POINTER(ctypes.c_int64)),
+    ('mindt', ctypes.POINTER(ctypes.c_double)),
+    ('mindtlim', ctypes.POINTER(ctypes.c_int64)),
+    ('running', ctypes.POINTER(ctypes.c_int64)),
+    ('err', ctypes.POINTER(ctypes.c_uint64)),
+    ('index', ctypes.POINTER(ctypes.c_int64)),
+    ('n_mrk', ctypes.c_uint64),
 ]
 
 particle_simd_fo = struct_c__SA_particle_simd_fo
@@ -998,9 +1130,15 @@ struct_c__SA_particle_simd_gc._fields_ = [
     ('endcond', ctypes.c_int64 * 16),
     ('walltile', ctypes.c_int64 * 16),
     ('mileage', ctypes.c_double * 16),
+    ('nstep', ctypes.c_int64 * 16),
+    ('nrej', ctypes.c_int64 * 16),
+    ('mindt', ctypes.c_double * 16),
+    ('mindtlim', ctypes.c_int64 * 16),
     ('running', ctypes.c_int64 * 16),
     ('err', ctypes.c_uint64 * 16),
     ('index', ctypes.c_int64 * 16),
+    ('n_mrk', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 60),
 ]
 
 particle_simd_gc = struct_c__SA_particle_simd_gc
@@ -1034,12 +1172,21 @@ struct_c__SA_particle_simd_ml._fields_ = [
     ('endcond', ctypes.c_int64 * 16),
     ('walltile', ctypes.c_int64 * 16),
     ('mileage', ctypes.c_double * 16),
+    ('nstep', ctypes.c_int64 * 16),
+    ('nrej', ctypes.c_int64 * 16),
+    ('mindt', ctypes.c_double * 16),
+    ('mindtlim', ctypes.c_int64 * 16),
     ('running', ctypes.c_int64 * 16),
     ('err', ctypes.c_uint64 * 16),
     ('index', ctypes.c_int64 * 16),
+    ('n_mrk', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 60),
 ]
 
 particle_simd_ml = struct_c__SA_particle_simd_ml
+particle_allocate_fo = _libraries['libascot.so'].particle_allocate_fo
+particle_allocate_fo.restype = None
+particle_allocate_fo.argtypes = [ctypes.POINTER(struct_c__SA_particle_simd_fo), ctypes.c_int32]
 particle_to_fo_dummy = _libraries['libascot.so'].particle_to_fo_dummy
 particle_to_fo_dummy.restype = None
 particle_to_fo_dummy.argtypes = [ctypes.POINTER(struct_c__SA_particle_simd_fo), ctypes.c_int32]
@@ -1058,6 +1205,12 @@ particle_cycle_gc.argtypes = [ctypes.POINTER(struct_c__SA_particle_queue), ctype
 particle_cycle_ml = _libraries['libascot.so'].particle_cycle_ml
 particle_cycle_ml.restype = ctypes.c_int32
 particle_cycle_ml.argtypes = [ctypes.POINTER(struct_c__SA_particle_queue), ctypes.POINTER(struct_c__SA_particle_simd_ml), ctypes.POINTER(struct_c__SA_B_field_data), ctypes.POINTER(ctypes.c_int32)]
+particle_compact_gc = _libraries['libascot.so'].particle_compact_gc
+particle_compact_gc.restype = ctypes.c_int32
+particle_compact_gc.argtypes = [ctypes.POINTER(struct_c__SA_particle_queue), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(ctypes.c_int32)]
+particle_compact_ml = _libraries['libascot.so'].particle_compact_ml
+particle_compact_ml.restype = ctypes.c_int32
+particle_compact_ml.argtypes = [ctypes.POINTER(struct_c__SA_particle_queue), ctypes.POINTER(struct_c__SA_particle_simd_ml), ctypes.POINTER(ctypes.c_int32)]
 particle_input_to_state = _libraries['libascot.so'].particle_input_to_state
 particle_input_to_state.restype = None
 particle_input_to_state.argtypes = [ctypes.POINTER(struct_c__SA_input_particle), ctypes.POINTER(struct_c__SA_particle_state), ctypes.POINTER(struct_c__SA_B_field_data)]
@@ -1070,6 +1223,9 @@ particle_input_gc_to_state.argtypes = [ctypes.POINTER(struct_c__SA_particle_gc),
 particle_input_ml_to_state = _libraries['libascot.so'].particle_input_ml_to_state
 particle_input_ml_to_state.restype = a5err
 particle_input_ml_to_state.argtypes = [ctypes.POINTER(struct_c__SA_particle_ml), ctypes.POINTER(struct_c__SA_particle_state), ctypes.POINTER(struct_c__SA_B_field_data)]
+particle_offload_fo = _libraries['libascot.so'].particle_offload_fo
+particle_offload_fo.restype = None
+particle_offload_fo.argtypes = [ctypes.POINTER(struct_c__SA_particle_simd_fo)]
 particle_state_to_fo = _libraries['libascot.so'].particle_state_to_fo
 particle_state_to_fo.restype = a5err
 particle_state_to_fo.argtypes = [ctypes.POINTER(struct_c__SA_particle_state), ctypes.c_int32, ctypes.POINTER(struct_c__SA_particle_simd_fo), ctypes.c_int32, ctypes.POINTER(struct_c__SA_B_field_data)]
@@ -1100,6 +1256,36 @@ particle_copy_gc.argtypes = [ctypes.POINTER(struct_c__SA_particle_simd_gc), ctyp
 particle_copy_ml = _libraries['libascot.so'].particle_copy_ml
 particle_copy_ml.restype = None
 particle_copy_ml.argtypes = [ctypes.POINTER(struct_c__SA_particle_simd_ml), ctypes.c_int32, ctypes.POINTER(struct_c__SA_particle_simd_ml), ctypes.c_int32]
+
+# values for enumeration 'DIST_COORDS_FLAG'
+DIST_COORDS_FLAG__enumvalues = {
+    1: 'dist_coords_momentum',
+    2: 'dist_coords_com',
+}
+dist_coords_momentum = 1
+dist_coords_com = 2
+DIST_COORDS_FLAG = ctypes.c_uint32 # enum
+class struct_c__SA_dist_coords_gc(Structure):
+    pass
+
+struct_c__SA_dist_coords_gc._pack_ = 1 # source:False
+struct_c__SA_dist_coords_gc._fields_ = [
+    ('phi', ctypes.c_double * 16),
+    ('theta', ctypes.c_double * 16),
+    ('pperp', ctypes.c_double * 16),
+    ('q', ctypes.c_double * 16),
+    ('weight', ctypes.c_double * 16),
+    ('pr', ctypes.c_double * 16),
+    ('pphi', ctypes.c_double * 16),
+    ('pz', ctypes.c_double * 16),
+    ('ekin', ctypes.c_double * 16),
+    ('ptor', ctypes.c_double * 16),
+]
+
+dist_coords_gc = struct_c__SA_dist_coords_gc
+dist_coords_eval_gc = _libraries['libascot.so'].dist_coords_eval_gc
+dist_coords_eval_gc.restype = None
+dist_coords_eval_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_coords_gc), ctypes.c_int32, ctypes.POINTER(struct_c__SA_B_field_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_particle_simd_gc)]
 class struct_c__SA_dist_5D_offload_data(Structure):
     pass
 
@@ -1191,7 +1377,7 @@ dist_5D_update_fo.restype = None
 dist_5D_update_fo.argtypes = [ctypes.POINTER(struct_c__SA_dist_5D_data), ctypes.POINTER(struct_c__SA_particle_simd_fo), ctypes.POINTER(struct_c__SA_particle_simd_fo)]
 dist_5D_update_gc = _libraries['libascot.so'].dist_5D_update_gc
 dist_5D_update_gc.restype = None
-dist_5D_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_5D_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_particle_simd_gc)]
+dist_5D_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_5D_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_dist_coords_gc)]
 class struct_c__SA_dist_6D_offload_data(Structure):
     pass
 
@@ -1288,7 +1474,7 @@ dist_6D_update_fo.restype = None
 dist_6D_update_fo.argtypes = [ctypes.POINTER(struct_c__SA_dist_6D_data), ctypes.POINTER(struct_c__SA_particle_simd_fo), ctypes.POINTER(struct_c__SA_particle_simd_fo)]
 dist_6D_update_gc = _libraries['libascot.so'].dist_6D_update_gc
 dist_6D_update_gc.restype = None
-dist_6D_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_6D_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_particle_simd_gc)]
+dist_6D_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_6D_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_dist_coords_gc)]
 class struct_c__SA_dist_rho5D_offload_data(Structure):
     pass
 
@@ -1376,7 +1562,7 @@ dist_rho5D_update_fo.restype = None
 dist_rho5D_update_fo.argtypes = [ctypes.POINTER(struct_c__SA_dist_rho5D_data), ctypes.POINTER(struct_c__SA_particle_simd_fo), ctypes.POINTER(struct_c__SA_particle_simd_fo)]
 dist_rho5D_update_gc = _libraries['libascot.so'].dist_rho5D_update_gc
 dist_rho5D_update_gc.restype = None
-dist_rho5D_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_rho5D_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_particle_simd_gc)]
+dist_rho5D_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_rho5D_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_dist_coords_gc)]
 class struct_c__SA_dist_rho6D_offload_data(Structure):
     pass
 
@@ -1473,7 +1659,7 @@ dist_rho6D_update_fo.restype = None
 dist_rho6D_update_fo.argtypes = [ctypes.POINTER(struct_c__SA_dist_rho6D_data), ctypes.POINTER(struct_c__SA_particle_simd_fo), ctypes.POINTER(struct_c__SA_particle_simd_fo)]
 dist_rho6D_update_gc = _libraries['libascot.so'].dist_rho6D_update_gc
 dist_rho6D_update_gc.restype = None
-dist_rho6D_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_rho6D_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_particle_simd_gc)]
+dist_rho6D_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_rho6D_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_dist_coords_gc)]
 class struct_c__SA_dist_COM_offload_data(Structure):
     pass
 
@@ -1525,7 +1711,7 @@ dist_COM_update_fo.restype = None
 dist_COM_update_fo.argtypes = [ctypes.POINTER(struct_c__SA_dist_COM_data), ctypes.POINTER(struct_c__SA_B_field_data), ctypes.POINTER(struct_c__SA_particle_simd_fo), ctypes.POINTER(struct_c__SA_particle_simd_fo)]
 dist_COM_update_gc = _libraries['libascot.so'].dist_COM_update_gc
 dist_COM_update_gc.restype = None
-dist_COM_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_COM_data), ctypes.POINTER(struct_c__SA_B_field_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_particle_simd_gc)]
+dist_COM_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_dist_COM_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_dist_coords_gc)]
 diag_orb_check_plane_crossing = _libraries['libascot.so'].diag_orb_check_plane_crossing
 diag_orb_check_plane_crossing.restype = real
 diag_orb_check_plane_crossing.argtypes = [real, real, real]
@@ -1667,6 +1853,241 @@ diag_transcoef_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_diag_transcoef_
 diag_transcoef_update_ml = _libraries['libascot.so'].diag_transcoef_update_ml
 diag_transcoef_update_ml.restype = None
 diag_transcoef_update_ml.argtypes = [ctypes.POINTER(struct_c__SA_diag_transcoef_data), ctypes.POINTER(struct_c__SA_particle_simd_ml), ctypes.POINTER(struct_c__SA_particle_simd_ml)]
+class struct_c__SA_wall_2d_offload_data(Structure):
+    pass
+
+struct_c__SA_wall_2d_offload_data._pack_ = 1 # source:False
+struct_c__SA_wall_2d_offload_data._fields_ = [
+    ('n', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('rmin', ctypes.c_double),
+    ('zmin', ctypes.c_double),
+    ('h', ctypes.c_double),
+    ('n_r', ctypes.c_int32),
+    ('n_z', ctypes.c_int32),
+    ('offload_array_length', ctypes.c_int32),
+    ('int_offload_array_length', ctypes.c_int32),
+]
+
+wall_2d_offload_data = struct_c__SA_wall_2d_offload_data
+class struct_c__SA_wall_2d_data(Structure):
+    pass
+
+struct_c__SA_wall_2d_data._pack_ = 1 # source:False
+struct_c__SA_wall_2d_data._fields_ = [
+    ('n', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('wall_r', ctypes.POINTER(ctypes.c_double)),
+    ('wall_z', ctypes.POINTER(ctypes.c_double)),
+    ('rmin', ctypes.c_double),
+    ('zmin', ctypes.c_double),
+    ('h', ctypes.c_double),
+    ('n_r', ctypes.c_int32),
+    ('n_z', ctypes.c_int32),
+    ('grid_array', ctypes.POINTER(ctypes.c_int32)),
+    ('grid_array_size', ctypes.c_int32),
+    ('PADDING_1', ctypes.c_ubyte * 4),
+]
+
+wall_2d_data = struct_c__SA_wall_2d_data
+wall_2d_init_offload = _libraries['libascot.so'].wall_2d_init_offload
+wall_2d_init_offload.restype = ctypes.c_int32
+wall_2d_init_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_2d_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
+wall_2d_free_offload = _libraries['libascot.so'].wall_2d_free_offload
+wall_2d_free_offload.restype = None
+wall_2d_free_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_2d_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
+wall_2d_init = _libraries['libascot.so'].wall_2d_init
+wall_2d_init.restype = None
+wall_2d_init.argtypes = [ctypes.POINTER(struct_c__SA_wall_2d_data), ctypes.POINTER(struct_c__SA_wall_2d_offload_data), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int32)]
+wall_2d_inside = _libraries['libascot.so'].wall_2d_inside
+wall_2d_inside.restype = ctypes.c_int32
+wall_2d_inside.argtypes = [real, real, ctypes.POINTER(struct_c__SA_wall_2d_data)]
+wall_2d_hit_wall = _libraries['libascot.so'].wall_2d_hit_wall
+wall_2d_hit_wall.restype = ctypes.c_int32
+wall_2d_hit_wall.argtypes = [real, real, real, real, real, real, ctypes.POINTER(struct_c__SA_wall_2d_data), ctypes.POINTER(ctypes.c_double)]
+wall_2d_find_intersection = _libraries['libascot.so'].wall_2d_find_intersection
+wall_2d_find_intersection.restype = ctypes.c_int32
+wall_2d_find_intersection.argtypes = [real, real, real, real, ctypes.POINTER(struct_c__SA_wall_2d_data), ctypes.POINTER(ctypes.c_double)]
+wall_2d_get_normal = _libraries['libascot.so'].wall_2d_get_normal
+wall_2d_get_normal.restype = None
+wall_2d_get_normal.argtypes = [ctypes.c_double * 3, ctypes.c_int32, ctypes.POINTER(struct_c__SA_wall_2d_data)]
+class struct_c__SA_wall_3d_offload_data(Structure):
+    pass
+
+struct_c__SA_wall_3d_offload_data._pack_ = 1 # source:False
+struct_c__SA_wall_3d_offload_data._fields_ = [
+    ('n', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('xmin', ctypes.c_double),
+    ('xmax', ctypes.c_double),
+    ('xgrid', ctypes.c_double),
+    ('ymin', ctypes.c_double),
+    ('ymax', ctypes.c_double),
+    ('ygrid', ctypes.c_double),
+    ('zmin', ctypes.c_double),
+    ('zmax', ctypes.c_double),
+    ('zgrid', ctypes.c_double),
+    ('depth', ctypes.c_int32),
+    ('ngrid', ctypes.c_int32),
+    ('offload_array_length', ctypes.c_int32),
+    ('int_offload_array_length', ctypes.c_int32),
+]
+
+wall_3d_offload_data = struct_c__SA_wall_3d_offload_data
+class struct_c__SA_wall_3d_data(Structure):
+    pass
+
+struct_c__SA_wall_3d_data._pack_ = 1 # source:False
+struct_c__SA_wall_3d_data._fields_ = [
+    ('n', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('xmin', ctypes.c_double),
+    ('xmax', ctypes.c_double),
+    ('xgrid', ctypes.c_double),
+    ('ymin', ctypes.c_double),
+    ('ymax', ctypes.c_double),
+    ('ygrid', ctypes.c_double),
+    ('zmin', ctypes.c_double),
+    ('zmax', ctypes.c_double),
+    ('zgrid', ctypes.c_double),
+    ('depth', ctypes.c_int32),
+    ('ngrid', ctypes.c_int32),
+    ('wall_tris', ctypes.POINTER(ctypes.c_double)),
+    ('tree_array_size', ctypes.c_int32),
+    ('PADDING_1', ctypes.c_ubyte * 4),
+    ('tree_array', ctypes.POINTER(ctypes.c_int32)),
+]
+
+wall_3d_data = struct_c__SA_wall_3d_data
+wall_3d_init_offload = _libraries['libascot.so'].wall_3d_init_offload
+wall_3d_init_offload.restype = ctypes.c_int32
+wall_3d_init_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_3d_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
+wall_3d_free_offload = _libraries['libascot.so'].wall_3d_free_offload
+wall_3d_free_offload.restype = None
+wall_3d_free_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_3d_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
+wall_3d_init_octree = _libraries['libascot.so'].wall_3d_init_octree
+wall_3d_init_octree.restype = None
+wall_3d_init_octree.argtypes = [ctypes.POINTER(struct_c__SA_wall_3d_offload_data), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
+wall_3d_init = _libraries['libascot.so'].wall_3d_init
+wall_3d_init.restype = None
+wall_3d_init.argtypes = [ctypes.POINTER(struct_c__SA_wall_3d_data), ctypes.POINTER(struct_c__SA_wall_3d_offload_data), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int32)]
+wall_3d_hit_wall = _libraries['libascot.so'].wall_3d_hit_wall
+wall_3d_hit_wall.restype = ctypes.c_int32
+wall_3d_hit_wall.argtypes = [real, real, real, real, real, real, ctypes.POINTER(struct_c__SA_wall_3d_data), ctypes.POINTER(ctypes.c_double)]
+wall_3d_hit_wall_full = _libraries['libascot.so'].wall_3d_hit_wall_full
+wall_3d_hit_wall_full.restype = ctypes.c_int32
+wall_3d_hit_wall_full.argtypes = [real, real, real, real, real, real, ctypes.POINTER(struct_c__SA_wall_3d_data), ctypes.POINTER(ctypes.c_double)]
+wall_3d_get_normal = _libraries['libascot.so'].wall_3d_get_normal
+wall_3d_get_normal.restype = None
+wall_3d_get_normal.argtypes = [ctypes.c_double * 3, ctypes.c_int32, real, ctypes.POINTER(struct_c__SA_wall_3d_data)]
+wall_3d_tri_collision = _libraries['libascot.so'].wall_3d_tri_collision
+wall_3d_tri_collision.restype = ctypes.c_double
+wall_3d_tri_collision.argtypes = [ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3]
+wall_3d_init_tree = _libraries['libascot.so'].wall_3d_init_tree
+wall_3d_init_tree.restype = None
+wall_3d_init_tree.argtypes = [ctypes.POINTER(struct_c__SA_wall_3d_data), ctypes.POINTER(ctypes.c_double)]
+wall_3d_tri_in_cube = _libraries['libascot.so'].wall_3d_tri_in_cube
+wall_3d_tri_in_cube.restype = ctypes.c_int32
+wall_3d_tri_in_cube.argtypes = [ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3]
+wall_3d_quad_collision = _libraries['libascot.so'].wall_3d_quad_collision
+wall_3d_quad_collision.restype = ctypes.c_int32
+wall_3d_quad_collision.argtypes = [ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3]
+
+# values for enumeration 'wall_type'
+wall_type__enumvalues = {
+    0: 'wall_type_2D',
+    1: 'wall_type_3D',
+}
+wall_type_2D = 0
+wall_type_3D = 1
+wall_type = ctypes.c_uint32 # enum
+class struct_c__SA_wall_offload_data(Structure):
+    pass
+
+struct_c__SA_wall_offload_data._pack_ = 1 # source:False
+struct_c__SA_wall_offload_data._fields_ = [
+    ('type', wall_type),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('w2d', wall_2d_offload_data),
+    ('w3d', wall_3d_offload_data),
+    ('dmap_n', ctypes.c_int32 * 3),
+    ('PADDING_1', ctypes.c_ubyte * 4),
+    ('dmap_min', ctypes.c_double * 3),
+    ('dmap_h', ctypes.c_double),
+    ('offload_array_length', ctypes.c_int32),
+    ('int_offload_array_length', ctypes.c_int32),
+]
+
+wall_offload_data = struct_c__SA_wall_offload_data
+class struct_c__SA_wall_data(Structure):
+    pass
+
+struct_c__SA_wall_data._pack_ = 1 # source:False
+struct_c__SA_wall_data._fields_ = [
+    ('type', wall_type),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('w2d', wall_2d_data),
+    ('w3d', wall_3d_data),
+    ('dmap_n', ctypes.c_int32 * 3),
+    ('PADDING_1', ctypes.c_ubyte * 4),
+    ('dmap_min', ctypes.c_double * 3),
+    ('dmap_h', ctypes.c_double),
+    ('dmap', ctypes.POINTER(ctypes.c_double)),
+]
+
+wall_data = struct_c__SA_wall_data
+wall_init_offload = _libraries['libascot.so'].wall_init_offload
+wall_init_offload.restype = ctypes.c_int32
+wall_init_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
+wall_free_offload = _libraries['libascot.so'].wall_free_offload
+wall_free_offload.restype = None
+wall_free_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
+wall_init = _libraries['libascot.so'].wall_init
+wall_init.restype = ctypes.c_int32
+wall_init.argtypes = [ctypes.POINTER(struct_c__SA_wall_data), ctypes.POINTER(struct_c__SA_wall_offload_data), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int32)]
+wall_hit_wall = _libraries['libascot.so'].wall_hit_wall
+wall_hit_wall.restype = ctypes.c_int32
+wall_hit_wall.argtypes = [real, real, real, real, real, real, ctypes.POINTER(struct_c__SA_wall_data), ctypes.POINTER(ctypes.c_double)]
+wall_get_n_elements = _libraries['libascot.so'].wall_get_n_elements
+wall_get_n_elements.restype = ctypes.c_int32
+wall_get_n_elements.argtypes = [ctypes.POINTER(struct_c__SA_wall_data)]
+wall_get_normal = _libraries['libascot.so'].wall_get_normal
+wall_get_normal.restype = None
+wall_get_normal.argtypes = [ctypes.c_double * 3, ctypes.c_int32, real, ctypes.POINTER(struct_c__SA_wall_data)]
+class struct_c__SA_diag_wall_offload_data(Structure):
+    pass
+
+struct_c__SA_diag_wall_offload_data._pack_ = 1 # source:False
+struct_c__SA_diag_wall_offload_data._fields_ = [
+    ('n_tile', ctypes.c_int32),
+]
+
+diag_wall_offload_data = struct_c__SA_diag_wall_offload_data
+class struct_c__SA_diag_wall_data(Structure):
+    pass
+
+struct_c__SA_diag_wall_data._pack_ = 1 # source:False
+struct_c__SA_diag_wall_data._fields_ = [
+    ('n_tile', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('nmrk', ctypes.POINTER(ctypes.c_double)),
+    ('pdepo', ctypes.POINTER(ctypes.c_double)),
+    ('emrk', ctypes.POINTER(ctypes.c_double)),
+    ('edepo', ctypes.POINTER(ctypes.c_double)),
+    ('angmrk', ctypes.POINTER(ctypes.c_double)),
+    ('angdepo', ctypes.POINTER(ctypes.c_double)),
+]
+
+diag_wall_data = struct_c__SA_diag_wall_data
+diag_wall_init = _libraries['libascot.so'].diag_wall_init
+diag_wall_init.restype = None
+diag_wall_init.argtypes = [ctypes.POINTER(struct_c__SA_diag_wall_data), ctypes.POINTER(struct_c__SA_diag_wall_offload_data), ctypes.POINTER(ctypes.c_double)]
+diag_wall_update_fo = _libraries['libascot.so'].diag_wall_update_fo
+diag_wall_update_fo.restype = None
+diag_wall_update_fo.argtypes = [ctypes.POINTER(struct_c__SA_diag_wall_data), ctypes.POINTER(struct_c__SA_wall_data), ctypes.POINTER(struct_c__SA_particle_simd_fo), ctypes.POINTER(struct_c__SA_particle_simd_fo)]
+diag_wall_update_gc = _libraries['libascot.so'].diag_wall_update_gc
+diag_wall_update_gc.restype = None
+diag_wall_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_diag_wall_data), ctypes.POINTER(struct_c__SA_wall_data), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_particle_simd_gc)]
 class struct_c__SA_diag_offload_data(Structure):
     pass
 
@@ -1679,7 +2100,7 @@ struct_c__SA_diag_offload_data._fields_ = [
     ('distrho6D_collect', ctypes.c_int32),
     ('distCOM_collect', ctypes.c_int32),
     ('diagtrcof_collect', ctypes.c_int32),
-    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('diagwall_collect', ctypes.c_int32),
     ('diagorb', diag_orb_offload_data),
     ('dist5D', dist_5D_offload_data),
     ('dist6D', dist_6D_offload_data),
@@ -1687,6 +2108,8 @@ struct_c__SA_diag_offload_data._fields_ = [
     ('distrho6D', dist_rho6D_offload_data),
     ('distCOM', dist_COM_offload_data),
     ('diagtrcof', diag_transcoef_offload_data),
+    ('diagwall', diag_wall_offload_data),
+    ('PADDING_0', ctypes.c_ubyte * 4),
     ('offload_dist5D_index', ctypes.c_uint64),
     ('offload_dist6D_index', ctypes.c_uint64),
     ('offload_distrho5D_index', ctypes.c_uint64),
@@ -1694,6 +2117,7 @@ struct_c__SA_diag_offload_data._fields_ = [
     ('offload_distCOM_index', ctypes.c_uint64),
     ('offload_diagorb_index', ctypes.c_uint64),
     ('offload_diagtrcof_index', ctypes.c_uint64),
+    ('offload_diagwall_index', ctypes.c_uint64),
     ('offload_dist_length', ctypes.c_uint64),
     ('offload_array_length', ctypes.c_uint64),
 ]
@@ -1711,7 +2135,7 @@ struct_c__SA_diag_data._fields_ = [
     ('distrho6D_collect', ctypes.c_int32),
     ('distCOM_collect', ctypes.c_int32),
     ('diagtrcof_collect', ctypes.c_int32),
-    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('diagwall_collect', ctypes.c_int32),
     ('diagorb', diag_orb_data),
     ('dist5D', dist_5D_data),
     ('dist6D', dist_6D_data),
@@ -1719,6 +2143,7 @@ struct_c__SA_diag_data._fields_ = [
     ('distrho6D', dist_rho6D_data),
     ('distCOM', dist_COM_data),
     ('diagtrcof', diag_transcoef_data),
+    ('diagwall', diag_wall_data),
 ]
 
 diag_data = struct_c__SA_diag_data
@@ -1746,21 +2171,6 @@ diag_update_gc.argtypes = [ctypes.POINTER(struct_c__SA_diag_data), ctypes.POINTE
 diag_update_ml = _libraries['libascot.so'].diag_update_ml
 diag_update_ml.restype = None
 diag_update_ml.argtypes = [ctypes.POINTER(struct_c__SA_diag_data), ctypes.POINTER(struct_c__SA_particle_simd_ml), ctypes.POINTER(struct_c__SA_particle_simd_ml)]
-mpi_interface_init = _libraries['libascot.so'].mpi_interface_init
-mpi_interface_init.restype = None
-mpi_interface_init.argtypes = [ctypes.c_int32, ctypes.POINTER(ctypes.POINTER(ctypes.c_char)), ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_int32)]
-mpi_interface_finalize = _libraries['libascot.so'].mpi_interface_finalize
-mpi_interface_finalize.restype = None
-mpi_interface_finalize.argtypes = []
-mpi_my_particles = _libraries['libascot.so'].mpi_my_particles
-mpi_my_particles.restype = None
-mpi_my_particles.argtypes = [ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_int32), ctypes.c_int32, ctypes.c_int32, ctypes.c_int32]
-mpi_gather_particlestate = _libraries['libascot.so'].mpi_gather_particlestate
-mpi_gather_particlestate.restype = None
-mpi_gather_particlestate.argtypes = [ctypes.POINTER(struct_c__SA_particle_state), ctypes.POINTER(ctypes.POINTER(struct_c__SA_particle_state)), ctypes.POINTER(ctypes.c_int32), ctypes.c_int32, ctypes.c_int32, ctypes.c_int32, ctypes.c_int32]
-mpi_gather_diag = _libraries['libascot.so'].mpi_gather_diag
-mpi_gather_diag.restype = None
-mpi_gather_diag.argtypes = [ctypes.POINTER(struct_c__SA_diag_offload_data), ctypes.POINTER(ctypes.c_double), ctypes.c_int32, ctypes.c_int32, ctypes.c_int32, ctypes.c_int32]
 class struct_c__SA_plasma_1D_offload_data(Structure):
     pass
 
@@ -1772,14 +2182,27 @@ struct_c__SA_plasma_1D_offload_data._fields_ = [
     ('charge', ctypes.c_double * 8),
     ('anum', ctypes.c_int32 * 8),
     ('znum', ctypes.c_int32 * 8),
+    ('n_bin_rho', ctypes.c_int32),
     ('offload_array_length', ctypes.c_int32),
-    ('PADDING_0', ctypes.c_ubyte * 4),
 ]
 
 plasma_1D_offload_data = struct_c__SA_plasma_1D_offload_data
 class struct_c__SA_plasma_1D_data(Structure):
     pass
 
+class struct_c__SA_linint_search_data(Structure):
+    pass
+
+struct_c__SA_linint_search_data._pack_ = 1 # source:False
+struct_c__SA_linint_search_data._fields_ = [
+    ('n_x', ctypes.c_int32),
+    ('n_bin', ctypes.c_int32),
+    ('x_min', ctypes.c_double),
+    ('x_bin', ctypes.c_double),
+    ('x', ctypes.POINTER(ctypes.c_double)),
+    ('bin', ctypes.POINTER(ctypes.c_double)),
+]
+
 struct_c__SA_plasma_1D_data._pack_ = 1 # source:False
 struct_c__SA_plasma_1D_data._fields_ = [
     ('n_rho', ctypes.c_int32),
@@ -1791,6 +2214,7 @@ struct_c__SA_plasma_1D_data._fields_ = [
     ('rho', ctypes.POINTER(ctypes.c_double)),
     ('temp', ctypes.POINTER(ctypes.c_double)),
     ('dens', ctypes.POINTER(ctypes.c_double)),
+    ('rho_search', struct_c__SA_linint_search_data),
 ]
 
 plasma_1D_data = struct_c__SA_plasma_1D_data
@@ -1825,6 +2249,8 @@ struct_c__SA_plasma_1Dt_offload_data._fields_ = [
     ('charge', ctypes.c_double * 8),
     ('anum', ctypes.c_int32 * 8),
     ('znum', ctypes.c_int32 * 8),
+    ('n_bin_rho', ctypes.c_int32),
+    ('n_bin_time', ctypes.c_int32),
     ('offload_array_length', ctypes.c_int32),
     ('PADDING_1', ctypes.c_ubyte * 4),
 ]
@@ -1847,6 +2273,8 @@ struct_c__SA_plasma_1Dt_data._fields_ = [
     ('time', ctypes.POINTER(ctypes.c_double)),
     ('temp', ctypes.POINTER(ctypes.c_double)),
     ('dens', ctypes.POINTER(ctypes.c_double)),
+    ('rho_search', struct_c__SA_linint_search_data),
+    ('time_search', struct_c__SA_linint_search_data),
 ]
 
 plasma_1Dt_data = struct_c__SA_plasma_1Dt_data
@@ -2021,8 +2449,7 @@ struct_c__SA_N0_1D_data._fields_ = [
     ('znum', ctypes.c_int32 * 8),
     ('maxwellian', ctypes.c_int32 * 8),
     ('PADDING_0', ctypes.c_ubyte * 4),
-    ('n0', struct_c__SA_linint1D_data * 8),
-    ('t0', struct_c__SA_linint1D_data * 8),
+    ('n0t0', struct_c__SA_linint1D_data),
 ]
 
 N0_1D_data = struct_c__SA_N0_1D_data
@@ -2035,6 +2462,9 @@ N0_1D_free_offload.argtypes = [ctypes.POINTER(struct_c__SA_N0_1D_offload_data),
 N0_1D_init = _libraries['libascot.so'].N0_1D_init
 N0_1D_init.restype = None
 N0_1D_init.argtypes = [ctypes.POINTER(struct_c__SA_N0_1D_data), ctypes.POINTER(struct_c__SA_N0_1D_offload_data), ctypes.POINTER(ctypes.c_double)]
+N0_1D_eval_n0t0 = _libraries['libascot.so'].N0_1D_eval_n0t0
+N0_1D_eval_n0t0.restype = a5err
+N0_1D_eval_n0t0.argtypes = [ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), real, ctypes.POINTER(struct_c__SA_N0_1D_data)]
 N0_1D_eval_n0 = _libraries['libascot.so'].N0_1D_eval_n0
 N0_1D_eval_n0.restype = a5err
 N0_1D_eval_n0.argtypes = [ctypes.POINTER(ctypes.c_double), real, ctypes.POINTER(struct_c__SA_N0_1D_data)]
@@ -2100,8 +2530,7 @@ struct_c__SA_N0_3D_data._fields_ = [
     ('znum', ctypes.c_int32 * 8),
     ('maxwellian', ctypes.c_int32 * 8),
     ('PADDING_0', ctypes.c_ubyte * 4),
-    ('n0', struct_c__SA_linint3D_data * 8),
-    ('t0', struct_c__SA_linint3D_data * 8),
+    ('n0t0', struct_c__SA_linint3D_data),
 ]
 
 N0_3D_data = struct_c__SA_N0_3D_data
@@ -2114,6 +2543,9 @@ N0_3D_free_offload.argtypes = [ctypes.POINTER(struct_c__SA_N0_3D_offload_data),
 N0_3D_init = _libraries['libascot.so'].N0_3D_init
 N0_3D_init.restype = None
 N0_3D_init.argtypes = [ctypes.POINTER(struct_c__SA_N0_3D_data), ctypes.POINTER(struct_c__SA_N0_3D_offload_data), ctypes.POINTER(ctypes.c_double)]
+N0_3D_eval_n0t0 = _libraries['libascot.so'].N0_3D_eval_n0t0
+N0_3D_eval_n0t0.restype = a5err
+N0_3D_eval_n0t0.argtypes = [ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), real, real, real, ctypes.POINTER(struct_c__SA_N0_3D_data)]
 N0_3D_eval_n0 = _libraries['libascot.so'].N0_3D_eval_n0
 N0_3D_eval_n0.restype = a5err
 N0_3D_eval_n0.argtypes = [ctypes.POINTER(ctypes.c_double), real, real, real, ctypes.POINTER(struct_c__SA_N0_3D_data)]
@@ -2170,180 +2602,15 @@ neutral_init.argtypes = [ctypes.POINTER(struct_c__SA_neutral_data), ctypes.POINT
 neutral_eval_n0 = _libraries['libascot.so'].neutral_eval_n0
 neutral_eval_n0.restype = a5err
 neutral_eval_n0.argtypes = [ctypes.POINTER(ctypes.c_double), real, real, real, real, real, ctypes.POINTER(struct_c__SA_neutral_data)]
+neutral_eval_n0t0 = _libraries['libascot.so'].neutral_eval_n0t0
+neutral_eval_n0t0.restype = a5err
+neutral_eval_n0t0.argtypes = [ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), real, real, real, real, real, ctypes.POINTER(struct_c__SA_neutral_data)]
 neutral_eval_t0 = _libraries['libascot.so'].neutral_eval_t0
 neutral_eval_t0.restype = a5err
 neutral_eval_t0.argtypes = [ctypes.POINTER(ctypes.c_double), real, real, real, real, real, ctypes.POINTER(struct_c__SA_neutral_data)]
 neutral_get_n_species = _libraries['libascot.so'].neutral_get_n_species
 neutral_get_n_species.restype = ctypes.c_int32
 neutral_get_n_species.argtypes = [ctypes.POINTER(struct_c__SA_neutral_data)]
-class struct_c__SA_wall_2d_offload_data(Structure):
-    pass
-
-struct_c__SA_wall_2d_offload_data._pack_ = 1 # source:False
-struct_c__SA_wall_2d_offload_data._fields_ = [
-    ('n', ctypes.c_int32),
-    ('offload_array_length', ctypes.c_int32),
-]
-
-wall_2d_offload_data = struct_c__SA_wall_2d_offload_data
-class struct_c__SA_wall_2d_data(Structure):
-    pass
-
-struct_c__SA_wall_2d_data._pack_ = 1 # source:False
-struct_c__SA_wall_2d_data._fields_ = [
-    ('n', ctypes.c_int32),
-    ('PADDING_0', ctypes.c_ubyte * 4),
-    ('wall_r', ctypes.POINTER(ctypes.c_double)),
-    ('wall_z', ctypes.POINTER(ctypes.c_double)),
-]
-
-wall_2d_data = struct_c__SA_wall_2d_data
-wall_2d_init_offload = _libraries['libascot.so'].wall_2d_init_offload
-wall_2d_init_offload.restype = ctypes.c_int32
-wall_2d_init_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_2d_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double))]
-wall_2d_free_offload = _libraries['libascot.so'].wall_2d_free_offload
-wall_2d_free_offload.restype = None
-wall_2d_free_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_2d_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double))]
-wall_2d_init = _libraries['libascot.so'].wall_2d_init
-wall_2d_init.restype = None
-wall_2d_init.argtypes = [ctypes.POINTER(struct_c__SA_wall_2d_data), ctypes.POINTER(struct_c__SA_wall_2d_offload_data), ctypes.POINTER(ctypes.c_double)]
-wall_2d_inside = _libraries['libascot.so'].wall_2d_inside
-wall_2d_inside.restype = ctypes.c_int32
-wall_2d_inside.argtypes = [real, real, ctypes.POINTER(struct_c__SA_wall_2d_data)]
-wall_2d_hit_wall = _libraries['libascot.so'].wall_2d_hit_wall
-wall_2d_hit_wall.restype = ctypes.c_int32
-wall_2d_hit_wall.argtypes = [real, real, real, real, real, real, ctypes.POINTER(struct_c__SA_wall_2d_data), ctypes.POINTER(ctypes.c_double)]
-wall_2d_find_intersection = _libraries['libascot.so'].wall_2d_find_intersection
-wall_2d_find_intersection.restype = ctypes.c_int32
-wall_2d_find_intersection.argtypes = [real, real, real, real, ctypes.POINTER(struct_c__SA_wall_2d_data), ctypes.POINTER(ctypes.c_double)]
-class struct_c__SA_wall_3d_offload_data(Structure):
-    pass
-
-struct_c__SA_wall_3d_offload_data._pack_ = 1 # source:False
-struct_c__SA_wall_3d_offload_data._fields_ = [
-    ('n', ctypes.c_int32),
-    ('PADDING_0', ctypes.c_ubyte * 4),
-    ('xmin', ctypes.c_double),
-    ('xmax', ctypes.c_double),
-    ('xgrid', ctypes.c_double),
-    ('ymin', ctypes.c_double),
-    ('ymax', ctypes.c_double),
-    ('ygrid', ctypes.c_double),
-    ('zmin', ctypes.c_double),
-    ('zmax', ctypes.c_double),
-    ('zgrid', ctypes.c_double),
-    ('depth', ctypes.c_int32),
-    ('ngrid', ctypes.c_int32),
-    ('offload_array_length', ctypes.c_int32),
-    ('int_offload_array_length', ctypes.c_int32),
-]
-
-wall_3d_offload_data = struct_c__SA_wall_3d_offload_data
-class struct_c__SA_wall_3d_data(Structure):
-    pass
-
-struct_c__SA_wall_3d_data._pack_ = 1 # source:False
-struct_c__SA_wall_3d_data._fields_ = [
-    ('n', ctypes.c_int32),
-    ('PADDING_0', ctypes.c_ubyte * 4),
-    ('xmin', ctypes.c_double),
-    ('xmax', ctypes.c_double),
-    ('xgrid', ctypes.c_double),
-    ('ymin', ctypes.c_double),
-    ('ymax', ctypes.c_double),
-    ('ygrid', ctypes.c_double),
-    ('zmin', ctypes.c_double),
-    ('zmax', ctypes.c_double),
-    ('zgrid', ctypes.c_double),
-    ('depth', ctypes.c_int32),
-    ('ngrid', ctypes.c_int32),
-    ('wall_tris', ctypes.POINTER(ctypes.c_double)),
-    ('tree_array_size', ctypes.c_int32),
-    ('PADDING_1', ctypes.c_ubyte * 4),
-    ('tree_array', ctypes.POINTER(ctypes.c_int32)),
-]
-
-wall_3d_data = struct_c__SA_wall_3d_data
-wall_3d_init_offload = _libraries['libascot.so'].wall_3d_init_offload
-wall_3d_init_offload.restype = ctypes.c_int32
-wall_3d_init_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_3d_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
-wall_3d_free_offload = _libraries['libascot.so'].wall_3d_free_offload
-wall_3d_free_offload.restype = None
-wall_3d_free_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_3d_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
-wall_3d_init_octree = _libraries['libascot.so'].wall_3d_init_octree
-wall_3d_init_octree.restype = None
-wall_3d_init_octree.argtypes = [ctypes.POINTER(struct_c__SA_wall_3d_offload_data), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
-wall_3d_init = _libraries['libascot.so'].wall_3d_init
-wall_3d_init.restype = None
-wall_3d_init.argtypes = [ctypes.POINTER(struct_c__SA_wall_3d_data), ctypes.POINTER(struct_c__SA_wall_3d_offload_data), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int32)]
-wall_3d_hit_wall = _libraries['libascot.so'].wall_3d_hit_wall
-wall_3d_hit_wall.restype = ctypes.c_int32
-wall_3d_hit_wall.argtypes = [real, real, real, real, real, real, ctypes.POINTER(struct_c__SA_wall_3d_data), ctypes.POINTER(ctypes.c_double)]
-wall_3d_hit_wall_full = _libraries['libascot.so'].wall_3d_hit_wall_full
-wall_3d_hit_wall_full.restype = ctypes.c_int32
-wall_3d_hit_wall_full.argtypes = [real, real, real, real, real, real, ctypes.POINTER(struct_c__SA_wall_3d_data), ctypes.POINTER(ctypes.c_double)]
-wall_3d_tri_collision = _libraries['libascot.so'].wall_3d_tri_collision
-wall_3d_tri_collision.restype = ctypes.c_double
-wall_3d_tri_collision.argtypes = [ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3]
-wall_3d_init_tree = _libraries['libascot.so'].wall_3d_init_tree
-wall_3d_init_tree.restype = None
-wall_3d_init_tree.argtypes = [ctypes.POINTER(struct_c__SA_wall_3d_data), ctypes.POINTER(ctypes.c_double)]
-wall_3d_tri_in_cube = _libraries['libascot.so'].wall_3d_tri_in_cube
-wall_3d_tri_in_cube.restype = ctypes.c_int32
-wall_3d_tri_in_cube.argtypes = [ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3]
-wall_3d_quad_collision = _libraries['libascot.so'].wall_3d_quad_collision
-wall_3d_quad_collision.restype = ctypes.c_int32
-wall_3d_quad_collision.argtypes = [ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3, ctypes.c_double * 3]
-
-# values for enumeration 'wall_type'
-wall_type__enumvalues = {
-    0: 'wall_type_2D',
-    1: 'wall_type_3D',
-}
-wall_type_2D = 0
-wall_type_3D = 1
-wall_type = ctypes.c_uint32 # enum
-class struct_c__SA_wall_offload_data(Structure):
-    pass
-
-struct_c__SA_wall_offload_data._pack_ = 1 # source:False
-struct_c__SA_wall_offload_data._fields_ = [
-    ('type', wall_type),
-    ('w2d', wall_2d_offload_data),
-    ('PADDING_0', ctypes.c_ubyte * 4),
-    ('w3d', wall_3d_offload_data),
-    ('offload_array_length', ctypes.c_int32),
-    ('int_offload_array_length', ctypes.c_int32),
-]
-
-wall_offload_data = struct_c__SA_wall_offload_data
-class struct_c__SA_wall_data(Structure):
-    pass
-
-struct_c__SA_wall_data._pack_ = 1 # source:False
-struct_c__SA_wall_data._fields_ = [
-    ('type', wall_type),
-    ('PADDING_0', ctypes.c_ubyte * 4),
-    ('w2d', wall_2d_data),
-    ('w3d', wall_3d_data),
-]
-
-wall_data = struct_c__SA_wall_data
-wall_init_offload = _libraries['libascot.so'].wall_init_offload
-wall_init_offload.restype = ctypes.c_int32
-wall_init_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
-wall_free_offload = _libraries['libascot.so'].wall_free_offload
-wall_free_offload.restype = None
-wall_free_offload.argtypes = [ctypes.POINTER(struct_c__SA_wall_offload_data), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
-wall_init = _libraries['libascot.so'].wall_init
-wall_init.restype = ctypes.c_int32
-wall_init.argtypes = [ctypes.POINTER(struct_c__SA_wall_data), ctypes.POINTER(struct_c__SA_wall_offload_data), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int32)]
-wall_hit_wall = _libraries['libascot.so'].wall_hit_wall
-wall_hit_wall.restype = ctypes.c_int32
-wall_hit_wall.argtypes = [real, real, real, real, real, real, ctypes.POINTER(struct_c__SA_wall_data), ctypes.POINTER(ctypes.c_double)]
-wall_get_n_elements = _libraries['libascot.so'].wall_get_n_elements
-wall_get_n_elements.restype = ctypes.c_int32
-wall_get_n_elements.argtypes = [ctypes.POINTER(struct_c__SA_wall_data)]
 class struct_c__SA_boozer_offload_data(Structure):
     pass
 
@@ -2787,6 +3054,17 @@ simulate_mode_gc = 2
 simulate_mode_hybrid = 3
 simulate_mode_ml = 4
 SIMULATION_MODE = ctypes.c_uint32 # enum
+
+# values for enumeration 'MARKER_SORTING'
+MARKER_SORTING__enumvalues = {
+    0: 'simulate_sort_none',
+    1: 'simulate_sort_rphiz',
+    2: 'simulate_sort_rhothetaphi',
+}
+simulate_sort_none = 0
+simulate_sort_rphiz = 1
+simulate_sort_rhothetaphi = 2
+MARKER_SORTING = ctypes.c_uint32 # enum
 class struct_c__SA_sim_offload_data(Structure):
     pass
 
@@ -2805,10 +3083,13 @@ struct_c__SA_sim_offload_data._fields_ = [
     ('sim_mode', ctypes.c_int32),
     ('enable_ada', ctypes.c_int32),
     ('record_mode', ctypes.c_int32),
+    ('marker_sorting', ctypes.c_int32),
+    ('simd_width', ctypes.c_int32),
     ('fix_usrdef_use', ctypes.c_int32),
     ('fix_usrdef_val', ctypes.c_double),
     ('fix_gyrodef_nstep', ctypes.c_int32),
-    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('fix_ccol_nstep', ctypes.c_int32),
+    ('fix_ccol_tol', ctypes.c_double),
     ('ada_tol_orbfol', ctypes.c_double),
     ('ada_tol_clmbcol', ctypes.c_double),
     ('ada_max_drho', ctypes.c_double),
@@ -2822,7 +3103,17 @@ struct_c__SA_sim_offload_data._fields_ = [
     ('disable_pitchccoll', ctypes.c_int32),
     ('disable_gcdiffccoll', ctypes.c_int32),
     ('reverse_time', ctypes.c_int32),
+    ('enable_split', ctypes.c_int32),
+    ('split_rho', ctypes.c_double),
+    ('split_number', ctypes.c_int32),
+    ('split_max_markers', ctypes.c_int32),
+    ('converge_mode', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('converge_tol', ctypes.c_double),
+    ('converge_batch', ctypes.c_int32),
+    ('converge_min_batches', ctypes.c_int32),
     ('endcond_active', ctypes.c_int32),
+    ('PADDING_1', ctypes.c_ubyte * 4),
     ('endcond_lim_simtime', ctypes.c_double),
     ('endcond_max_mileage', ctypes.c_double),
     ('endcond_max_cputime', ctypes.c_double),
@@ -2840,6 +3131,7 @@ struct_c__SA_sim_offload_data._fields_ = [
     ('mpi_root', ctypes.c_int32),
     ('mpi_rank', ctypes.c_int32),
     ('mpi_size', ctypes.c_int32),
+    ('mpi_shmem', ctypes.c_int32),
     ('qid_options', ctypes.c_char * 256),
     ('qid_bfield', ctypes.c_char * 256),
     ('qid_efield', ctypes.c_char * 256),
@@ -2851,6 +3143,7 @@ struct_c__SA_sim_offload_data._fields_ = [
     ('qid_mhd', ctypes.c_char * 256),
     ('qid_asigma', ctypes.c_char * 256),
     ('qid_nbi', ctypes.c_char * 256),
+    ('PADDING_2', ctypes.c_ubyte * 4),
 ]
 
 sim_offload_data = struct_c__SA_sim_offload_data
@@ -2868,6 +3161,48 @@ struct_c__SA_mccc_data._fields_ = [
     ('include_gcdiff', ctypes.c_int32),
 ]
 
+class struct_c__SA_simulate_converge_data(Structure):
+    pass
+
+struct_c__SA_simulate_converge_data._pack_ = 1 # source:False
+struct_c__SA_simulate_converge_data._fields_ = [
+    ('mode', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('tol', ctypes.c_double),
+    ('batch_size', ctypes.c_int32),
+    ('min_batches', ctypes.c_int32),
+    ('pq', ctypes.POINTER(struct_c__SA_particle_queue)),
+    ('n_input', ctypes.c_int32),
+    ('n_skipped', ctypes.c_int32),
+    ('mrk', ctypes.POINTER(struct_c__SA_particle_state)),
+    ('pool', ctypes.POINTER(struct_c__SA_particle_state)),
+    ('pool_size', ctypes.c_int32),
+    ('n_batches', ctypes.c_int32),
+    ('batch', ctypes.c_int32),
+    ('check', ctypes.c_int32),
+    ('slot_batch', ctypes.POINTER(ctypes.c_int32)),
+    ('done', ctypes.POINTER(ctypes.c_char)),
+    ('child_head', ctypes.POINTER(ctypes.c_int32)),
+    ('child_next', ctypes.POINTER(ctypes.c_int32)),
+    ('w_batch', ctypes.c_double),
+    ('x_batch', ctypes.c_double),
+    ('n_batch', ctypes.c_int32),
+    ('PADDING_1', ctypes.c_ubyte * 4),
+    ('s1', ctypes.c_double),
+    ('s2', ctypes.c_double),
+    ('n_tile', ctypes.c_int32),
+    ('n_touched', ctypes.c_int32),
+    ('touched', ctypes.POINTER(ctypes.c_int32)),
+    ('tile_batch', ctypes.POINTER(ctypes.c_double)),
+    ('tile_s1', ctypes.POINTER(ctypes.c_double)),
+    ('tile_s2', ctypes.POINTER(ctypes.c_double)),
+    ('tile_max', ctypes.c_int32),
+    ('n_counted', ctypes.c_int32),
+    ('relerr', ctypes.c_double),
+    ('converged', ctypes.c_int32),
+    ('PADDING_2', ctypes.c_ubyte * 4),
+]
+
 struct_c__SA_sim_data._pack_ = 1 # source:False
 struct_c__SA_sim_data._fields_ = [
     ('B_data', B_field_data),
@@ -2885,10 +3220,13 @@ struct_c__SA_sim_data._fields_ = [
     ('sim_mode', ctypes.c_int32),
     ('enable_ada', ctypes.c_int32),
     ('record_mode', ctypes.c_int32),
+    ('simd_width', ctypes.c_int32),
     ('fix_usrdef_use', ctypes.c_int32),
+    ('PADDING_0', ctypes.c_ubyte * 4),
     ('fix_usrdef_val', ctypes.c_double),
     ('fix_gyrodef_nstep', ctypes.c_int32),
-    ('PADDING_0', ctypes.c_ubyte * 4),
+    ('fix_ccol_nstep', ctypes.c_int32),
+    ('fix_ccol_tol', ctypes.c_double),
     ('ada_tol_orbfol', ctypes.c_double),
     ('ada_tol_clmbcol', ctypes.c_double),
     ('ada_max_drho', ctypes.c_double),
@@ -2902,7 +3240,17 @@ struct_c__SA_sim_data._fields_ = [
     ('disable_pitchccoll', ctypes.c_int32),
     ('disable_gcdiffccoll', ctypes.c_int32),
     ('reverse_time', ctypes.c_int32),
+    ('enable_split', ctypes.c_int32),
+    ('split_rho', ctypes.c_double),
+    ('split_number', ctypes.c_int32),
+    ('PADDING_1', ctypes.c_ubyte * 4),
+    ('split_pool', ctypes.POINTER(struct_c__SA_particle_state)),
+    ('split_factor', ctypes.POINTER(ctypes.c_int32)),
+    ('split_pool_size', ctypes.c_int32),
+    ('split_pool_next', ctypes.c_int32),
+    ('converge_data', struct_c__SA_simulate_converge_data),
     ('endcond_active', ctypes.c_int32),
+    ('PADDING_2', ctypes.c_ubyte * 4),
     ('endcond_lim_simtime', ctypes.c_double),
     ('endcond_max_mileage', ctypes.c_double),
     ('endcond_max_cputime', ctypes.c_double),
@@ -2913,7 +3261,7 @@ struct_c__SA_sim_data._fields_ = [
     ('endcond_max_tororb', ctypes.c_double),
     ('endcond_max_polorb', ctypes.c_double),
     ('endcond_torandpol', ctypes.c_int32),
-    ('PADDING_1', ctypes.c_ubyte * 4),
+    ('PADDING_3', ctypes.c_ubyte * 4),
 ]
 
 sim_data = struct_c__SA_sim_data
@@ -2923,6 +3271,9 @@ simulate_init_offload.argtypes = [ctypes.POINTER(struct_c__SA_sim_offload_data)]
 sim_init = _libraries['libascot.so'].sim_init
 sim_init.restype = None
 sim_init.argtypes = [ctypes.POINTER(struct_c__SA_sim_data), ctypes.POINTER(struct_c__SA_sim_offload_data)]
+simulate_simd_width = _libraries['libascot.so'].simulate_simd_width
+simulate_simd_width.restype = ctypes.c_int32
+simulate_simd_width.argtypes = [ctypes.c_int32]
 class struct_c__SA_offload_package(Structure):
     pass
 
@@ -2937,6 +3288,45 @@ struct_c__SA_offload_package._fields_ = [
 simulate = _libraries['libascot.so'].simulate
 simulate.restype = None
 simulate.argtypes = [ctypes.c_int32, ctypes.c_int32, ctypes.POINTER(struct_c__SA_particle_state), ctypes.POINTER(struct_c__SA_sim_offload_data), ctypes.POINTER(struct_c__SA_offload_package), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_double)]
+simulate_sort_queue = _libraries['libascot.so'].simulate_sort_queue
+simulate_sort_queue.restype = None
+simulate_sort_queue.argtypes = [ctypes.POINTER(struct_c__SA_particle_queue), ctypes.c_int32]
+simulate_cycle_gc_hybrid = _libraries['libascot.so'].simulate_cycle_gc_hybrid
+simulate_cycle_gc_hybrid.restype = ctypes.c_int32
+simulate_cycle_gc_hybrid.argtypes = [ctypes.POINTER(struct_c__SA_particle_queue), ctypes.POINTER(struct_c__SA_particle_queue), ctypes.POINTER(struct_c__SA_particle_simd_gc), ctypes.POINTER(struct_c__SA_sim_data), ctypes.POINTER(ctypes.c_int32)]
+mpi_interface_barrier = _libraries['libascot.so'].mpi_interface_barrier
+mpi_interface_barrier.restype = None
+mpi_interface_barrier.argtypes = []
+mpi_interface_init = _libraries['libascot.so'].mpi_interface_init
+mpi_interface_init.restype = None
+mpi_interface_init.argtypes = [ctypes.c_int32, ctypes.POINTER(ctypes.POINTER(ctypes.c_char)), ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_int32)]
+mpi_interface_finalize = _libraries['libascot.so'].mpi_interface_finalize
+mpi_interface_finalize.restype = None
+mpi_interface_finalize.argtypes = []
+mpi_my_particles = _libraries['libascot.so'].mpi_my_particles
+mpi_my_particles.restype = None
+mpi_my_particles.argtypes = [ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_int32), ctypes.c_int32, ctypes.c_int32, ctypes.c_int32]
+mpi_gather_particlestate = _libraries['libascot.so'].mpi_gather_particlestate
+mpi_gather_particlestate.restype = None
+mpi_gather_particlestate.argtypes = [ctypes.POINTER(struct_c__SA_particle_state), ctypes.POINTER(ctypes.POINTER(struct_c__SA_particle_state)), ctypes.POINTER(ctypes.c_int32), ctypes.c_int32, ctypes.c_int32, ctypes.c_int32, ctypes.c_int32]
+mpi_gather_diag = _libraries['libascot.so'].mpi_gather_diag
+mpi_gather_diag.restype = None
+mpi_gather_diag.argtypes = [ctypes.POINTER(struct_c__SA_diag_offload_data), ctypes.POINTER(ctypes.c_double), ctypes.c_int32, ctypes.c_int32, ctypes.c_int32, ctypes.c_int32]
+mpi_interface_bcast_status = _libraries['libascot.so'].mpi_interface_bcast_status
+mpi_interface_bcast_status.restype = ctypes.c_int32
+mpi_interface_bcast_status.argtypes = [ctypes.POINTER(struct_c__SA_sim_offload_data), ctypes.c_int32]
+mpi_interface_bcast_input = _libraries['libascot.so'].mpi_interface_bcast_input
+mpi_interface_bcast_input.restype = None
+mpi_interface_bcast_input.argtypes = [ctypes.POINTER(struct_c__SA_sim_offload_data), ctypes.POINTER(struct_c__SA_offload_package), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32)), ctypes.POINTER(ctypes.POINTER(struct_c__SA_input_particle)), ctypes.POINTER(ctypes.c_int32)]
+mpi_interface_shmem_init = _libraries['libascot.so'].mpi_interface_shmem_init
+mpi_interface_shmem_init.restype = None
+mpi_interface_shmem_init.argtypes = [ctypes.POINTER(ctypes.c_int32)]
+mpi_interface_shmem_share = _libraries['libascot.so'].mpi_interface_shmem_share
+mpi_interface_shmem_share.restype = None
+mpi_interface_shmem_share.argtypes = [ctypes.POINTER(struct_c__SA_sim_offload_data), ctypes.POINTER(struct_c__SA_offload_package), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
+mpi_interface_shmem_free = _libraries['libascot.so'].mpi_interface_shmem_free
+mpi_interface_shmem_free.restype = None
+mpi_interface_shmem_free.argtypes = [ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32))]
 
 # values for enumeration 'ENDCOND_FLAG'
 ENDCOND_FLAG__enumvalues = {
@@ -2952,6 +3342,7 @@ ENDCOND_FLAG__enumvalues = {
     512: 'endcond_hybrid',
     1024: 'endcond_neutr',
     2048: 'endcond_ioniz',
+    4096: 'endcond_roul',
 }
 endcond_tlim = 1
 endcond_emin = 2
@@ -2965,6 +3356,7 @@ endcond_cpumax = 256
 endcond_hybrid = 512
 endcond_neutr = 1024
 endcond_ioniz = 2048
+endcond_roul = 4096
 ENDCOND_FLAG = ctypes.c_uint32 # enum
 endcond_check_gc = _libraries['libascot.so'].endcond_check_gc
 endcond_check_gc.restype = None
@@ -3011,6 +3403,9 @@ input_group = ctypes.c_uint32 # enum
 hdf5_interface_read_input = _libraries['libascot.so'].hdf5_interface_read_input
 hdf5_interface_read_input.restype = ctypes.c_int32
 hdf5_interface_read_input.argtypes = [ctypes.POINTER(struct_c__SA_sim_offload_data), ctypes.c_int32, ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_int32)), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(ctypes.c_double)), ctypes.POINTER(ctypes.POINTER(struct_c__SA_input_particle)), ctypes.POINTER(ctypes.c_int32)]
+hdf5_interface_write_spline_cache = _libraries['libascot.so'].hdf5_interface_write_spline_cache
+hdf5_interface_write_spline_cache.restype = None
+hdf5_interface_write_spline_cache.argtypes = [ctypes.POINTER(struct_c__SA_sim_offload_data), ctypes.POINTER(ctypes.c_double)]
 hdf5_interface_init_results = _libraries['libascot.so'].hdf5_interface_init_results
 hdf5_interface_init_results.restype = ctypes.c_int32
 hdf5_interface_init_results.argtypes = [ctypes.POINTER(struct_c__SA_sim_offload_data), ctypes.POINTER(ctypes.c_char), ctypes.POINTER(ctypes.c_char)]
@@ -3121,6 +3516,9 @@ print_marker_summary.argtypes = [ctypes.POINTER(struct_c__SA_particle_state), ct
 biosaw_calc_B = _libraries['libascot.so'].biosaw_calc_B
 biosaw_calc_B.restype = None
 biosaw_calc_B.argtypes = [ctypes.c_int32, ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.c_int32, ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double)]
+biosaw_calc_B_dB = _libraries['libascot.so'].biosaw_calc_B_dB
+biosaw_calc_B_dB.restype = None
+biosaw_calc_B_dB.argtypes = [ctypes.c_int32, ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.c_int32, ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), real, ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double)]
 bbnbi_simulate = _libraries['libascot.so'].bbnbi_simulate
 bbnbi_simulate.restype = None
 bbnbi_simulate.argtypes = [ctypes.POINTER(struct_c__SA_sim_offload_data), ctypes.c_int32, real, real, ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.POINTER(struct_c__SA_particle_state)), ctypes.POINTER(ctypes.c_double)]
@@ -3128,7 +3526,11 @@ __all__ = \
     ['B_2DS_data', 'B_2DS_eval_B', 'B_2DS_eval_B_dB',
     'B_2DS_eval_psi', 'B_2DS_eval_psi_dpsi', 'B_2DS_eval_rho_drho',
     'B_2DS_free_offload', 'B_2DS_get_axis_rz', 'B_2DS_init',
-    'B_2DS_init_offload', 'B_2DS_offload_data', 'B_3DS_data',
+    'B_2DS_init_offload', 'B_2DS_offload_data', 'B_3DST_data',
+    'B_3DST_eval_B', 'B_3DST_eval_B_dB', 'B_3DST_eval_psi',
+    'B_3DST_eval_psi_dpsi', 'B_3DST_eval_rho_drho',
+    'B_3DST_free_offload', 'B_3DST_get_axis_rz', 'B_3DST_init',
+    'B_3DST_init_offload', 'B_3DST_offload_data', 'B_3DS_data',
     'B_3DS_eval_B', 'B_3DS_eval_B_dB', 'B_3DS_eval_psi',
     'B_3DS_eval_psi_dpsi', 'B_3DS_eval_rho_drho',
     'B_3DS_free_offload', 'B_3DS_get_axis_rz', 'B_3DS_init',
@@ -3144,36 +3546,40 @@ __all__ = \
     'B_TC_eval_psi_dpsi', 'B_TC_eval_rho_drho', 'B_TC_free_offload',
     'B_TC_get_axis_rz', 'B_TC_init', 'B_TC_init_offload',
     'B_TC_offload_data', 'B_field_data', 'B_field_eval_B',
-    'B_field_eval_B_dB', 'B_field_eval_psi', 'B_field_eval_psi_dpsi',
+    'B_field_eval_B_dB', 'B_field_eval_B_dB_simd', 'B_field_eval_psi',
+    'B_field_eval_psi_dpsi', 'B_field_eval_psi_from_rho',
     'B_field_eval_rho', 'B_field_eval_rho_drho',
-    'B_field_free_offload', 'B_field_get_axis_rz', 'B_field_init',
-    'B_field_init_offload', 'B_field_offload_data', 'B_field_type',
-    'B_field_type_2DS', 'B_field_type_3DS', 'B_field_type_GS',
+    'B_field_free_offload', 'B_field_get_axis_rz',
+    'B_field_get_psilim', 'B_field_init', 'B_field_init_offload',
+    'B_field_offload_data', 'B_field_type', 'B_field_type_2DS',
+    'B_field_type_3DS', 'B_field_type_3DST', 'B_field_type_GS',
     'B_field_type_STS', 'B_field_type_TC', 'DD_He3n', 'DD_Tp',
-    'DHe3_He4p', 'DT_He4n', 'ENDCOND_FLAG', 'E_1DS_data',
-    'E_1DS_eval_E', 'E_1DS_free_offload', 'E_1DS_init',
+    'DHe3_He4p', 'DIST_COORDS_FLAG', 'DT_He4n', 'ENDCOND_FLAG',
+    'E_1DS_data', 'E_1DS_eval_E', 'E_1DS_free_offload', 'E_1DS_init',
     'E_1DS_init_offload', 'E_1DS_offload_data', 'E_TC_data',
     'E_TC_eval_E', 'E_TC_free_offload', 'E_TC_init',
     'E_TC_init_offload', 'E_TC_offload_data', 'E_field_data',
     'E_field_eval_E', 'E_field_free_offload', 'E_field_init',
     'E_field_init_offload', 'E_field_offload_data', 'E_field_type',
-    'E_field_type_1DS', 'E_field_type_TC', 'N0_1D_data',
-    'N0_1D_eval_n0', 'N0_1D_eval_t0', 'N0_1D_free_offload',
-    'N0_1D_get_n_species', 'N0_1D_init', 'N0_1D_init_offload',
-    'N0_1D_offload_data', 'N0_3D_data', 'N0_3D_eval_n0',
-    'N0_3D_eval_t0', 'N0_3D_free_offload', 'N0_3D_get_n_species',
-    'N0_3D_init', 'N0_3D_init_offload', 'N0_3D_offload_data',
-    'Reaction', 'SIMULATION_MODE', 'a5err', 'afsi_data', 'afsi_run',
-    'afsi_test_dist', 'afsi_test_thermal', 'afsi_thermal_data',
-    'asigma_data', 'asigma_eval_bms', 'asigma_eval_cx',
-    'asigma_eval_sigma', 'asigma_eval_sigmav', 'asigma_extrapolate',
-    'asigma_free_offload', 'asigma_init', 'asigma_init_offload',
-    'asigma_loc_data', 'asigma_loc_eval_bms', 'asigma_loc_eval_cx',
-    'asigma_loc_eval_sigma', 'asigma_loc_eval_sigmav',
-    'asigma_loc_free_offload', 'asigma_loc_init',
-    'asigma_loc_init_offload', 'asigma_loc_offload_data',
-    'asigma_offload_data', 'asigma_reac_type', 'asigma_type',
-    'asigma_type_loc', 'bbnbi_simulate', 'biosaw_calc_B',
+    'E_field_type_1DS', 'E_field_type_TC', 'MARKER_SORTING',
+    'N0_1D_data', 'N0_1D_eval_n0', 'N0_1D_eval_n0t0', 'N0_1D_eval_t0',
+    'N0_1D_free_offload', 'N0_1D_get_n_species', 'N0_1D_init',
+    'N0_1D_init_offload', 'N0_1D_offload_data', 'N0_3D_data',
+    'N0_3D_eval_n0', 'N0_3D_eval_n0t0', 'N0_3D_eval_t0',
+    'N0_3D_free_offload', 'N0_3D_get_n_species', 'N0_3D_init',
+    'N0_3D_init_offload', 'N0_3D_offload_data', 'Reaction',
+    'SIMULATION_MODE', 'STEP_LIMITER', 'a5err', 'afsi_data',
+    'afsi_run', 'afsi_test_dist', 'afsi_test_thermal',
+    'afsi_thermal_data', 'asigma_data', 'asigma_eval_bms',
+    'asigma_eval_cx', 'asigma_eval_sigma', 'asigma_eval_sigmav',
+    'asigma_extrapolate', 'asigma_free_offload', 'asigma_init',
+    'asigma_init_offload', 'asigma_loc_data', 'asigma_loc_eval_bms',
+    'asigma_loc_eval_cx', 'asigma_loc_eval_sigma',
+    'asigma_loc_eval_sigmav', 'asigma_loc_free_offload',
+    'asigma_loc_init', 'asigma_loc_init_offload',
+    'asigma_loc_offload_data', 'asigma_offload_data',
+    'asigma_reac_type', 'asigma_type', 'asigma_type_loc',
+    'bbnbi_simulate', 'biosaw_calc_B', 'biosaw_calc_B_dB',
     'boozer_data', 'boozer_eval_psithetazeta', 'boozer_free_offload',
     'boozer_init', 'boozer_init_offload', 'boozer_offload_data',
     'boschhale_reaction', 'boschhale_sigma', 'boschhale_sigmav',
@@ -3188,27 +3594,32 @@ __all__ = \
     'diag_transcoef_offload_data', 'diag_transcoef_update_fo',
     'diag_transcoef_update_gc', 'diag_transcoef_update_ml',
     'diag_update_fo', 'diag_update_gc', 'diag_update_ml',
-    'dist_5D_data', 'dist_5D_index', 'dist_5D_init',
-    'dist_5D_offload_data', 'dist_5D_update_fo', 'dist_5D_update_gc',
-    'dist_6D_data', 'dist_6D_init', 'dist_6D_offload_data',
-    'dist_6D_update_fo', 'dist_6D_update_gc', 'dist_COM_data',
-    'dist_COM_init', 'dist_COM_offload_data', 'dist_COM_update_fo',
-    'dist_COM_update_gc', 'dist_rho5D_data', 'dist_rho5D_init',
-    'dist_rho5D_offload_data', 'dist_rho5D_update_fo',
-    'dist_rho5D_update_gc', 'dist_rho6D_data', 'dist_rho6D_init',
-    'dist_rho6D_offload_data', 'dist_rho6D_update_fo',
-    'dist_rho6D_update_gc', 'endcond_check_fo', 'endcond_check_gc',
-    'endcond_check_ml', 'endcond_cpumax', 'endcond_emin',
-    'endcond_hybrid', 'endcond_ioniz', 'endcond_neutr',
-    'endcond_parse', 'endcond_parse2str', 'endcond_polmax',
-    'endcond_rhomax', 'endcond_rhomin', 'endcond_therm',
-    'endcond_tlim', 'endcond_tormax', 'endcond_wall',
-    'hdf5_generate_qid', 'hdf5_input_asigma', 'hdf5_input_bfield',
-    'hdf5_input_boozer', 'hdf5_input_efield', 'hdf5_input_marker',
-    'hdf5_input_mhd', 'hdf5_input_nbi', 'hdf5_input_neutral',
-    'hdf5_input_options', 'hdf5_input_plasma', 'hdf5_input_wall',
+    'diag_wall_data', 'diag_wall_init', 'diag_wall_offload_data',
+    'diag_wall_update_fo', 'diag_wall_update_gc', 'dist_5D_data',
+    'dist_5D_index', 'dist_5D_init', 'dist_5D_offload_data',
+    'dist_5D_update_fo', 'dist_5D_update_gc', 'dist_6D_data',
+    'dist_6D_init', 'dist_6D_offload_data', 'dist_6D_update_fo',
+    'dist_6D_update_gc', 'dist_COM_data', 'dist_COM_init',
+    'dist_COM_offload_data', 'dist_COM_update_fo',
+    'dist_COM_update_gc', 'dist_coords_com', 'dist_coords_eval_gc',
+    'dist_coords_gc', 'dist_coords_momentum', 'dist_rho5D_data',
+    'dist_rho5D_init', 'dist_rho5D_offload_data',
+    'dist_rho5D_update_fo', 'dist_rho5D_update_gc', 'dist_rho6D_data',
+    'dist_rho6D_init', 'dist_rho6D_offload_data',
+    'dist_rho6D_update_fo', 'dist_rho6D_update_gc',
+    'endcond_check_fo', 'endcond_check_gc', 'endcond_check_ml',
+    'endcond_cpumax', 'endcond_emin', 'endcond_hybrid',
+    'endcond_ioniz', 'endcond_neutr', 'endcond_parse',
+    'endcond_parse2str', 'endcond_polmax', 'endcond_rhomax',
+    'endcond_rhomin', 'endcond_roul', 'endcond_therm', 'endcond_tlim',
+    'endcond_tormax', 'endcond_wall', 'hdf5_generate_qid',
+    'hdf5_input_asigma', 'hdf5_input_bfield', 'hdf5_input_boozer',
+    'hdf5_input_efield', 'hdf5_input_marker', 'hdf5_input_mhd',
+    'hdf5_input_nbi', 'hdf5_input_neutral', 'hdf5_input_options',
+    'hdf5_input_plasma', 'hdf5_input_wall',
     'hdf5_interface_init_results', 'hdf5_interface_read_input',
-    'hdf5_interface_write_diagnostics', 'hdf5_interface_write_state',
+    'hdf5_interface_write_diagnostics',
+    'hdf5_interface_write_spline_cache', 'hdf5_interface_write_state',
     'input_group', 'input_particle', 'input_particle_type',
     'input_particle_type_gc', 'input_particle_type_ml',
     'input_particle_type_p', 'input_particle_type_s', 'integer',
@@ -3225,31 +3636,36 @@ __all__ = \
     'mhd_stat_free_offload', 'mhd_stat_init', 'mhd_stat_init_offload',
     'mhd_stat_offload_data', 'mhd_stat_perturbations', 'mhd_type',
     'mhd_type_nonstat', 'mhd_type_stat', 'mpi_gather_diag',
-    'mpi_gather_particlestate', 'mpi_interface_finalize',
-    'mpi_interface_init', 'mpi_my_particles', 'nbi_data',
+    'mpi_gather_particlestate', 'mpi_interface_barrier',
+    'mpi_interface_bcast_input', 'mpi_interface_bcast_status',
+    'mpi_interface_finalize', 'mpi_interface_init',
+    'mpi_interface_shmem_free', 'mpi_interface_shmem_init',
+    'mpi_interface_shmem_share', 'mpi_my_particles', 'nbi_data',
     'nbi_free_offload', 'nbi_init', 'nbi_init_offload', 'nbi_inject',
     'nbi_injector', 'nbi_offload_data', 'neutral_data',
-    'neutral_eval_n0', 'neutral_eval_t0', 'neutral_free_offload',
-    'neutral_get_n_species', 'neutral_init', 'neutral_init_offload',
-    'neutral_offload_data', 'neutral_type', 'neutral_type_1D',
-    'neutral_type_3D', 'offload_and_simulate', 'pack_offload_array',
-    'particle', 'particle_copy_fo', 'particle_copy_gc',
-    'particle_copy_ml', 'particle_cycle_fo', 'particle_cycle_gc',
-    'particle_cycle_ml', 'particle_fo_to_gc', 'particle_fo_to_state',
-    'particle_gc', 'particle_gc_to_state',
+    'neutral_eval_n0', 'neutral_eval_n0t0', 'neutral_eval_t0',
+    'neutral_free_offload', 'neutral_get_n_species', 'neutral_init',
+    'neutral_init_offload', 'neutral_offload_data', 'neutral_type',
+    'neutral_type_1D', 'neutral_type_3D', 'offload_and_simulate',
+    'pack_offload_array', 'particle', 'particle_allocate_fo',
+    'particle_compact_gc', 'particle_compact_ml', 'particle_copy_fo',
+    'particle_copy_gc', 'particle_copy_ml', 'particle_cycle_fo',
+    'particle_cycle_gc', 'particle_cycle_ml', 'particle_fo_to_gc',
+    'particle_fo_to_state', 'particle_gc', 'particle_gc_to_state',
     'particle_input_gc_to_state', 'particle_input_ml_to_state',
     'particle_input_p_to_state', 'particle_input_to_state',
-    'particle_ml', 'particle_ml_to_state', 'particle_queue',
-    'particle_simd_fo', 'particle_simd_gc', 'particle_simd_ml',
-    'particle_state', 'particle_state_to_fo', 'particle_state_to_gc',
-    'particle_state_to_ml', 'particle_to_fo_dummy',
-    'particle_to_gc_dummy', 'particle_to_ml_dummy', 'plasma_1DS_data',
-    'plasma_1DS_eval_dens', 'plasma_1DS_eval_densandtemp',
-    'plasma_1DS_eval_temp', 'plasma_1DS_free_offload',
-    'plasma_1DS_init', 'plasma_1DS_init_offload',
-    'plasma_1DS_offload_data', 'plasma_1D_data',
-    'plasma_1D_eval_dens', 'plasma_1D_eval_densandtemp',
-    'plasma_1D_eval_temp', 'plasma_1D_free_offload', 'plasma_1D_init',
+    'particle_ml', 'particle_ml_to_state', 'particle_offload_fo',
+    'particle_queue', 'particle_simd_fo', 'particle_simd_gc',
+    'particle_simd_ml', 'particle_state', 'particle_state_to_fo',
+    'particle_state_to_gc', 'particle_state_to_ml',
+    'particle_to_fo_dummy', 'particle_to_gc_dummy',
+    'particle_to_ml_dummy', 'plasma_1DS_data', 'plasma_1DS_eval_dens',
+    'plasma_1DS_eval_densandtemp', 'plasma_1DS_eval_temp',
+    'plasma_1DS_free_offload', 'plasma_1DS_init',
+    'plasma_1DS_init_offload', 'plasma_1DS_offload_data',
+    'plasma_1D_data', 'plasma_1D_eval_dens',
+    'plasma_1D_eval_densandtemp', 'plasma_1D_eval_temp',
+    'plasma_1D_free_offload', 'plasma_1D_init',
     'plasma_1D_init_offload', 'plasma_1D_offload_data',
     'plasma_1Dt_data', 'plasma_1Dt_eval_dens',
     'plasma_1Dt_eval_densandtemp', 'plasma_1Dt_eval_temp',
@@ -3265,22 +3681,27 @@ __all__ = \
     'real', 'sigma_CX', 'sigma_ioniz', 'sigma_recomb', 'sigmav_BMS',
     'sigmav_CX', 'sigmav_ioniz', 'sigmav_recomb', 'sigmaveff_CX',
     'sigmaveff_ioniz', 'sigmaveff_recomb', 'sim_data', 'sim_init',
-    'sim_offload_data', 'simulate', 'simulate_init_offload',
-    'simulate_mode_fo', 'simulate_mode_gc', 'simulate_mode_hybrid',
-    'simulate_mode_ml', 'size_t', 'struct_c__SA_B_2DS_data',
-    'struct_c__SA_B_2DS_offload_data', 'struct_c__SA_B_3DS_data',
-    'struct_c__SA_B_3DS_offload_data', 'struct_c__SA_B_GS_data',
-    'struct_c__SA_B_GS_offload_data', 'struct_c__SA_B_STS_data',
-    'struct_c__SA_B_STS_offload_data', 'struct_c__SA_B_TC_data',
-    'struct_c__SA_B_TC_offload_data', 'struct_c__SA_B_field_data',
-    'struct_c__SA_B_field_offload_data', 'struct_c__SA_E_1DS_data',
-    'struct_c__SA_E_1DS_offload_data', 'struct_c__SA_E_TC_data',
-    'struct_c__SA_E_TC_offload_data', 'struct_c__SA_E_field_data',
-    'struct_c__SA_E_field_offload_data', 'struct_c__SA_N0_1D_data',
-    'struct_c__SA_N0_1D_offload_data', 'struct_c__SA_N0_3D_data',
-    'struct_c__SA_N0_3D_offload_data', 'struct_c__SA_afsi_data',
-    'struct_c__SA_afsi_thermal_data', 'struct_c__SA_asigma_data',
-    'struct_c__SA_asigma_loc_data',
+    'sim_offload_data', 'simulate', 'simulate_cycle_gc_hybrid',
+    'simulate_init_offload', 'simulate_mode_fo', 'simulate_mode_gc',
+    'simulate_mode_hybrid', 'simulate_mode_ml', 'simulate_simd_width',
+    'simulate_sort_none', 'simulate_sort_queue',
+    'simulate_sort_rhothetaphi', 'simulate_sort_rphiz', 'size_t',
+    'step_limiter_collisions', 'step_limiter_dphi',
+    'step_limiter_drho', 'step_limiter_initial', 'step_limiter_orbit',
+    'struct_c__SA_B_2DS_data', 'struct_c__SA_B_2DS_offload_data',
+    'struct_c__SA_B_3DST_data', 'struct_c__SA_B_3DST_offload_data',
+    'struct_c__SA_B_3DS_data', 'struct_c__SA_B_3DS_offload_data',
+    'struct_c__SA_B_GS_data', 'struct_c__SA_B_GS_offload_data',
+    'struct_c__SA_B_STS_data', 'struct_c__SA_B_STS_offload_data',
+    'struct_c__SA_B_TC_data', 'struct_c__SA_B_TC_offload_data',
+    'struct_c__SA_B_field_data', 'struct_c__SA_B_field_offload_data',
+    'struct_c__SA_E_1DS_data', 'struct_c__SA_E_1DS_offload_data',
+    'struct_c__SA_E_TC_data', 'struct_c__SA_E_TC_offload_data',
+    'struct_c__SA_E_field_data', 'struct_c__SA_E_field_offload_data',
+    'struct_c__SA_N0_1D_data', 'struct_c__SA_N0_1D_offload_data',
+    'struct_c__SA_N0_3D_data', 'struct_c__SA_N0_3D_offload_data',
+    'struct_c__SA_afsi_data', 'struct_c__SA_afsi_thermal_data',
+    'struct_c__SA_asigma_data', 'struct_c__SA_asigma_loc_data',
     'struct_c__SA_asigma_loc_offload_data',
     'struct_c__SA_asigma_offload_data', 'struct_c__SA_boozer_data',
     'struct_c__SA_boozer_offload_data', 'struct_c__SA_diag_data',
@@ -3288,19 +3709,21 @@ __all__ = \
     'struct_c__SA_diag_orb_offload_data',
     'struct_c__SA_diag_transcoef_data',
     'struct_c__SA_diag_transcoef_offload_data',
+    'struct_c__SA_diag_wall_data',
+    'struct_c__SA_diag_wall_offload_data',
     'struct_c__SA_dist_5D_data', 'struct_c__SA_dist_5D_offload_data',
     'struct_c__SA_dist_6D_data', 'struct_c__SA_dist_6D_offload_data',
     'struct_c__SA_dist_COM_data',
     'struct_c__SA_dist_COM_offload_data',
-    'struct_c__SA_dist_rho5D_data',
+    'struct_c__SA_dist_coords_gc', 'struct_c__SA_dist_rho5D_data',
     'struct_c__SA_dist_rho5D_offload_data',
     'struct_c__SA_dist_rho6D_data',
     'struct_c__SA_dist_rho6D_offload_data',
     'struct_c__SA_input_particle', 'struct_c__SA_interp1D_data',
     'struct_c__SA_interp2D_data', 'struct_c__SA_interp3D_data',
     'struct_c__SA_linint1D_data', 'struct_c__SA_linint3D_data',
-    'struct_c__SA_mccc_data', 'struct_c__SA_mhd_data',
-    'struct_c__SA_mhd_nonstat_data',
+    'struct_c__SA_linint_search_data', 'struct_c__SA_mccc_data',
+    'struct_c__SA_mhd_data', 'struct_c__SA_mhd_nonstat_data',
     'struct_c__SA_mhd_nonstat_offload_data',
     'struct_c__SA_mhd_offload_data', 'struct_c__SA_mhd_stat_data',
     'struct_c__SA_mhd_stat_offload_data', 'struct_c__SA_nbi_data',
@@ -3318,19 +3741,21 @@ __all__ = \
     'struct_c__SA_plasma_1Dt_offload_data',
     'struct_c__SA_plasma_data', 'struct_c__SA_plasma_offload_data',
     'struct_c__SA_sim_data', 'struct_c__SA_sim_offload_data',
+    'struct_c__SA_simulate_converge_data',
     'struct_c__SA_wall_2d_data', 'struct_c__SA_wall_2d_offload_data',
     'struct_c__SA_wall_3d_data', 'struct_c__SA_wall_3d_offload_data',
     'struct_c__SA_wall_data', 'struct_c__SA_wall_offload_data',
     'struct_diag_transcoef_link', 'union_c__SA_input_particle_0',
     'wall_2d_data', 'wall_2d_find_intersection',
-    'wall_2d_free_offload', 'wall_2d_hit_wall', 'wall_2d_init',
-    'wall_2d_init_offload', 'wall_2d_inside', 'wall_2d_offload_data',
-    'wall_3d_data', 'wall_3d_free_offload', 'wall_3d_hit_wall',
-    'wall_3d_hit_wall_full', 'wall_3d_init', 'wall_3d_init_octree',
-    'wall_3d_init_offload', 'wall_3d_init_tree',
-    'wall_3d_offload_data', 'wall_3d_quad_collision',
-    'wall_3d_tri_collision', 'wall_3d_tri_in_cube', 'wall_data',
-    'wall_free_offload', 'wall_get_n_elements', 'wall_hit_wall',
+    'wall_2d_free_offload', 'wall_2d_get_normal', 'wall_2d_hit_wall',
+    'wall_2d_init', 'wall_2d_init_offload', 'wall_2d_inside',
+    'wall_2d_offload_data', 'wall_3d_data', 'wall_3d_free_offload',
+    'wall_3d_get_normal', 'wall_3d_hit_wall', 'wall_3d_hit_wall_full',
+    'wall_3d_init', 'wall_3d_init_octree', 'wall_3d_init_offload',
+    'wall_3d_init_tree', 'wall_3d_offload_data',
+    'wall_3d_quad_collision', 'wall_3d_tri_collision',
+    'wall_3d_tri_in_cube', 'wall_data', 'wall_free_offload',
+    'wall_get_n_elements', 'wall_get_normal', 'wall_hit_wall',
     'wall_init', 'wall_init_offload', 'wall_offload_data',
     'wall_type', 'wall_type_2D', 'wall_type_3D', 'write_output',
     'write_rungroup']
@@ -63,6 +63,10 @@ except ImportError as error:
         "Some functionalities of Ascot are not available"
     warnings.warn(msg, stacklevel=4)
 
+# Number of compact spline coefficients per grid point (see spline/interp.h)
+NSIZE_COMP2D = 4
+NSIZE_COMP3D = 8
+
 class LibAscot:
     """Python wrapper of libascot.so.
     """
@@ -641,6 +645,106 @@ class LibAscot:
         if len(out) == 1: out = out[0]
         return out
 
+    @parseunits(ma="kg", r="m", phi="rad", z="m", t="s", ppar="kg*m/s",
+                pperp="kg*m/s", charge="C", strip=True)
+    def input_eval_moments(self, ma, r, phi, z, t, ppar, pperp, charge,
+                           histogram, *moments):
+        """Evaluate moments of a 5D distribution in a single pass.
+
+        Magnetic field, plasma parameters, and collision coefficients are
+        evaluated once per spatial cell, after which all requested moments
+        are accumulated from the cell's momentum, charge, and time bins.
+
+        The moments are integrated over each cell but not divided by the cell
+        volume.
+
+        Parameters
+        ----------
+        ma : float
+            Test particle mass.
+        r : array_like, (n,)
+            R coordinates of the cell centers.
+        phi : array_like, (n,)
+            phi coordinates of the cell centers.
+        z : array_like, (n,)
+            z coordinates of the cell centers.
+        t : float
+            Time at which the input data is evaluated.
+        ppar : array_like, (nppar,)
+            Parallel momentum bin centers.
+        pperp : array_like, (npperp,)
+            Perpendicular momentum bin centers.
+        charge : array_like, (nq,)
+            Charge bin centers.
+        histogram : array_like, (n, nppar, npperp, nq, ntime)
+            Number of particles in each bin.
+        *moments : str
+            Names of the moments to be evaluated.
+
+            "density"          - Number of particles.
+            "chargedensity"    - Charge.
+            "energydensity"    - Kinetic energy.
+            "pressure"         - Pressure times volume.
+            "toroidalcurrent"  - Toroidal current times volume.
+            "parallelcurrent"  - Parallel current times volume.
+            "powerdep"         - Power deposited to plasma.
+            "electronpowerdep" - Power deposited to electrons.
+            "ionpowerdep"      - Power deposited to ions.
+
+        Returns
+        -------
+        *out : array_like, (n,)
+            Evaluated moments in same order as declared in ``*moments``.
+
+        Raises
+        ------
+        AssertionError
+            If required data has not been initialized.
+        """
+        self._requireinit("bfield", "plasma")
+        Ncell = r.size
+        histogram = np.ascontiguousarray(histogram, dtype="f8").reshape(
+            (Ncell, ppar.size, pperp.size, charge.size, -1))
+        Ntime = histogram.shape[-1]
+
+        units = {"density":unyt.particles, "chargedensity":unyt.C,
+                 "energydensity":unyt.J, "pressure":unyt.J,
+                 "toroidalcurrent":unyt.A*unyt.m,
+                 "parallelcurrent":unyt.A*unyt.m, "powerdep":unyt.W,
+                 "electronpowerdep":unyt.W, "ionpowerdep":unyt.W}
+        out = {}
+        for m in units:
+            out[m] = np.zeros((Ncell,), dtype="f8") if m in moments else None
+        for m in moments:
+            if m not in units:
+                raise ValueError("Unknown moment: %s" % m)
+
+        fun = _LIBASCOT.libascot_eval_moments
+        fun.restype  = None
+        fun.argtypes = [PTR_SIM, PTR_ARR, PTR_ARR,
+                        ctypes.c_int, PTR_REAL, PTR_REAL, PTR_REAL,
+                        ctypes.c_double, ctypes.c_int, PTR_REAL,
+                        ctypes.c_int, PTR_REAL, ctypes.c_int, PTR_REAL,
+                        ctypes.c_int, ctypes.c_double, PTR_REAL,
+                        PTR_REAL, PTR_REAL, PTR_REAL, PTR_REAL, PTR_REAL,
+                        PTR_REAL, PTR_REAL, PTR_REAL, PTR_REAL]
+        fun(ctypes.byref(self._sim), self._bfield_offload_array,
+            self._plasma_offload_array, Ncell,
+            np.ascontiguousarray(r, dtype="f8").ravel(),
+            np.ascontiguousarray(phi, dtype="f8").ravel(),
+            np.ascontiguousarray(z, dtype="f8").ravel(), float(t),
+            ppar.size, np.ascontiguousarray(ppar, dtype="f8"),
+            pperp.size, np.ascontiguousarray(pperp, dtype="f8"),
+            charge.size, np.ascontiguousarray(charge, dtype="f8"),
+            Ntime, float(ma), histogram,
+            out["density"], out["chargedensity"], out["energydensity"],
+            out["pressure"], out["toroidalcurrent"], out["parallelcurrent"],
+            out["powerdep"], out["electronpowerdep"], out["ionpowerdep"])
+
+        out = [out[m] * units[m] for m in moments]
+        if len(out) == 1: out = out[0]
+        return out
+
     def input_eval_atomicsigma(self, ma, anum, znum, r, phi, z, t, va, ion,
                                reaction):
         """Deprecated.
@@ -766,7 +870,8 @@ class LibAscot:
             out["znum"]
 
     @parseunits(rho="1", theta="rad", phi="rad", time="s")
-    def input_rhotheta2rz(self, rho, theta, phi, time, maxiter=100, tol=1e-5):
+    def input_rhotheta2rz(self, rho, theta, phi, time, maxiter=100, tol=1e-5,
+                          usemap=None):
         """Convert (rho, theta, phi) coordinates to (R,z) positions.
 
         Parameters
@@ -779,6 +884,16 @@ class LibAscot:
             Toroidal angle coordinates to be converted.
         time : float
             Time slice (same for all).
+        maxiter : int, optional
+            Maximum number of Newton iterations.
+        tol : float, optional
+            Required accuracy in rho.
+        usemap : bool, optional
+            Use a tabulated map as an initial guess for the Newton iteration.
+
+            The map is constructed once for the current magnetic field and
+            reused in subsequent calls. By default the map is used when
+            the number of query points is large.
 
         Returns
         -------
@@ -805,17 +920,229 @@ class LibAscot:
         if phi.size == 1:
             phi = phi * np.ones(rho.shape).astype(dtype="f8")
 
+        if usemap is None:
+            usemap = Neval > 10000
+        fluxmap = self._input_fluxmap() if usemap else None
+        if fluxmap is None:
+            fluxmap = (0, 0, 0, 0.0, None)
+
         fun = _LIBASCOT.libascot_B_field_rhotheta2rz
         fun.restype  = None
         fun.argtypes = [PTR_SIM, PTR_ARR,
                         ctypes.c_int, PTR_REAL, PTR_REAL, PTR_REAL,
                         ctypes.c_double, ctypes.c_int, ctypes.c_double,
-                        PTR_REAL, PTR_REAL]
+                        PTR_REAL, PTR_REAL, ctypes.c_int, ctypes.c_int,
+                        ctypes.c_int, ctypes.c_double, PTR_REAL]
         fun(ctypes.byref(self._sim), self._bfield_offload_array,
-            Neval, rho, theta, phi, time, maxiter, tol, r, z)
+            Neval, rho, theta, phi, time, maxiter, tol, r, z, *fluxmap)
 
         return (r, z)
 
+    @parseunits(r="m", phi="rad", z="m", t="s", lmax="m")
+    def input_eval_connectionlength(self, r, phi, z, t, lmax=1000*unyt.m,
+                                    tol=1e-8):
+        """Trace field lines to the wall and return their connection lengths.
+
+        Field lines are traced from each point both along and against
+        the magnetic field until they hit the wall, reach the maximum length,
+        or leave the magnetic field. Only the results listed below are
+        computed, so this is much faster than a field line simulation when
+        mapping e.g. a fine (R, z) grid.
+
+        Parameters
+        ----------
+        r : array_like (n,)
+            R coordinates of the starting points.
+        phi : array_like (n,)
+            phi coordinates of the starting points.
+        z : array_like (n,)
+            z coordinates of the starting points.
+        t : float
+            Time slice (same for all).
+        lmax : float, optional
+            Maximum length of the line in each direction.
+        tol : float, optional
+            Relative error tolerance of the integration.
+
+        Returns
+        -------
+        lfwd : array_like (n,)
+            Length of the line along the field.
+        lbwd : array_like (n,)
+            Length of the line against the field.
+        tfwd : array_like (n,)
+            Wall element hit along the field, zero if the maximum length was
+            reached, and -1 if the line left the field.
+        tbwd : array_like (n,)
+            Wall element hit against the field.
+        rhomin : array_like (n,)
+            Minimum rho along the whole line.
+
+        The connection length is lfwd + lbwd where both tiles are positive.
+
+        Raises
+        ------
+        AssertionError
+            If required data has not been initialized.
+        """
+        self._requireinit("bfield", "wall")
+        r = np.asarray(r).ravel().astype(dtype="f8")
+        Neval = r.size
+        phi = np.asarray(phi).ravel().astype(dtype="f8")
+        z   = np.asarray(z).ravel().astype(dtype="f8")
+        if phi.size == 1:
+            phi = phi * np.ones(r.shape).astype(dtype="f8")
+        if z.size == 1:
+            z = z * np.ones(r.shape).astype(dtype="f8")
+
+        lfwd   = np.zeros((Neval,), dtype="f8")
+        lbwd   = np.zeros((Neval,), dtype="f8")
+        tfwd   = np.zeros((Neval,), dtype="i4")
+        tbwd   = np.zeros((Neval,), dtype="i4")
+        rhomin = np.zeros((Neval,), dtype="f8")
+
+        fun = _LIBASCOT.libascot_fieldline_connection
+        fun.restype  = None
+        fun.argtypes = [PTR_SIM, PTR_ARR, PTR_ARR,
+                        ctypes.POINTER(ctypes.c_int), ctypes.c_int,
+                        PTR_REAL, PTR_REAL, PTR_REAL, ctypes.c_double,
+                        ctypes.c_double, ctypes.c_double, PTR_REAL, PTR_REAL,
+                        PTR_INT, PTR_INT, PTR_REAL]
+        fun(ctypes.byref(self._sim), self._bfield_offload_array,
+            self._wall_offload_array, self._wall_int_offload_array, Neval,
+            r, phi, z, t, lmax, tol, lfwd, lbwd, tfwd, tbwd, rhomin)
+
+        return (lfwd * unyt.m, lbwd * unyt.m, tfwd, tbwd,
+                rhomin * unyt.dimensionless)
+
+    def _input_fluxmap(self, nrho=64, ntheta=128, nphi=36, rhomax=1.0):
+        """Return the tabulated (rho, theta, phi) -> (R,z) map.
+
+        The map is constructed when this method is called for the first time
+        after the magnetic field was initialized. Only stellarator fields
+        depend on phi; for the other fields the map is axisymmetric.
+
+        Returns
+        -------
+        fluxmap : tuple or None
+            Grid dimensions, maximum rho, and spline coefficients that are
+            passed to libascot, or None if the map could not be constructed.
+        """
+        cached = getattr(self, "_fluxmap", None)
+        if cached is not None and cached[0] is self._bfield_offload_array:
+            return cached[1]
+
+        if self._sim.B_offload_data.type != ascot2py.B_field_type_STS:
+            nphi = 1
+        size = nrho * ntheta * nphi \
+            * (NSIZE_COMP2D if nphi == 1 else NSIZE_COMP3D)
+        coeff = np.zeros((size,), dtype="f8")
+
+        fun = _LIBASCOT.libascot_B_field_init_fluxmap
+        fun.restype  = ctypes.c_int
+        fun.argtypes = [PTR_SIM, PTR_ARR, ctypes.c_int, ctypes.c_int,
+                        ctypes.c_int, ctypes.c_double, PTR_REAL]
+        err = fun(ctypes.byref(self._sim), self._bfield_offload_array,
+                  nrho, ntheta, nphi, rhomax, coeff)
+
+        fluxmap = None if err else (nrho, ntheta, nphi, rhomax, coeff)
+        self._fluxmap = (self._bfield_offload_array, fluxmap)
+        return fluxmap
+
+    def _input_generate_markers(self, nmrk, edges, markerdist, particledist,
+                                minweight, spatial, momentum, mode, mass,
+                                seed, maxiter=100, tol=1e-5, usemap=None):
+        """Sample markers from 5D histograms in libascot.
+
+        Parameters
+        ----------
+        nmrk : int
+            Number of markers to be sampled.
+        edges : list [array_like]
+            Edges of the five abscissae in SI units.
+        markerdist : array_like
+            Marker distribution histogram.
+        particledist : array_like
+            Particle distribution histogram with the same shape as
+            ``markerdist``.
+        minweight : float
+            Minimum weight a marker must have or else it is rejected.
+        spatial : {0, 1}
+            Spatial basis: 0 for (R, phi, z) and 1 for (rho, theta, phi).
+        momentum : {0, 1}
+            Momentum basis: 0 for (ppar, pperp) and 1 for (ekin, pitch).
+        mode : {0, 1}
+            Generated marker type: 0 for guiding centers and 1 for particles.
+        mass : float
+            Marker mass in kg.
+        seed : int
+            Random number generator seed.
+        maxiter : int, optional
+            Maximum number of Newton iterations when mapping (rho, theta) to
+            (R, z).
+        tol : float, optional
+            Required accuracy in rho when mapping (rho, theta) to (R, z).
+        usemap : bool, optional
+            Use the tabulated map when mapping (rho, theta) to (R, z).
+
+            By default the map is used when the number of markers is large.
+
+        Returns
+        -------
+        out : tuple [array_like]
+            R [m], phi [rad], z [m], three momentum space coordinates, weight,
+            and the cell index of each marker.
+
+            The momentum space coordinates are energy [J], pitch, and
+            gyroangle [rad] for guiding centers, and the velocity components
+            (vR, vphi, vz) [m/s] for particles.
+
+        Raises
+        ------
+        AssertionError
+            If required data has not been initialized.
+        RuntimeError
+            If sampling in libascot.so failed.
+        """
+        if spatial == 1 or mode == 1:
+            self._requireinit("bfield")
+
+        n     = np.array([e.size - 1 for e in edges], dtype="i4")
+        edges = np.concatenate(edges).astype(dtype="f8")
+        markerdist   = np.ascontiguousarray(markerdist, dtype="f8").ravel()
+        particledist = np.ascontiguousarray(particledist, dtype="f8").ravel()
+        out   = [np.zeros((nmrk,), dtype="f8") for i in range(7)]
+        icell = np.zeros((nmrk,), dtype="i8")
+
+        fluxmap = None
+        if spatial == 1:
+            if usemap is None:
+                usemap = nmrk > 10000
+            fluxmap = self._input_fluxmap() if usemap else None
+        if fluxmap is None:
+            fluxmap = (0, 0, 0, 0.0, None)
+
+        fun = _LIBASCOT.libascot_generate_markers
+        fun.restype  = ctypes.c_int
+        fun.argtypes = [PTR_SIM, PTR_ARR, ctypes.c_int, PTR_INT, PTR_REAL,
+                        ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                        ctypes.c_double, PTR_REAL, PTR_REAL, ctypes.c_double,
+                        ctypes.c_int, ctypes.c_int, ctypes.c_double,
+                        PTR_REAL, PTR_REAL, PTR_REAL, PTR_REAL, PTR_REAL,
+                        PTR_REAL, PTR_REAL,
+                        _ndpointerwithnull(ctypes.c_int64,
+                                           flags="C_CONTIGUOUS"),
+                        ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                        ctypes.c_double, PTR_REAL]
+        err = fun(ctypes.byref(self._sim), self._bfield_offload_array, nmrk,
+                  n, edges, spatial, momentum, mode, mass, markerdist,
+                  particledist, minweight, seed, maxiter, tol, *out, icell,
+                  *fluxmap)
+        if err:
+            raise RuntimeError("Failed to sample markers")
+
+        return (*out, icell)
+
     @parseunits(rho="1", theta="rad", phi="rad", time="s")
     def input_findpsi0(self, psi1):
         """Find poloidal flux on axis value numerically.
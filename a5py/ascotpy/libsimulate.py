@@ -49,11 +49,19 @@ class LibSimulate():
         self._sim.sim_mode    = int(opt["SIM_MODE"]);
         self._sim.enable_ada  = int(opt["ENABLE_ADAPTIVE"])
         self._sim.record_mode = int(opt["RECORD_MODE"])
+        self._sim.marker_sorting = int(opt["MARKER_SORTING"])
+        self._sim.simd_width = int(opt["SIMD_WIDTH"])
+        self._sim.converge_mode = int(opt["CONVERGENCE_MODE"])
+        self._sim.converge_tol = opt["CONVERGENCE_TOLERANCE"]
+        self._sim.converge_batch = int(opt["CONVERGENCE_BATCH"])
+        self._sim.converge_min_batches = int(opt["CONVERGENCE_MIN_BATCHES"])
 
         # Time step
         self._sim.fix_usrdef_use    = int(opt["FIXEDSTEP_USE_USERDEFINED"])
         self._sim.fix_usrdef_val    = opt["FIXEDSTEP_USERDEFINED"]
         self._sim.fix_gyrodef_nstep = int(opt["FIXEDSTEP_GYRODEFINED"])
+        self._sim.fix_ccol_nstep    = int(opt["FIXEDSTEP_CCOL_NSTEP"])
+        self._sim.fix_ccol_tol      = opt["FIXEDSTEP_CCOL_TOL"]
         self._sim.ada_tol_orbfol    = opt["ADAPTIVE_TOL_ORBIT"]
         self._sim.ada_tol_clmbcol   = opt["ADAPTIVE_TOL_CCOL"]
         self._sim.ada_max_drho      = opt["ADAPTIVE_MAX_DRHO"]
@@ -69,6 +77,10 @@ class LibSimulate():
         self._sim.disable_pitchccoll  = int(opt["DISABLE_PITCH_CCOLL"])
         self._sim.disable_gcdiffccoll = int(opt["DISABLE_GCDIFF_CCOLL"])
         self._sim.reverse_time        = int(opt["REVERSE_TIME"])
+        self._sim.enable_split        = int(opt["ENABLE_SPLITTING"])
+        self._sim.split_rho           = opt["SPLIT_RHO"]
+        self._sim.split_number        = int(opt["SPLIT_NUMBER"])
+        self._sim.split_max_markers   = int(opt["SPLIT_MAX_MARKERS"])
 
         # Which end conditions are active
         self._sim.endcond_active = 0;
@@ -6,7 +6,7 @@ from scipy import interpolate
 from copy import deepcopy
 
 from a5py.exceptions import AscotInitException
-from a5py.ascotpy.libascot import _LIBASCOT, PTR_REAL
+from a5py.ascotpy.libascot import _LIBASCOT, PTR_REAL, PTR_INT
 
 class BioSaw():
     """Biot-Savart solver for computing magnetic field from a coil geometry.
@@ -20,7 +20,8 @@ class BioSaw():
     def __init__(self, ascot):
         self._ascot = ascot
 
-    def calculate(self, r, phi, z, coilxyz, current=1.0, revolve=None):
+    def calculate(self, r, phi, z, coilxyz, current=1.0, revolve=None,
+                  gradient=False, theta=0.0):
         """Calculate magnetic field at given points due to given coil(s).
 
         Parameters
@@ -51,6 +52,14 @@ class BioSaw():
             + B_coil(phi0 at phi[2*revolve]) + ...,
 
             where the field is rotated through the whole ``phi`` array.
+        gradient : bool, optional
+            Also return the gradient of the field.
+        theta : float, optional
+            Opening angle for approximating distant closed coils as dipoles.
+
+            A coil is approximated when its radius is smaller than ``theta``
+            times its distance from the evaluation points. The relative error
+            is of the order of ``theta``. Zero disables the approximation.
 
         Returns
         -------
@@ -60,6 +69,10 @@ class BioSaw():
             Magnetic field phi component.
         bz : array_like, (nr,nphi,nz)
             Magnetic field z component.
+        db : array_like, (9,nr,nphi,nz)
+            Derivatives of the field components in the same order as they are
+            evaluated in ASCOT5: dbr/dr, dbr/dphi, dbr/dz, dbphi/dr, ...,
+            dbz/dz. Returned only if ``gradient`` is True.
         """
         if _LIBASCOT is None:
             raise AscotInitException(
@@ -73,41 +86,55 @@ class BioSaw():
         Y = R * np.sin(P)
         n = R.size
 
+        for xyz in coilxyz:
+            if any(  np.diff(xyz[:,0])**2 + np.diff(xyz[:,1])**2
+                   + np.diff(xyz[:,2])**2 == 0):
+                raise ValueError("A coil has zero-length elements")
+        coiln = np.array([xyz.shape[0] for xyz in coilxyz], dtype="i4")
+        coilx = np.concatenate([xyz[:,0].ravel() for xyz in coilxyz])
+        coily = np.concatenate([xyz[:,1].ravel() for xyz in coilxyz])
+        coilz = np.concatenate([xyz[:,2].ravel() for xyz in coilxyz])
+        current = np.array(current, dtype="f8")
+
         bx = np.zeros(n, dtype="f8")
         by = np.zeros(n, dtype="f8")
         bz = np.zeros(n, dtype="f8")
+        db = np.zeros((9, n), dtype="f8") if gradient else None
 
-        fun = _LIBASCOT.biosaw_calc_B
+        fun = _LIBASCOT.biosaw_calc_B_dB
         fun.restype  = None
         fun.argtypes = [ctypes.c_int, PTR_REAL, PTR_REAL, PTR_REAL,
-                        ctypes.c_int, PTR_REAL, PTR_REAL, PTR_REAL,
-                                      PTR_REAL, PTR_REAL, PTR_REAL]
-
-        for xyz, I in zip(coilxyz, current):
-            coiln = xyz.shape[0]
-            bx0 = np.zeros(n, dtype="f8")
-            by0 = np.zeros(n, dtype="f8")
-            bz0 = np.zeros(n, dtype="f8")
-            if any(  np.diff(xyz[:,0])**2 + np.diff(xyz[:,1])**2
-                   + np.diff(xyz[:,2])**2 == 0):
-                raise ValueError("A coil has zero-length elements")
-            _LIBASCOT.biosaw_calc_B(
-                n, X.ravel(), Y.ravel(), Z.ravel(), coiln,
-                xyz[:,0].ravel(), xyz[:,1].ravel(), xyz[:,2].ravel(),
-                bx0, by0, bz0)
-            bx += bx0 * I
-            by += by0 * I
-            bz += bz0 * I
+                        ctypes.c_int, PTR_INT, PTR_REAL, PTR_REAL, PTR_REAL,
+                        PTR_REAL, ctypes.c_double,
+                        PTR_REAL, PTR_REAL, PTR_REAL, PTR_REAL]
+        fun(n, X.ravel(), Y.ravel(), Z.ravel(), len(coilxyz), coiln,
+            coilx, coily, coilz, current, theta, bx, by, bz, db)
 
         shape = (r.size,phi.size,z.size)
         bx = bx.reshape(shape)
         by = by.reshape(shape)
         bz = bz.reshape(shape)
 
-        br   =  bx*np.cos(P) + by*np.sin(P)
-        bphi = -bx*np.sin(P) + by*np.cos(P)
+        c, s = np.cos(P), np.sin(P)
+        br   =  bx*c + by*s
+        bphi = -bx*s + by*c
         bz   =  bz
 
+        if gradient:
+            # Cartesian gradient to derivatives of cylindrical components
+            # with respect to (R, phi, z)
+            db = db.reshape((3,3) + shape)
+            dbdr   = db[:,0] * c + db[:,1] * s
+            dbdphi = R * ( -db[:,0] * s + db[:,1] * c )
+            dbdz   = db[:,2]
+            dbr    = [dbdr[0]*c + dbdr[1]*s, dbdphi[0]*c + dbdphi[1]*s + bphi,
+                      dbdz[0]*c + dbdz[1]*s]
+            dbphi  = [-dbdr[0]*s + dbdr[1]*c,
+                      -dbdphi[0]*s + dbdphi[1]*c - br,
+                      -dbdz[0]*s + dbdz[1]*c]
+            dbz    = [dbdr[2], dbdphi[2], dbdz[2]]
+            db = np.array(dbr + dbphi + dbz)
+
         if revolve is not None:
             br0   = np.copy(br)
             bphi0 = np.copy(bphi)
@@ -118,7 +145,15 @@ class BioSaw():
                 bphi += np.roll(bphi0, i*revolve, axis=1)
                 bz   += np.roll(bz0,   i*revolve, axis=1)
                 i += 1
-
+            if gradient:
+                db0 = np.copy(db)
+                i = 1
+                while i*revolve < phi.size:
+                    db += np.roll(db0, i*revolve, axis=2)
+                    i += 1
+
+        if gradient:
+            return br, bphi, bz, db
         return br, bphi, bz
 
     def addto2d(self, coilxyz, phimin=0, phimax=360, nphi=360,
@@ -1,10 +1,12 @@
 """Generate marker populations.
 """
+import warnings
 import numpy as np
 import unyt
 
 from a5py.ascot5io.marker import Marker
 from a5py.ascot5io.dist import DistData
+from a5py.ascotpy.libascot import _LIBASCOT
 from a5py import physlib
 
 class MarkerGenerator():
@@ -20,7 +22,8 @@ class MarkerGenerator():
         self._ascot = ascot
 
     def generate(self, nmrk, mass, charge, anum, znum, particledist,
-                 markerdist=None, mode='gc', minweight=0, return_dists=False):
+                 markerdist=None, mode='gc', minweight=0, return_dists=False,
+                 seed=None):
         """Generate weighted markers from marker and particle distributions.
 
         This function takes two 5D distributions that must have identical grids.
@@ -65,6 +68,13 @@ class MarkerGenerator():
             These distributions hould converge to inputs as the marker number is
             increased. The exception is ``particledist`` which will always get
             zero values in regions where ``markerdist`` is zero.
+        seed : int, optional
+            Seed for the random number generator when the markers are generated
+            in libascot.
+
+            If not given, the seed is drawn with :func:`numpy.random.randint`.
+            For a given seed, the markers are reproducible when the number of
+            OpenMP threads is the same.
 
         Returns
         -------
@@ -82,6 +92,13 @@ class MarkerGenerator():
         """
         if markerdist is None:
             markerdist = particledist
+        if _LIBASCOT is not None:
+            mrk, icell = self._generate_native(
+                nmrk, mass, charge, anum, znum, particledist, markerdist, mode,
+                minweight, seed)
+            return self._output_dists(mrk, icell, particledist, markerdist,
+                                      return_dists)
+
         # Number of markers successfully generated
         ngen      = 0
         # Cell indices of generated markers
@@ -206,6 +223,91 @@ class MarkerGenerator():
                 mrk['vphi'] = pvec[1,:] / mrk['mass']
                 mrk['vz']   = pvec[2,:] / mrk['mass']
 
+        return self._output_dists(mrk, icell, particledist, markerdist,
+                                  return_dists)
+
+    def _generate_native(self, nmrk, mass, charge, anum, znum, particledist,
+                         markerdist, mode, minweight, seed):
+        """Generate markers with the sampler in libascot.
+
+        See :meth:`generate` for the parameters.
+
+        Returns
+        -------
+        mrk : dict
+            Marker input data on a dictionary.
+        icell : array_like
+            Index of the cell in the flattened histogram of each marker.
+        """
+        if set(['r', 'phi', 'z']).issubset(markerdist.abscissae):
+            spatial = 0
+            edges = [markerdist.abscissa_edges("r").to("m"),
+                     markerdist.abscissa_edges("phi").to("rad"),
+                     markerdist.abscissa_edges("z").to("m")]
+        elif set(['rho', 'theta', 'phi']).issubset(markerdist.abscissae):
+            spatial = 1
+            edges = [markerdist.abscissa_edges("rho"),
+                     markerdist.abscissa_edges("theta").to("rad"),
+                     markerdist.abscissa_edges("phi").to("rad")]
+        else:
+            raise ValueError("Spatial abscissae basis not found form the "\
+                        "distribution.")
+
+        if "ppar" in markerdist.abscissae:
+            momentum = 0
+            edges += [markerdist.abscissa_edges("ppar").to("kg*m/s"),
+                      markerdist.abscissa_edges("pperp").to("kg*m/s")]
+        else:
+            momentum = 1
+            edges += [markerdist.abscissa_edges("ekin").to("J"),
+                      markerdist.abscissa_edges("pitch")]
+        edges = [np.asarray(e, dtype="f8") for e in edges]
+
+        if seed is None:
+            seed = np.random.randint(np.iinfo(np.int32).max // 2)
+        mass = mass * unyt.amu if not hasattr(mass, "units") else mass
+        r, phi, z, c1, c2, c3, weight, icell = \
+            self._ascot._input_generate_markers(
+                nmrk, edges, markerdist.histogram().v,
+                particledist.histogram().v, minweight, spatial, momentum,
+                0 if mode == 'gc' else 1, mass.to("kg").v, seed)
+
+        # Markers whose position could not be mapped from (rho, theta) to
+        # (R, z), or where the magnetic field could not be evaluated, are NaN
+        valid = np.isfinite(r) & np.isfinite(z) & np.isfinite(c1)
+        if not np.all(valid):
+            warnings.warn(
+                "%d markers were discarded because their initial coordinates "
+                "could not be evaluated." % (np.sum(~valid)))
+            r, phi, z, c1, c2, c3, weight, icell = \
+                [x[valid] for x in (r, phi, z, c1, c2, c3, weight, icell)]
+            nmrk = r.size
+
+        mrk = Marker.generate(mode, n=nmrk)
+        mrk["anum"][:]   = anum
+        mrk["znum"][:]   = znum
+        mrk["mass"][:]   = mass
+        mrk["charge"][:] = charge
+        mrk["weight"][:] = weight
+        mrk["r"]   = r * unyt.m
+        mrk["phi"] = (phi * unyt.rad).to("deg")
+        mrk["z"]   = z * unyt.m
+        if mode == 'gc':
+            mrk["energy"] = (c1 * unyt.J).to("eV")
+            mrk["pitch"]  = c2 * unyt.dimensionless
+            mrk["zeta"]   = c3 * unyt.rad
+        else:
+            mrk["vr"]   = c1 * unyt.m / unyt.s
+            mrk["vphi"] = c2 * unyt.m / unyt.s
+            mrk["vz"]   = c3 * unyt.m / unyt.s
+        return mrk, icell
+
+    def _output_dists(self, mrk, icell, particledist, markerdist,
+                      return_dists):
+        """Return markers and, if requested, their distributions.
+
+        See :meth:`generate` for the return values.
+        """
         if not return_dists:
             return mrk
 
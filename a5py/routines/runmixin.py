@@ -516,7 +516,24 @@ class RunMixin(DistMixin):
             all markers that hit the tile weighted by the marker energy and
             weight. Otherwise it is the mean value of all markers without any
             weights.
+
+        Notes
+        -----
+        If the wall loads were accumulated during the simulation
+        (ENABLE_WALLLOAD) and ``p_ids`` is not given, the stored loads are
+        returned instead of processing the marker end states.
         """
+        if p_ids is None and hasattr(self, "_wallload"):
+            data = self._wallload.read()
+            wetted = data["ids"]
+            area = self.wall.area()[wetted-1]
+            if weights:
+                return wetted, area, data["edepo"], data["pdepo"], \
+                    data["iangle"]
+            return wetted, area, data["edepo_mrk"], \
+                data["nmrk"].v * unyt.dimensionless, \
+                data["iangle_mrk"]
+
         self._require("_endstate")
         ids, energy, weight, pr, pphi, pz, pnorm, phi = self.getstate(
             "walltile", "ekin", "weight", "pr", "pphi", "pz", "pnorm", "phi",
@@ -749,26 +766,42 @@ class RunMixin(DistMixin):
             raise ValueError(
                 "Distribution has neither (rho, theta, phi) nor (R, phi, z)")
 
-        ordinates = {}
+        # Moments that only need the input data at the cell centers are
+        # evaluated in libascot in a single pass through the histogram
         mass = np.mean(self.getstate("mass"))
-        if "density" in moments:
-            Dist.density(dist, out)
-        if "chargedensity" in moments:
-            Dist.chargedensity(dist, out)
-        if "energydensity" in moments:
-            Dist.energydensity(mass, dist, out)
-        if "toroidalcurrent" in moments:
-            Dist.toroidalcurrent(self._root._ascot, mass, dist, out)
-        if "parallelcurrent" in moments:
-            Dist.parallelcurrent(self._root._ascot, mass, dist, out)
-        if "pressure" in moments:
-            Dist.pressure(mass, dist, out)
-        if "powerdep" in moments:
-            Dist.powerdep(self._root._ascot, mass, dist, out)
-        if "electronpowerdep" in moments:
-            Dist.electronpowerdep(self._root._ascot, mass, dist, out)
-        if "ionpowerdep" in moments:
-            Dist.ionpowerdep(self._root._ascot, mass, dist, out)
+        native = [m for m in moments if m in [
+            "density", "chargedensity", "energydensity", "pressure",
+            "toroidalcurrent", "parallelcurrent", "powerdep",
+            "electronpowerdep", "ionpowerdep"]]
+        if len(native) > 0:
+            if rhodist:
+                axes = ["rho", "theta", "phi"]
+                rc, phic, zc = r, phi, z
+            else:
+                axes = ["r", "phi", "z"]
+                rc, phic, zc = np.meshgrid(
+                    dist.abscissa("r"), dist.abscissa("phi"),
+                    dist.abscissa("z"), indexing="ij")
+            axes += ["ppar", "pperp", "charge"]
+            if "time" in dist.abscissae:
+                axes.append("time")
+            histogram = np.moveaxis(
+                dist.histogram().v,
+                [dist.abscissae.index(a) for a in axes], range(len(axes)))
+            values = self._root._ascot.input_eval_moments(
+                mass, rc.ravel(), phic.ravel(), zc.ravel(), 0*unyt.s,
+                dist.abscissa("ppar"), dist.abscissa("pperp"),
+                dist.abscissa("charge"), histogram, *native)
+            if len(native) == 1: values = [values]
+
+            units = {"density":"particles/m**3", "chargedensity":"C/m**3",
+                     "energydensity":"J/m**3", "pressure":"J/m**3",
+                     "toroidalcurrent":"A/m**2", "parallelcurrent":"A/m**2",
+                     "powerdep":"W/m**3", "electronpowerdep":"W/m**3",
+                     "ionpowerdep":"W/m**3"}
+            for m, val in zip(native, values):
+                val = val.reshape(out.volume.shape) / out.volume
+                out.add_ordinates(**{m:val.to(units[m])})
         #if "jxbtorque" in moments:
         #    Dist.jxbtorque(self._root._ascot, mass, dist, out)
         #if "colltorque" in moments:
@@ -175,6 +175,10 @@ class VirtualState():
             elif q == "time":      return arr(q) * s
             elif q == "mileage":   return arr(q) * s
             elif q == "cputime":   return arr(q) * s
+            elif q == "mindt":     return arr(q) * s
+            elif q == "nstep":     return arr(q) * nodim
+            elif q == "nrej":      return arr(q) * nodim
+            elif q == "mindtlim":  return arr(q) * nodim
             elif q == "rho":       return arr(q) * nodim
             elif q == "theta":     return arr(q) * rad
             elif q == "mass":      return arr(q) * kg
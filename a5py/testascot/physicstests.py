@@ -52,6 +52,7 @@ class PhysTest():
     tag_ccoll_slowinggo    = "TESTCCOLLSLOWINGGO"
     tag_ccoll_slowinggcf   = "TESTCCOLLSLOWINGGCF"
     tag_ccoll_slowinggca   = "TESTCCOLLSLOWINGGCA"
+    tag_ccoll_slowinggcs   = "TESTCCOLLSLOWINGGCS"
     tag_classical_go       = "TESTCLASSGO"
     tag_classical_gcf      = "TESTCLASSGCF"
     tag_classical_gca      = "TESTCLASSGCA"
@@ -860,12 +861,16 @@ class PhysTest():
                     "ADAPTIVE_TOL_CCOL" : 1e-2, "ADAPTIVE_MAX_DRHO" : 0.1,
                     "ADAPTIVE_MAX_DPHI" : 10, "FIXEDSTEP_USERDEFINED" : 1e-8})
         init("opt", **opt, desc=PhysTest.tag_ccoll_slowinggca)
+        # Same as GCF but collisions are applied only every tenth step
+        opt.update({"ENABLE_ADAPTIVE" : 0, "FIXEDSTEP_USERDEFINED" : 3e-8,
+                    "FIXEDSTEP_CCOL_NSTEP" : 10, "FIXEDSTEP_CCOL_TOL" : 1e-2})
+        init("opt", **opt, desc=PhysTest.tag_ccoll_slowinggcs)
 
         # Magnetic field is just some tokamak and plasma is uniform
         for tag in [PhysTest.tag_ccoll_thermalgo, PhysTest.tag_ccoll_thermalgcf,
                     PhysTest.tag_ccoll_thermalgca, PhysTest.tag_ccoll_slowinggo,
-                    PhysTest.tag_ccoll_slowinggcf, PhysTest.tag_ccoll_slowinggca
-                    ]:
+                    PhysTest.tag_ccoll_slowinggcf, PhysTest.tag_ccoll_slowinggca,
+                    PhysTest.tag_ccoll_slowinggcs]:
             init("bfield_analytical_iter_circular", desc=tag)
             init("plasma_flat", density=1e20, temperature=1e3, desc=tag)
 
@@ -892,6 +897,7 @@ class PhysTest():
         init("gc", **mrk, desc=PhysTest.tag_ccoll_slowinggo)
         init("gc", **mrk, desc=PhysTest.tag_ccoll_slowinggcf)
         init("gc", **mrk, desc=PhysTest.tag_ccoll_slowinggca)
+        init("gc", **mrk, desc=PhysTest.tag_ccoll_slowinggcs)
 
     def run_ccoll(self):
         """Run Coulmb collision test.
@@ -901,8 +907,8 @@ class PhysTest():
             return
         for tag in [PhysTest.tag_ccoll_thermalgo, PhysTest.tag_ccoll_thermalgcf,
                     PhysTest.tag_ccoll_thermalgca, PhysTest.tag_ccoll_slowinggo,
-                    PhysTest.tag_ccoll_slowinggcf, PhysTest.tag_ccoll_slowinggca
-                    ]:
+                    PhysTest.tag_ccoll_slowinggcf, PhysTest.tag_ccoll_slowinggca,
+                    PhysTest.tag_ccoll_slowinggcs]:
             self._activateinputs(tag)
             self._runascot(tag)
 
@@ -915,6 +921,7 @@ class PhysTest():
         run_sgo  = self.ascot.data[PhysTest.tag_ccoll_slowinggo]
         run_sgcf = self.ascot.data[PhysTest.tag_ccoll_slowinggcf]
         run_sgca = self.ascot.data[PhysTest.tag_ccoll_slowinggca]
+        run_sgcs = self.ascot.data[PhysTest.tag_ccoll_slowinggcs]
 
         fig = a5plt.figuredoublecolumn()
         gs = GridSpec(2, 2, figure=fig)
@@ -972,9 +979,10 @@ class PhysTest():
             th_pitch[i] = np.mean(run.getstate("pitch", state="end"))
             th_ekin[i]  = np.mean(run.getstate("ekin",  state="end"))
 
-        sd_time  = np.zeros((3,))
-        sd_pitch = np.zeros((3,))
-        for i, run in enumerate([run_sgo, run_sgcf, run_sgca]):
+        sd_time  = np.zeros((4,))
+        sd_pitch = np.zeros((4,))
+        sd_cpu   = np.zeros((4,))
+        for i, run in enumerate([run_sgo, run_sgcf, run_sgca, run_sgcs]):
             dist = run.getdist("5d", exi=True, ekin_edges=egridsd)
             edist = dist.integrate(
                 r=np.s_[:], phi=np.s_[:], z=np.s_[:], time=np.s_[:],
@@ -986,6 +994,7 @@ class PhysTest():
             xdist.plot(axes=h4)
             sd_pitch[i] = np.mean(run.getstate("pitch", state="end"))
             sd_time[i]  = np.mean(run.getstate("time",  state="end"))
+            sd_cpu[i]   = np.sum(run.getstate("cputime", state="end"))
 
         # These are multiplied with marker number to get correct normalization
         Nmrkth = run_tgo.getstate("ids").size
@@ -1010,11 +1019,19 @@ class PhysTest():
         print("  GO            %1.1e      %1.2f" % (sd_time[0], sd_pitch[0]))
         print("  GCF           %1.1e      %1.2f" % (sd_time[1], sd_pitch[1]))
         print("  GCA           %1.1e      %1.2f" % (sd_time[2], sd_pitch[2]))
+        print("  GCS           %1.1e      %1.2f" % (sd_time[3], sd_pitch[3]))
         print("  Expected      %1.1e      %1.2f" % (slowingdowntime, 0.0))
         if np.amax(np.abs(slowingdowntime.v  - sd_time))  > 2e-3 or \
            np.amax(np.abs(0.0 - sd_pitch)) > 0.2:
             print("  (Failed)")
             passed = False
+        print("")
+        print("  Slowing-down with subcycled collisions (GCS) vs GCF")
+        print("  Error in final time  GCF %1.1e  GCS %1.1e" % (
+            np.abs(slowingdowntime.v - sd_time[1]),
+            np.abs(slowingdowntime.v - sd_time[3])))
+        print("  CPU time [s]         GCF %1.1e  GCS %1.1e  speedup %1.1f" % (
+            sd_cpu[1], sd_cpu[3], sd_cpu[1] / sd_cpu[3]))
 
         fig = a5plt.figuredoublecolumn(3/2)
         ax = fig.add_subplot(1,1,1)
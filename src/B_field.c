@@ -23,6 +23,7 @@
 #include "Bfield/B_3DS.h"
 #include "Bfield/B_STS.h"
 #include "Bfield/B_TC.h"
+#include "Bfield/B_3DST.h"
 
 /**
  * @brief Load magnetic field data and prepare parameters
@@ -32,7 +33,8 @@
  * array length in the offload struct.
  *
  * The offload data has to have a type when this function is called as it should
- * be set when the offload data is constructed from inputs.
+ * be set when the offload data is constructed from inputs. The
+ * single_precision flag is passed on to the field types that support it.
  *
  * This function is host only.
  *
@@ -59,12 +61,22 @@ int B_field_init_offload(B_field_offload_data* offload_data,
             break;
 
         case B_field_type_3DS:
+            offload_data->B3DS.single_precision =
+                offload_data->single_precision;
             err = B_3DS_init_offload(&(offload_data->B3DS), offload_array);
             offload_data->offload_array_length =
                 offload_data->B3DS.offload_array_length;
             break;
 
+        case B_field_type_3DST:
+            err = B_3DST_init_offload(&(offload_data->B3DST), offload_array);
+            offload_data->offload_array_length =
+                offload_data->B3DST.offload_array_length;
+            break;
+
         case B_field_type_STS:
+            offload_data->BSTS.single_precision =
+                offload_data->single_precision;
             err = B_STS_init_offload(&(offload_data->BSTS), offload_array);
             offload_data->offload_array_length =
                 offload_data->BSTS.offload_array_length;
@@ -117,6 +129,10 @@ void B_field_free_offload(B_field_offload_data* offload_data,
             B_3DS_free_offload(&(offload_data->B3DS), offload_array);
             break;
 
+        case B_field_type_3DST:
+            B_3DST_free_offload(&(offload_data->B3DST), offload_array);
+            break;
+
         case B_field_type_STS:
             B_STS_free_offload(&(offload_data->BSTS), offload_array);
             break;
@@ -160,6 +176,11 @@ int B_field_init(B_field_data* Bdata, B_field_offload_data* offload_data,
                 &(Bdata->B3DS), &(offload_data->B3DS), offload_array);
             break;
 
+        case B_field_type_3DST:
+            B_3DST_init(
+                &(Bdata->B3DST), &(offload_data->B3DST), offload_array);
+            break;
+
         case B_field_type_STS:
             B_STS_init(
                 &(Bdata->BSTS), &(offload_data->BSTS), offload_array);
@@ -215,6 +236,10 @@ a5err B_field_eval_psi(real* psi, real r, real phi, real z, real t,
             err = B_3DS_eval_psi(psi, r, phi, z, &(Bdata->B3DS));
             break;
 
+        case B_field_type_3DST:
+            err = B_3DST_eval_psi(psi, r, phi, z, &(Bdata->B3DST));
+            break;
+
         case B_field_type_STS:
             err = B_STS_eval_psi(psi, r, phi, z, &(Bdata->BSTS));
             break;
@@ -279,6 +304,10 @@ a5err B_field_eval_psi_dpsi(real psi_dpsi[4], real r, real phi, real z, real t,
             err = B_3DS_eval_psi_dpsi(psi_dpsi, r, phi, z, &(Bdata->B3DS));
             break;
 
+        case B_field_type_3DST:
+            err = B_3DST_eval_psi_dpsi(psi_dpsi, r, phi, z, &(Bdata->B3DST));
+            break;
+
         case B_field_type_STS:
             err = B_STS_eval_psi_dpsi(psi_dpsi, r, phi, z, &(Bdata->BSTS));
             break;
@@ -304,54 +333,49 @@ a5err B_field_eval_psi_dpsi(real psi_dpsi[4], real r, real phi, real z, real t,
 }
 
 /**
- * @brief Evaluate normalized poloidal flux rho and its psi derivative
- *
- * This function evaluates the normalized poloidal flux rho at the given
- * coordinates. The rho is evaluated from psi as:
- *
- * \f{equation*}{
- * \rho = \sqrt{ \frac{\psi - \psi_0}{\psi_1 - \psi_0} },
- * \f}
- *
- * where \f$\psi_0\f$ is psi at magnetic axis and \f$\psi_1\f$ is psi at
- * separatrix.
+ * @brief Get poloidal flux at magnetic axis and at separatrix
  *
  * This is a SIMD function.
  *
- * @param rho pointer where rho value will be stored
- * @param psi poloidal flux from which rho is evaluated
+ * @param psilim pointer where psi at axis and at separatrix will be stored
  * @param Bdata pointer to magnetic field data struct
  *
  * @return Non-zero a5err value if evaluation failed, zero otherwise
  */
-a5err B_field_eval_rho(real rho[2], real psi, B_field_data* Bdata) {
+a5err B_field_get_psilim(real psilim[2], B_field_data* Bdata) {
     a5err err = 0;
 
-    real psi0 = 0.0, psi1 = 1.0;
+    psilim[0] = 0.0;
+    psilim[1] = 1.0;
     switch(Bdata->type) {
         case B_field_type_GS:
-            psi0 = Bdata->BGS.psi0;
-            psi1 = Bdata->BGS.psi1;
+            psilim[0] = Bdata->BGS.psi0;
+            psilim[1] = Bdata->BGS.psi1;
             break;
 
         case B_field_type_2DS:
-            psi0 = Bdata->B2DS.psi0;
-            psi1 = Bdata->B2DS.psi1;
+            psilim[0] = Bdata->B2DS.psi0;
+            psilim[1] = Bdata->B2DS.psi1;
             break;
 
         case B_field_type_3DS:
-            psi0 = Bdata->B3DS.psi0;
-            psi1 = Bdata->B3DS.psi1;
+            psilim[0] = Bdata->B3DS.psi0;
+            psilim[1] = Bdata->B3DS.psi1;
+            break;
+
+        case B_field_type_3DST:
+            psilim[0] = Bdata->B3DST.psi0;
+            psilim[1] = Bdata->B3DST.psi1;
             break;
 
         case B_field_type_STS:
-            psi0 = Bdata->BSTS.psi0;
-            psi1 = Bdata->BSTS.psi1;
+            psilim[0] = Bdata->BSTS.psi0;
+            psilim[1] = Bdata->BSTS.psi1;
             break;
 
         case B_field_type_TC:
-            psi0 = Bdata->BTC.psival;
-            psi1 = 2.0;
+            psilim[0] = Bdata->BTC.psival;
+            psilim[1] = 2.0;
             break;
 
         default:
@@ -360,6 +384,35 @@ a5err B_field_eval_rho(real rho[2], real psi, B_field_data* Bdata) {
             break;
     }
 
+    return err;
+}
+
+/**
+ * @brief Evaluate normalized poloidal flux rho and its psi derivative
+ *
+ * This function evaluates the normalized poloidal flux rho at the given
+ * coordinates. The rho is evaluated from psi as:
+ *
+ * \f{equation*}{
+ * \rho = \sqrt{ \frac{\psi - \psi_0}{\psi_1 - \psi_0} },
+ * \f}
+ *
+ * where \f$\psi_0\f$ is psi at magnetic axis and \f$\psi_1\f$ is psi at
+ * separatrix.
+ *
+ * This is a SIMD function.
+ *
+ * @param rho pointer where rho value will be stored
+ * @param psi poloidal flux from which rho is evaluated
+ * @param Bdata pointer to magnetic field data struct
+ *
+ * @return Non-zero a5err value if evaluation failed, zero otherwise
+ */
+a5err B_field_eval_rho(real rho[2], real psi, B_field_data* Bdata) {
+    real psilim[2];
+    a5err err = B_field_get_psilim(psilim, Bdata);
+    real psi0 = psilim[0], psi1 = psilim[1];
+
     real delta = (psi1 - psi0);
     if( (psi - psi0) / delta < 0 ) {
          err = error_raise( ERR_INPUT_UNPHYSICAL, __LINE__, EF_B_FIELD );
@@ -378,6 +431,28 @@ a5err B_field_eval_rho(real rho[2], real psi, B_field_data* Bdata) {
     return err;
 }
 
+/**
+ * @brief Evaluate poloidal flux psi from normalized poloidal flux rho
+ *
+ * Inverse of B_field_eval_rho(). Useful when rho is already known, e.g. it is
+ * stored in the marker struct, since evaluating psi this way requires no
+ * interpolation.
+ *
+ * This is a SIMD function.
+ *
+ * @param psi pointer where psi value will be stored
+ * @param rho normalized poloidal flux
+ * @param Bdata pointer to magnetic field data struct
+ *
+ * @return Non-zero a5err value if evaluation failed, zero otherwise
+ */
+a5err B_field_eval_psi_from_rho(real* psi, real rho, B_field_data* Bdata) {
+    real psilim[2];
+    a5err err = B_field_get_psilim(psilim, Bdata);
+    psi[0] = psilim[0] + rho * rho * (psilim[1] - psilim[0]);
+    return err;
+}
+
 /**
  * @brief Evaluate normalized poloidal flux rho and its derivatives
  *
@@ -424,6 +499,10 @@ a5err B_field_eval_rho_drho(real rho_drho[4], real r, real phi, real z,
             err = B_3DS_eval_rho_drho(rho_drho, r, phi, z, &(Bdata->B3DS));
             break;
 
+        case B_field_type_3DST:
+            err = B_3DST_eval_rho_drho(rho_drho, r, phi, z, &(Bdata->B3DST));
+            break;
+
         case B_field_type_STS:
             err = B_STS_eval_rho_drho(rho_drho, r, phi, z, &(Bdata->BSTS));
             break;
@@ -486,6 +565,10 @@ a5err B_field_eval_B(real B[3], real r, real phi, real z, real t,
             err = B_3DS_eval_B(B, r, phi, z, &(Bdata->B3DS));
             break;
 
+        case B_field_type_3DST:
+            err = B_3DST_eval_B(B, r, phi, z, t, &(Bdata->B3DST));
+            break;
+
         case B_field_type_STS:
             err = B_STS_eval_B(B, r, phi, z, &(Bdata->BSTS));
             break;
@@ -561,6 +644,10 @@ a5err B_field_eval_B_dB(real B_dB[15], real r, real phi, real z, real t,
             err = B_3DS_eval_B_dB(B_dB, r, phi, z, &(Bdata->B3DS));
             break;
 
+        case B_field_type_3DST:
+            err = B_3DST_eval_B_dB(B_dB, r, phi, z, t, &(Bdata->B3DST));
+            break;
+
         case B_field_type_STS:
             err = B_STS_eval_B_dB(B_dB, r, phi, z, &(Bdata->BSTS));
             break;
@@ -585,6 +672,65 @@ a5err B_field_eval_B_dB(real B_dB[15], real r, real phi, real z, real t,
     return err;
 }
 
+/**
+ * @brief Evaluate magnetic field and its derivatives for a batch of markers
+ *
+ * This is the batched counterpart of B_field_eval_B_dB(). The lanes are
+ * evaluated one after another with B_field_eval_B_dB().
+ *
+ * The field components are stored in the same order as in
+ * B_field_eval_B_dB() but in structure-of-arrays layout, i.e. component k of
+ * lane i is stored in B_dB[k*n + i]. Time derivatives are zero for static
+ * fields.
+ *
+ * Only lanes for which mask[i] is non-zero and err[i] is zero are evaluated.
+ * If evaluation fails, err[i] is set and the lane is given same fallback values
+ * as in B_field_eval_B_dB().
+ *
+ * @param n number of lanes
+ * @param B_dB pointer to array of size 15*n where the field and its
+ *        derivatives are stored
+ * @param r R coordinates [m]
+ * @param phi phi coordinates [rad]
+ * @param z z coordinates [m]
+ * @param t time coordinates [s]
+ * @param mask lanes to be evaluated
+ * @param err error flags for each lane
+ * @param Bdata pointer to magnetic field data struct
+ */
+void B_field_eval_B_dB_simd(int n, real* B_dB, real* r, real* phi, real* z,
+                            real* t, integer* mask, a5err* err,
+                            B_field_data* Bdata) {
+    #pragma omp simd
+    for(int i = 0; i < n; i++) {
+        if(mask[i] && !err[i]) {
+            real B_dB_i[15];
+            err[i] = B_field_eval_B_dB(B_dB_i, r[i], phi[i], z[i], t[i],
+                                       Bdata);
+            for(int k = 0; k < 15; k++) {
+                B_dB[k*n + i] = B_dB_i[k];
+            }
+        }
+    }
+
+    int timedep = Bdata->type == B_field_type_3DST;
+    #pragma omp simd
+    for(int i = 0; i < n; i++) {
+        if(mask[i]) {
+            if(err[i]) {
+                /* Same fallback values as in the scalar version */
+                B_dB[i] = 1;
+                for(int k = 1; k < 12; k++) {B_dB[k*n + i] = 0;}
+            }
+            if(err[i] || !timedep) {
+                B_dB[12*n + i] = 0;
+                B_dB[13*n + i] = 0;
+                B_dB[14*n + i] = 0;
+            }
+        }
+    }
+}
+
 /**
  * @brief Return magnetic axis Rz-coordinates
  *
@@ -612,6 +758,10 @@ a5err B_field_get_axis_rz(real rz[2], B_field_data* Bdata, real phi) {
             err = B_3DS_get_axis_rz(rz, &(Bdata->B3DS));
             break;
 
+        case B_field_type_3DST:
+            err = B_3DST_get_axis_rz(rz, &(Bdata->B3DST));
+            break;
+
         case B_field_type_STS:
             err = B_STS_get_axis_rz(rz, &(Bdata->BSTS), phi);
             break;
@@ -16,6 +16,7 @@
 #include "Bfield/B_3DS.h"
 #include "Bfield/B_STS.h"
 #include "Bfield/B_TC.h"
+#include "Bfield/B_3DST.h"
 
 /**
  * @brief Magnetic field types
@@ -29,7 +30,8 @@ typedef enum B_field_type {
     B_field_type_2DS, /**< Spline-interpolated axisymmetric  magnetic field */
     B_field_type_3DS, /**< Spline-interpolated 3D magnetic field            */
     B_field_type_STS, /**< Spline-interpolated stellarator magnetic field   */
-    B_field_type_TC   /**< Trivial Cartesian magnetic field                 */
+    B_field_type_TC,  /**< Trivial Cartesian magnetic field                 */
+    B_field_type_3DST /**< Time-dependent spline-interpolated 3D field      */
 } B_field_type;
 
 /**
@@ -48,6 +50,13 @@ typedef struct {
     B_3DS_offload_data B3DS;  /**< 3DS field or NULL if not active            */
     B_STS_offload_data BSTS;  /**< STS field or NULL if not active            */
     B_TC_offload_data BTC;    /**< TC field or NULL if not active             */
+    B_3DST_offload_data B3DST;/**< 3DST field or NULL if not active           */
+    int single_precision;     /**< Store 3D spline coefficients in single
+                                   precision if supported by the field type   */
+    int spline_cache;         /**< Read and store 3D spline coefficients in
+                                   the input file if supported by the type    */
+    char spline_hash[17];     /**< Key of the coefficients which are to be
+                                   stored in the cache or empty if none       */
     int offload_array_length; /**< Allocated offload array length             */
 } B_field_offload_data;
 
@@ -67,6 +76,7 @@ typedef struct {
     B_3DS_data B3DS;   /**< 3DS field or NULL if not active            */
     B_STS_data BSTS;   /**< STS field or NULL if not active            */
     B_TC_data BTC;     /**< TC field or NULL if not active             */
+    B_3DST_data B3DST; /**< 3DST field or NULL if not active           */
 } B_field_data;
 
 int B_field_init_offload(B_field_offload_data* offload_data,
@@ -86,9 +96,15 @@ a5err B_field_eval_psi_dpsi(
     real psi_dpsi[4], real r, real phi, real z, real t, B_field_data* Bdata);
 DECLARE_TARGET_END
 GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
+a5err B_field_get_psilim(real psilim[2], B_field_data* Bdata);
+DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
 a5err B_field_eval_rho(real rho[2], real psi, B_field_data* Bdata);
 DECLARE_TARGET_END
 GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
+a5err B_field_eval_psi_from_rho(real* psi, real rho, B_field_data* Bdata);
+DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
 a5err B_field_eval_rho_drho(
     real rho_drho[4], real r, real phi, real z, B_field_data* Bdata);
 DECLARE_TARGET_END
@@ -100,6 +116,9 @@ GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
 a5err B_field_eval_B_dB(
     real B_dB[15], real r, real phi, real z, real t, B_field_data* Bdata);
 DECLARE_TARGET_END
+void B_field_eval_B_dB_simd(int n, real* B_dB, real* r, real* phi, real* z,
+                            real* t, integer* mask, a5err* err,
+                            B_field_data* Bdata);
 GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
 a5err B_field_get_axis_rz(real rz[2], B_field_data* Bdata, real phi);
 DECLARE_TARGET_END
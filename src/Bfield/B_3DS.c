@@ -32,6 +32,7 @@
  * @see B_field.c
  */
 #include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 #include <math.h>
 #include "../math.h"
@@ -42,55 +43,19 @@
 #include "../spline/interp.h"
 
 /**
- * @brief Initialize magnetic field offload data
- *
- * This function takes pre-initialized offload data struct and offload array as
- * inputs. The data is used to fill rest of the offload struct and to construct
- * bicubic splines whose coefficients are stored in re-allocated offload array.
+ * @brief Evaluate spline coefficients and store them in the offload array
  *
- * The offload data struct must have the following fields initialized:
- * - B_3DS_offload_data.psigrid_n_r
- * - B_3DS_offload_data.psigrid_n_z
- * - B_3DS_offload_data.psigrid_r_min
- * - B_3DS_offload_data.psigrid_r_max
- * - B_3DS_offload_data.psigrid_z_min
- * - B_3DS_offload_data.psigrid_z_max
- *
- * - B_3DS_offload_data.Bgrid_n_r
- * - B_3DS_offload_data.Bgrid_n_z
- * - B_3DS_offload_data.Bgrid_r_min
- * - B_3DS_offload_data.Bgrid_r_max
- * - B_3DS_offload_data.Bgrid_z_min
- * - B_3DS_offload_data.Bgrid_z_max
- * - B_3DS_offload_data.n_phi
- * - B_3DS_offload_data.phi_min
- * - B_3DS_offload_data.phi_max
- *
- * - B_3DS_offload_data.psi0
- * - B_3DS_offload_data.psi1
- * - B_3DS_offload_data.axis_r
- * - B_3DS_offload_data.axis_z
- *
- * B_3DS_offload_data.offload_array_length is set here.
- *
- * The offload array must contain the following data:
- * - offload_array[                     j*Bn_r*Bn_phi + z*Bn_r + i]
- *   = B_R(R_i, phi_z, z_j)   [T]
- * - offload_array[  Bn_r*Bn_z*Bn_phi + j*Bn_r*Bn_phi + z*Bn_r + i]
- *   = B_phi(R_i, phi_z, z_j) [T]
- * - offload_array[2*Bn_r*Bn_z*Bn_phi + j*Bn_r*Bn_phi + z*Bn_r + i]
- *   = B_z(R_i, phi_z, z_j)   [T]
- * - offload_array[3*Bn_r*Bn_z*Bn_phi + j*n_r + i]
- *   = psi(R_i, z_j)   [V*s*m^-1]
- *
- * Sanity checks are printed if data was initialized succesfully.
+ * The offload array containing the input data is replaced with the
+ * coefficient array, converted to single precision if requested.
  *
  * @param offload_data pointer to offload data struct
  * @param offload_array pointer to offload array which is reallocated here
+ * @param B_err array where the single precision error of B is stored
  *
  * @return zero if initialization succeeded
  */
-int B_3DS_init_offload(B_3DS_offload_data* offload_data, real** offload_array) {
+static int B_3DS_init_coeff(B_3DS_offload_data* offload_data,
+                            real** offload_array, real B_err[3]) {
 
     /* Spline initialization. */
     int err = 0;
@@ -151,6 +116,121 @@ int B_3DS_init_offload(B_3DS_offload_data* offload_data, real** offload_array) {
     offload_data->offload_array_length = NSIZE_COMP2D*psi_size
                                        + NSIZE_COMP3D*B_size*3;
 
+    /* Convert B coefficients to single precision. Each component then takes
+       half the space and the floats are packed in the offload array. */
+    if(offload_data->single_precision) {
+        int B_length = ( NSIZE_COMP3D*B_size + 1 ) / 2;
+        real* single_array = (real*) malloc(
+            (3*B_length + NSIZE_COMP2D*psi_size)*sizeof(real) );
+        for(int i = 0; i < 3; i++) {
+            err += interp3Dcomp_compress_coeff(
+                (float*)&(single_array[i*B_length]),
+                &(coeff_array[i*B_size*NSIZE_COMP3D]), NSIZE_COMP3D*B_size);
+        }
+        memcpy(&(single_array[3*B_length]), psi,
+               NSIZE_COMP2D*psi_size*sizeof(real));
+
+        /* Compare to the double precision splines */
+        B_3DS_data Bdouble, Bsingle;
+        offload_data->single_precision = 0;
+        B_3DS_init(&Bdouble, offload_data, coeff_array);
+        offload_data->single_precision = 1;
+        B_3DS_init(&Bsingle, offload_data, single_array);
+        interp3D_data* Bd[3] = {&Bdouble.B_r, &Bdouble.B_phi, &Bdouble.B_z};
+        interp3D_data* Bs[3] = {&Bsingle.B_r, &Bsingle.B_phi, &Bsingle.B_z};
+        for(int i = 0; i < 3; i++) {
+            real cerr[3];
+            interp3Dcomp_compress_error(cerr, Bd[i], Bs[i]);
+            B_err[0] = fmax(B_err[0], cerr[0]);
+            B_err[1] = fmax(B_err[1], cerr[1]);
+            B_err[2] = fmax(B_err[2], cerr[2]);
+        }
+        if( err || B_err[0] > INTERP_SINGLE_PRECISION_TOL * B_err[2] ) {
+            print_err("Error: Single precision coefficients are not "
+                      "accurate enough.\n");
+            free(single_array);
+            return 1;
+        }
+
+        free(*offload_array);
+        *offload_array = single_array;
+        offload_data->offload_array_length = NSIZE_COMP2D*psi_size
+                                           + 3*B_length;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Initialize magnetic field offload data
+ *
+ * This function takes pre-initialized offload data struct and offload array as
+ * inputs. The data is used to fill rest of the offload struct and to construct
+ * bicubic splines whose coefficients are stored in re-allocated offload array.
+ *
+ * The offload data struct must have the following fields initialized:
+ * - B_3DS_offload_data.psigrid_n_r
+ * - B_3DS_offload_data.psigrid_n_z
+ * - B_3DS_offload_data.psigrid_r_min
+ * - B_3DS_offload_data.psigrid_r_max
+ * - B_3DS_offload_data.psigrid_z_min
+ * - B_3DS_offload_data.psigrid_z_max
+ *
+ * - B_3DS_offload_data.Bgrid_n_r
+ * - B_3DS_offload_data.Bgrid_n_z
+ * - B_3DS_offload_data.Bgrid_r_min
+ * - B_3DS_offload_data.Bgrid_r_max
+ * - B_3DS_offload_data.Bgrid_z_min
+ * - B_3DS_offload_data.Bgrid_z_max
+ * - B_3DS_offload_data.n_phi
+ * - B_3DS_offload_data.phi_min
+ * - B_3DS_offload_data.phi_max
+ *
+ * - B_3DS_offload_data.psi0
+ * - B_3DS_offload_data.psi1
+ * - B_3DS_offload_data.axis_r
+ * - B_3DS_offload_data.axis_z
+ *
+ * B_3DS_offload_data.offload_array_length is set here.
+ *
+ * If B_3DS_offload_data.single_precision is set, the coefficients of B_R,
+ * B_phi, and B_z are stored in single precision which halves their memory
+ * footprint. The resulting interpolation error is measured here and the
+ * initialization fails if it exceeds INTERP_SINGLE_PRECISION_TOL relative to
+ * the maximum field strength.
+ *
+ * The offload array must contain the following data:
+ * - offload_array[                     j*Bn_r*Bn_phi + z*Bn_r + i]
+ *   = B_R(R_i, phi_z, z_j)   [T]
+ * - offload_array[  Bn_r*Bn_z*Bn_phi + j*Bn_r*Bn_phi + z*Bn_r + i]
+ *   = B_phi(R_i, phi_z, z_j) [T]
+ * - offload_array[2*Bn_r*Bn_z*Bn_phi + j*Bn_r*Bn_phi + z*Bn_r + i]
+ *   = B_z(R_i, phi_z, z_j)   [T]
+ * - offload_array[3*Bn_r*Bn_z*Bn_phi + j*n_r + i]
+ *   = psi(R_i, z_j)   [V*s*m^-1]
+ *
+ * If B_3DS_offload_data.precomputed is set, the offload array already contains
+ * the (possibly single precision) spline coefficients, e.g. read from a cache,
+ * and they are used as such.
+ *
+ * Sanity checks are printed if data was initialized succesfully.
+ *
+ * @param offload_data pointer to offload data struct
+ * @param offload_array pointer to offload array which is reallocated here
+ *
+ * @return zero if initialization succeeded
+ */
+int B_3DS_init_offload(B_3DS_offload_data* offload_data, real** offload_array) {
+
+    int err = 0;
+    real B_err[3] = {0, 0, 0};
+    if(!offload_data->precomputed) {
+        err = B_3DS_init_coeff(offload_data, offload_array, B_err);
+        if(err) {
+            return err;
+        }
+    }
+
     /* Evaluate psi and magnetic field on axis for checks */
     B_3DS_data Bdata;
     B_3DS_init(&Bdata, offload_data, *offload_array);
@@ -189,6 +269,11 @@ int B_3DS_init_offload(B_3DS_offload_data* offload_data, real** offload_array) {
     print_out(VERBOSE_IO, "Magnetic field on axis:\n"
               "B_R = %3.3f B_phi = %3.3f B_z = %3.3f\n",
               Bval[0], Bval[1], Bval[2]);
+    if(offload_data->single_precision && !offload_data->precomputed) {
+        print_out(VERBOSE_IO, "Single precision coefficients, max error:\n"
+                  "B %.3e T (relative %.3e) derivatives %.3e\n",
+                  B_err[0], B_err[0] / B_err[2], B_err[1]);
+    }
 
     return err;
 }
@@ -217,6 +302,10 @@ void B_3DS_init(B_3DS_data* Bdata, B_3DS_offload_data* offload_data,
 
     int B_size = NSIZE_COMP3D * offload_data->Bgrid_n_r
                  * offload_data->Bgrid_n_z * offload_data->Bgrid_n_phi;
+    if(offload_data->single_precision) {
+        /* Coefficients are packed floats */
+        B_size = ( B_size + 1 ) / 2;
+    }
 
     /* Initialize target data struct */
     Bdata->psi0 = offload_data->psi0;
@@ -261,6 +350,14 @@ void B_3DS_init(B_3DS_data* Bdata, B_3DS_offload_data* offload_data,
                              offload_data->Bgrid_z_min,
                              offload_data->Bgrid_z_max);
 
+    if(offload_data->single_precision) {
+        interp3D_data* B[3] = {&Bdata->B_r, &Bdata->B_phi, &Bdata->B_z};
+        for(int i = 0; i < 3; i++) {
+            B[i]->cf = (float*)B[i]->c;
+            B[i]->c  = NULL;
+        }
+    }
+
     interp2Dcomp_init_spline(&Bdata->psi, &(offload_array[3*B_size]),
                              offload_data->psigrid_n_r,
                              offload_data->psigrid_n_z,
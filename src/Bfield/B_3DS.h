@@ -34,6 +34,8 @@ typedef struct {
     real psi1;           /**< Poloidal flux value at separatrix [V*s*m^-1]    */
     real axis_r;         /**< R coordinate of magnetic axis [m]               */
     real axis_z;         /**< z coordinate of magnetic axis [m]               */
+    int single_precision;/**< Store B coefficients in single precision        */
+    int precomputed;     /**< Offload array already contains coefficients     */
     int offload_array_length; /**< Number of elements in offload_array        */
 } B_3DS_offload_data;
 
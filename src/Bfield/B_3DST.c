@@ -0,0 +1,560 @@
+/**
+ * @file B_3DST.c
+ * @brief Time-dependent 3D magnetic field with tricubic spline interpolation
+ *
+ * This module represents a magnetic field that is given as a sequence of
+ * \f$R\phi z\f$-grids, or time slices, on a uniform time grid. Each slice is
+ * interpolated with tricubic splines exactly as in B_3DS, and the field is
+ * interpolated linearly in time between the two slices bracketing the queried
+ * time. The time derivative of the field is the difference of these slices
+ * divided by the slice separation.
+ *
+ * As in B_3DS, the \f$B_R\f$ and \f$B_z\f$ components also have a
+ * contribution from the poloidal magnetic flux \f$\psi(R,z)\f$, which is
+ * axisymmetric, time-independent, and interpolated with bicubic splines.
+ *
+ * Only the slices that the simulation may access need to be resident. The
+ * offload data stores the index of the first resident slice and the number of
+ * resident slices, and the reader (see hdf5_bfield.c) loads only those slices
+ * from the input. Querying a time that is within the input time grid but
+ * outside the resident slices throws an error. Before the first and after the
+ * last slice of the input the field is kept constant.
+ *
+ * This module does no extrapolation in space so if queried value is outside
+ * the \f$Rz\f$-grid an error is thrown. The toroidal angle phi is treated as a
+ * periodic coordinate similarly to B_3DS.
+ *
+ * @see B_field.c B_3DS.c
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include "../math.h"
+#include "../ascot5.h"
+#include "../error.h"
+#include "../print.h"
+#include "B_3DST.h"
+#include "../spline/interp.h"
+
+GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
+static a5err B_3DST_find_slices(int* k0, int* k1, real* w, real* dwdt, real t,
+                                B_3DST_data* Bdata);
+DECLARE_TARGET_END
+
+/**
+ * @brief Initialize magnetic field offload data
+ *
+ * This function takes pre-initialized offload data struct and offload array as
+ * inputs. The data is used to fill rest of the offload struct and to construct
+ * the spline coefficients of each resident time slice. The coefficients are
+ * stored in re-allocated offload array.
+ *
+ * The offload data struct must have the same fields initialized as in
+ * B_3DS_init_offload() and in addition the following:
+ * - B_3DST_offload_data.Bgrid_n_t
+ * - B_3DST_offload_data.Bgrid_t_min
+ * - B_3DST_offload_data.Bgrid_t_max
+ * - B_3DST_offload_data.slice_i0
+ * - B_3DST_offload_data.slice_n
+ *
+ * B_3DST_offload_data.offload_array_length is set here.
+ *
+ * The offload array must contain the following data, where k is the index of
+ * the resident slice and Bn = Bn_r*Bn_z*Bn_phi:
+ * - offload_array[(0*n + k)*Bn + j*Bn_r*Bn_phi + z*Bn_r + i]
+ *   = B_R(R_i, phi_z, z_j, t_k)   [T]
+ * - offload_array[(1*n + k)*Bn + j*Bn_r*Bn_phi + z*Bn_r + i]
+ *   = B_phi(R_i, phi_z, z_j, t_k) [T]
+ * - offload_array[(2*n + k)*Bn + j*Bn_r*Bn_phi + z*Bn_r + i]
+ *   = B_z(R_i, phi_z, z_j, t_k)   [T]
+ * - offload_array[3*n*Bn + j*n_r + i]
+ *   = psi(R_i, z_j)   [V*s*m^-1]
+ *
+ * Sanity checks are printed if data was initialized succesfully.
+ *
+ * @param offload_data pointer to offload data struct
+ * @param offload_array pointer to offload array which is reallocated here
+ *
+ * @return zero if initialization succeeded
+ */
+int B_3DST_init_offload(B_3DST_offload_data* offload_data,
+                        real** offload_array) {
+
+    /* Spline initialization. */
+    int err = 0;
+    int n_slice  = offload_data->slice_n;
+    int psi_size = offload_data->psigrid_n_r * offload_data->psigrid_n_z;
+    int B_size   = offload_data->Bgrid_n_r   * offload_data->Bgrid_n_z
+                   * offload_data->Bgrid_n_phi;
+
+    /* Allocate enough space to store three 3D arrays for each slice and one
+       2D array */
+    real* coeff_array = (real*) malloc(
+        (3*n_slice*NSIZE_COMP3D*B_size + NSIZE_COMP2D*psi_size)*sizeof(real));
+    if(coeff_array == NULL) {
+        print_err("Error: Failed to allocate memory.\n");
+        return 1;
+    }
+    real* psi = &(coeff_array[3*n_slice*B_size*NSIZE_COMP3D]);
+
+    err += interp2Dcomp_init_coeff(
+        psi, *offload_array + 3*n_slice*B_size,
+        offload_data->psigrid_n_r, offload_data->psigrid_n_z,
+        NATURALBC, NATURALBC,
+        offload_data->psigrid_r_min, offload_data->psigrid_r_max,
+        offload_data->psigrid_z_min, offload_data->psigrid_z_max);
+
+    /* Each component of each slice is an independent 3D spline */
+    for(int i = 0; i < 3*n_slice; i++) {
+        err += interp3Dcomp_init_coeff(
+            &(coeff_array[i*B_size*NSIZE_COMP3D]), *offload_array + i*B_size,
+            offload_data->Bgrid_n_r, offload_data->Bgrid_n_phi,
+            offload_data->Bgrid_n_z,
+            NATURALBC, PERIODICBC, NATURALBC,
+            offload_data->Bgrid_r_min,   offload_data->Bgrid_r_max,
+            offload_data->Bgrid_phi_min, offload_data->Bgrid_phi_max,
+            offload_data->Bgrid_z_min,   offload_data->Bgrid_z_max);
+    }
+
+    if(err) {
+        print_err("Error: Failed to initialize splines.\n");
+        free(coeff_array);
+        return err;
+    }
+
+    /* Re-allocate the offload array and store spline coefficients there */
+    free(*offload_array);
+    *offload_array = coeff_array;
+    offload_data->offload_array_length = NSIZE_COMP2D*psi_size
+                                       + NSIZE_COMP3D*B_size*3*n_slice;
+
+    /* Evaluate psi and magnetic field on axis at the first resident slice for
+       checks */
+    real t0 = offload_data->Bgrid_t_min;
+    if(offload_data->Bgrid_n_t > 1) {
+        t0 += offload_data->slice_i0
+            * (offload_data->Bgrid_t_max - offload_data->Bgrid_t_min)
+            / (offload_data->Bgrid_n_t - 1);
+    }
+    B_3DST_data Bdata;
+    B_3DST_init(&Bdata, offload_data, *offload_array);
+    real psival[1], Bval[3];
+    err = B_3DST_eval_psi(psival, offload_data->axis_r, 0,
+                          offload_data->axis_z, &Bdata);
+    if(!err) {
+        err = B_3DST_eval_B(Bval, offload_data->axis_r, 0,
+                            offload_data->axis_z, t0, &Bdata);
+    }
+    if(err) {
+        print_err("Error: Initialization failed.\n");
+        return err;
+    }
+
+    /* Print some sanity check on data */
+    printf("\n3D time-dependent magnetic field (B_3DST)\n");
+    print_out(VERBOSE_IO, "Psi-grid: nR = %4.d Rmin = %3.3f m Rmax = %3.3f m\n",
+              offload_data->psigrid_n_r,
+              offload_data->psigrid_r_min, offload_data->psigrid_r_max);
+    print_out(VERBOSE_IO, "      nz = %4.d zmin = %3.3f m zmax = %3.3f m\n",
+              offload_data->psigrid_n_z,
+              offload_data->psigrid_z_min, offload_data->psigrid_z_max);
+    print_out(VERBOSE_IO, "B-grid: nR = %4.d Rmin = %3.3f m Rmax = %3.3f m\n",
+              offload_data->Bgrid_n_r,
+              offload_data->Bgrid_r_min, offload_data->Bgrid_r_max);
+    print_out(VERBOSE_IO, "      nz = %4.d zmin = %3.3f m zmax = %3.3f m\n",
+              offload_data->Bgrid_n_z,
+              offload_data->Bgrid_z_min, offload_data->Bgrid_z_max);
+    print_out(VERBOSE_IO, "nphi = %4.d phimin = %3.3f deg phimax = %3.3f deg\n",
+              offload_data->Bgrid_n_phi,
+              math_rad2deg(offload_data->Bgrid_phi_min),
+              math_rad2deg(offload_data->Bgrid_phi_max));
+    print_out(VERBOSE_IO, "nt = %4.d tmin = %3.3e s tmax = %3.3e s\n",
+              offload_data->Bgrid_n_t,
+              offload_data->Bgrid_t_min, offload_data->Bgrid_t_max);
+    print_out(VERBOSE_IO, "Resident slices %d - %d (%d of %d)\n",
+              offload_data->slice_i0,
+              offload_data->slice_i0 + offload_data->slice_n - 1,
+              offload_data->slice_n, offload_data->Bgrid_n_t);
+    print_out(VERBOSE_IO, "Psi at magnetic axis (%1.3f m, %1.3f m)\n",
+              offload_data->axis_r, offload_data->axis_z);
+    print_out(VERBOSE_IO, "%3.3f (evaluated)\n%3.3f (given)\n",
+              psival[0], offload_data->psi0);
+    print_out(VERBOSE_IO, "Magnetic field on axis at t = %3.3e s:\n"
+              "B_R = %3.3f B_phi = %3.3f B_z = %3.3f\n",
+              t0, Bval[0], Bval[1], Bval[2]);
+
+    return err;
+}
+
+/**
+ * @brief Free offload array
+ *
+ * @param offload_data pointer to offload data struct
+ * @param offload_array pointer to pointer to offload array
+ */
+void B_3DST_free_offload(B_3DST_offload_data* offload_data,
+                         real** offload_array) {
+    free(*offload_array);
+    *offload_array = NULL;
+}
+
+/**
+ * @brief Initialize magnetic field data struct on target
+ *
+ * @param Bdata pointer to data struct on target
+ * @param offload_data pointer to offload data struct
+ * @param offload_array offload array
+ */
+void B_3DST_init(B_3DST_data* Bdata, B_3DST_offload_data* offload_data,
+                 real* offload_array) {
+
+    int n_slice = offload_data->slice_n;
+    int B_size  = NSIZE_COMP3D * offload_data->Bgrid_n_r
+                  * offload_data->Bgrid_n_z * offload_data->Bgrid_n_phi;
+
+    /* Initialize target data struct */
+    Bdata->psi0       = offload_data->psi0;
+    Bdata->psi1       = offload_data->psi1;
+    Bdata->axis_r     = offload_data->axis_r;
+    Bdata->axis_z     = offload_data->axis_z;
+    Bdata->n_t        = offload_data->Bgrid_n_t;
+    Bdata->t_min      = offload_data->Bgrid_t_min;
+    Bdata->t_max      = offload_data->Bgrid_t_max;
+    Bdata->slice_i0   = offload_data->slice_i0;
+    Bdata->slice_n    = n_slice;
+    Bdata->slice_size = B_size;
+
+    /* Initialize spline structs from the coefficients of the first slice */
+    interp3Dcomp_init_spline(&Bdata->B_r, &(offload_array[0*n_slice*B_size]),
+                             offload_data->Bgrid_n_r,
+                             offload_data->Bgrid_n_phi,
+                             offload_data->Bgrid_n_z,
+                             NATURALBC, PERIODICBC, NATURALBC,
+                             offload_data->Bgrid_r_min,
+                             offload_data->Bgrid_r_max,
+                             offload_data->Bgrid_phi_min,
+                             offload_data->Bgrid_phi_max,
+                             offload_data->Bgrid_z_min,
+                             offload_data->Bgrid_z_max);
+
+    interp3Dcomp_init_spline(&Bdata->B_phi, &(offload_array[1*n_slice*B_size]),
+                             offload_data->Bgrid_n_r,
+                             offload_data->Bgrid_n_phi,
+                             offload_data->Bgrid_n_z,
+                             NATURALBC, PERIODICBC, NATURALBC,
+                             offload_data->Bgrid_r_min,
+                             offload_data->Bgrid_r_max,
+                             offload_data->Bgrid_phi_min,
+                             offload_data->Bgrid_phi_max,
+                             offload_data->Bgrid_z_min,
+                             offload_data->Bgrid_z_max);
+
+    interp3Dcomp_init_spline(&Bdata->B_z, &(offload_array[2*n_slice*B_size]),
+                             offload_data->Bgrid_n_r,
+                             offload_data->Bgrid_n_phi,
+                             offload_data->Bgrid_n_z,
+                             NATURALBC, PERIODICBC, NATURALBC,
+                             offload_data->Bgrid_r_min,
+                             offload_data->Bgrid_r_max,
+                             offload_data->Bgrid_phi_min,
+                             offload_data->Bgrid_phi_max,
+                             offload_data->Bgrid_z_min,
+                             offload_data->Bgrid_z_max);
+
+    interp2Dcomp_init_spline(&Bdata->psi, &(offload_array[3*n_slice*B_size]),
+                             offload_data->psigrid_n_r,
+                             offload_data->psigrid_n_z,
+                             NATURALBC, NATURALBC,
+                             offload_data->psigrid_r_min,
+                             offload_data->psigrid_r_max,
+                             offload_data->psigrid_z_min,
+                             offload_data->psigrid_z_max);
+}
+
+/**
+ * @brief Find the resident time slices bracketing the given time
+ *
+ * The field at time t is (1-w)*B[k0] + w*B[k1] and its time derivative
+ * (B[k1] - B[k0])*dwdt, where k0 and k1 are indices of the resident slices.
+ *
+ * @param k0 pointer where index of the preceding resident slice is stored
+ * @param k1 pointer where index of the following resident slice is stored
+ * @param w pointer where the interpolation weight is stored
+ * @param dwdt pointer where the time derivative of the weight is stored
+ * @param t time coordinate [s]
+ * @param Bdata pointer to magnetic field data struct
+ *
+ * @return Non-zero a5err value if the slices are not resident
+ */
+static a5err B_3DST_find_slices(int* k0, int* k1, real* w, real* dwdt, real t,
+                                B_3DST_data* Bdata) {
+    int i_t = 0;
+    *w    = 0;
+    *dwdt = 0;
+    if(Bdata->n_t > 1) {
+        real t_grid = (Bdata->t_max - Bdata->t_min) / (Bdata->n_t - 1);
+        if(t >= Bdata->t_max) {
+            /* Field is constant after the last slice */
+            i_t = Bdata->n_t - 2;
+            *w  = 1;
+        }
+        else if(t > Bdata->t_min) {
+            i_t = (t - Bdata->t_min) / t_grid;
+            i_t = i_t > Bdata->n_t - 2 ? Bdata->n_t - 2 : i_t;
+            *w    = ( t - (Bdata->t_min + i_t*t_grid) ) / t_grid;
+            *dwdt = 1.0 / t_grid;
+        }
+    }
+
+    *k0 = i_t - Bdata->slice_i0;
+    if(*k0 == Bdata->slice_n - 1 && *k0 > 0 && *w == 0) {
+        /* Time is exactly at the last resident slice */
+        *k0 -= 1;
+        *w   = 1;
+    }
+    *k1 = *k0 + (Bdata->n_t > 1);
+    if(*k0 < 0 || *k1 >= Bdata->slice_n) {
+        return error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_B_3DST );
+    }
+    return 0;
+}
+
+/**
+ * @brief Evaluate poloidal flux psi
+ *
+ * @param psi pointer where psi [V*s*m^-1] value will be stored
+ * @param r R coordinate [m]
+ * @param phi phi coordinate [rad]
+ * @param z z coordinate [m]
+ * @param Bdata pointer to magnetic field data struct
+ *
+ * @return Non-zero a5err value if evaluation failed, zero otherwise
+ */
+a5err B_3DST_eval_psi(real* psi, real r, real phi, real z,
+                      B_3DST_data* Bdata) {
+    a5err err = 0;
+    int interperr = 0; /* If error happened during interpolation */
+    interperr += interp2Dcomp_eval_f(&psi[0], &Bdata->psi, r, z);
+
+    if(interperr) {
+        err = error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_B_3DST );
+    }
+
+    return err;
+}
+
+/**
+ * @brief Evaluate poloidal flux psi and its derivatives
+ *
+ * @param psi_dpsi pointer for storing psi [V*s*m^-1] and its derivatives
+ * @param r R coordinate [m]
+ * @param phi phi coordinate [rad]
+ * @param z z coordinate [m]
+ * @param Bdata pointer to magnetic field data struct
+ *
+ * @return Non-zero a5err value if evaluation failed, zero otherwise
+ */
+a5err B_3DST_eval_psi_dpsi(real psi_dpsi[4], real r, real phi, real z,
+                           B_3DST_data* Bdata) {
+    a5err err = 0;
+    int interperr = 0;
+    real psi_dpsi_temp[6];
+
+    interperr += interp2Dcomp_eval_df(psi_dpsi_temp, &Bdata->psi, r, z);
+
+    psi_dpsi[0] = psi_dpsi_temp[0];
+    psi_dpsi[1] = psi_dpsi_temp[1];
+    psi_dpsi[2] = 0;
+    psi_dpsi[3] = psi_dpsi_temp[2];
+
+    if(interperr) {
+        err = error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_B_3DST );
+    }
+
+    return err;
+}
+
+/**
+ * @brief Evaluate normalized poloidal flux rho and its derivatives
+ *
+ * @param rho_drho pointer where rho and its derivatives will be stored
+ * @param r R coordinate [m]
+ * @param phi phi coordinate [rad]
+ * @param z z coordinate [m]
+ * @param Bdata pointer to magnetic field data struct
+ *
+ * @return Non-zero a5err value if evaluation failed, zero otherwise
+ */
+a5err B_3DST_eval_rho_drho(real rho_drho[4], real r, real phi, real z,
+                           B_3DST_data* Bdata) {
+    int interperr = 0; /* If error happened during interpolation */
+    real psi_dpsi[6];
+
+    interperr += interp2Dcomp_eval_df(psi_dpsi, &Bdata->psi, r, z);
+
+    if(interperr) {
+        return error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_B_3DST );
+    }
+
+    /* Check that the values seem valid */
+    real delta = Bdata->psi1 - Bdata->psi0;
+    if( (psi_dpsi[0] - Bdata->psi0) / delta < 0 ) {
+         return error_raise( ERR_INPUT_UNPHYSICAL, __LINE__, EF_B_3DST );
+    }
+
+    /* Normalize psi to get rho */
+    rho_drho[0] = sqrt(fabs((psi_dpsi[0] - Bdata->psi0) / delta));
+
+    rho_drho[1] = psi_dpsi[1] / (2*delta*rho_drho[0]);
+    rho_drho[2] = 0;
+    rho_drho[3] = psi_dpsi[2] / (2*delta*rho_drho[0]);
+
+    return 0;
+}
+
+/**
+ * @brief Evaluate magnetic field
+ *
+ * @param B pointer to array where magnetic field values are stored
+ * @param r R coordinate [m]
+ * @param phi phi coordinate [rad]
+ * @param z z coordinate [m]
+ * @param t time coordinate [s]
+ * @param Bdata pointer to magnetic field data struct
+ *
+ * @return Non-zero a5err value if evaluation failed, zero otherwise
+ */
+a5err B_3DST_eval_B(real B[3], real r, real phi, real z, real t,
+                    B_3DST_data* Bdata) {
+    int k0, k1;
+    real w, dwdt;
+    a5err err = B_3DST_find_slices(&k0, &k1, &w, &dwdt, t, Bdata);
+    if(err) {
+        return err;
+    }
+
+    int interperr = 0;
+    interp3D_data* comp[3] = {&Bdata->B_r, &Bdata->B_phi, &Bdata->B_z};
+    for(int i = 0; i < 3; i++) {
+        real B0, B1;
+        interp3D_data slice = *comp[i];
+        slice.c = comp[i]->c + k0*Bdata->slice_size;
+        interperr += interp3Dcomp_eval_f(&B0, &slice, r, phi, z);
+        slice.c = comp[i]->c + k1*Bdata->slice_size;
+        interperr += interp3Dcomp_eval_f(&B1, &slice, r, phi, z);
+        B[i] = (1 - w) * B0 + w * B1;
+    }
+
+    /* Test for B field interpolation error */
+    if(interperr) {
+        err = error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_B_3DST );
+    }
+
+    if(!err) {
+        real psi_dpsi[6];
+        interperr += interp2Dcomp_eval_df(psi_dpsi, &Bdata->psi, r, z);
+
+        B[0] = B[0] - psi_dpsi[2]/r;
+        B[2] = B[2] + psi_dpsi[1]/r;
+
+        /* Test for psi interpolation error */
+        if(interperr) {
+            err = error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_B_3DST );
+        }
+    }
+
+    /* Check that magnetic field seems valid */
+    int check = 0;
+    check += ((B[0]*B[0] + B[1]*B[1] + B[2]*B[2]) == 0);
+    if(!err && check) {
+        err = error_raise( ERR_INPUT_UNPHYSICAL, __LINE__, EF_B_3DST );
+    }
+
+    return err;
+}
+
+/**
+ * @brief Evaluate magnetic field and its derivatives
+ *
+ * Unlike the static fields, this function also evaluates the time derivatives
+ * B_dB[12], B_dB[13], and B_dB[14].
+ *
+ * @param B_dB pointer to array where the field and its derivatives are stored
+ * @param r R coordinate [m]
+ * @param phi phi coordinate [rad]
+ * @param z z coordinate [m]
+ * @param t time coordinate [s]
+ * @param Bdata pointer to magnetic field data struct
+ *
+ * @return Non-zero a5err value if evaluation failed, zero otherwise
+ */
+a5err B_3DST_eval_B_dB(real B_dB[15], real r, real phi, real z, real t,
+                       B_3DST_data* Bdata) {
+    int k0, k1;
+    real w, dwdt;
+    a5err err = B_3DST_find_slices(&k0, &k1, &w, &dwdt, t, Bdata);
+    if(err) {
+        return err;
+    }
+
+    int interperr = 0; /* If error happened during interpolation */
+    interp3D_data* comp[3] = {&Bdata->B_r, &Bdata->B_phi, &Bdata->B_z};
+    for(int i = 0; i < 3; i++) {
+        real B0[10], B1[10];
+        interp3D_data slice = *comp[i];
+        slice.c = comp[i]->c + k0*Bdata->slice_size;
+        interperr += interp3Dcomp_eval_df(B0, &slice, r, phi, z);
+        slice.c = comp[i]->c + k1*Bdata->slice_size;
+        interperr += interp3Dcomp_eval_df(B1, &slice, r, phi, z);
+        for(int j = 0; j < 4; j++) {
+            B_dB[4*i + j] = (1 - w) * B0[j] + w * B1[j];
+        }
+        B_dB[12 + i] = (B1[0] - B0[0]) * dwdt;
+    }
+
+    /* Test for B field interpolation error */
+    if(interperr) {
+        err = error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_B_3DST );
+    }
+
+    if(!err) {
+        real psi_dpsi[6];
+        interperr += interp2Dcomp_eval_df(psi_dpsi, &Bdata->psi, r, z);
+
+        B_dB[0] = B_dB[0] - psi_dpsi[2]/r;
+        B_dB[1] = B_dB[1] + psi_dpsi[2]/(r*r)-psi_dpsi[5]/r;
+        B_dB[3] = B_dB[3] - psi_dpsi[4]/r;
+        B_dB[8] = B_dB[8] + psi_dpsi[1]/r;
+        B_dB[9] = B_dB[9] - psi_dpsi[1]/(r*r) + psi_dpsi[3]/r;
+        B_dB[11] = B_dB[11] + psi_dpsi[5]/r;
+
+        /* Test for psi interpolation error */
+        if(interperr) {
+            err = error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_B_3DST );
+        }
+    }
+
+    /* Check that magnetic field seems valid */
+    int check = 0;
+    check += ((B_dB[0]*B_dB[0] + B_dB[4]*B_dB[4] + B_dB[8]*B_dB[8]) == 0);
+    if(!err && check) {
+        err = error_raise( ERR_INPUT_UNPHYSICAL, __LINE__, EF_B_3DST );
+    }
+
+    return err;
+}
+
+/**
+ * @brief Return magnetic axis R-coordinate
+ *
+ * @param rz pointer where axis R and z [m] values will be stored
+ * @param Bdata pointer to magnetic field data struct
+ *
+ * @return Zero a5err value as this function can't fail.
+ */
+a5err B_3DST_get_axis_rz(real rz[2], B_3DST_data* Bdata) {
+    a5err err = 0;
+    rz[0] = Bdata->axis_r;
+    rz[1] = Bdata->axis_z;
+    return err;
+}
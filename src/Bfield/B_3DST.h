@@ -0,0 +1,98 @@
+/**
+ * @file B_3DST.h
+ * @brief Header file for B_3DST.c
+ */
+#ifndef B_3DST_H
+#define B_3DST_H
+#include "../offload_acc_omp.h"
+#include "../ascot5.h"
+#include "../error.h"
+#include "../spline/interp.h"
+
+/**
+ * @brief Time-dependent 3D magnetic field parameters on the host
+ */
+typedef struct {
+    int psigrid_n_r;     /**< Number of R grid points in psi data             */
+    int psigrid_n_z;     /**< Number of z grid points in psi data             */
+    real psigrid_r_min;  /**< Minimum R grid point in psi data [m]            */
+    real psigrid_r_max;  /**< Maximum R grid point in psi data [m]            */
+    real psigrid_z_min;  /**< Minimum z grid point in psi data [m]            */
+    real psigrid_z_max;  /**< Maximum z grid point in psi data [m]            */
+
+    int Bgrid_n_r;       /**< Number of R grid points in B data               */
+    int Bgrid_n_z;       /**< Number of z grid points in B data               */
+    real Bgrid_r_min;    /**< Minimum R coordinate in the grid in B data [m]  */
+    real Bgrid_r_max;    /**< Maximum R coordinate in the grid in B data [m]  */
+    real Bgrid_z_min;    /**< Minimum z coordinate in the grid in B data [m]  */
+    real Bgrid_z_max;    /**< Maximum z coordinate in the grid in B data [m]  */
+    int Bgrid_n_phi;     /**< Number of phi grid points in B data             */
+    real Bgrid_phi_min;  /**< Minimum phi grid point in B data [rad]          */
+    real Bgrid_phi_max;  /**< Maximum phi grid point in B data [rad]          */
+    int Bgrid_n_t;       /**< Number of time slices in the input data         */
+    real Bgrid_t_min;    /**< Time of the first slice in the input data [s]   */
+    real Bgrid_t_max;    /**< Time of the last slice in the input data [s]    */
+
+    int slice_i0;        /**< Index of the first resident time slice          */
+    int slice_n;         /**< Number of resident time slices                  */
+
+    real psi0;           /**< Poloidal flux value at magnetic axis [v*s*m^-1] */
+    real psi1;           /**< Poloidal flux value at separatrix [V*s*m^-1]    */
+    real axis_r;         /**< R coordinate of magnetic axis [m]               */
+    real axis_z;         /**< z coordinate of magnetic axis [m]               */
+    int offload_array_length; /**< Number of elements in offload_array        */
+} B_3DST_offload_data;
+
+/**
+ * @brief Time-dependent 3D magnetic field parameters on the target
+ *
+ * The spline structs describe the first resident time slice. Coefficients of
+ * the subsequent slices follow contiguously, slice_size elements apart.
+ */
+typedef struct {
+    real psi0;           /**< Poloidal flux value at magnetic axis [v*s*m^-1] */
+    real psi1;           /**< Poloidal flux value at separatrix [V*s*m^-1]    */
+    real axis_r;         /**< R coordinate of magnetic axis [m]               */
+    real axis_z;         /**< z coordinate of magnetic axis [m]               */
+    int n_t;             /**< Number of time slices in the input data         */
+    real t_min;          /**< Time of the first slice in the input data [s]   */
+    real t_max;          /**< Time of the last slice in the input data [s]    */
+    int slice_i0;        /**< Index of the first resident time slice          */
+    int slice_n;         /**< Number of resident time slices                  */
+    int slice_size;      /**< Number of coefficients per component and slice  */
+    interp2D_data psi;   /**< 2D psi interpolation data struct                */
+    interp3D_data B_r;   /**< 3D B_r interpolation data struct (first slice)  */
+    interp3D_data B_phi; /**< 3D B_phi interpolation data struct (first slice)*/
+    interp3D_data B_z;   /**< 3D B_z interpolation data struct (first slice)  */
+} B_3DST_data;
+
+int B_3DST_init_offload(B_3DST_offload_data* offload_data,
+                        real** offload_array);
+void B_3DST_free_offload(B_3DST_offload_data* offload_data,
+                         real** offload_array);
+
+void B_3DST_init(B_3DST_data* Bdata, B_3DST_offload_data* offload_data,
+                 real* offload_array);
+GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
+a5err B_3DST_eval_psi(real* psi, real r, real phi, real z, B_3DST_data* Bdata);
+DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
+a5err B_3DST_eval_psi_dpsi(real psi_dpsi[4], real r, real phi, real z,
+                           B_3DST_data* Bdata);
+DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
+a5err B_3DST_eval_rho_drho(real rho_drho[4], real r, real phi, real z,
+                           B_3DST_data* Bdata);
+DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
+a5err B_3DST_eval_B(real B[3], real r, real phi, real z, real t,
+                    B_3DST_data* Bdata);
+DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
+a5err B_3DST_eval_B_dB(real B_dB[15], real r, real phi, real z, real t,
+                       B_3DST_data* Bdata);
+DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(Bdata)
+a5err B_3DST_get_axis_rz(real rz[2], B_3DST_data* Bdata);
+DECLARE_TARGET_END
+#endif
@@ -39,63 +39,21 @@
 #include "../spline/interp.h"
 
 /**
- * @brief Initialize magnetic field offload data
- *
- * This function takes pre-initialized offload data struct and offload array as
- * inputs. The data is used to fill rest of the offload struct and to construct
- * bicubic splines whose coefficients are stored in re-allocated offload array.
- *
- * The offload data struct must have the following fields initialized:
- * - B_STS_offload_data.psigrid_n_r
- * - B_STS_offload_data.psigrid_n_z
- * - B_STS_offload_data.psigrid_r_min
- * - B_STS_offload_data.psigrid_r_max
- * - B_STS_offload_data.psigrid_z_min
- * - B_STS_offload_data.psigrid_z_max
- *
- * - B_STS_offload_data.Bgrid_n_r
- * - B_STS_offload_data.Bgrid_n_z
- * - B_STS_offload_data.Bgrid_r_min
- * - B_STS_offload_data.Bgrid_r_max
- * - B_STS_offload_data.Bgrid_z_min
- * - B_STS_offload_data.Bgrid_z_max
- * - B_STS_offload_data.Bgrid_n_phi
- * - B_STS_offload_data.Bgrid_phi_min
- * - B_STS_offload_data.Bgrid_phi_max
- *
- * - B_STS_offload_data.n_axis
- * - B_STS_offload_data.axis_min
- * - B_STS_offload_data.axis_max
- *
- * - B_STS_offload_data.psi0
- * - B_STS_offload_data.psi1
- * - B_STS_offload_data.axis_r
- * - B_STS_offload_data.axis_z
- *
- * B_STS_offload_data.offload_array_length is set here.
+ * @brief Evaluate spline coefficients and store them in the offload array
  *
- * The offload array must contain the following data:
- * - offload_array[                     z*Bn_r*Bn_z + j*Bn_r + i]
- *   = B_R(R_i, phi_z, z_j)   [T]
- * - offload_array[  Bn_r*Bn_z*Bn_phi + z*Bn_r*Bn_z + j*Bn_r + i]
- *   = B_phi(R_i, phi_z, z_j)   [T]
- * - offload_array[2*Bn_r*Bn_z*Bn_phi + z*Bn_r*Bn_z + j*Bn_r + i]
- *   = B_z(R_i, phi_z, z_j)   [T]
- * - offload_array[3*Bn_r*Bn_z*Bn_phi + z*psin_r*psin_z + j*psin_r + i]
- *   = psi(R_i, phi_z, z_j)   [V*s*m^-1]
- * - offload_array[3*Bn_r*Bn_z*Bn_phi + psin_r*psin_z*psin_phi + z]
- *   = axis_R(phi_z)   [m]
- * - offload_array[3*Bn_r*Bn_z*Bn_phi + psin_r*psin_z*psin_phi + n_axis + z]
- *   = axis_z(phi_z)   [m]
- *
- * Sanity checks are printed if data was initialized succesfully.
+ * The offload array containing the input data is replaced with the
+ * coefficient array, converted to single precision if requested.
  *
  * @param offload_data pointer to offload data struct
  * @param offload_array pointer to offload array which is reallocated here
+ * @param B_err array where the single precision error of B is stored
+ * @param psi_err array where the single precision error of psi is stored
  *
  * @return zero if initialization succeeded
  */
-int B_STS_init_offload(B_STS_offload_data* offload_data, real** offload_array) {
+static int B_STS_init_coeff(B_STS_offload_data* offload_data,
+                            real** offload_array, real B_err[3],
+                            real psi_err[3]) {
 
     /* Spline initialization. */
     int err = 0;
@@ -170,6 +128,135 @@ int B_STS_init_offload(B_STS_offload_data* offload_data, real** offload_array) {
                                          + NSIZE_COMP3D*psi_size
                                          + 2*axis_size;
 
+    /* Convert B and psi coefficients to single precision. Each spline then
+       takes half the space and the floats are packed in the offload array. */
+    if(offload_data->single_precision) {
+        int B_length   = ( NSIZE_COMP3D*B_size + 1 ) / 2;
+        int psi_length = ( NSIZE_COMP3D*psi_size + 1 ) / 2;
+        real* single_array = (real*) malloc(
+            (3*B_length + psi_length + 2*axis_size)*sizeof(real) );
+        for(int i = 0; i < 3; i++) {
+            err += interp3Dcomp_compress_coeff(
+                (float*)&(single_array[i*B_length]),
+                &(coeff_array[i*B_size*NSIZE_COMP3D]), NSIZE_COMP3D*B_size);
+        }
+        err += interp3Dcomp_compress_coeff(
+            (float*)&(single_array[3*B_length]), psi, NSIZE_COMP3D*psi_size);
+        memcpy(&(single_array[3*B_length + psi_length]), axis_r,
+               2*axis_size*sizeof(real));
+
+        /* Compare to the double precision splines */
+        B_STS_data Bdouble, Bsingle;
+        offload_data->single_precision = 0;
+        B_STS_init(&Bdouble, offload_data, coeff_array);
+        offload_data->single_precision = 1;
+        B_STS_init(&Bsingle, offload_data, single_array);
+        interp3D_data* Bd[3] = {&Bdouble.B_r, &Bdouble.B_phi, &Bdouble.B_z};
+        interp3D_data* Bs[3] = {&Bsingle.B_r, &Bsingle.B_phi, &Bsingle.B_z};
+        for(int i = 0; i < 3; i++) {
+            real cerr[3];
+            interp3Dcomp_compress_error(cerr, Bd[i], Bs[i]);
+            B_err[0] = fmax(B_err[0], cerr[0]);
+            B_err[1] = fmax(B_err[1], cerr[1]);
+            B_err[2] = fmax(B_err[2], cerr[2]);
+        }
+        interp3Dcomp_compress_error(psi_err, &Bdouble.psi, &Bsingle.psi);
+        real dpsi = fabs(offload_data->psi1 - offload_data->psi0);
+        if( err || B_err[0]   > INTERP_SINGLE_PRECISION_TOL * B_err[2]
+                || psi_err[0] > INTERP_SINGLE_PRECISION_TOL * dpsi ) {
+            print_err("Error: Single precision coefficients are not "
+                      "accurate enough.\n");
+            free(single_array);
+            return 1;
+        }
+
+        free(*offload_array);
+        *offload_array = single_array;
+        offload_data->offload_array_length = 3*B_length + psi_length
+                                             + 2*axis_size;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Initialize magnetic field offload data
+ *
+ * This function takes pre-initialized offload data struct and offload array as
+ * inputs. The data is used to fill rest of the offload struct and to construct
+ * bicubic splines whose coefficients are stored in re-allocated offload array.
+ *
+ * The offload data struct must have the following fields initialized:
+ * - B_STS_offload_data.psigrid_n_r
+ * - B_STS_offload_data.psigrid_n_z
+ * - B_STS_offload_data.psigrid_r_min
+ * - B_STS_offload_data.psigrid_r_max
+ * - B_STS_offload_data.psigrid_z_min
+ * - B_STS_offload_data.psigrid_z_max
+ *
+ * - B_STS_offload_data.Bgrid_n_r
+ * - B_STS_offload_data.Bgrid_n_z
+ * - B_STS_offload_data.Bgrid_r_min
+ * - B_STS_offload_data.Bgrid_r_max
+ * - B_STS_offload_data.Bgrid_z_min
+ * - B_STS_offload_data.Bgrid_z_max
+ * - B_STS_offload_data.Bgrid_n_phi
+ * - B_STS_offload_data.Bgrid_phi_min
+ * - B_STS_offload_data.Bgrid_phi_max
+ *
+ * - B_STS_offload_data.n_axis
+ * - B_STS_offload_data.axis_min
+ * - B_STS_offload_data.axis_max
+ *
+ * - B_STS_offload_data.psi0
+ * - B_STS_offload_data.psi1
+ * - B_STS_offload_data.axis_r
+ * - B_STS_offload_data.axis_z
+ *
+ * B_STS_offload_data.offload_array_length is set here.
+ *
+ * If B_STS_offload_data.single_precision is set, the coefficients of B_R,
+ * B_phi, B_z, and psi are stored in single precision which halves their memory
+ * footprint. The resulting interpolation error is measured here and the
+ * initialization fails if it exceeds INTERP_SINGLE_PRECISION_TOL relative to
+ * the maximum field strength or to psi1 - psi0.
+ *
+ * The offload array must contain the following data:
+ * - offload_array[                     z*Bn_r*Bn_z + j*Bn_r + i]
+ *   = B_R(R_i, phi_z, z_j)   [T]
+ * - offload_array[  Bn_r*Bn_z*Bn_phi + z*Bn_r*Bn_z + j*Bn_r + i]
+ *   = B_phi(R_i, phi_z, z_j)   [T]
+ * - offload_array[2*Bn_r*Bn_z*Bn_phi + z*Bn_r*Bn_z + j*Bn_r + i]
+ *   = B_z(R_i, phi_z, z_j)   [T]
+ * - offload_array[3*Bn_r*Bn_z*Bn_phi + z*psin_r*psin_z + j*psin_r + i]
+ *   = psi(R_i, phi_z, z_j)   [V*s*m^-1]
+ * - offload_array[3*Bn_r*Bn_z*Bn_phi + psin_r*psin_z*psin_phi + z]
+ *   = axis_R(phi_z)   [m]
+ * - offload_array[3*Bn_r*Bn_z*Bn_phi + psin_r*psin_z*psin_phi + n_axis + z]
+ *   = axis_z(phi_z)   [m]
+ *
+ * If B_STS_offload_data.precomputed is set, the offload array already contains
+ * the (possibly single precision) spline coefficients, e.g. read from a cache,
+ * and they are used as such.
+ *
+ * Sanity checks are printed if data was initialized succesfully.
+ *
+ * @param offload_data pointer to offload data struct
+ * @param offload_array pointer to offload array which is reallocated here
+ *
+ * @return zero if initialization succeeded
+ */
+int B_STS_init_offload(B_STS_offload_data* offload_data, real** offload_array) {
+
+    int err = 0;
+    real B_err[3] = {0, 0, 0}, psi_err[3] = {0, 0, 0};
+    if(!offload_data->precomputed) {
+        err = B_STS_init_coeff(offload_data, offload_array, B_err, psi_err);
+        if(err) {
+            return err;
+        }
+    }
+
     /* Evaluate psi and magnetic field on axis for checks */
     B_STS_data Bdata;
     B_STS_init(&Bdata, offload_data, *offload_array);
@@ -212,6 +299,13 @@ int B_STS_init_offload(B_STS_offload_data* offload_data, real** offload_array) {
     print_out(VERBOSE_IO, "Magnetic field on axis:\n"
               "B_R = %3.3f B_phi = %3.3f B_z = %3.3f\n",
               Bval[0], Bval[1], Bval[2]);
+    if(offload_data->single_precision && !offload_data->precomputed) {
+        print_out(VERBOSE_IO, "Single precision coefficients, max error:\n"
+                  "B %.3e T (relative %.3e) derivatives %.3e\n"
+                  "psi %.3e V*s*m^-1 (relative to psi1-psi0 %.3e)\n",
+                  B_err[0], B_err[0] / B_err[2], B_err[1], psi_err[0],
+                  psi_err[0] / fabs(offload_data->psi1 - offload_data->psi0));
+    }
 
     return 0;
 }
@@ -242,6 +336,11 @@ void B_STS_init(B_STS_data* Bdata, B_STS_offload_data* offload_data,
     int psi_size = offload_data->psigrid_n_r * offload_data->psigrid_n_z
         * offload_data->psigrid_n_phi*NSIZE_COMP3D;
     int axis_size = offload_data->n_axis;
+    if(offload_data->single_precision) {
+        /* Coefficients are packed floats */
+        B_size   = ( B_size + 1 ) / 2;
+        psi_size = ( psi_size + 1 ) / 2;
+    }
 
     /* Initialize target data struct */
     Bdata->psi0 = offload_data->psi0;
@@ -297,6 +396,15 @@ void B_STS_init(B_STS_data* Bdata, B_STS_offload_data* offload_data,
                              offload_data->psigrid_z_min,
                              offload_data->psigrid_z_max);
 
+    if(offload_data->single_precision) {
+        interp3D_data* spl[4] = {&Bdata->B_r, &Bdata->B_phi, &Bdata->B_z,
+                                 &Bdata->psi};
+        for(int i = 0; i < 4; i++) {
+            spl[i]->cf = (float*)spl[i]->c;
+            spl[i]->c  = NULL;
+        }
+    }
+
     linint1D_init(&Bdata->axis_r,
                   &(offload_array[3*B_size + psi_size]),
                   offload_data->n_axis, PERIODICBC,
@@ -35,6 +35,8 @@ typedef struct {
 
     real psi0;           /**< Poloidal flux value at magnetic axis [V*s*m^-1] */
     real psi1;           /**< Poloidal flux value at separatrix [V*s*m^-1]    */
+    int single_precision;/**< Store B and psi coefficients in single precision*/
+    int precomputed;     /**< Offload array already contains coefficients     */
     int offload_array_length; /**< Number of elements in offload_array        */
 
     int n_axis;          /**< Number of phi grid points in axis data          */
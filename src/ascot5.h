@@ -26,8 +26,11 @@
  *
  * Available parameters:
  *
- *  - NSIMD=n   number of particles in a group (default 16); these are
- *              processed simultaneously by each thread
+ *  - NSIMD=n   maximum number of particles in a group (default 16); these
+ *              are processed simultaneously by each thread and the number
+ *              actually used is set with the SIMD_WIDTH option
+ *  - MULTIARCH=1 compile the simulation kernels for AVX2 and AVX-512 in
+ *              addition to the baseline and select one at run time
  *  - CC=...    compiler (default icc)
  *  - TARGET=1  Offload computation to Xeon Phi accelerator
  *  - VERBOSE=n print increasing amounts of progress information:
@@ -91,6 +94,21 @@ typedef double real;  /**< Double precision float   */
 #define NSIMD 16
 #endif
 
+/** @brief Compile the marker integration kernels for several instruction sets
+ *         and select the variant matching the CPU at run time
+ *
+ * The SIMD loops of a kernel compiled for a wider instruction set use the
+ * corresponding variants of the functions declared with DECLARE_TARGET_SIMD.
+ * Enabled with MULTIARCH=1, which requires GCC and glibc.
+ */
+#if defined(MULTIARCH) && !defined(GPU)
+#define A5_TARGET_CLONES \
+    __attribute__((target_clones("default", "arch=haswell", \
+                                 "arch=skylake-avx512")))
+#else
+#define A5_TARGET_CLONES
+#endif
+
 /** @brief Maximum number of plasma species */
 #define MAX_SPECIES 8
 
@@ -127,10 +145,17 @@ typedef double real;  /**< Double precision float   */
  *  with an explicit (1) or compact (0) way */
 #define INTERP_SPL_EXPL 0
 
+/** @brief Maximum interpolation error, relative to the maximum value of the
+ *  data, allowed when spline coefficients are stored in single precision */
+#define INTERP_SINGLE_PRECISION_TOL 1e-5
+
 /** @brief Choose whether to use tabulated values for collision coefficients */
 #define A5_CCOL_USE_TABULATED 0
 
 /** @brief Default depth of octree struct */
 #define WALL_OCTREE_DEPTH 7
 
+/** @brief Number of cells in the wall distance map, zero disables the map */
+#define WALL_DMAP_NCELL 262144
+
 #endif
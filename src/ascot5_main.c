@@ -41,6 +41,16 @@
  * run (between [0, size-1]). Running the program this way does not use MPI.
  * This is intended to be used in Condor-like environments.
  *
+ * When MPI is used, only the root process reads the input file and the input
+ * is broadcast to the other processes. The input data can also be shared between processes on the same
+ * node with
+ *
+ *     ascot5_main --mpi_shmem=1
+ *
+ * in which case the input is broadcast to one process per node only and the
+ * rest map the same data from a shared memory window instead of holding their
+ * own copies.
+ *
  * You can add a description of the simulation as:
  *
  * ascot5_main --d="This is a test run"
@@ -79,6 +89,13 @@
 #include <fenv.h>
 #endif
 
+/** Markers whose wall-clock time exceeds the mean by this factor are listed
+    in the marker summary                                                   */
+#define STRAGGLER_FACTOR 10
+
+/** Maximum number of markers listed in the marker summary as stragglers    */
+#define STRAGGLER_NPRINT 10
+
 int read_arguments(int argc, char** argv, sim_offload_data* sim);
 
 /**
@@ -120,7 +137,8 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    if(sim.mpi_size > 0) {
+    int pseudo_mpi = sim.mpi_size > 0;
+    if(pseudo_mpi) {
         /* This is a pseudo-mpi run, where rank and size were set on the command
          * line. Only set root equal to rank since there are no other processes
          */
@@ -158,47 +176,111 @@ int main(int argc, char** argv) {
     real* asigma_offload_array;
     real* diag_offload_array;
 
-    /* Read input from the HDF5 file */
-    if( hdf5_interface_read_input(&sim,
-                                  hdf5_input_options | hdf5_input_bfield |
-                                  hdf5_input_efield  | hdf5_input_plasma |
-                                  hdf5_input_neutral | hdf5_input_wall   |
-                                  hdf5_input_marker  | hdf5_input_boozer |
-                                  hdf5_input_mhd     | hdf5_input_asigma,
+    /* With shared memory, only one process per node holds the packed input
+     * data, and the rest receive only options and markers */
+    int node_rank = 0;
+    if(sim.mpi_shmem) {
+#ifdef MPI
+        if(pseudo_mpi) {
+            print_out0(VERBOSE_MINIMAL, sim.mpi_rank, sim.mpi_root,
+                       "--mpi_shmem requires MPI and is ignored when "
+                       "--mpi_size is given.\n");
+            sim.mpi_shmem = 0;
+        }
+        else {
+            mpi_interface_shmem_init(&node_rank);
+        }
+#else
+        print_out0(VERBOSE_MINIMAL, sim.mpi_rank, sim.mpi_root,
+                   "Compiled without MPI, --mpi_shmem is ignored.\n");
+        sim.mpi_shmem = 0;
+#endif
+    }
+
+    /* With MPI, only the root process reads the input and broadcasts it to
+     * the rest. Pseudo-mpi runs are independent processes that all read. */
+    int bcast_input = 0;
+#ifdef MPI
+    bcast_input = !pseudo_mpi && sim.mpi_size > 1;
+#endif
+    int reader = !bcast_input || sim.mpi_rank == sim.mpi_root;
+
+    int input_active = 0;
+    if(reader) {
+        input_active = hdf5_input_options | hdf5_input_marker;
+    }
+    if(reader && node_rank == 0) {
+        input_active |= hdf5_input_bfield  | hdf5_input_efield |
+                        hdf5_input_plasma  | hdf5_input_neutral |
+                        hdf5_input_wall    | hdf5_input_boozer |
+                        hdf5_input_mhd     | hdf5_input_asigma;
+    }
+
+    /* Read input from the HDF5 file and combine input offload arrays to one.
+     * With broadcast input, the other processes are waiting for the root in
+     * mpi_interface_bcast_input(), so the root tells them first whether it
+     * succeeded and all processes quit together if it did not. */
+    int input_err = 0;
+    offload_package offload_data;
+    real* offload_array = NULL;
+    int* int_offload_array = NULL;
+    if( input_active && hdf5_interface_read_input(&sim, input_active,
                                   &B_offload_array, &E_offload_array,
                                   &plasma_offload_array, &neutral_offload_array,
                                   &wall_offload_array,  &wall_int_offload_array,
                                   &boozer_offload_array, &mhd_offload_array,
                                   &asigma_offload_array, NULL,
                                   &p, &n_tot) ) {
+        input_err = 1;
+    }
+    else if( reader && node_rank == 0 && pack_offload_array(
+            &sim, &offload_data, &B_offload_array, &E_offload_array,
+            &plasma_offload_array, &neutral_offload_array, &wall_offload_array,
+            &wall_int_offload_array, &boozer_offload_array, &mhd_offload_array,
+            &asigma_offload_array, &offload_array, &int_offload_array) ) {
+        input_err = 1;
+    }
+    if(bcast_input) {
+        input_err = mpi_interface_bcast_status(&sim, input_err);
+    }
+    if(input_err) {
         print_out0(VERBOSE_MINIMAL, sim.mpi_rank, sim.mpi_root,
                    "\nInput reading or initializing failed.\n"
                    "See stderr for details.\n");
         mpi_interface_finalize();
         abort();
         return 1;
-    };
+    }
 
-    /* Initialize marker states array ps and free marker input p */
-    int n_proc; /* Number of markers allocated for this MPI process */
-    particle_state* ps;
-    if( prepare_markers(&sim, n_tot, p, &ps, &n_proc, B_offload_array) ) {
-        goto CLEANUP_FAILURE;
+    /* Store the magnetic field spline coefficients for later runs. The
+     * magnetic field data is located at the beginning of the packed offload
+     * array. */
+    if(node_rank == 0 && sim.mpi_rank == sim.mpi_root) {
+        hdf5_interface_write_spline_cache(&sim, offload_array);
+    }
+    if(bcast_input) {
+        mpi_interface_bcast_input(&sim, &offload_data, &offload_array,
+                                  &int_offload_array, &p, &n_tot);
+    }
+    if(sim.mpi_shmem) {
+        mpi_interface_shmem_share(&sim, &offload_data, &offload_array,
+                                  &int_offload_array);
     }
 
-    /* Combine input offload arrays to one */
-    offload_package offload_data;
-    real* offload_array;
-    int* int_offload_array;
-    if( pack_offload_array(
-            &sim, &offload_data, &B_offload_array, &E_offload_array,
-            &plasma_offload_array, &neutral_offload_array, &wall_offload_array,
-            &wall_int_offload_array, &boozer_offload_array, &mhd_offload_array,
-            &asigma_offload_array, &offload_array, &int_offload_array) ) {
+    /* Initialize marker states array ps and free marker input p. The magnetic
+     * field data is located at the beginning of the packed offload array. */
+    int n_proc; /* Number of markers allocated for this MPI process */
+    particle_state* ps;
+    if( prepare_markers(&sim, n_tot, p, &ps, &n_proc, offload_array) ) {
         goto CLEANUP_FAILURE;
     }
 
     /* Initialize diagnostics offload data */
+    if(sim.diag_offload_data.diagwall_collect) {
+        sim.diag_offload_data.diagwall.n_tile =
+            sim.wall_offload_data.type == wall_type_2D ?
+            sim.wall_offload_data.w2d.n : sim.wall_offload_data.w3d.n;
+    }
     diag_init_offload(&sim.diag_offload_data, &diag_offload_array, n_tot);
     print_out0(VERBOSE_NORMAL, sim.mpi_rank, sim.mpi_root,
                "Initialized diagnostics, %.1f MB.\n",
@@ -224,7 +306,12 @@ int main(int argc, char** argv) {
         int_offload_array, &n_gathered, &pout, diag_offload_array);
 
     /* Free input data */
-    offload_free_offload(&offload_data, &offload_array, &int_offload_array);
+    if(sim.mpi_shmem) {
+        mpi_interface_shmem_free(&offload_array, &int_offload_array);
+    }
+    else {
+        offload_free_offload(&offload_data, &offload_array, &int_offload_array);
+    }
 
     /* Write output and clean */
     if( write_output(&sim, pout, n_gathered, diag_offload_array) ) {
@@ -248,8 +335,10 @@ CLEANUP_FAILURE:
     free(p);
     free(ps);
     free(pout);
-    free(offload_array);
-    free(int_offload_array);
+    if(!sim.mpi_shmem) {
+        free(offload_array);
+        free(int_offload_array);
+    }
     free(diag_offload_array);
     abort();
     return 1;
@@ -586,6 +675,7 @@ int read_arguments(int argc, char** argv, sim_offload_data* sim) {
         {"boozer",  required_argument, 0, 13},
         {"mhd",     required_argument, 0, 14},
         {"asigma",  required_argument, 0, 15},
+        {"mpi_shmem", required_argument, 0, 16},
         {0, 0, 0, 0}
     };
 
@@ -594,6 +684,7 @@ int read_arguments(int argc, char** argv, sim_offload_data* sim) {
     sim->hdf5_out[0]    = '\0';
     sim->mpi_rank       = 0;
     sim->mpi_size       = 0;
+    sim->mpi_shmem      = 0;
     strcpy(sim->description, "No description.");
     sim->qid_options[0] = '\0';
     sim->qid_bfield[0]  = '\0';
@@ -675,6 +766,9 @@ int read_arguments(int argc, char** argv, sim_offload_data* sim) {
             case 15:
                 strcpy(sim->qid_asigma, optarg);
                 break;
+            case 16:
+                sim->mpi_shmem = atoi(optarg);
+                break;
             default:
                 // Unregonizable argument(s). Tell user how to run ascot5_main
                 print_out(VERBOSE_MINIMAL,
@@ -687,6 +781,9 @@ int read_arguments(int argc, char** argv, sim_offload_data* sim) {
                           "--mpi_size number of independent processes\n");
                 print_out(VERBOSE_MINIMAL,
                           "--mpi_rank rank of independent process\n");
+                print_out(VERBOSE_MINIMAL,
+                          "--mpi_shmem share input data within node (1) or "
+                          "not (0)\n");
                 print_out(VERBOSE_MINIMAL,
                           "--d run description maximum of 250 characters\n");
                 return 1;
@@ -728,6 +825,12 @@ int read_arguments(int argc, char** argv, sim_offload_data* sim) {
  *
  * End conditions and errors are printed in human-readable format.
  *
+ * The summary also lists the total number of accepted and rejected time-steps
+ * and the slowest markers among those whose wall-clock time exceeded the mean
+ * by a factor of STRAGGLER_FACTOR. These are usually markers stuck with
+ * a very small time-step, and the step statistics shown for them help in
+ * tuning the adaptive time-step tolerances.
+ *
  * This function is called by the root MPI process only.
  *
  * @param ps array of marker states after simulation has finished
@@ -822,4 +925,53 @@ void print_marker_summary(particle_state* ps, int n_tot) {
     free(temp);
     free(unique);
     free(count);
+
+    /* Time-step statistics */
+    integer nstep = 0, nrej = 0;
+    real cputime = 0;
+    for(int i = 0; i < n_tot; i++) {
+        nstep   += ps[i].nstep;
+        nrej    += ps[i].nrej;
+        cputime += ps[i].cputime;
+    }
+    print_out(VERBOSE_NORMAL,
+              "\n%9ld accepted and %ld rejected time-steps in total.\n",
+              (long)nstep, (long)nrej);
+
+    /* Find stragglers and list the slowest ones in descending order */
+    real threshold = STRAGGLER_FACTOR * cputime / n_tot;
+    int n_straggler = 0;
+    for(int i = 0; i < n_tot; i++) {
+        n_straggler += ps[i].cputime > threshold;
+    }
+    if(n_straggler == 0 || threshold <= 0) {
+        return;
+    }
+    print_out(VERBOSE_NORMAL,
+              "%9d markers took over %d times the mean wall-clock time "
+              "(%.3g s). Slowest:\n", n_straggler, STRAGGLER_FACTOR,
+              cputime / n_tot);
+    const char* limiter[] = {"initial step", "orbit tolerance",
+                             "collision tolerance", "max drho", "max dphi"};
+    real prev = INFINITY;
+    for(int k = 0; k < STRAGGLER_NPRINT && k < n_straggler; k++) {
+        int imax = -1;
+        for(int i = 0; i < n_tot; i++) {
+            if(ps[i].cputime < prev
+               && (imax < 0 || ps[i].cputime > ps[imax].cputime)) {
+                imax = i;
+            }
+        }
+        if(imax < 0) {
+            break;
+        }
+        prev = ps[imax].cputime;
+        int lim = ps[imax].mindtlim;
+        print_out(VERBOSE_NORMAL,
+                  "          ID %ld: %.3g s, %ld steps (%ld rejected), "
+                  "smallest step %.3g s limited by %s\n",
+                  (long)ps[imax].id, ps[imax].cputime, (long)ps[imax].nstep,
+                  (long)ps[imax].nrej, ps[imax].mindt,
+                  lim >= 0 && lim <= step_limiter_dphi ? limiter[lim] : "?");
+    }
 }
@@ -208,6 +208,10 @@ void bbnbi_inject_markers(particle_state* p, int nprt, int ngenerated, real t0,
         p[i].time     = time;
         p[i].mileage  = 0.0;
         p[i].cputime  = 0.0;
+        p[i].nstep    = 0;
+        p[i].nrej     = 0;
+        p[i].mindt    = 0.0;
+        p[i].mindtlim = 0;
         p[i].id       = ngenerated + i + 1;
         p[i].endcond  = 0;
         p[i].walltile = 0;
@@ -1,12 +1,33 @@
 /**
  * @file biosaw.c
  * @brief Functions for calculating fields from coil geometry
+ *
+ * The field of each straight coil segment is evaluated with the closed-form
+ * Biot-Savart expression. For a segment from p1 to p2 carrying current I,
+ * and for r1 = x - p1, r2 = x - p2,
+ *
+ *     B = mu0 I / (4 pi) (r1 x r2) (|r1| + |r2|)
+ *         / ( |r1| |r2| (|r1| |r2| + r1 . r2) ).
+ *
+ * Query points are processed in tiles of BIOSAW_TILE points. Each tile is
+ * looped over all segments so that the segment data is loaded once per tile
+ * and the innermost loop vectorizes over the points in the tile.
+ *
+ * Closed coils that are far from a tile can optionally be replaced by their
+ * magnetic dipole. The approximation is used when the distance between the
+ * tile and the coil exceeds the coil radius divided by the opening angle
+ * theta. The leading neglected term is the quadrupole, so the relative error
+ * is of the order of theta (theta^2 for coils symmetric about their center).
  */
+#include <stdlib.h>
+#include <math.h>
 #include "ascot5.h"
 #include "biosaw.h"
 #include "consts.h"
 #include "math.h"
 
+#define BIOSAW_TILE 64 /**< Number of query points processed together */
+
 /**
  * @brief Evaluate magnetic field due to a coil at given points.
  *
@@ -27,61 +48,269 @@
 void biosaw_calc_B(int n, real* x, real* y, real* z,
                    int coil_n, real* coil_x, real* coil_y, real* coil_z,
                    real* Bx, real* By, real* Bz) {
+    real current = 1.0;
+    biosaw_calc_B_dB(n, x, y, z, 1, &coil_n, coil_x, coil_y, coil_z,
+                     &current, 0.0, Bx, By, Bz, NULL);
+}
 
-    #pragma omp parallel for
-    for(int ix = 0; ix < n; ix++) {
-        Bx[ix] = 0;
-        By[ix] = 0;
-        Bz[ix] = 0;
+/**
+ * @brief Evaluate magnetic field and its gradient due to a set of coils.
+ *
+ * The coil coordinates are given as concatenated arrays where the points of
+ * coil k follow those of coil k-1. A coil is considered closed if its first
+ * and last points coincide, and only closed coils are approximated as dipoles
+ * in the far field.
+ *
+ * The gradient is stored as dB[(3*i + j)*n + ix] = dB_i/dx_j where i and j
+ * are the Cartesian components.
+ *
+ * @param n number of query points
+ * @param x x-coordinate of a query point [m]
+ * @param y y-coordinate of a query point [m]
+ * @param z z-coordinate of a query point [m]
+ * @param n_coil number of coils
+ * @param coil_n number of points in each coil
+ * @param coil_x coil geometry x-coordinate [m]
+ * @param coil_y coil geometry y-coordinate [m]
+ * @param coil_z coil geometry z-coordinate [m]
+ * @param current current in each coil [A]
+ * @param theta opening angle for the dipole approximation or zero to always
+ *        evaluate the segments exactly
+ * @param Bx evaluated magnetic field x-component [T]
+ * @param By evaluated magnetic field y-component [T]
+ * @param Bz evaluated magnetic field z-component [T]
+ * @param dB evaluated magnetic field gradient [T/m] or NULL if not needed
+ */
+void biosaw_calc_B_dB(int n, real* x, real* y, real* z,
+                      int n_coil, int* coil_n, real* coil_x, real* coil_y,
+                      real* coil_z, real* current, real theta,
+                      real* Bx, real* By, real* Bz, real* dB) {
 
-        real p1[3], p2[3];
-        p2[0] = coil_x[0];
-        p2[1] = coil_y[0];
-        p2[2] = coil_z[0];
+    /* Store segments as start points and direction vectors, and evaluate
+     * the center, radius, and dipole moment of each coil */
+    int n_seg = 0;
+    for(int k = 0; k < n_coil; k++) {
+        n_seg += coil_n[k] > 1 ? coil_n[k] - 1 : 0;
+    }
+    real* seg    = malloc(7 * n_seg * sizeof(real));
+    real* dipole = malloc(8 * n_coil * sizeof(real));
+    int* seg0    = malloc((n_coil + 1) * sizeof(int));
+    real* p1x = seg,           * p1y = seg + n_seg,     * p1z = seg + 2*n_seg;
+    real* lx  = seg + 3*n_seg, * ly  = seg + 4*n_seg,   * lz  = seg + 5*n_seg;
+    real* Iseg = seg + 6*n_seg;
 
-        for(int i = 1; i < coil_n; i++) {
-            math_copy(p1, p2);
+    int is = 0, ip = 0;
+    for(int k = 0; k < n_coil; k++) {
+        real* d = dipole + 8*k;
+        seg0[k] = is;
+        real len = 0, c[3] = {0, 0, 0};
+        for(int i = 1; i < coil_n[k]; i++) {
+            int i1 = ip + i - 1, i2 = ip + i;
+            p1x[is] = coil_x[i1];
+            p1y[is] = coil_y[i1];
+            p1z[is] = coil_z[i1];
+            lx[is]  = coil_x[i2] - coil_x[i1];
+            ly[is]  = coil_y[i2] - coil_y[i1];
+            lz[is]  = coil_z[i2] - coil_z[i1];
+            Iseg[is] = current[k];
 
-            p2[0] = coil_x[i];
-            p2[1] = coil_y[i];
-            p2[2] = coil_z[i];
+            real l = sqrt(lx[is]*lx[is] + ly[is]*ly[is] + lz[is]*lz[is]);
+            c[0] += l * ( coil_x[i1] + 0.5*lx[is] );
+            c[1] += l * ( coil_y[i1] + 0.5*ly[is] );
+            c[2] += l * ( coil_z[i1] + 0.5*lz[is] );
+            len  += l;
+            is++;
+        }
+        for(int j = 0; j < 3; j++) {
+            d[j] = len > 0 ? c[j] / len : 0;
+        }
 
-            real p1p2[3];
-            p1p2[0] = p2[0] - p1[0];
-            p1p2[1] = p2[1] - p1[1];
-            p1p2[2] = p2[2] - p1[2];
+        /* Radius and dipole moment m = I/2 sum (r_mid - c) x l */
+        real radius = 0, m[3] = {0, 0, 0};
+        for(int i = 0; i < coil_n[k]; i++) {
+            real r[3] = {coil_x[ip+i] - d[0], coil_y[ip+i] - d[1],
+                         coil_z[ip+i] - d[2]};
+            radius = fmax(radius, math_norm(r));
+        }
+        for(int i = seg0[k]; i < is; i++) {
+            real r[3] = {p1x[i] + 0.5*lx[i] - d[0], p1y[i] + 0.5*ly[i] - d[1],
+                         p1z[i] + 0.5*lz[i] - d[2]};
+            real l[3] = {lx[i], ly[i], lz[i]}, rxl[3];
+            math_cross(r, l, rxl);
+            m[0] += 0.5 * current[k] * rxl[0];
+            m[1] += 0.5 * current[k] * rxl[1];
+            m[2] += 0.5 * current[k] * rxl[2];
+        }
+        real gap[3] = {0, 0, 0};
+        if(coil_n[k] > 1) {
+            int il = ip + coil_n[k] - 1;
+            gap[0] = coil_x[il] - coil_x[ip];
+            gap[1] = coil_y[il] - coil_y[ip];
+            gap[2] = coil_z[il] - coil_z[ip];
+        }
+        d[3] = radius;
+        d[4] = m[0];
+        d[5] = m[1];
+        d[6] = m[2];
+        d[7] = coil_n[k] > 3 && math_norm(gap) <= 1e-6 * radius;
+        ip += coil_n[k];
+    }
+    seg0[n_coil] = is;
+
+    const real k0 = CONST_MU0 / (4*CONST_PI);
+    int n_tile = (n + BIOSAW_TILE - 1) / BIOSAW_TILE;
+
+    #pragma omp parallel for schedule(dynamic)
+    for(int it = 0; it < n_tile; it++) {
+        int i0 = it * BIOSAW_TILE;
+        int nt = n - i0 < BIOSAW_TILE ? n - i0 : BIOSAW_TILE;
+
+        real px[BIOSAW_TILE], py[BIOSAW_TILE], pz[BIOSAW_TILE];
+        real B[3][BIOSAW_TILE], G[9][BIOSAW_TILE];
+        for(int i = 0; i < BIOSAW_TILE; i++) {
+            /* Pad the last tile by repeating its first point */
+            int ix = i < nt ? i0 + i : i0;
+            px[i] = x[ix];
+            py[i] = y[ix];
+            pz[i] = z[ix];
+            for(int j = 0; j < 3; j++) { B[j][i] = 0; }
+            for(int j = 0; j < 9; j++) { G[j][i] = 0; }
+        }
 
-            real p1x[3];
-            p1x[0] = x[ix] - p1[0];
-            p1x[1] = y[ix] - p1[1];
-            p1x[2] = z[ix] - p1[2];
+        /* Bounding sphere of the tile */
+        real tc[3] = {0, 0, 0}, tr = 0;
+        if(theta > 0) {
+            for(int i = 0; i < nt; i++) {
+                tc[0] += px[i] / nt;
+                tc[1] += py[i] / nt;
+                tc[2] += pz[i] / nt;
+            }
+            for(int i = 0; i < nt; i++) {
+                real r[3] = {px[i] - tc[0], py[i] - tc[1], pz[i] - tc[2]};
+                tr = fmax(tr, math_norm(r));
+            }
+        }
 
-            real p2x[3];
-            p2x[0] = x[ix] - p2[0];
-            p2x[1] = y[ix] - p2[1];
-            p2x[2] = z[ix] - p2[2];
+        for(int k = 0; k < n_coil; k++) {
+            real* d = dipole + 8*k;
+            if(theta > 0 && d[7]) {
+                real r[3] = {tc[0] - d[0], tc[1] - d[1], tc[2] - d[2]};
+                real dist = math_norm(r) - tr;
+                if(dist > 0 && dist * theta > d[3]) {
+                    /* Far field: B = k0 ( 3 r (m.r) / r^5 - m / r^3 ) */
+                    real mx = d[4], my = d[5], mz = d[6];
+                    #pragma omp simd
+                    for(int i = 0; i < BIOSAW_TILE; i++) {
+                        real rx = px[i] - d[0];
+                        real ry = py[i] - d[1];
+                        real rz = pz[i] - d[2];
+                        real ir2 = 1.0 / (rx*rx + ry*ry + rz*rz);
+                        real ir3 = ir2 * sqrt(ir2);
+                        real mr  = mx*rx + my*ry + mz*rz;
+                        real f   = 3 * mr * ir2;
+                        B[0][i] += k0 * ir3 * ( f*rx - mx );
+                        B[1][i] += k0 * ir3 * ( f*ry - my );
+                        B[2][i] += k0 * ir3 * ( f*rz - mz );
+                        if(dB != NULL) {
+                            real r3[3] = {rx, ry, rz};
+                            real m3[3] = {mx, my, mz};
+                            for(int a = 0; a < 3; a++) {
+                                for(int b = 0; b < 3; b++) {
+                                    G[3*a+b][i] += k0 * ir3 * 3 * ir2 * (
+                                        m3[b]*r3[a] + m3[a]*r3[b]
+                                        + (a == b) * mr
+                                        - 5 * mr * r3[a] * r3[b] * ir2 );
+                                }
+                            }
+                        }
+                    }
+                    continue;
+                }
+            }
 
-            real d1 = math_norm(p1x);
-            real d2 = math_norm(p2x);
-            real l = math_norm(p1p2);
-            real s = math_dot(p1p2, p1x) / math_dot(p1p2, p1p2);
-            real h = s * l;
+            for(int s = seg0[k]; s < seg0[k+1]; s++) {
+                real ax = p1x[s], ay = p1y[s], az = p1z[s];
+                real Lx = lx[s], Ly = ly[s], Lz = lz[s];
+                real kI = k0 * Iseg[s];
+                if(dB == NULL) {
+                    #pragma omp simd
+                    for(int i = 0; i < BIOSAW_TILE; i++) {
+                        real r1x = px[i] - ax, r1y = py[i] - ay;
+                        real r1z = pz[i] - az;
+                        real r2x = r1x - Lx, r2y = r1y - Ly, r2z = r1z - Lz;
+                        real a  = sqrt(r1x*r1x + r1y*r1y + r1z*r1z);
+                        real b  = sqrt(r2x*r2x + r2y*r2y + r2z*r2z);
+                        real ab = a * b;
+                        real q  = ab + r1x*r2x + r1y*r2y + r1z*r2z;
 
-            real xs[3];
-            xs[0] = p1[0] + s*p1p2[0] - x[ix];
-            xs[1] = p1[1] + s*p1p2[1] - y[ix];
-            xs[2] = p1[2] + s*p1p2[2] - z[ix];
+                        /* Points on the segment itself have q = 0 */
+                        real F = q > 1e-12 * ab ? kI * (a + b) / (ab * q)
+                                                : 0.0;
 
-            real d = math_norm(xs);
+                        /* r1 x r2 = L x r1 */
+                        B[0][i] += F * ( Ly*r1z - Lz*r1y );
+                        B[1][i] += F * ( Lz*r1x - Lx*r1z );
+                        B[2][i] += F * ( Lx*r1y - Ly*r1x );
+                    }
+                    continue;
+                }
 
-            real abs_B = CONST_MU0 / (4*CONST_PI) * ((l-h)/d2 + h/d1)/d;
+                #pragma omp simd
+                for(int i = 0; i < BIOSAW_TILE; i++) {
+                    real r1x = px[i] - ax, r1y = py[i] - ay, r1z = pz[i] - az;
+                    real r2x = r1x - Lx,   r2y = r1y - Ly,   r2z = r1z - Lz;
+                    real a  = sqrt(r1x*r1x + r1y*r1y + r1z*r1z);
+                    real b  = sqrt(r2x*r2x + r2y*r2y + r2z*r2z);
+                    real dd = r1x*r2x + r1y*r2y + r1z*r2z;
+                    real ab = a * b;
+                    real q  = ab + dd;
+                    real iD = q > 1e-12 * ab ? 1.0 / (ab * q) : 0.0;
+                    real F  = kI * (a + b) * iD;
+                    real cx = Ly*r1z - Lz*r1y;
+                    real cy = Lz*r1x - Lx*r1z;
+                    real cz = Lx*r1y - Ly*r1x;
+                    B[0][i] += F * cx;
+                    B[1][i] += F * cy;
+                    B[2][i] += F * cz;
 
-            real dir_B[3];
-            math_cross(p1x, p2x, dir_B);
+                    /* Gradient of F = N / D, N = a + b, D = ab (ab + r1.r2),
+                     * and of L x r1 */
+                    real ia = a > 0 ? 1.0 / a : 0.0;
+                    real ib = b > 0 ? 1.0 / b : 0.0;
+                    real c1 = 2*b*b + dd*b*ia + ab;
+                    real c2 = 2*a*a + dd*a*ib + ab;
+                    real N  = a + b;
+                    real e1 = kI * iD * ( ia - N * iD * c1 );
+                    real e2 = kI * iD * ( ib - N * iD * c2 );
+                    real Fx = e1*r1x + e2*r2x;
+                    real Fy = e1*r1y + e2*r2y;
+                    real Fz = e1*r1z + e2*r2z;
+                    G[0][i] += cx*Fx;
+                    G[1][i] += cx*Fy - F*Lz;
+                    G[2][i] += cx*Fz + F*Ly;
+                    G[3][i] += cy*Fx + F*Lz;
+                    G[4][i] += cy*Fy;
+                    G[5][i] += cy*Fz - F*Lx;
+                    G[6][i] += cz*Fx - F*Ly;
+                    G[7][i] += cz*Fy + F*Lx;
+                    G[8][i] += cz*Fz;
+                }
+            }
+        }
 
-            Bx[ix] += abs_B * dir_B[0] / math_norm(dir_B);
-            By[ix] += abs_B * dir_B[1] / math_norm(dir_B);
-            Bz[ix] += abs_B * dir_B[2] / math_norm(dir_B);
+        for(int i = 0; i < nt; i++) {
+            Bx[i0+i] = B[0][i];
+            By[i0+i] = B[1][i];
+            Bz[i0+i] = B[2][i];
+            if(dB != NULL) {
+                for(int j = 0; j < 9; j++) {
+                    dB[j*n + i0 + i] = G[j][i];
+                }
+            }
         }
     }
+
+    free(seg);
+    free(dipole);
+    free(seg0);
 }
@@ -11,4 +11,9 @@ void biosaw_calc_B(int n, real* x, real* y, real* z,
                    int coil_n, real* coil_x, real* coil_y, real* coil_z,
                    real* Bx, real* By, real* Bz);
 
+void biosaw_calc_B_dB(int n, real* x, real* y, real* z,
+                      int n_coil, int* coil_n, real* coil_x, real* coil_y,
+                      real* coil_z, real* current, real theta,
+                      real* Bx, real* By, real* Bz, real* dB);
+
 #endif
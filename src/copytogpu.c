@@ -17,7 +17,7 @@ void simulate_copy_to_gpu(sim_data* sim) {
     switch(sim->wall_data.type) {
     case wall_type_2D:
       GPU_MAP_TO_DEVICE(
-			sim->wall_data.w2d.wall_r[0:sim->wall_data.w2d.n],sim->wall_data.w2d.wall_z[0:sim->wall_data.w2d.n] )
+			sim->wall_data.w2d.wall_r[0:sim->wall_data.w2d.n],sim->wall_data.w2d.wall_z[0:sim->wall_data.w2d.n],sim->wall_data.w2d.grid_array[0:sim->wall_data.w2d.grid_array_size] )
       break;
     case wall_type_3D:
       GPU_MAP_TO_DEVICE(
@@ -26,6 +26,10 @@ void simulate_copy_to_gpu(sim_data* sim) {
     default:
       break;
     }
+    if(sim->wall_data.dmap != NULL) {
+      GPU_MAP_TO_DEVICE(
+			sim->wall_data.dmap[0:sim->wall_data.dmap_n[0]*sim->wall_data.dmap_n[1]*sim->wall_data.dmap_n[2]] )
+    }
 
     if(sim->diag_data.dist5D_collect) {
       GPU_MAP_TO_DEVICE(
@@ -52,6 +56,11 @@ void simulate_copy_to_gpu(sim_data* sim) {
 			sim->diag_data.distCOM.histogram[0:sim->diag_data.distCOM.n_mu*sim->diag_data.distCOM.n_Ekin*sim->diag_data.distCOM.n_Ptor] )
     }
 
+    if(sim->diag_data.diagwall_collect) {
+      GPU_MAP_TO_DEVICE(
+			sim->diag_data.diagwall.nmrk[0:sim->diag_data.diagwall.n_tile],sim->diag_data.diagwall.pdepo[0:sim->diag_data.diagwall.n_tile],sim->diag_data.diagwall.emrk[0:sim->diag_data.diagwall.n_tile],sim->diag_data.diagwall.edepo[0:sim->diag_data.diagwall.n_tile],sim->diag_data.diagwall.angmrk[0:sim->diag_data.diagwall.n_tile],sim->diag_data.diagwall.angdepo[0:sim->diag_data.diagwall.n_tile] )
+    }
+
 
   switch(sim->E_data.type) {
 
@@ -77,7 +86,9 @@ void simulate_copy_to_gpu(sim_data* sim) {
 		      sim->plasma_data.plasma_1D.znum       [0:MAX_SPECIES],\
 		      sim->plasma_data.plasma_1D.rho        [0:sim->plasma_data.plasma_1D.n_rho],\
 		      sim->plasma_data.plasma_1D.temp       [0:sim->plasma_data.plasma_1D.n_rho*sim->plasma_data.plasma_1D.n_species], \
-  		      sim->plasma_data.plasma_1D.dens       [0:sim->plasma_data.plasma_1D.n_rho*sim->plasma_data.plasma_1D.n_species] )
+  		      sim->plasma_data.plasma_1D.dens       [0:sim->plasma_data.plasma_1D.n_rho*sim->plasma_data.plasma_1D.n_species], \
+		      sim->plasma_data.plasma_1D.rho_search.x   [0:sim->plasma_data.plasma_1D.n_rho], \
+		      sim->plasma_data.plasma_1D.rho_search.bin [0:sim->plasma_data.plasma_1D.rho_search.n_bin] )
       break;
 
       case plasma_type_1Dt:
@@ -89,7 +100,11 @@ void simulate_copy_to_gpu(sim_data* sim) {
 		      sim->plasma_data.plasma_1Dt.rho       [0:sim->plasma_data.plasma_1Dt.n_rho],\
 		      sim->plasma_data.plasma_1Dt.temp      [0:sim->plasma_data.plasma_1Dt.n_time*sim->plasma_data.plasma_1Dt.n_rho*sim->plasma_data.plasma_1Dt.n_species],\
 		      sim->plasma_data.plasma_1Dt.dens      [0:sim->plasma_data.plasma_1Dt.n_rho*sim->plasma_data.plasma_1Dt.n_species*sim->plasma_data.plasma_1Dt.n_time],\
-		      sim->plasma_data.plasma_1Dt.time      [0:sim->plasma_data.plasma_1Dt.n_time] )
+		      sim->plasma_data.plasma_1Dt.time      [0:sim->plasma_data.plasma_1Dt.n_time],\
+		      sim->plasma_data.plasma_1Dt.rho_search.x    [0:sim->plasma_data.plasma_1Dt.n_rho],\
+		      sim->plasma_data.plasma_1Dt.time_search.x   [0:sim->plasma_data.plasma_1Dt.n_time],\
+		      sim->plasma_data.plasma_1Dt.rho_search.bin  [0:sim->plasma_data.plasma_1Dt.rho_search.n_bin],\
+		      sim->plasma_data.plasma_1Dt.time_search.bin [0:sim->plasma_data.plasma_1Dt.time_search.n_bin] )
       break;
 
       case plasma_type_1DS:
@@ -128,19 +143,26 @@ void simulate_copy_to_gpu(sim_data* sim) {
     case B_field_type_3DS:
       GPU_MAP_TO_DEVICE(
 			sim->B_data.B3DS.psi,    sim->B_data.B3DS.psi.c    [0:sim->B_data.B3DS.psi.n_x   *sim->B_data.B3DS.psi.n_y                          *NSIZE_COMP2D],	\
-			sim->B_data.B3DS.B_r,    sim->B_data.B3DS.B_r.c    [0:sim->B_data.B3DS.B_r.n_x   *sim->B_data.B3DS.B_r.n_y   *sim->B_data.B3DS.B_r.n_z   *NSIZE_COMP3D],	\
-			sim->B_data.B3DS.B_phi,  sim->B_data.B3DS.B_phi.c  [0:sim->B_data.B3DS.B_phi.n_x *sim->B_data.B3DS.B_phi.n_y *sim->B_data.B3DS.B_phi.n_z *NSIZE_COMP3D],	\
-			sim->B_data.B3DS.B_z,    sim->B_data.B3DS.B_z.c    [0:sim->B_data.B3DS.B_z.n_x   *sim->B_data.B3DS.B_z.n_y   *sim->B_data.B3DS.B_z.n_z   *NSIZE_COMP3D] )
+			sim->B_data.B3DS.B_r,    sim->B_data.B3DS.B_r.c    [0:(sim->B_data.B3DS.B_r.cf == NULL)*sim->B_data.B3DS.B_r.n_x   *sim->B_data.B3DS.B_r.n_y   *sim->B_data.B3DS.B_r.n_z   *NSIZE_COMP3D], sim->B_data.B3DS.B_r.cf[0:(sim->B_data.B3DS.B_r.cf != NULL)*sim->B_data.B3DS.B_r.n_x   *sim->B_data.B3DS.B_r.n_y   *sim->B_data.B3DS.B_r.n_z   *NSIZE_COMP3D],	\
+			sim->B_data.B3DS.B_phi,  sim->B_data.B3DS.B_phi.c  [0:(sim->B_data.B3DS.B_phi.cf == NULL)*sim->B_data.B3DS.B_phi.n_x *sim->B_data.B3DS.B_phi.n_y *sim->B_data.B3DS.B_phi.n_z *NSIZE_COMP3D], sim->B_data.B3DS.B_phi.cf[0:(sim->B_data.B3DS.B_phi.cf != NULL)*sim->B_data.B3DS.B_phi.n_x *sim->B_data.B3DS.B_phi.n_y *sim->B_data.B3DS.B_phi.n_z *NSIZE_COMP3D],	\
+			sim->B_data.B3DS.B_z,    sim->B_data.B3DS.B_z.c    [0:(sim->B_data.B3DS.B_z.cf == NULL)*sim->B_data.B3DS.B_z.n_x   *sim->B_data.B3DS.B_z.n_y   *sim->B_data.B3DS.B_z.n_z   *NSIZE_COMP3D], sim->B_data.B3DS.B_z.cf[0:(sim->B_data.B3DS.B_z.cf != NULL)*sim->B_data.B3DS.B_z.n_x   *sim->B_data.B3DS.B_z.n_y   *sim->B_data.B3DS.B_z.n_z   *NSIZE_COMP3D] )
 
       break;
+    case B_field_type_3DST:
+      GPU_MAP_TO_DEVICE(
+			sim->B_data.B3DST.psi,   sim->B_data.B3DST.psi.c   [0:sim->B_data.B3DST.psi.n_x  *sim->B_data.B3DST.psi.n_y                         *NSIZE_COMP2D],	\
+			sim->B_data.B3DST.B_r,   sim->B_data.B3DST.B_r.c   [0:sim->B_data.B3DST.slice_size*sim->B_data.B3DST.slice_n],	\
+			sim->B_data.B3DST.B_phi, sim->B_data.B3DST.B_phi.c [0:sim->B_data.B3DST.slice_size*sim->B_data.B3DST.slice_n],	\
+			sim->B_data.B3DST.B_z,   sim->B_data.B3DST.B_z.c   [0:sim->B_data.B3DST.slice_size*sim->B_data.B3DST.slice_n] )
+      break;
     case B_field_type_STS:
       GPU_MAP_TO_DEVICE(
 			sim->B_data.BSTS.axis_r, sim->B_data.BSTS.axis_r.c [0:sim->B_data.BSTS.axis_r.n_x                                                           ], \
 			sim->B_data.BSTS.axis_z, sim->B_data.BSTS.axis_z.c [0:sim->B_data.BSTS.axis_z.n_x                                                           ],	\
-			sim->B_data.BSTS.psi,    sim->B_data.BSTS.psi.c    [0:sim->B_data.BSTS.psi.n_x   *sim->B_data.BSTS.psi.n_y   *sim->B_data.BSTS.psi.n_z   *NSIZE_COMP3D],	\
-			sim->B_data.BSTS.B_r,    sim->B_data.BSTS.B_r.c    [0:sim->B_data.BSTS.B_r.n_x   *sim->B_data.BSTS.B_r.n_y   *sim->B_data.BSTS.B_r.n_z   *NSIZE_COMP3D],	\
-			sim->B_data.BSTS.B_z,    sim->B_data.BSTS.B_z.c    [0:sim->B_data.BSTS.B_z.n_x   *sim->B_data.BSTS.B_z.n_y   *sim->B_data.BSTS.B_z.n_z   *NSIZE_COMP3D],	\
-			sim->B_data.BSTS.B_phi,  sim->B_data.BSTS.B_phi.c  [0:sim->B_data.BSTS.B_phi.n_x *sim->B_data.BSTS.B_phi.n_y *sim->B_data.BSTS.B_phi.n_z *NSIZE_COMP3D] )
+			sim->B_data.BSTS.psi,    sim->B_data.BSTS.psi.c    [0:(sim->B_data.BSTS.psi.cf == NULL)*sim->B_data.BSTS.psi.n_x   *sim->B_data.BSTS.psi.n_y   *sim->B_data.BSTS.psi.n_z   *NSIZE_COMP3D], sim->B_data.BSTS.psi.cf[0:(sim->B_data.BSTS.psi.cf != NULL)*sim->B_data.BSTS.psi.n_x   *sim->B_data.BSTS.psi.n_y   *sim->B_data.BSTS.psi.n_z   *NSIZE_COMP3D],	\
+			sim->B_data.BSTS.B_r,    sim->B_data.BSTS.B_r.c    [0:(sim->B_data.BSTS.B_r.cf == NULL)*sim->B_data.BSTS.B_r.n_x   *sim->B_data.BSTS.B_r.n_y   *sim->B_data.BSTS.B_r.n_z   *NSIZE_COMP3D], sim->B_data.BSTS.B_r.cf[0:(sim->B_data.BSTS.B_r.cf != NULL)*sim->B_data.BSTS.B_r.n_x   *sim->B_data.BSTS.B_r.n_y   *sim->B_data.BSTS.B_r.n_z   *NSIZE_COMP3D],	\
+			sim->B_data.BSTS.B_z,    sim->B_data.BSTS.B_z.c    [0:(sim->B_data.BSTS.B_z.cf == NULL)*sim->B_data.BSTS.B_z.n_x   *sim->B_data.BSTS.B_z.n_y   *sim->B_data.BSTS.B_z.n_z   *NSIZE_COMP3D], sim->B_data.BSTS.B_z.cf[0:(sim->B_data.BSTS.B_z.cf != NULL)*sim->B_data.BSTS.B_z.n_x   *sim->B_data.BSTS.B_z.n_y   *sim->B_data.BSTS.B_z.n_z   *NSIZE_COMP3D],	\
+			sim->B_data.BSTS.B_phi,  sim->B_data.BSTS.B_phi.c  [0:(sim->B_data.BSTS.B_phi.cf == NULL)*sim->B_data.BSTS.B_phi.n_x *sim->B_data.BSTS.B_phi.n_y *sim->B_data.BSTS.B_phi.n_z *NSIZE_COMP3D], sim->B_data.BSTS.B_phi.cf[0:(sim->B_data.BSTS.B_phi.cf != NULL)*sim->B_data.BSTS.B_phi.n_x *sim->B_data.BSTS.B_phi.n_y *sim->B_data.BSTS.B_phi.n_z *NSIZE_COMP3D] )
       break;
     case B_field_type_TC:
       GPU_MAP_TO_DEVICE(
@@ -161,7 +183,8 @@ void simulate_fo_fixed_copy_from_gpu(sim_data* sim, particle_simd_fo *p_ptr){
   p_ptr->z[0:p_ptr->n_mrk],p_ptr->charge[0:p_ptr->n_mrk],p_ptr->mass[0:p_ptr->n_mrk],p_ptr->B_r[0:p_ptr->n_mrk],p_ptr->B_r_dr[0:p_ptr->n_mrk],p_ptr->B_r_dphi[0:p_ptr->n_mrk],p_ptr->B_r_dz[0:p_ptr->n_mrk], \
   p_ptr->B_phi[0:p_ptr->n_mrk],p_ptr->B_phi_dr[0:p_ptr->n_mrk],p_ptr->B_phi_dphi[0:p_ptr->n_mrk],p_ptr->B_phi_dz[0:p_ptr->n_mrk],p_ptr->B_z[0:p_ptr->n_mrk],p_ptr->B_z_dr[0:p_ptr->n_mrk],p_ptr->B_z_dphi[0:p_ptr->n_mrk], \
   p_ptr->B_z_dz[0:p_ptr->n_mrk],p_ptr->rho[0:p_ptr->n_mrk],p_ptr->theta[0:p_ptr->n_mrk],p_ptr->err[0:p_ptr->n_mrk],p_ptr->time[0:p_ptr->n_mrk],p_ptr->weight[0:p_ptr->n_mrk],p_ptr->cputime[0:p_ptr->n_mrk], \
-      p_ptr->id[0:p_ptr->n_mrk],p_ptr->endcond[0:p_ptr->n_mrk],p_ptr->walltile[0:p_ptr->n_mrk],p_ptr->index[0:p_ptr->n_mrk],p_ptr->znum[0:p_ptr->n_mrk],p_ptr->anum[0:p_ptr->n_mrk],p_ptr->bounces[0:p_ptr->n_mrk] )
+      p_ptr->id[0:p_ptr->n_mrk],p_ptr->endcond[0:p_ptr->n_mrk],p_ptr->walltile[0:p_ptr->n_mrk],p_ptr->index[0:p_ptr->n_mrk],p_ptr->znum[0:p_ptr->n_mrk],p_ptr->anum[0:p_ptr->n_mrk],p_ptr->bounces[0:p_ptr->n_mrk], \
+      p_ptr->nstep[0:p_ptr->n_mrk],p_ptr->nrej[0:p_ptr->n_mrk],p_ptr->mindt[0:p_ptr->n_mrk],p_ptr->mindtlim[0:p_ptr->n_mrk] )
 
     GPU_MAP_FROM_DEVICE(
 			      sim[0:1]  )
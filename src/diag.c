@@ -23,7 +23,9 @@
 #include "diag/dist_rho5D.h"
 #include "diag/dist_rho6D.h"
 #include "diag/dist_com.h"
+#include "diag/dist_coords.h"
 #include "diag/diag_transcoef.h"
+#include "diag/diag_wall.h"
 #include "particle.h"
 
 void diag_arraysum(size_t start, size_t stop, real* array1, real* array2);
@@ -79,6 +81,11 @@ int diag_init_offload(diag_offload_data* data, real** offload_array, int Nmrk){
             * (size_t)(data->distCOM.n_Ptor);
     }
 
+    if(data->diagwall_collect) {
+        data->offload_diagwall_index = n;
+        n += (size_t)(DIAG_WALL_NQNT) * (size_t)(data->diagwall.n_tile);
+    }
+
     data->offload_dist_length = n;
 
     if(data->diagorb_collect) {
@@ -158,6 +165,7 @@ void diag_init(diag_data* data, diag_offload_data* offload_data,
     data->distrho6D_collect = offload_data->distrho6D_collect;
     data->distCOM_collect   = offload_data->distCOM_collect;
     data->diagtrcof_collect = offload_data->diagtrcof_collect;
+    data->diagwall_collect  = offload_data->diagwall_collect;
 
     if(data->dist5D_collect) {
         dist_5D_init(&data->dist5D, &offload_data->dist5D,
@@ -184,6 +192,11 @@ void diag_init(diag_data* data, diag_offload_data* offload_data,
                         &offload_array[offload_data->offload_distCOM_index]);
     }
 
+    if(data->diagwall_collect) {
+        diag_wall_init(&data->diagwall, &offload_data->diagwall,
+                       &offload_array[offload_data->offload_diagwall_index]);
+    }
+
     if(data->diagorb_collect) {
         diag_orb_init(&data->diagorb, &offload_data->diagorb,
                       &offload_array[offload_data->offload_diagorb_index]);
@@ -261,24 +274,38 @@ void diag_update_gc(diag_data* data, B_field_data* Bdata, particle_simd_gc* p_f,
         diag_orb_update_gc(&data->diagorb, p_f, p_i);
     }
 
-    if(data->dist5D_collect){
-        dist_5D_update_gc(&data->dist5D, p_f, p_i);
-    }
+    /* Coordinates shared by the distributions are evaluated only once */
+    if(data->dist5D_collect || data->dist6D_collect || data->distrho5D_collect
+       || data->distrho6D_collect || data->distCOM_collect) {
+        int flags = 0;
+        if(data->dist6D_collect || data->distrho6D_collect) {
+            flags |= dist_coords_momentum;
+        }
+        if(data->distCOM_collect) {
+            flags |= dist_coords_com;
+        }
+        dist_coords_gc coords;
+        dist_coords_eval_gc(&coords, flags, Bdata, p_f, p_i);
 
-    if(data->dist6D_collect){
-        dist_6D_update_gc(&data->dist6D, p_f, p_i);
-    }
+        if(data->dist5D_collect){
+            dist_5D_update_gc(&data->dist5D, p_f, &coords);
+        }
 
-    if(data->distrho5D_collect){
-        dist_rho5D_update_gc(&data->distrho5D, p_f, p_i);
-    }
+        if(data->dist6D_collect){
+            dist_6D_update_gc(&data->dist6D, p_f, &coords);
+        }
 
-    if(data->distrho6D_collect){
-        dist_rho6D_update_gc(&data->distrho6D, p_f, p_i);
-    }
+        if(data->distrho5D_collect){
+            dist_rho5D_update_gc(&data->distrho5D, p_f, &coords);
+        }
 
-    if(data->distCOM_collect){
-        dist_COM_update_gc(&data->distCOM, Bdata, p_f, p_i);
+        if(data->distrho6D_collect){
+            dist_rho6D_update_gc(&data->distrho6D, p_f, &coords);
+        }
+
+        if(data->distCOM_collect){
+            dist_COM_update_gc(&data->distCOM, p_f, &coords);
+        }
     }
 
     if(data->diagtrcof_collect){
@@ -387,6 +414,13 @@ void diag_sum(diag_offload_data* data, real* array1, real* array2) {
             * (size_t)(data->distCOM.n_Ekin) * (size_t)(data->distCOM.n_Ptor);
         diag_arraysum(start, stop, array1, array2);
     }
+
+    if(data->diagwall_collect){
+        size_t start = data->offload_diagwall_index;
+        size_t stop = start
+            + (size_t)(DIAG_WALL_NQNT) * (size_t)(data->diagwall.n_tile);
+        diag_arraysum(start, stop, array1, array2);
+    }
 }
 
 /**
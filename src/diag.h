@@ -14,6 +14,7 @@
 #include "diag/dist_com.h"
 #include "diag/diag_orb.h"
 #include "diag/diag_transcoef.h"
+#include "diag/diag_wall.h"
 
 /**
  * @brief Diagnostics offload data struct
@@ -26,6 +27,7 @@ typedef struct {
     int distrho6D_collect; /**< Flag for collecting 6D rho distribution      */
     int distCOM_collect;    /**< Flag for collecting COM distribution        */
     int diagtrcof_collect; /**< Flag for collecting transport coefficients   */
+    int diagwall_collect;  /**< Flag for collecting wall loads               */
 
     diag_orb_offload_data diagorb;     /**< Orbit offload data               */
     dist_5D_offload_data dist5D;       /**< 5D distribution offload data     */
@@ -34,6 +36,7 @@ typedef struct {
     dist_rho6D_offload_data distrho6D; /**< 6D rho distribution offload data */
     dist_COM_offload_data distCOM;     /**< COM distribution offload data    */
     diag_transcoef_offload_data diagtrcof; /**< Transp. Coef. offload data   */
+    diag_wall_offload_data diagwall;   /**< Wall load offload data           */
 
     size_t offload_dist5D_index;   /**< Index for 5D dist in offload array    */
     size_t offload_dist6D_index;   /**< Index for 5D dist in offload array    */
@@ -42,6 +45,7 @@ typedef struct {
     size_t offload_distCOM_index;  /**< Index for COM dist in offload array   */
     size_t offload_diagorb_index;  /**< Index for orbit data in offload array */
     size_t offload_diagtrcof_index;/**< Index for trcoef data in offload array*/
+    size_t offload_diagwall_index; /**< Index for wall loads in offload array */
 
     size_t offload_dist_length;    /**< Number of elements in distributions   */
     size_t offload_array_length;   /**< Number of elements in offload_array   */
@@ -59,6 +63,7 @@ typedef struct {
     int distrho6D_collect; /**< Flag for collecting 6D rho distribution      */
     int distCOM_collect;   /**< Flag for collecting COM distribution         */
     int diagtrcof_collect; /**< Flag for collecting transport coefficients   */
+    int diagwall_collect;  /**< Flag for collecting wall loads               */
 
     diag_orb_data diagorb;     /**< Orbit diagnostics data                   */
     dist_5D_data dist5D;       /**< 5D distribution diagnostics data         */
@@ -67,6 +72,7 @@ typedef struct {
     dist_rho6D_data distrho6D; /**< 6D rho distribution diagnostics data     */
     dist_COM_data distCOM;     /**< COM distribution diagnostics data        */
     diag_transcoef_data diagtrcof; /**< Transp. Coef. diagnostics data       */
+    diag_wall_data diagwall;   /**< Wall load diagnostics data               */
 
 } diag_data;
 
@@ -164,7 +164,7 @@ void diag_orb_update_fo(diag_orb_data* data, particle_simd_fo* p_f,
     if(data->mode == DIAG_ORB_INTERVAL) {
 
         #pragma omp simd
-        for(int i= 0; i < NSIMD; i++) {
+        for(int i= 0; i < p_f->n_mrk; i++) {
 
             /* Mask dummy markers */
             if(p_f->id[i] > 0) {
@@ -237,7 +237,7 @@ void diag_orb_update_fo(diag_orb_data* data, particle_simd_fo* p_f,
     else if(data->mode == DIAG_ORB_POINCARE) {
 
         #pragma omp simd
-        for(int i= 0; i < NSIMD; i++) {
+        for(int i= 0; i < p_f->n_mrk; i++) {
             /* Mask dummy markers and those whose time-step was rejected. */
             if( p_f->id[i] > 0 && (p_f->mileage[i] != p_i->mileage[i]) ) {
 
@@ -369,7 +369,7 @@ void diag_orb_update_gc(diag_orb_data* data, particle_simd_gc* p_f,
 
     if(data->mode == DIAG_ORB_INTERVAL) {
         #pragma omp simd
-        for(int i= 0; i < NSIMD; i++) {
+        for(int i= 0; i < p_f->n_mrk; i++) {
 
             /* Mask dummy markers */
             if(p_f->id[i] > 0) {
@@ -441,7 +441,7 @@ void diag_orb_update_gc(diag_orb_data* data, particle_simd_gc* p_f,
     }
     else if(data->mode == DIAG_ORB_POINCARE) {
         #pragma omp simd
-        for(int i= 0; i < NSIMD; i++) {
+        for(int i= 0; i < p_f->n_mrk; i++) {
             /* Mask dummy markers and those whose time-step was rejected. */
             if( p_f->id[i] > 0 && (p_f->mileage[i] != p_i->mileage[i]) ) {
 
@@ -577,7 +577,7 @@ void diag_orb_update_ml(diag_orb_data* data, particle_simd_ml* p_f,
     if(data->mode == DIAG_ORB_INTERVAL) {
 
         #pragma omp simd
-        for(int i= 0; i < NSIMD; i++) {
+        for(int i= 0; i < p_f->n_mrk; i++) {
 
             /* Mask dummy markers */
             if(p_f->id[i] > 0) {
@@ -637,7 +637,7 @@ void diag_orb_update_ml(diag_orb_data* data, particle_simd_ml* p_f,
     }
     else if(data->mode == DIAG_ORB_POINCARE) {
         #pragma omp simd
-        for(int i= 0; i < NSIMD; i++) {
+        for(int i= 0; i < p_f->n_mrk; i++) {
             /* Mask dummy markers and thosw whose time-step was rejected. */
             if( p_f->id[i] > 0 && (p_f->mileage[i] != p_i->mileage[i]) ) {
 
@@ -0,0 +1,145 @@
+/**
+ * @file diag_wall.c
+ * @brief Wall load accumulated during the simulation
+ *
+ * Markers that hit the wall deposit their weight and energy on the tile they
+ * hit. The loads are accumulated on the fly so that wall loads are available
+ * without storing and post-processing the end states of all markers.
+ *
+ * Each marker hits the wall only once, so the updates are rare and the
+ * accumulators are updated with atomic operations instead of using
+ * thread-local buffers (which would be large for 3D walls).
+ */
+#include <math.h>
+#include "../ascot5.h"
+#include "../consts.h"
+#include "../math.h"
+#include "../physlib.h"
+#include "../particle.h"
+#include "../endcond.h"
+#include "../gctransform.h"
+#include "diag_wall.h"
+
+DECLARE_TARGET
+void diag_wall_deposit(diag_wall_data* data, int tile, real weight, real ekin,
+                       real angle);
+DECLARE_TARGET_END
+
+/**
+ * @brief Initializes wall load diagnostics from offload data
+ *
+ * @param data pointer to data struct
+ * @param offload_data pointer to offload data struct
+ * @param offload_array offload array
+ */
+void diag_wall_init(diag_wall_data* data, diag_wall_offload_data* offload_data,
+                    real* offload_array) {
+    int n = offload_data->n_tile;
+    data->n_tile  = n;
+    data->nmrk    = &offload_array[0*n];
+    data->pdepo   = &offload_array[1*n];
+    data->emrk    = &offload_array[2*n];
+    data->edepo   = &offload_array[3*n];
+    data->angmrk  = &offload_array[4*n];
+    data->angdepo = &offload_array[5*n];
+}
+
+/**
+ * @brief Collect wall loads from full-orbit markers
+ *
+ * Only markers that hit the wall during the current time step are recorded.
+ *
+ * @param data pointer to wall load diagnostics data
+ * @param wdata pointer to wall data
+ * @param p_f pointer to SIMD fo struct at the end of current time step
+ * @param p_i pointer to SIMD fo struct at the start of current time step
+ */
+void diag_wall_update_fo(diag_wall_data* data, wall_data* wdata,
+                         particle_simd_fo* p_f, particle_simd_fo* p_i) {
+    GPU_PARALLEL_LOOP_ALL_LEVELS
+    for(int i = 0; i < p_f->n_mrk; i++) {
+        if(!p_f->running[i] && p_i->running[i]
+           && (p_f->endcond[i] & endcond_wall) && p_f->walltile[i] > 0) {
+            int tile = p_f->walltile[i];
+            real p[3] = {p_f->p_r[i], p_f->p_phi[i], p_f->p_z[i]};
+            real pnorm = math_norm(p);
+            real ekin  = physlib_Ekin_pnorm(p_f->mass[i], pnorm);
+
+            real n[3];
+            wall_get_normal(n, tile, p_f->phi[i], wdata);
+            real angle = acos(fabs(math_dot(p, n)) / pnorm) * 180 / CONST_PI;
+
+            diag_wall_deposit(data, tile, p_f->weight[i], ekin, angle);
+        }
+    }
+}
+
+/**
+ * @brief Collect wall loads from guiding center markers
+ *
+ * Only markers that hit the wall during the current time step are recorded.
+ * The incidence angle is evaluated from the particle momentum corresponding
+ * to the guiding center.
+ *
+ * @param data pointer to wall load diagnostics data
+ * @param wdata pointer to wall data
+ * @param p_f pointer to SIMD gc struct at the end of current time step
+ * @param p_i pointer to SIMD gc struct at the start of current time step
+ */
+void diag_wall_update_gc(diag_wall_data* data, wall_data* wdata,
+                         particle_simd_gc* p_f, particle_simd_gc* p_i) {
+    for(int i = 0; i < p_f->n_mrk; i++) {
+        if(!p_f->running[i] && p_i->running[i]
+           && (p_f->endcond[i] & endcond_wall) && p_f->walltile[i] > 0) {
+            int tile = p_f->walltile[i];
+            real B_dB[12] = {
+                p_f->B_r[i],   p_f->B_r_dr[i],   p_f->B_r_dphi[i],
+                p_f->B_r_dz[i],
+                p_f->B_phi[i], p_f->B_phi_dr[i], p_f->B_phi_dphi[i],
+                p_f->B_phi_dz[i],
+                p_f->B_z[i],   p_f->B_z_dr[i],   p_f->B_z_dphi[i],
+                p_f->B_z_dz[i]};
+            real Bnorm = math_normc(B_dB[0], B_dB[4], B_dB[8]);
+            real ekin  = physlib_Ekin_ppar(p_f->mass[i], p_f->mu[i],
+                                           p_f->ppar[i], Bnorm);
+
+            real p[3];
+            gctransform_pparmuzeta2prpphipz(
+                p_f->mass[i], p_f->charge[i], B_dB, p_f->phi[i], p_f->ppar[i],
+                p_f->mu[i], p_f->zeta[i], &p[0], &p[1], &p[2]);
+            real pnorm = math_norm(p);
+
+            real n[3];
+            wall_get_normal(n, tile, p_f->phi[i], wdata);
+            real angle = acos(fabs(math_dot(p, n)) / pnorm) * 180 / CONST_PI;
+
+            diag_wall_deposit(data, tile, p_f->weight[i], ekin, angle);
+        }
+    }
+}
+
+/**
+ * @brief Add marker contribution to the tile accumulators
+ *
+ * @param data pointer to wall load diagnostics data
+ * @param tile index of the tile that was hit (starting from 1)
+ * @param weight marker weight [markers/s]
+ * @param ekin marker kinetic energy [J]
+ * @param angle incidence angle [deg]
+ */
+void diag_wall_deposit(diag_wall_data* data, int tile, real weight, real ekin,
+                       real angle) {
+    int j = tile - 1;
+    GPU_ATOMIC
+    data->nmrk[j]    += 1.0;
+    GPU_ATOMIC
+    data->pdepo[j]   += weight;
+    GPU_ATOMIC
+    data->emrk[j]    += ekin;
+    GPU_ATOMIC
+    data->edepo[j]   += weight * ekin;
+    GPU_ATOMIC
+    data->angmrk[j]  += angle;
+    GPU_ATOMIC
+    data->angdepo[j] += weight * ekin * angle;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file diag_wall.h
+ * @brief Header file for diag_wall.c
+ */
+#ifndef DIAG_WALL_H
+#define DIAG_WALL_H
+
+#include "../ascot5.h"
+#include "../particle.h"
+#include "../wall.h"
+
+/**
+ * @brief Number of quantities accumulated per wall tile
+ *
+ * The quantities are stored in offload array in blocks of n_tile elements
+ * and in this order:
+ *
+ * - number of markers that hit the tile
+ * - sum of marker weights [markers/s]
+ * - sum of marker energies [J]
+ * - sum of weighted marker energies [W]
+ * - sum of incidence angles [deg]
+ * - sum of weighted energy times incidence angle [W*deg]
+ */
+#define DIAG_WALL_NQNT 6
+
+/**
+ * @brief Wall load diagnostics offload data struct
+ */
+typedef struct {
+    int n_tile; /**< Number of wall tiles (elements) */
+} diag_wall_offload_data;
+
+/**
+ * @brief Wall load diagnostics data struct
+ */
+typedef struct {
+    int n_tile;   /**< Number of wall tiles (elements)                */
+    real* nmrk;   /**< Number of markers that hit the tile            */
+    real* pdepo;  /**< Sum of marker weights [markers/s]              */
+    real* emrk;   /**< Sum of marker energies [J]                     */
+    real* edepo;  /**< Sum of weighted marker energies [W]            */
+    real* angmrk; /**< Sum of incidence angles [deg]                  */
+    real* angdepo;/**< Sum of weighted energy times angle [W*deg]     */
+} diag_wall_data;
+
+void diag_wall_init(diag_wall_data* data, diag_wall_offload_data* offload_data,
+                    real* offload_array);
+
+void diag_wall_update_fo(diag_wall_data* data, wall_data* wdata,
+                         particle_simd_fo* p_f, particle_simd_fo* p_i);
+
+void diag_wall_update_gc(diag_wall_data* data, wall_data* wdata,
+                         particle_simd_gc* p_f, particle_simd_gc* p_i);
+
+#endif
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include "../ascot5.h"
 #include "../particle.h"
+#include "dist_coords.h"
 
 /**
  * @brief Histogram parameters that will be offloaded to target
@@ -94,6 +95,6 @@ void dist_5D_init(dist_5D_data* dist_data,
 void dist_5D_update_fo(dist_5D_data* dist, particle_simd_fo* p_f,
                        particle_simd_fo* p_i);
 void dist_5D_update_gc(dist_5D_data* dist, particle_simd_gc* p_f,
-                       particle_simd_gc* p_i);
+                       dist_coords_gc* c);
 
 #endif
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include "../ascot5.h"
 #include "../particle.h"
+#include "dist_coords.h"
 
 /**
  * @brief Histogram parameters that will be offloaded to target
@@ -98,6 +99,6 @@ void dist_6D_init(dist_6D_data* dist_data, dist_6D_offload_data* offload_data,
 void dist_6D_update_fo(dist_6D_data* dist, particle_simd_fo* p_f,
                        particle_simd_fo* p_i);
 void dist_6D_update_gc(dist_6D_data* dist, particle_simd_gc* p_f,
-                       particle_simd_gc* p_i);
+                       dist_coords_gc* c);
 
 #endif
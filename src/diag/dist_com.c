@@ -10,6 +10,7 @@
 #include "../physlib.h"
 #include "../particle.h"
 #include "dist_com.h"
+#include "dist_coords.h"
 
 /**
  * @brief Internal function calculating the index in the histogram array
@@ -128,59 +129,41 @@ void dist_COM_update_fo(dist_COM_data* dist, B_field_data* Bdata,
  * avoid race conditions.
  *
  * @param dist pointer to distribution parameter struct
- * @param Bdata pointer to magnetic field data
  * @param p_f pointer to SIMD gc struct at the end of current time step
- * @param p_i pointer to SIMD gc struct at the start of current time step
+ * @param c pointer to coordinates evaluated by dist_coords_eval_gc()
  */
-void dist_COM_update_gc(dist_COM_data* dist, B_field_data* Bdata,
-                        particle_simd_gc* p_f, particle_simd_gc* p_i) {
+void dist_COM_update_gc(dist_COM_data* dist, particle_simd_gc* p_f,
+                        dist_coords_gc* c) {
     int i_mu[NSIMD];
     int i_Ekin[NSIMD];
     int i_Ptor[NSIMD];
 
     int ok[NSIMD];
-    real weight[NSIMD];
 
     #pragma omp simd
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p_f->n_mrk; i++) {
         if(p_f->running[i]) {
-            real Ekin, Ptor, B, psi;
-
-            B_field_eval_psi(&psi, p_f->r[i], p_f->phi[i], p_f->z[i],
-                             p_f->time[i], Bdata);
-
-            B = math_normc(p_f->B_r[i], p_f->B_phi[i], p_f->B_z[i]);
             i_mu[i] = floor((p_f->mu[i] - dist->min_mu)
                             / ((dist->max_mu - dist->min_mu)/dist->n_mu));
 
-            Ekin = physlib_Ekin_ppar(p_f->mass[i], p_f->mu[i], p_f->ppar[i], B);
-
-            i_Ekin[i] = floor((Ekin - dist->min_Ekin)
+            i_Ekin[i] = floor((c->ekin[i] - dist->min_Ekin)
                          / ((dist->max_Ekin - dist->min_Ekin) / dist->n_Ekin));
-            Ptor = phys_ptoroid_gc(p_f->charge[i], p_f->r[i], p_f->ppar[i], psi,
-                                   B, p_f->B_phi[i]);
 
-            i_Ptor[i] = floor((Ptor - dist->min_Ptor)
+            i_Ptor[i] = floor((c->ptor[i] - dist->min_Ptor)
                          / ((dist->max_Ptor - dist->min_Ptor)/dist->n_Ptor));
 
-            if(i_mu[i]   >= 0 && i_mu[i]   <= dist->n_mu - 1   &&
-               i_Ekin[i] >= 0 && i_Ekin[i] <= dist->n_Ekin - 1 &&
-               i_Ptor[i] >= 0 && i_Ptor[i] <= dist->n_Ptor - 1 ) {
-                ok[i] = 1;
-                weight[i] = p_f->weight[i] * (p_f->time[i] - p_i->time[i]);
-            }
-            else {
-                ok[i] = 0;
-            }
+            ok[i] = i_mu[i]   >= 0 && i_mu[i]   <= dist->n_mu - 1   &&
+                    i_Ekin[i] >= 0 && i_Ekin[i] <= dist->n_Ekin - 1 &&
+                    i_Ptor[i] >= 0 && i_Ptor[i] <= dist->n_Ptor - 1;
         }
     }
 
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p_f->n_mrk; i++) {
         if(p_f->running[i] && ok[i]) {
             size_t index = dist_COM_index(i_mu[i], i_Ekin[i], i_Ptor[i],
                                           dist->step_2, dist->step_1);
             #pragma omp atomic
-            dist->histogram[index] += weight[i];
+            dist->histogram[index] += c->weight[i];
         }
     }
 }
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include "../ascot5.h"
 #include "../particle.h"
+#include "dist_coords.h"
 #include "../B_field.h"
 
 /**
@@ -54,7 +55,7 @@ void dist_COM_init(dist_COM_data* dist_data,
                    real* offload_array);
 void dist_COM_update_fo(dist_COM_data* dist, B_field_data*Bdata,
                         particle_simd_fo* p_f, particle_simd_fo* p_i);
-void dist_COM_update_gc(dist_COM_data* dist, B_field_data* Bdata,
-                        particle_simd_gc* p_f, particle_simd_gc* p_i);
+void dist_COM_update_gc(dist_COM_data* dist, particle_simd_gc* p_f,
+                        dist_coords_gc* c);
 
 #endif
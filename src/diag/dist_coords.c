@@ -0,0 +1,78 @@
+/**
+ * @file dist_coords.c
+ * @brief Evaluation of the coordinates used in distribution binning
+ */
+#include <math.h>
+#include "../ascot5.h"
+#include "../consts.h"
+#include "../physlib.h"
+#include "../particle.h"
+#include "../B_field.h"
+#include "../gctransform.h"
+#include "dist_coords.h"
+
+/**
+ * @brief Evaluate distribution coordinates for guiding center markers
+ *
+ * Coordinates are evaluated only for the running markers. The particle
+ * momentum and the constants of motion are evaluated only when requested by
+ * the flags since they are more expensive and not needed by all
+ * distributions. The poloidal flux needed for Ptor is evaluated from the rho
+ * already stored in the marker struct.
+ *
+ * @param c pointer to coordinate struct where results are stored
+ * @param flags bitwise or of DIST_COORDS_FLAG values
+ * @param Bdata pointer to magnetic field data
+ * @param p_f pointer to SIMD gc struct at the end of current time step
+ * @param p_i pointer to SIMD gc struct at the start of current time step
+ */
+void dist_coords_eval_gc(dist_coords_gc* c, int flags, B_field_data* Bdata,
+                         particle_simd_gc* p_f, particle_simd_gc* p_i) {
+    int eval_momentum = flags & dist_coords_momentum;
+    int eval_com      = flags & dist_coords_com;
+
+    #pragma omp simd
+    for(int i = 0; i < p_f->n_mrk; i++) {
+        if(p_f->running[i]) {
+            c->phi[i] = fmod(p_f->phi[i], 2*CONST_PI);
+            if(c->phi[i] < 0) {
+                c->phi[i] = c->phi[i] + 2*CONST_PI;
+            }
+            c->theta[i] = fmod(p_f->theta[i], 2*CONST_PI);
+            if(c->theta[i] < 0) {
+                c->theta[i] = c->theta[i] + 2*CONST_PI;
+            }
+
+            real Bnorm = sqrt(  p_f->B_r[i]   * p_f->B_r[i]
+                              + p_f->B_phi[i] * p_f->B_phi[i]
+                              + p_f->B_z[i]   * p_f->B_z[i] );
+            c->pperp[i]  = sqrt(2 * Bnorm * p_f->mu[i] * p_f->mass[i]);
+            c->q[i]      = p_f->charge[i]/CONST_E;
+            c->weight[i] = p_f->weight[i] * (p_f->time[i] - p_i->time[i]);
+
+            if(eval_momentum) {
+                real B_dB[12] = {
+                    p_f->B_r[i], p_f->B_r_dr[i], p_f->B_r_dphi[i],
+                    p_f->B_r_dz[i],
+                    p_f->B_phi[i], p_f->B_phi_dr[i], p_f->B_phi_dphi[i],
+                    p_f->B_phi_dz[i],
+                    p_f->B_z[i], p_f->B_z_dr[i], p_f->B_z_dphi[i],
+                    p_f->B_z_dz[i]};
+                gctransform_pparmuzeta2prpphipz(
+                    p_f->mass[i], p_f->charge[i], B_dB, p_f->phi[i],
+                    p_f->ppar[i], p_f->mu[i], p_f->zeta[i],
+                    &c->pr[i], &c->pphi[i], &c->pz[i]);
+            }
+
+            if(eval_com) {
+                real psi;
+                B_field_eval_psi_from_rho(&psi, p_f->rho[i], Bdata);
+                c->ekin[i] = physlib_Ekin_ppar(p_f->mass[i], p_f->mu[i],
+                                               p_f->ppar[i], Bnorm);
+                c->ptor[i] = phys_ptoroid_gc(p_f->charge[i], p_f->r[i],
+                                             p_f->ppar[i], psi, Bnorm,
+                                             p_f->B_phi[i]);
+            }
+        }
+    }
+}
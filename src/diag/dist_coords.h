@@ -0,0 +1,46 @@
+/**
+ * @file dist_coords.h
+ * @brief Header file for dist_coords.c
+ */
+#ifndef DIST_COORDS_H
+#define DIST_COORDS_H
+
+#include "../ascot5.h"
+#include "../particle.h"
+#include "../B_field.h"
+
+/**
+ * @brief Flags for optional quantities evaluated by dist_coords_eval_gc()
+ */
+enum DIST_COORDS_FLAG {
+    dist_coords_momentum = 0x1, /**< Particle momentum (for 6D distributions) */
+    dist_coords_com      = 0x2  /**< Ekin and Ptor (for COM distribution)     */
+};
+
+/**
+ * @brief Derived phase-space coordinates shared by all distributions
+ *
+ * Quantities that are needed by several distributions are evaluated once per
+ * time step and stored here, so that each distribution only needs to find its
+ * bins.
+ */
+typedef struct {
+    real phi[NSIMD] __memalign__;    /**< Toroidal angle in [0, 2pi) [rad]    */
+    real theta[NSIMD] __memalign__;  /**< Poloidal angle in [0, 2pi) [rad]    */
+    real pperp[NSIMD] __memalign__;  /**< Perpendicular momentum [kg m/s]     */
+    real q[NSIMD] __memalign__;      /**< Charge [e]                          */
+    real weight[NSIMD] __memalign__; /**< Weight times time step [markers]    */
+
+    real pr[NSIMD] __memalign__;     /**< Particle momentum R comp. [kg m/s]  */
+    real pphi[NSIMD] __memalign__;   /**< Particle momentum phi comp. [kg m/s]*/
+    real pz[NSIMD] __memalign__;     /**< Particle momentum z comp. [kg m/s]  */
+
+    real ekin[NSIMD] __memalign__;   /**< Kinetic energy [J]                  */
+    real ptor[NSIMD] __memalign__;   /**< Canonical toroidal momentum
+                                          [kg m^2/s]                          */
+} dist_coords_gc;
+
+void dist_coords_eval_gc(dist_coords_gc* c, int flags, B_field_data* Bdata,
+                         particle_simd_gc* p_f, particle_simd_gc* p_i);
+
+#endif
@@ -10,6 +10,7 @@
 #include "../physlib.h"
 #include "../gctransform.h"
 #include "dist_rho6D.h"
+#include "dist_coords.h"
 
 /**
  * @brief Internal function calculating the index in the histogram array
@@ -189,14 +190,11 @@ void dist_rho6D_update_fo(dist_rho6D_data* dist, particle_simd_fo* p_f,
  * avoid race conditions.
  *
  * @param dist pointer to distribution parameter struct
- * @param p_i pointer to SIMD GC struct at the beginning of time step
+ * @param c pointer to coordinates evaluated by dist_coords_eval_gc()
  * @param p_f pointer to SIMD GC struct at the end of time step
  */
 void dist_rho6D_update_gc(dist_rho6D_data* dist, particle_simd_gc* p_f,
-                          particle_simd_gc* p_i) {
-    real phi[NSIMD];
-    real theta[NSIMD];
-
+                          dist_coords_gc* c) {
     int i_rho[NSIMD];
     int i_theta[NSIMD];
     int i_phi[NSIMD];
@@ -207,89 +205,55 @@ void dist_rho6D_update_gc(dist_rho6D_data* dist, particle_simd_gc* p_f,
     int i_q[NSIMD];
 
     int ok[NSIMD];
-    real weight[NSIMD];
 
     #pragma omp simd
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p_f->n_mrk; i++) {
         if(p_f->running[i]) {
-
-            real pr, pphi, pz;
-            real B_dB[12] = {p_f->B_r[i],
-                             p_f->B_r_dr[i],
-                             p_f->B_r_dphi[i],
-                             p_f->B_r_dz[i],
-                             p_f->B_phi[i],
-                             p_f->B_phi_dr[i],
-                             p_f->B_phi_dphi[i],
-                             p_f->B_phi_dz[i],
-                             p_f->B_z[i],
-                             p_f->B_z_dr[i],
-                             p_f->B_z_dphi[i],
-                             p_f->B_z_dz[i]};
-            gctransform_pparmuzeta2prpphipz(p_f->mass[i], p_f->charge[i], B_dB,
-                                            p_f->phi[i], p_f->ppar[i],
-                                            p_f->mu[i], p_f->zeta[i],
-                                            &pr, &pphi, &pz);
-
             i_rho[i] = floor((p_f->rho[i] - dist->min_rho)
                              / ((dist->max_rho - dist->min_rho)/dist->n_rho));
 
-            phi[i] = fmod(p_f->phi[i], 2*CONST_PI);
-            if(phi[i] < 0) {
-                phi[i] = phi[i] + 2*CONST_PI;
-            }
-            i_phi[i] = floor((phi[i] - dist->min_phi)
+            i_phi[i] = floor((c->phi[i] - dist->min_phi)
                              / ((dist->max_phi - dist->min_phi)/dist->n_phi));
 
-            theta[i] = fmod(p_f->theta[i], 2*CONST_PI);
-            if(theta[i] < 0) {
-                theta[i] = theta[i] + 2*CONST_PI;
-            }
-            i_theta[i] = floor((theta[i] - dist->min_theta)
+            i_theta[i] = floor((c->theta[i] - dist->min_theta)
                              / ((dist->max_theta - dist->min_theta)
                                 / dist->n_theta));
 
-            i_pr[i] = floor((pr - dist->min_pr)
+            i_pr[i] = floor((c->pr[i] - dist->min_pr)
                             / ((dist->max_pr - dist->min_pr) / dist->n_pr));
 
-            i_pphi[i] = floor((pphi - dist->min_pphi)
+            i_pphi[i] = floor((c->pphi[i] - dist->min_pphi)
                               / ((dist->max_pphi - dist->min_pphi)
                                  / dist->n_pphi));
 
-            i_pz[i] = floor((pz - dist->min_pz)
+            i_pz[i] = floor((c->pz[i] - dist->min_pz)
                             / ((dist->max_pz - dist->min_pz) / dist->n_pz));
 
             i_time[i] = floor((p_f->time[i] - dist->min_time)
                           / ((dist->max_time - dist->min_time) / dist->n_time));
 
-            i_q[i] = floor((p_f->charge[i]/CONST_E - dist->min_q)
+            i_q[i] = floor((c->q[i] - dist->min_q)
                            / ((dist->max_q - dist->min_q) / dist->n_q));
 
-            if(i_rho[i]  >= 0 && i_rho[i]  <= dist->n_rho - 1  &&
-               i_theta[i]  >= 0 && i_theta[i]  <= dist->n_theta -1   &&
-               i_phi[i]  >= 0 && i_phi[i]  <= dist->n_phi - 1  &&
-               i_pr[i]   >= 0 && i_pr[i]   <= dist->n_pr - 1   &&
-               i_pphi[i] >= 0 && i_pphi[i] <= dist->n_pphi - 1 &&
-               i_pz[i]   >= 0 && i_pz[i]   <= dist->n_pz - 1   &&
-               i_time[i] >= 0 && i_time[i] <= dist->n_time - 1 &&
-               i_q[i]    >= 0 && i_q[i]    <= dist->n_q - 1      ) {
-                ok[i] = 1;
-                weight[i] = p_f->weight[i] * (p_f->time[i] - p_i->time[i]);
-            }
-            else {
-                ok[i] = 0;
-            }
+            ok[i] = i_rho[i]   >= 0 && i_rho[i]   <= dist->n_rho - 1   &&
+                    i_theta[i] >= 0 && i_theta[i] <= dist->n_theta - 1 &&
+                    i_phi[i]   >= 0 && i_phi[i]   <= dist->n_phi - 1   &&
+                    i_pr[i]    >= 0 && i_pr[i]    <= dist->n_pr - 1    &&
+                    i_pphi[i]  >= 0 && i_pphi[i]  <= dist->n_pphi - 1  &&
+                    i_pz[i]    >= 0 && i_pz[i]    <= dist->n_pz - 1    &&
+                    i_time[i]  >= 0 && i_time[i]  <= dist->n_time - 1  &&
+                    i_q[i]     >= 0 && i_q[i]     <= dist->n_q - 1;
         }
     }
 
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p_f->n_mrk; i++) {
         if(p_f->running[i] && ok[i]) {
             size_t index = dist_rho6D_index(
                 i_rho[i], i_theta[i], i_phi[i], i_pr[i], i_pphi[i], i_pz[i],
                 i_time[i], i_q[i], dist->step_7, dist->step_6, dist->step_5,
                 dist->step_4, dist->step_3, dist->step_2, dist->step_1);
             #pragma omp atomic
-            dist->histogram[index] += weight[i];
+            dist->histogram[index] += c->weight[i];
         }
     }
 }
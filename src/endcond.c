@@ -246,6 +246,12 @@ void endcond_check_fo(particle_simd_fo* p_f, particle_simd_fo* p_i,
             }
         }
     }
+
+    /* Deposit the markers that hit the wall on the wall load diagnostics */
+    if(active_wall && sim->diag_data.diagwall_collect) {
+        diag_wall_update_fo(&sim->diag_data.diagwall, &sim->wall_data,
+                            p_f, p_i);
+    }
 }
 
 /**
@@ -274,7 +280,7 @@ void endcond_check_gc(particle_simd_gc* p_f, particle_simd_gc* p_i,
     int active_cpumax    = sim->endcond_active & endcond_cpumax;
 
     #pragma omp simd
-    for(i = 0; i < NSIMD; i++) {
+    for(i = 0; i < p_f->n_mrk; i++) {
         if(p_f->running[i]) {
             /* Update bounces if pitch changed sign */
             if( p_i->ppar[i] * p_f->ppar[i] < 0 ) {
@@ -419,6 +425,12 @@ void endcond_check_gc(particle_simd_gc* p_f, particle_simd_gc* p_i,
             }
         }
     }
+
+    /* Deposit the markers that hit the wall on the wall load diagnostics */
+    if(active_wall && sim->diag_data.diagwall_collect) {
+        diag_wall_update_gc(&sim->diag_data.diagwall, &sim->wall_data,
+                            p_f, p_i);
+    }
 }
 
 /**
@@ -445,7 +457,7 @@ void endcond_check_ml(particle_simd_ml* p_f, particle_simd_ml* p_i,
     int active_cpumax    = sim->endcond_active & endcond_cpumax;
 
     #pragma omp simd
-    for(i = 0; i < NSIMD; i++) {
+    for(i = 0; i < p_f->n_mrk; i++) {
         if(p_f->running[i]) {
             /* Check if the marker time exceeds simulation time */
             if(active_tlim) {
@@ -550,6 +562,7 @@ void endcond_parse(int endcond, int* endconds) {
     if(endcond & endcond_hybrid) {endconds[i++] = 10;};
     if(endcond & endcond_neutr)  {endconds[i++] = 11;};
     if(endcond & endcond_ioniz)  {endconds[i++] = 12;};
+    if(endcond & endcond_roul)   {endconds[i++] = 13;};
 }
 
 /**
@@ -602,5 +615,8 @@ void endcond_parse2str(int endcond, char* str) {
         case 12:
             sprintf(str, "Ionization");
             break;
+        case 13:
+            sprintf(str, "Russian roulette");
+            break;
     }
 }
@@ -199,6 +199,14 @@ void error_parse2str(a5err err, char* msg, char* line, char* file) {
             sprintf(file, "B_3DS.c");
             break;
 
+        case EF_B_3DST:
+            sprintf(file, "B_3DST.c");
+            break;
+
+        case EF_FLUXMAP:
+            sprintf(file, "fluxmap.c");
+            break;
+
         case EF_PARTICLE:
             sprintf(file, "particle.c");
             break;
@@ -50,7 +50,9 @@ typedef enum error_file {
     EF_ATOMIC            =  25, /**< Error is from atomic.c                   */
     EF_ASIGMA            =  26, /**< Error is from asigma.c                   */
     EF_ASIGMA_LOC        =  27, /**< Error is from asigma_loc.c               */
-    EF_SUZUKI            =  28  /**< Error is from suzuki.c                   */
+    EF_SUZUKI            =  28, /**< Error is from suzuki.c                   */
+    EF_B_3DST            =  29, /**< Error is from B_3DST.c                   */
+    EF_FLUXMAP           =  30  /**< Error is from fluxmap.c                  */
 }error_file;
 
 /**
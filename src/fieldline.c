@@ -0,0 +1,275 @@
+/**
+ * @file fieldline.c
+ * @brief Connection lengths and wall footprints of magnetic field lines
+ *
+ * Maps of connection length or strike points are made by tracing field lines
+ * from a large number of starting points, e.g. a fine (R, z) grid, in both
+ * directions until they hit the wall. Only a few numbers per starting point
+ * are needed, so the lines are traced here directly with an adaptive
+ * Cash-Karp method without the marker structs, queue, end conditions, and
+ * diagnostics of a field line simulation (SIM_MODE=4). Each line is
+ * integrated independently, and the lines are distributed over OpenMP
+ * threads.
+ *
+ * A line is traced until it hits the wall, its length reaches the given
+ * maximum, or the magnetic field can no longer be evaluated. The hit tile is
+ * reported as the wall element id, zero if the maximum length was reached,
+ * and -1 if the line left the field or the field evaluation failed otherwise.
+ */
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include "ascot5.h"
+#include "math.h"
+#include "error.h"
+#include "B_field.h"
+#include "wall.h"
+#include "fieldline.h"
+
+#define FIELDLINE_INISTEP 1.0e-2 /**< Initial step size [m]                 */
+/** Maximum step size [m]. The wall is checked along the chord of each step,
+ *  which stays within about 2 cm of the line at R = 6 m with this value. */
+#define FIELDLINE_MAXSTEP 1.0
+
+/**
+ * @brief Evaluate the field line tangent in cylindrical coordinates
+ *
+ * @param k array where (dR/ds, dphi/ds, dz/ds) is stored
+ * @param y position (R, phi, z)
+ * @param dir direction of integration, 1 along the field and -1 against it
+ * @param t time [s]
+ * @param Bdata pointer to magnetic field data
+ *
+ * @return zero if the evaluation succeeded
+ */
+static a5err fieldline_tangent(real k[3], real y[3], int dir, real t,
+                               B_field_data* Bdata) {
+    real B[3];
+    a5err err = B_field_eval_B(B, y[0], y[1], y[2], t, Bdata);
+    if(err) {
+        return err;
+    }
+    real normB = math_normc(B[0], B[1], B[2]) * dir;
+    k[0] = B[0] / normB;
+    k[1] = B[1] / ( normB * y[0] );
+    k[2] = B[2] / normB;
+    return 0;
+}
+
+/**
+ * @brief Take a single Cash-Karp step along a field line
+ *
+ * @param y initial position (R, phi, z)
+ * @param k1 field line tangent at the initial position
+ * @param h step length [m]
+ * @param dir direction of integration
+ * @param t time [s]
+ * @param Bdata pointer to magnetic field data
+ * @param yout array where the fifth order solution is stored
+ * @param err pointer where the relative error estimate is stored
+ *
+ * @return zero if the step could be evaluated
+ */
+static a5err fieldline_step(real y[3], real k1[3], real h, int dir, real t,
+                            B_field_data* Bdata, real yout[3], real* err) {
+    real k2[3], k3[3], k4[3], k5[3], k6[3], tempy[3];
+    a5err errflag;
+
+    for(int j = 0; j < 3; j++) {
+        tempy[j] = y[j] + h * ( (1.0/5) * k1[j] );
+    }
+    errflag = fieldline_tangent(k2, tempy, dir, t, Bdata);
+    if(errflag) {
+        return errflag;
+    }
+
+    for(int j = 0; j < 3; j++) {
+        tempy[j] = y[j] + h * ( (3.0/40) * k1[j] + (9.0/40) * k2[j] );
+    }
+    errflag = fieldline_tangent(k3, tempy, dir, t, Bdata);
+    if(errflag) {
+        return errflag;
+    }
+
+    for(int j = 0; j < 3; j++) {
+        tempy[j] = y[j] + h * (
+              ( 3.0/10) * k1[j]
+            + (-9.0/10) * k2[j]
+            + ( 6.0/5 ) * k3[j] );
+    }
+    errflag = fieldline_tangent(k4, tempy, dir, t, Bdata);
+    if(errflag) {
+        return errflag;
+    }
+
+    for(int j = 0; j < 3; j++) {
+        tempy[j] = y[j] + h * (
+              (-11.0/54) * k1[j]
+            + (  5.0/2 ) * k2[j]
+            + (-70.0/27) * k3[j]
+            + ( 35.0/27) * k4[j] );
+    }
+    errflag = fieldline_tangent(k5, tempy, dir, t, Bdata);
+    if(errflag) {
+        return errflag;
+    }
+
+    for(int j = 0; j < 3; j++) {
+        tempy[j] = y[j] + h * (
+              ( 1631.0/55296 ) * k1[j]
+            + (  175.0/512   ) * k2[j]
+            + (  575.0/13824 ) * k3[j]
+            + (44275.0/110592) * k4[j]
+            + (  253.0/4096  ) * k5[j] );
+    }
+    errflag = fieldline_tangent(k6, tempy, dir, t, Bdata);
+    if(errflag) {
+        return errflag;
+    }
+
+    /* Error estimate is the difference between RK4 and RK5 solutions */
+    *err = 0.0;
+    for(int j = 0; j < 3; j++) {
+        yout[j] = y[j] + h * (
+              ( 37.0/378 ) * k1[j]
+            + (250.0/621 ) * k3[j]
+            + (125.0/594 ) * k4[j]
+            + (512.0/1771) * k6[j] );
+
+        real rk4 = y[j] + h * (
+              ( 2825.0/27648) * k1[j]
+            + (18575.0/48384) * k3[j]
+            + (13525.0/55296) * k4[j]
+            + (  277.0/14336) * k5[j]
+            + (    1.0/4    ) * k6[j] );
+
+        real ytol = fabs(y[j]) + fabs( k1[j] * h ) + DBL_EPSILON;
+        *err = fmax( *err, fabs(yout[j] - rk4) / ytol );
+    }
+    return 0;
+}
+
+/**
+ * @brief Trace a field line in one direction
+ *
+ * @param y0 starting position (R, phi, z)
+ * @param dir direction of integration, 1 along the field and -1 against it
+ * @param t time [s]
+ * @param lmax maximum length of the line [m]
+ * @param tol relative error tolerance of the integration
+ * @param Bdata pointer to magnetic field data
+ * @param wdata pointer to wall data
+ * @param len pointer where the length of the line is stored [m]
+ * @param tile pointer where the hit wall element is stored
+ * @param rhomin pointer to the minimum rho, updated along the line
+ */
+static void fieldline_trace(real y0[3], int dir, real t, real lmax, real tol,
+                            B_field_data* Bdata, wall_data* wdata, real* len,
+                            int* tile, real* rhomin) {
+    real y[3] = {y0[0], y0[1], y0[2]};
+    real k1[3], ynew[3];
+    real s = 0, h = FIELDLINE_INISTEP;
+
+    *tile = -1;
+    *len  = 0;
+    if( fieldline_tangent(k1, y, dir, t, Bdata) ) {
+        return;
+    }
+
+    while(s < lmax) {
+        if(h > lmax - s) {
+            h = lmax - s;
+        }
+
+        real err;
+        if( fieldline_step(y, k1, h, dir, t, Bdata, ynew, &err) ) {
+            break;
+        }
+        err = err / tol;
+        if(err > 1) {
+            /* Step rejected */
+            h = 0.85 * h * pow(err, -0.25);
+            continue;
+        }
+        real hnext = err > 0 ? 0.85 * h * pow(err, -0.2) : 5 * h;
+        hnext = fmin( fmin(hnext, 5 * h), FIELDLINE_MAXSTEP );
+
+        real w_coll;
+        int w = wall_hit_wall(y[0], y[1], y[2], ynew[0], ynew[1], ynew[2],
+                              wdata, &w_coll);
+        if(w > 0) {
+            *tile = w;
+            *len  = s + w_coll * h;
+            return;
+        }
+        s += h;
+        y[0] = ynew[0];
+        y[1] = ynew[1];
+        y[2] = ynew[2];
+
+        real psi[1], rho[2];
+        if( B_field_eval_psi(psi, y[0], y[1], y[2], t, Bdata)
+            || B_field_eval_rho(rho, psi[0], Bdata)
+            || fieldline_tangent(k1, y, dir, t, Bdata) ) {
+            break;
+        }
+        *rhomin = fmin(*rhomin, rho[0]);
+        h = hnext;
+    }
+
+    *len = s;
+    if(s >= lmax) {
+        *tile = 0;
+    }
+}
+
+/**
+ * @brief Evaluate connection lengths and wall hits of field lines
+ *
+ * Field lines are traced from each starting point both along and against the
+ * magnetic field until they hit the wall, their length reaches lmax, or they
+ * leave the field. For each starting point, the lengths and hit tiles in
+ * both directions and the minimum rho on the whole line are returned. The
+ * connection length is lfwd + lbwd when both tiles are positive. Starting
+ * points where the field cannot be evaluated have zero lengths, tiles -1, and
+ * rhomin NaN.
+ *
+ * @param n number of starting points
+ * @param r R coordinates of the starting points [m]
+ * @param phi phi coordinates of the starting points [rad]
+ * @param z z coordinates of the starting points [m]
+ * @param t time at which the field is evaluated [s]
+ * @param lmax maximum length of the line in each direction [m]
+ * @param tol relative error tolerance of the integration
+ * @param Bdata pointer to magnetic field data
+ * @param wdata pointer to wall data
+ * @param lfwd output array for the length along the field [m]
+ * @param lbwd output array for the length against the field [m]
+ * @param tfwd output array for the tile hit along the field
+ * @param tbwd output array for the tile hit against the field
+ * @param rhomin output array for the minimum rho on the line
+ */
+void fieldline_connection(int n, real* r, real* phi, real* z, real t,
+                          real lmax, real tol, B_field_data* Bdata,
+                          wall_data* wdata, real* lfwd, real* lbwd,
+                          int* tfwd, int* tbwd, real* rhomin) {
+    #pragma omp parallel for schedule(dynamic, 16)
+    for(int i = 0; i < n; i++) {
+        real y0[3] = {r[i], phi[i], z[i]};
+        real psi[1], rho[2];
+        if( B_field_eval_psi(psi, y0[0], y0[1], y0[2], t, Bdata)
+            || B_field_eval_rho(rho, psi[0], Bdata) ) {
+            lfwd[i]   = 0;
+            lbwd[i]   = 0;
+            tfwd[i]   = -1;
+            tbwd[i]   = -1;
+            rhomin[i] = NAN;
+            continue;
+        }
+        rhomin[i] = rho[0];
+        fieldline_trace(y0,  1, t, lmax, tol, Bdata, wdata, &lfwd[i],
+                        &tfwd[i], &rhomin[i]);
+        fieldline_trace(y0, -1, t, lmax, tol, Bdata, wdata, &lbwd[i],
+                        &tbwd[i], &rhomin[i]);
+    }
+}
@@ -0,0 +1,17 @@
+/**
+ * @file fieldline.h
+ * @brief Header file for fieldline.c
+ */
+#ifndef FIELDLINE_H
+#define FIELDLINE_H
+
+#include "ascot5.h"
+#include "B_field.h"
+#include "wall.h"
+
+void fieldline_connection(int n, real* r, real* phi, real* z, real t,
+                          real lmax, real tol, B_field_data* Bdata,
+                          wall_data* wdata, real* lfwd, real* lbwd,
+                          int* tfwd, int* tbwd, real* rhomin);
+
+#endif
@@ -0,0 +1,307 @@
+/**
+ * @file fluxmap.c
+ * @brief Map from flux coordinates (rho, theta, phi) to cylindrical (R, z)
+ *
+ * Finding (R, z) for a given (rho, theta, phi), where theta is the geometric
+ * poloidal angle measured from the magnetic axis, requires a root search
+ * along the ray starting from the axis. When the map is needed at many
+ * points, e.g. when generating markers or plotting flux surfaces, it is
+ * cheaper to tabulate the distance from the axis on a (rho, theta, phi) grid
+ * once and interpolate it with splines. Where the interpolated value is not
+ * accurate enough, it is used as an initial guess for the Newton iteration
+ * which then converges in one or two steps.
+ *
+ * The map is tabulated on uniform grids rho in [0, rho_max],
+ * theta in [0, 2pi), and phi in [0, 2pi). Queries outside the tabulated rho
+ * range fall back to the plain Newton iteration.
+ */
+#include <stdlib.h>
+#include <math.h>
+#include "ascot5.h"
+#include "consts.h"
+#include "error.h"
+#include "B_field.h"
+#include "fluxmap.h"
+#include "spline/interp.h"
+
+/**
+ * @brief Return the number of spline coefficients needed by the map
+ *
+ * @param n_rho number of rho grid points
+ * @param n_theta number of theta grid points
+ * @param n_phi number of phi grid points or one for an axisymmetric map
+ *
+ * @return length of the coefficient array
+ */
+int fluxmap_size(int n_rho, int n_theta, int n_phi) {
+    if(n_phi == 1) {
+        return NSIZE_COMP2D * n_rho * n_theta;
+    }
+    return NSIZE_COMP3D * n_rho * n_theta * n_phi;
+}
+
+/**
+ * @brief Tabulate the map and construct its spline coefficients
+ *
+ * The Newton iteration is run on every grid point. Points sharing the same
+ * (theta, phi) are processed in order of increasing rho so that the previous
+ * solutions provide the initial guess for the next one.
+ *
+ * @param map pointer to map struct to be initialized
+ * @param c allocated array of length fluxmap_size() for the coefficients
+ * @param n_rho number of rho grid points
+ * @param n_theta number of theta grid points
+ * @param n_phi number of phi grid points or one for an axisymmetric map
+ * @param rho_max maximum rho in the map
+ * @param Bdata pointer to magnetic field data
+ *
+ * @return zero if initialization succeeded
+ */
+int fluxmap_init(fluxmap_data* map, real* c, int n_rho, int n_theta,
+                 int n_phi, real rho_max, B_field_data* Bdata) {
+    if(n_rho < 3 || n_theta < 3 || n_phi < 1 || rho_max <= 0) {
+        return 1;
+    }
+
+    real* x = malloc(n_rho * n_theta * n_phi * sizeof(real));
+    if(x == NULL) {
+        return 1;
+    }
+
+    int err = 0;
+    #pragma omp parallel for reduction(|:err)
+    for(int i = 0; i < n_theta * n_phi; i++) {
+        int i_theta = i % n_theta;
+        int i_phi   = i / n_theta;
+        real theta  = i_theta * CONST_2PI / n_theta;
+        real phi    = i_phi * CONST_2PI / n_phi;
+
+        real axisrz[2];
+        if( B_field_get_axis_rz(axisrz, Bdata, phi) ) {
+            err = 1;
+            continue;
+        }
+
+        real* xi = x + ( (size_t)i_phi * n_theta + i_theta ) * n_rho;
+        xi[0] = 0.0;
+        for(int i_rho = 1; i_rho < n_rho; i_rho++) {
+            real rho = i_rho * rho_max / (n_rho - 1);
+            real x0  = 1e-1;
+            if(i_rho > 1) {
+                x0 = 2 * xi[i_rho-1] - xi[i_rho-2];
+            }
+            real rz[2];
+            if( fluxmap_newton(rz, rho, theta, phi, x0 > 0 ? x0 : 1e-1,
+                               100, 1e-10, Bdata) ) {
+                err = 1;
+                break;
+            }
+            real dr = rz[0] - axisrz[0];
+            real dz = rz[1] - axisrz[1];
+            xi[i_rho] = sqrt(dr*dr + dz*dz);
+        }
+    }
+
+    if(!err) {
+        if(n_phi == 1) {
+            err = interp2Dcomp_init_coeff(c, x, n_rho, n_theta,
+                                          NATURALBC, PERIODICBC,
+                                          0, rho_max, 0, CONST_2PI);
+        }
+        else {
+            err = interp3Dcomp_init_coeff(c, x, n_rho, n_theta, n_phi,
+                                          NATURALBC, PERIODICBC, PERIODICBC,
+                                          0, rho_max, 0, CONST_2PI,
+                                          0, CONST_2PI);
+        }
+    }
+    free(x);
+    if(err) {
+        return 1;
+    }
+
+    fluxmap_init_spline(map, c, n_rho, n_theta, n_phi, rho_max);
+    return 0;
+}
+
+/**
+ * @brief Initialize map from precomputed spline coefficients
+ *
+ * @param map pointer to map struct to be initialized
+ * @param c coefficients constructed with fluxmap_init()
+ * @param n_rho number of rho grid points
+ * @param n_theta number of theta grid points
+ * @param n_phi number of phi grid points or one for an axisymmetric map
+ * @param rho_max maximum rho in the map
+ */
+void fluxmap_init_spline(fluxmap_data* map, real* c, int n_rho, int n_theta,
+                         int n_phi, real rho_max) {
+    map->n_rho   = n_rho;
+    map->n_theta = n_theta;
+    map->n_phi   = n_phi;
+    map->rho_max = rho_max;
+    if(n_phi == 1) {
+        interp2Dcomp_init_spline(&map->x2D, c, n_rho, n_theta,
+                                 NATURALBC, PERIODICBC,
+                                 0, rho_max, 0, CONST_2PI);
+    }
+    else {
+        interp3Dcomp_init_spline(&map->x3D, c, n_rho, n_theta, n_phi,
+                                 NATURALBC, PERIODICBC, PERIODICBC,
+                                 0, rho_max, 0, CONST_2PI, 0, CONST_2PI);
+    }
+}
+
+/**
+ * @brief Newton iteration along the ray starting from the magnetic axis
+ *
+ * @param rz output array for (R, z) coordinates [m]
+ * @param rho the square root of the normalized poloidal flux
+ * @param theta poloidal angle [rad]
+ * @param phi toroidal angle [rad]
+ * @param x initial guess for the distance from the axis [m]
+ * @param axisrz magnetic axis (R, z) coordinates at phi [m]
+ * @param maxiter maximum number of iterations
+ * @param tol iteration is stopped when |rho - rho(R,z)| < tol
+ * @param Bdata pointer to magnetic field data
+ *
+ * @return zero if the iteration converged
+ */
+static a5err fluxmap_newton_ray(real rz[2], real rho, real theta, real phi,
+                                real x, real axisrz[2], int maxiter, real tol,
+                                B_field_data* Bdata) {
+    a5err err = 0;
+    real rhodrho[4];
+    real costh = cos(theta);
+    real sinth = sin(theta);
+    for(int i = 0; i < maxiter; i++) {
+        real rj = axisrz[0] + x * costh;
+        real zj = axisrz[1] + x * sinth;
+        err = B_field_eval_rho_drho(rhodrho, rj, phi, zj, Bdata);
+        if(err) {
+            return err;
+        }
+        if( fabs(rho - rhodrho[0]) < tol ) {
+            rz[0] = rj;
+            rz[1] = zj;
+            return 0;
+        }
+
+        real drhodx = costh * rhodrho[1] + sinth * rhodrho[3];
+        x = x - (rhodrho[0] - rho) / drhodx;
+        if( x < 0 ) {
+            /* Try again starting closer from the axis */
+            x = (x + (rhodrho[0] - rho) / drhodx) / 2;
+        }
+    }
+    return error_raise(ERR_INPUT_EVALUATION, __LINE__, EF_FLUXMAP);
+}
+
+/**
+ * @brief Find (R, z) for given (rho, theta, phi) with the Newton method
+ *
+ * The search is done along the ray starting from the magnetic axis at the
+ * poloidal angle theta. For rho values smaller than the value at the axis
+ * (which may be nonzero due to padding), the axis position is returned.
+ *
+ * @param rz output array for (R, z) coordinates [m]
+ * @param rho the square root of the normalized poloidal flux
+ * @param theta poloidal angle [rad]
+ * @param phi toroidal angle [rad]
+ * @param x0 initial guess for the distance from the axis [m]
+ * @param maxiter maximum number of iterations
+ * @param tol iteration is stopped when |rho - rho(R,z)| < tol
+ * @param Bdata pointer to magnetic field data
+ *
+ * @return zero if the iteration converged
+ */
+a5err fluxmap_newton(real rz[2], real rho, real theta, real phi, real x0,
+                     int maxiter, real tol, B_field_data* Bdata) {
+    a5err err = 0;
+    real axisrz[2];
+    real rhodrho[4];
+    err = B_field_get_axis_rz(axisrz, Bdata, phi);
+    if(!err) {
+        err = B_field_eval_rho_drho(rhodrho, axisrz[0], phi, axisrz[1],
+                                    Bdata);
+    }
+    if(err) {
+        return err;
+    }
+    if( rhodrho[0] > rho ) {
+        /* Due to padding, rho might not be exactly zero on the axis so we
+         * return the axis position for small values of queried rho */
+        rz[0] = axisrz[0];
+        rz[1] = axisrz[1];
+        return 0;
+    }
+    return fluxmap_newton_ray(rz, rho, theta, phi, x0, axisrz, maxiter, tol,
+                              Bdata);
+}
+
+/**
+ * @brief Evaluate (R, z) for given (rho, theta, phi) using the map
+ *
+ * The interpolated position is accepted if |rho - rho(R,z)| < tol. Otherwise
+ * it is refined with the Newton method. If maxiter is zero, the interpolated
+ * position is returned as is without evaluating rho.
+ *
+ * @param rz output array for (R, z) coordinates [m]
+ * @param rho the square root of the normalized poloidal flux
+ * @param theta poloidal angle [rad]
+ * @param phi toroidal angle [rad]
+ * @param maxiter maximum number of Newton iterations
+ * @param tol required accuracy in rho
+ * @param map pointer to map data
+ * @param Bdata pointer to magnetic field data
+ *
+ * @return zero if evaluation succeeded
+ */
+a5err fluxmap_eval_rz(real rz[2], real rho, real theta, real phi,
+                      int maxiter, real tol, fluxmap_data* map,
+                      B_field_data* Bdata) {
+    if(rho < 0 || rho > map->rho_max) {
+        return fluxmap_newton(rz, rho, theta, phi, 1e-1, maxiter, tol, Bdata);
+    }
+
+    a5err err = 0;
+    real axisrz[2];
+    err = B_field_get_axis_rz(axisrz, Bdata, phi);
+    if(err) {
+        return err;
+    }
+
+    real x;
+    theta = fmod(theta, CONST_2PI);
+    if(theta < 0) {
+        theta += CONST_2PI;
+    }
+    if(map->n_phi == 1) {
+        err = interp2Dcomp_eval_f(&x, &map->x2D, rho, theta);
+    }
+    else {
+        real phimod = fmod(phi, CONST_2PI);
+        if(phimod < 0) {
+            phimod += CONST_2PI;
+        }
+        err = interp3Dcomp_eval_f(&x, &map->x3D, rho, theta, phimod);
+    }
+    if(err) {
+        return error_raise(ERR_INPUT_EVALUATION, __LINE__, EF_FLUXMAP);
+    }
+    if(maxiter == 0) {
+        x = x > 0 ? x : 0;
+        rz[0] = axisrz[0] + x * cos(theta);
+        rz[1] = axisrz[1] + x * sin(theta);
+        return 0;
+    }
+    if(x <= 0) {
+        /* Close to the axis where the padding needs to be checked */
+        return fluxmap_newton(rz, rho, theta, phi, 1e-1, maxiter, tol, Bdata);
+    }
+
+    /* The first iteration checks whether the interpolated value is already
+     * accurate enough */
+    return fluxmap_newton_ray(rz, rho, theta, phi, x, axisrz, maxiter, tol,
+                              Bdata);
+}
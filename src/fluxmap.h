@@ -0,0 +1,45 @@
+/**
+ * @file fluxmap.h
+ * @brief Header file for fluxmap.c
+ */
+#ifndef FLUXMAP_H
+#define FLUXMAP_H
+
+#include "ascot5.h"
+#include "error.h"
+#include "B_field.h"
+#include "spline/interp.h"
+
+/**
+ * @brief Tabulated map from flux coordinates (rho, theta, phi) to (R, z)
+ *
+ * The map stores the distance x from the magnetic axis along the ray
+ * (cos(theta), sin(theta)) at which rho(R, z) has the tabulated value, so
+ * that R = R_axis(phi) + x cos(theta) and z = z_axis(phi) + x sin(theta).
+ * When n_phi is one, the map is axisymmetric and only x2D is used.
+ */
+typedef struct {
+    int n_rho;         /**< Number of rho grid points                        */
+    int n_theta;       /**< Number of theta grid points                      */
+    int n_phi;         /**< Number of phi grid points                        */
+    real rho_max;      /**< Maximum rho in the map                           */
+    interp2D_data x2D; /**< x(rho, theta) when the map is axisymmetric       */
+    interp3D_data x3D; /**< x(rho, theta, phi) otherwise                     */
+} fluxmap_data;
+
+int fluxmap_size(int n_rho, int n_theta, int n_phi);
+
+int fluxmap_init(fluxmap_data* map, real* c, int n_rho, int n_theta,
+                 int n_phi, real rho_max, B_field_data* Bdata);
+
+void fluxmap_init_spline(fluxmap_data* map, real* c, int n_rho, int n_theta,
+                         int n_phi, real rho_max);
+
+a5err fluxmap_newton(real rz[2], real rho, real theta, real phi, real x0,
+                     int maxiter, real tol, B_field_data* Bdata);
+
+a5err fluxmap_eval_rz(real rz[2], real rho, real theta, real phi,
+                      int maxiter, real tol, fluxmap_data* map,
+                      B_field_data* Bdata);
+
+#endif
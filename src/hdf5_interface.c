@@ -5,6 +5,8 @@
  * This module handles IO operations to HDF5 file. Accessing HDF5 files
  * from the main program should be done using this module.
  */
+#include <float.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,6 +15,7 @@
 #include <hdf5_hl.h>
 #include "ascot5.h"
 #include "simulate.h"
+#include "endcond.h"
 #include "print.h"
 #include "gitver.h"
 #include "compiler_flags.h"
@@ -31,10 +34,13 @@
 #include "hdf5io/hdf5_dist.h"
 #include "hdf5io/hdf5_orbit.h"
 #include "hdf5io/hdf5_transcoef.h"
+#include "hdf5io/hdf5_wallload.h"
 #include "hdf5io/hdf5_asigma.h"
 #include "hdf5io/hdf5_nbi.h"
 
 int hdf5_get_active_qid(hid_t f, const char* group, char qid[11]);
+void hdf5_interface_time_window(sim_offload_data* sim, input_particle* p,
+                                int n, real t_window[2]);
 
 /**
  * @brief Read and initialize input data
@@ -113,6 +119,36 @@ int hdf5_interface_read_input(sim_offload_data* sim,
         print_out(VERBOSE_IO, "Options read and initialized.\n");
     }
 
+    if(input_active & hdf5_input_marker) {
+        if(hdf5_find_group(f, "/marker/")) {
+            print_err("Error: No marker data in input file.");
+            return 1;
+        }
+        print_out(VERBOSE_IO, "\nReading marker input.\n");
+        if(sim->qid_marker[0] != '\0') {
+            strcpy(qid, sim->qid_marker);
+        }
+        else if( hdf5_get_active_qid(f, "/marker/", qid) ) {
+            print_err("Error: Active QID not declared.");
+            return 1;
+        }
+        strcpy(sim->qid_marker, qid);
+        print_out(VERBOSE_IO, "Active QID is %s\n", qid);
+        if( hdf5_marker_read(f, n_markers, p, qid) ) {
+            print_err("Error: Failed to read markers.\n");
+            return 1;
+        }
+        print_out(VERBOSE_IO, "Marker data read and initialized.\n");
+    }
+
+    /* Time window the simulation may access. Used to limit the amount of
+       time-dependent data that is read. */
+    real t_window[2] = {-DBL_MAX, DBL_MAX};
+    if( (input_active & hdf5_input_marker)
+        && (input_active & hdf5_input_options) ) {
+        hdf5_interface_time_window(sim, *p, *n_markers, t_window);
+    }
+
     if(input_active & hdf5_input_bfield) {
         if(hdf5_find_group(f, "/bfield/")) {
             print_err("Error: No magnetic field in input file.");
@@ -129,7 +165,8 @@ int hdf5_interface_read_input(sim_offload_data* sim,
         strcpy(sim->qid_bfield, qid);
         print_out(VERBOSE_IO, "Active QID is %s\n", qid);
         if( hdf5_bfield_init_offload(f, &(sim->B_offload_data),
-                                     B_offload_array, qid) ) {
+                                     B_offload_array, qid,
+                                     t_window[0], t_window[1]) ) {
             print_err("Error: Failed to initialize magnetic field.\n");
             return 1;
         }
@@ -321,28 +358,6 @@ int hdf5_interface_read_input(sim_offload_data* sim,
         print_out(VERBOSE_IO, "NBI data read and initialized.\n");
     }
 
-    if(input_active & hdf5_input_marker) {
-        if(hdf5_find_group(f, "/marker/")) {
-            print_err("Error: No marker data in input file.");
-            return 1;
-        }
-        print_out(VERBOSE_IO, "\nReading marker input.\n");
-        if(sim->qid_marker[0] != '\0') {
-            strcpy(qid, sim->qid_marker);
-        }
-        else if( hdf5_get_active_qid(f, "/marker/", qid) ) {
-            print_err("Error: Active QID not declared.");
-            return 1;
-        }
-        strcpy(sim->qid_marker, qid);
-        print_out(VERBOSE_IO, "Active QID is %s\n", qid);
-        if( hdf5_marker_read(f, n_markers, p, qid) ) {
-            print_err("Error: Failed to read markers.\n");
-            return 1;
-        }
-        print_out(VERBOSE_IO, "Marker data read and initialized.\n");
-    }
-
     /* Close the hdf5 file */
     if( hdf5_close(f) ) {
         print_err("Error: Could not close the file.\n");
@@ -353,6 +368,36 @@ int hdf5_interface_read_input(sim_offload_data* sim,
     return 0;
 }
 
+/**
+ * @brief Store the magnetic field spline coefficients in the input file
+ *
+ * The coefficients are stored only if the cache was enabled and they were not
+ * read from it, see hdf5_bfield_write_cache(). Failure to store them is not
+ * an error as the cache only speeds up the initialization of later runs.
+ *
+ * @param sim pointer to simulation offload data
+ * @param B_offload_array initialized magnetic field offload array
+ */
+void hdf5_interface_write_spline_cache(sim_offload_data* sim,
+                                       real* B_offload_array) {
+    if(sim->B_offload_data.spline_hash[0] == '\0') {
+        return;
+    }
+    hid_t f = hdf5_open(sim->hdf5_in);
+    if( f < 0 || hdf5_bfield_write_cache(f, &(sim->B_offload_data),
+                                         B_offload_array, sim->qid_bfield) ) {
+        print_err("Warning: Could not store spline coefficients in %s.\n",
+                  sim->hdf5_in);
+    }
+    else {
+        print_out(VERBOSE_IO, "Spline coefficients stored in cache %s.\n",
+                  sim->B_offload_data.spline_hash);
+    }
+    if(f >= 0) {
+        hdf5_close(f);
+    }
+}
+
 /**
  * @brief Initialize run group
  *
@@ -687,6 +732,16 @@ int hdf5_interface_write_diagnostics(sim_offload_data* sim,
         }
     }
 
+    if(sim->diag_offload_data.diagwall_collect) {
+        print_out(VERBOSE_IO, "Writing wall loads.\n");
+        int idx = sim->diag_offload_data.offload_diagwall_index;
+        sprintf(path, "%swallload", run);
+        if( hdf5_wallload_write(f, path, &sim->diag_offload_data.diagwall,
+                                &diag_offload_array[idx]) ) {
+            print_err("Warning: Wall loads could not be written.\n");
+        }
+    }
+
     hdf5_close(f);
 
     print_out(VERBOSE_IO, "\nDiagnostics output written.\n");
@@ -718,6 +773,63 @@ int hdf5_get_active_qid(hid_t f, const char* group, char qid[11]) {
     return 0;
 }
 
+/**
+ * @brief Find the time window the simulation may access
+ *
+ * The window begins at the earliest marker time and, if the simulation time
+ * limit is active, ends at the time limit or when the latest marker has used
+ * up its maximum mileage, whichever comes first. The window is mirrored when
+ * the simulation is run backwards in time.
+ *
+ * @param sim pointer to simulation offload data with options initialized
+ * @param p array of input markers
+ * @param n number of input markers
+ * @param t_window array where the window [t0, t1] is stored
+ */
+void hdf5_interface_time_window(sim_offload_data* sim, input_particle* p,
+                                int n, real t_window[2]) {
+    if(n < 1) {
+        return;
+    }
+
+    real tmin = DBL_MAX, tmax = -DBL_MAX;
+    for(int i = 0; i < n; i++) {
+        real t = 0;
+        switch(p[i].type) {
+            case input_particle_type_p:
+                t = p[i].p.time;
+                break;
+            case input_particle_type_gc:
+                t = p[i].p_gc.time;
+                break;
+            case input_particle_type_ml:
+                t = p[i].p_ml.time;
+                break;
+            case input_particle_type_s:
+                t = p[i].p_s.time;
+                break;
+        }
+        tmin = fmin(tmin, t);
+        tmax = fmax(tmax, t);
+    }
+
+    int tlim = sim->endcond_active & endcond_tlim;
+    if(!sim->reverse_time) {
+        t_window[0] = tmin;
+        if(tlim) {
+            t_window[1] = fmin(sim->endcond_lim_simtime,
+                               tmax + sim->endcond_max_mileage);
+        }
+    }
+    else {
+        t_window[1] = tmax;
+        if(tlim) {
+            t_window[0] = fmax(sim->endcond_lim_simtime,
+                               tmin - sim->endcond_max_mileage);
+        }
+    }
+}
+
 /**
  * @brief Generate an identification number for a run
  *
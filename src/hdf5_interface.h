@@ -46,6 +46,9 @@ int hdf5_interface_read_input(sim_offload_data* sim,
                               input_particle** p,
                               int* n_markers);
 
+void hdf5_interface_write_spline_cache(sim_offload_data* sim,
+                                       real* B_offload_array);
+
 int hdf5_interface_init_results(sim_offload_data* sim, char* qid, char* run);
 
 int hdf5_interface_write_state(char* fn, char* state, integer n,
@@ -16,6 +16,8 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include <hdf5.h>
 #include <hdf5_hl.h>
@@ -29,6 +31,7 @@
 #include "../Bfield/B_STS.h"
 #include "../Bfield/B_TC.h"
 #include "../Bfield/B_GS.h"
+#include "../Bfield/B_3DST.h"
 #include "hdf5_helpers.h"
 #include "hdf5_bfield.h"
 
@@ -38,12 +41,18 @@ int hdf5_bfield_read_2DS(hid_t f, B_2DS_offload_data* offload_data,
                          real** offload_array, char* qid);
 int hdf5_bfield_read_3DS(hid_t f, B_3DS_offload_data* offload_data,
                          real** offload_array, char* qid);
+int hdf5_bfield_read_3DST(hid_t f, B_3DST_offload_data* offload_data,
+                          real** offload_array, char* qid, real t0, real t1);
 int hdf5_bfield_read_STS(hid_t f, B_STS_offload_data* offload_data,
                          real** offload_array, char* qid);
 int hdf5_bfield_read_TC(hid_t f, B_TC_offload_data* offload_data,
                         real** offload_array, char* qid);
 int hdf5_bfield_read_GS(hid_t f, B_GS_offload_data* offload_data,
                         real** offload_array, char* qid);
+int hdf5_bfield_cache_key(B_field_offload_data* offload_data,
+                          real* offload_array, char* qid);
+int hdf5_bfield_read_cache(hid_t f, B_field_offload_data* offload_data,
+                           real** offload_array);
 
 /**
  * @brief Initialize magnetic field offload data from HDF5 file
@@ -57,17 +66,23 @@ int hdf5_bfield_read_GS(hid_t f, B_GS_offload_data* offload_data,
  * their respective groups as long as the group name contains QID as an
  * identifier.
  *
+ * Time-dependent fields only read the data that is needed to cover the time
+ * window [t0, t1] which the simulation may access.
+ *
  * @param f HDF5 file identifier for a file which is opened and closed outside
  *          of this function
  * @param offload_data pointer to offload data struct which is initialized here
  * @param offload_array pointer to offload array which is allocated and
  *                      initialized here
  * @param qid QID of the data that is to be read
+ * @param t0 beginning of the simulation time window [s]
+ * @param t1 end of the simulation time window [s]
  *
  * @return zero if reading and initialization succeeded
  */
 int hdf5_bfield_init_offload(hid_t f, B_field_offload_data* offload_data,
-                             real** offload_array, char* qid) {
+                             real** offload_array, char* qid,
+                             real t0, real t1) {
 
     char path[256]; // Storage array required for hdf5_gen_path() calls
     int err = 1;    // Error flag which is nullified if data is read succesfully
@@ -102,6 +117,13 @@ int hdf5_bfield_init_offload(hid_t f, B_field_offload_data* offload_data,
                                    offload_array, qid);
     }
 
+    hdf5_gen_path("/bfield/B_3DST_XXXXXXXXXX", qid, path);
+    if( !hdf5_find_group(f, path) ) {
+        offload_data->type = B_field_type_3DST;
+        err = hdf5_bfield_read_3DST(f, &(offload_data->B3DST),
+                                    offload_array, qid, t0, t1);
+    }
+
     hdf5_gen_path("/bfield/B_STS_XXXXXXXXXX", qid, path);
     if( !hdf5_find_group(f, path) ) {
         offload_data->type = B_field_type_STS;
@@ -109,6 +131,20 @@ int hdf5_bfield_init_offload(hid_t f, B_field_offload_data* offload_data,
                                    offload_array, qid);
     }
 
+    /* Use cached spline coefficients if they exist. Otherwise the key is
+       left in the offload data so that the coefficients are stored once
+       they have been evaluated. */
+    offload_data->spline_hash[0] = '\0';
+    offload_data->B3DS.precomputed = 0;
+    offload_data->BSTS.precomputed = 0;
+    if(!err && offload_data->spline_cache
+       && !hdf5_bfield_cache_key(offload_data, *offload_array, qid)
+       && !hdf5_bfield_read_cache(f, offload_data, offload_array)) {
+        print_out(VERBOSE_IO, "Spline coefficients read from cache %s.\n",
+                  offload_data->spline_hash);
+        offload_data->spline_hash[0] = '\0';
+    }
+
     /* Initialize if data was read succesfully */
     if(!err) {
         err = B_field_init_offload(offload_data, offload_array);
@@ -332,6 +368,168 @@ int hdf5_bfield_read_3DS(hid_t f, B_3DS_offload_data* offload_data,
     return 0;
 }
 
+/**
+ * @brief Read magnetic field data of type B_3DST
+ *
+ * The B_3DST data is stored in HDF5 file under the group
+ * /bfield/B_3DST_XXXXXXXXXX/ where X's mark the QID.
+ *
+ * The group holds the same datasets as B_3DS (see hdf5_bfield_read_3DS())
+ * with the exception that B data has an additional time dimension:
+ *
+ * - int b_nt Number of time slices in the B data
+ * - double b_tmin Time of the first slice [s]
+ * - double b_tmax Time of the last slice [s]
+ * - double br   Magnetic field R component as
+ *               a {b_nt, b_nz, b_nphi, b_nr} matrix [T]
+ * - double bphi Magnetic field phi component as
+ *               a {b_nt, b_nz, b_nphi, b_nr} matrix [T]
+ * - double bz   Magnetic field z component as
+ *               a {b_nt, b_nz, b_nphi, b_nr} matrix [T]
+ *
+ * Only the time slices needed to interpolate the field within [t0, t1] are
+ * read, so the memory footprint is set by the simulated time window and not by
+ * the number of slices in the input.
+ *
+ * @param f HDF5 file identifier for a file which is opened and closed outside
+ *          of this function
+ * @param offload_data pointer to offload data struct which is allocated here
+ * @param offload_array pointer to offload array which is allocated here and
+ *                      used to store psi, B_R, B_phi, and B_z values as
+ *                      required by B_3DST_init_offload()
+ * @param qid QID of the B_3DST field that is to be read
+ * @param t0 beginning of the simulation time window [s]
+ * @param t1 end of the simulation time window [s]
+ *
+ * @return zero if reading succeeded
+ */
+int hdf5_bfield_read_3DST(hid_t f, B_3DST_offload_data* offload_data,
+                          real** offload_array, char* qid, real t0, real t1) {
+    #undef BPATH
+    #define BPATH "/bfield/B_3DST_XXXXXXXXXX/"
+
+    /* Read and initialize magnetic field Rpz-grid */
+    if( hdf5_read_int(BPATH "b_nr", &(offload_data->Bgrid_n_r),
+                      f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_int(BPATH "b_nz", &(offload_data->Bgrid_n_z),
+                      f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "b_rmin", &(offload_data->Bgrid_r_min),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "b_rmax", &(offload_data->Bgrid_r_max),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "b_zmin", &(offload_data->Bgrid_z_min),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "b_zmax", &(offload_data->Bgrid_z_max),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+
+    if( hdf5_read_int(BPATH "b_nphi", &(offload_data->Bgrid_n_phi),
+                      f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "b_phimin", &(offload_data->Bgrid_phi_min),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "b_phimax", &(offload_data->Bgrid_phi_max),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+
+    // Convert to radians
+    offload_data->Bgrid_phi_min = math_deg2rad(offload_data->Bgrid_phi_min);
+    offload_data->Bgrid_phi_max = math_deg2rad(offload_data->Bgrid_phi_max);
+
+    /* Read the time grid */
+    if( hdf5_read_int(BPATH "b_nt", &(offload_data->Bgrid_n_t),
+                      f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "b_tmin", &(offload_data->Bgrid_t_min),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "b_tmax", &(offload_data->Bgrid_t_max),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+
+    /* Read and initialize psi field Rz-grid */
+    if( hdf5_read_int(BPATH "psi_nr", &(offload_data->psigrid_n_r),
+                      f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_int(BPATH "psi_nz", &(offload_data->psigrid_n_z),
+                      f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "psi_rmin", &(offload_data->psigrid_r_min),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "psi_rmax", &(offload_data->psigrid_r_max),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "psi_zmin", &(offload_data->psigrid_z_min),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "psi_zmax", &(offload_data->psigrid_z_max),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+
+    /* Find the slices that bracket the time window. The slice index is found
+     * the same way as in B_3DST.c, and the slice following the last index is
+     * needed for the interpolation. */
+    int n_t = offload_data->Bgrid_n_t;
+    int i0  = 0;
+    int i1  = n_t - 1;
+    if(n_t > 1) {
+        real tmin   = offload_data->Bgrid_t_min;
+        real tmax   = offload_data->Bgrid_t_max;
+        real t_grid = (tmax - tmin) / (n_t - 1);
+        if(t0 > tmin) {
+            i0 = t0 < tmax ? (int)((t0 - tmin) / t_grid) : n_t - 2;
+            i0 = i0 > n_t - 2 ? n_t - 2 : i0;
+        }
+        if(t1 < tmax) {
+            i1 = t1 > tmin ? (int)((t1 - tmin) / t_grid) + 1 : 1;
+            i1 = i1 > n_t - 1 ? n_t - 1 : i1;
+            i1 = i1 < i0 + 1 ? i0 + 1 : i1;
+        }
+
+        /* One extra slice on both sides as the end condition is checked only
+           after the time step that crosses the window boundary */
+        i0 = i0 > 0 ? i0 - 1 : i0;
+        i1 = i1 < n_t - 1 ? i1 + 1 : i1;
+    }
+    offload_data->slice_i0 = i0;
+    offload_data->slice_n  = i1 - i0 + 1;
+
+    /* Allocate offload_array storing psi and the three components of B for
+       each resident slice */
+    int n_slice  = offload_data->slice_n;
+    int psi_size = offload_data->psigrid_n_r*offload_data->psigrid_n_z;
+    int B_size   = offload_data->Bgrid_n_r * offload_data->Bgrid_n_z
+        * offload_data->Bgrid_n_phi;
+
+    *offload_array = (real*) malloc((psi_size + 3 * n_slice * B_size)
+                                    * sizeof(real));
+    offload_data->offload_array_length = psi_size + 3 * n_slice * B_size;
+
+    /* Read psi */
+    if( hdf5_read_double(BPATH "psi", &(*offload_array)[3*n_slice*B_size],
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+
+    /* Read the resident slices of the magnetic field */
+    if( hdf5_read_double_slices(BPATH "br",
+                                &(*offload_array)[0*n_slice*B_size],
+                                i0, n_slice, f, qid, __FILE__, __LINE__) ) {
+        return 1;
+    }
+    if( hdf5_read_double_slices(BPATH "bphi",
+                                &(*offload_array)[1*n_slice*B_size],
+                                i0, n_slice, f, qid, __FILE__, __LINE__) ) {
+        return 1;
+    }
+    if( hdf5_read_double_slices(BPATH "bz",
+                                &(*offload_array)[2*n_slice*B_size],
+                                i0, n_slice, f, qid, __FILE__, __LINE__) ) {
+        return 1;
+    }
+
+    /* Read the poloidal flux (psi) values at magnetic axis and separatrix. */
+    if( hdf5_read_double(BPATH "psi0", &(offload_data->psi0),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "psi1", &(offload_data->psi1),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+
+    /* Read magnetic axis R and z coordinates */
+    if( hdf5_read_double(BPATH "axisr", &(offload_data->axis_r),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(BPATH "axisz", &(offload_data->axis_z),
+                         f, qid, __FILE__, __LINE__) ) {return 1;}
+
+    return 0;
+}
+
 /**
  * @brief Read magnetic field data of type B_STS
  *
@@ -620,3 +818,158 @@ int hdf5_bfield_read_GS(hid_t f, B_GS_offload_data* offload_data,
 
     return 0;
 }
+
+/**
+ * @brief Compute the key of cached spline coefficients
+ *
+ * The key is a 64-bit FNV-1a hash of the QID, field type, precision, grid
+ * parameters, and the data in the offload array as it was read from the file.
+ * It is stored in B_field_offload_data.spline_hash as a hexadecimal string.
+ * Only B_3DS and B_STS fields, whose coefficients are expensive to evaluate,
+ * support caching.
+ *
+ * @param offload_data pointer to offload data struct
+ * @param offload_array offload array containing the data read from the file
+ * @param qid QID of the magnetic field input
+ *
+ * @return zero if the key was computed, nonzero if caching is not supported
+ */
+int hdf5_bfield_cache_key(B_field_offload_data* offload_data,
+                          real* offload_array, char* qid) {
+    size_t n;
+    real grid[20];
+    int n_grid;
+    if(offload_data->type == B_field_type_3DS) {
+        B_3DS_offload_data* d = &(offload_data->B3DS);
+        real g[] = {d->psigrid_n_r, d->psigrid_n_z,
+                    d->psigrid_r_min, d->psigrid_r_max,
+                    d->psigrid_z_min, d->psigrid_z_max,
+                    d->Bgrid_n_r, d->Bgrid_n_z, d->Bgrid_n_phi,
+                    d->Bgrid_r_min, d->Bgrid_r_max,
+                    d->Bgrid_z_min, d->Bgrid_z_max,
+                    d->Bgrid_phi_min, d->Bgrid_phi_max,
+                    d->psi0, d->psi1, d->axis_r, d->axis_z};
+        n_grid = sizeof(g) / sizeof(real);
+        memcpy(grid, g, sizeof(g));
+        n = 3 * (size_t)d->Bgrid_n_r * d->Bgrid_n_z * d->Bgrid_n_phi
+            + (size_t)d->psigrid_n_r * d->psigrid_n_z;
+    }
+    else if(offload_data->type == B_field_type_STS) {
+        B_STS_offload_data* d = &(offload_data->BSTS);
+        real g[] = {d->psigrid_n_r, d->psigrid_n_z, d->psigrid_n_phi,
+                    d->psigrid_r_min, d->psigrid_r_max,
+                    d->psigrid_z_min, d->psigrid_z_max,
+                    d->psigrid_phi_min, d->psigrid_phi_max,
+                    d->Bgrid_n_r, d->Bgrid_n_z, d->Bgrid_n_phi,
+                    d->Bgrid_r_min, d->Bgrid_r_max,
+                    d->Bgrid_z_min, d->Bgrid_z_max,
+                    d->Bgrid_phi_min, d->Bgrid_phi_max,
+                    d->psi0, d->psi1};
+        n_grid = sizeof(g) / sizeof(real);
+        memcpy(grid, g, sizeof(g));
+        n = 3 * (size_t)d->Bgrid_n_r * d->Bgrid_n_z * d->Bgrid_n_phi
+            + (size_t)d->psigrid_n_r * d->psigrid_n_z * d->psigrid_n_phi
+            + 2 * (size_t)d->n_axis;
+    }
+    else {
+        return 1;
+    }
+
+    int header[2] = {offload_data->type, offload_data->single_precision};
+    uint64_t h = 14695981039346656037ULL;
+    const unsigned char* data[4] = {(unsigned char*)qid,
+                                    (unsigned char*)header,
+                                    (unsigned char*)grid,
+                                    (unsigned char*)offload_array};
+    size_t size[4] = {strlen(qid), sizeof(header), n_grid*sizeof(real),
+                      n*sizeof(real)};
+    for(int j = 0; j < 4; j++) {
+        for(size_t i = 0; i < size[j]; i++) {
+            h = ( h ^ data[j][i] ) * 1099511628211ULL;
+        }
+    }
+    sprintf(offload_data->spline_hash, "%016llx", (unsigned long long)h);
+    return 0;
+}
+
+/**
+ * @brief Read cached spline coefficients
+ *
+ * The coefficients are stored in /splinecache/B_XXXXXXXXXXXXXXXX/coeff
+ * where X's are the key computed by hdf5_bfield_cache_key(). If found, the
+ * offload array is replaced with the coefficients and the field is marked as
+ * precomputed so that B_field_init_offload() uses them as such.
+ *
+ * @param f HDF5 file identifier
+ * @param offload_data pointer to offload data struct
+ * @param offload_array pointer to offload array which is reallocated here
+ *
+ * @return zero if the coefficients were found and read
+ */
+int hdf5_bfield_read_cache(hid_t f, B_field_offload_data* offload_data,
+                           real** offload_array) {
+    char path[256];
+    sprintf(path, "/splinecache/B_%s/coeff", offload_data->spline_hash);
+    if( hdf5_find_group(f, path) ) {
+        return 1;
+    }
+
+    hsize_t dims[1];
+    if( H5LTget_dataset_info(f, path, dims, NULL, NULL) < 0 ) {
+        return 1;
+    }
+    real* coeff = (real*) malloc(dims[0] * sizeof(real));
+    if( coeff == NULL || H5LTread_dataset_double(f, path, coeff) < 0 ) {
+        free(coeff);
+        return 1;
+    }
+
+    free(*offload_array);
+    *offload_array = coeff;
+    if(offload_data->type == B_field_type_3DS) {
+        offload_data->B3DS.precomputed = 1;
+        offload_data->B3DS.offload_array_length = dims[0];
+    }
+    else {
+        offload_data->BSTS.precomputed = 1;
+        offload_data->BSTS.offload_array_length = dims[0];
+    }
+    return 0;
+}
+
+/**
+ * @brief Store spline coefficients in the cache
+ *
+ * Does nothing if B_field_offload_data.spline_hash is empty, i.e. caching is
+ * not enabled or the coefficients were read from the cache.
+ *
+ * @param f HDF5 file identifier for a file opened with write access
+ * @param offload_data pointer to initialized offload data struct
+ * @param offload_array offload array containing the coefficients
+ * @param qid QID of the magnetic field input the coefficients belong to
+ *
+ * @return zero if the coefficients were stored or there was nothing to store
+ */
+int hdf5_bfield_write_cache(hid_t f, B_field_offload_data* offload_data,
+                            real* offload_array, char* qid) {
+    if(offload_data->spline_hash[0] == '\0') {
+        return 0;
+    }
+
+    char path[256];
+    sprintf(path, "/splinecache/B_%s", offload_data->spline_hash);
+    if( !hdf5_find_group(f, path) ) {
+        return 0;
+    }
+    hid_t grp = hdf5_create_group(f, path);
+    if(grp < 0) {
+        return 1;
+    }
+    hsize_t dims[1] = {offload_data->offload_array_length};
+    herr_t err = H5LTmake_dataset_double(grp, "coeff", 1, dims, offload_array);
+    H5Gclose(grp);
+    if( err < 0 || hdf5_write_string_attribute(f, path, "qid", qid) ) {
+        return 1;
+    }
+    return 0;
+}
@@ -11,9 +11,13 @@
 #include "../Bfield/B_STS.h"
 #include "../Bfield/B_GS.h"
 #include "../Bfield/B_TC.h"
+#include "../Bfield/B_3DST.h"
 #include "hdf5.h"
 
 int hdf5_bfield_init_offload(hid_t f, B_field_offload_data* offload_data,
-                             real** offload_array, char* qid);
+                             real** offload_array, char* qid,
+                             real t0, real t1);
+int hdf5_bfield_write_cache(hid_t f, B_field_offload_data* offload_data,
+                            real* offload_array, char* qid);
 
 #endif
@@ -244,6 +244,142 @@ int hdf5_read_long(const char* var, long* ptr, hid_t file, char* qid,
     return 0;
 }
 
+/**
+ * @brief Read a range of leading-dimension slices of double-valued data.
+ *
+ * Same as hdf5_read_double() except that only slices first, ...,
+ * first + count - 1 along the first (slowest varying) dimension of the dataset
+ * are read. This allows reading e.g. selected time slices of a large
+ * time-dependent dataset without reading the whole dataset into memory.
+ *
+ * The file is opened and closed outside of this function.
+ *
+ * @param var "dummy" (otherwise valid but with X's) path to variable
+ * @param ptr pointer where data will be stored
+ * @param first index of the first slice to be read
+ * @param count number of slices to be read
+ * @param file HDF5 file
+ * @param qid QID value
+ * @param errfile use macro __FILE__ here to indicate the file this function
+ *        was called
+ * @param errline use macro __LINE__ here to indicate the line this function
+ *        was called
+ *
+ * @return zero if success
+ */
+int hdf5_read_double_slices(const char* var, real* ptr, int first, int count,
+                            hid_t file, char* qid, const char* errfile,
+                            int errline) {
+    char temp[256];
+    hdf5_gen_path(var, qid, temp);
+
+    int err = 0;
+    hid_t dset   = H5Dopen(file, temp, H5P_DEFAULT);
+    hid_t fspace = dset < 0 ? -1 : H5Dget_space(dset);
+    int rank     = fspace < 0 ? -1 : H5Sget_simple_extent_ndims(fspace);
+    if(rank < 1 || rank > 8) {
+        err = 1;
+    }
+
+    hsize_t dims[8], start[8], block[8];
+    if(!err) {
+        H5Sget_simple_extent_dims(fspace, dims, NULL);
+        if(first < 0 || count < 1 || (hsize_t)(first + count) > dims[0]) {
+            err = 1;
+        }
+    }
+    if(!err) {
+        for(int i = 0; i < rank; i++) {
+            start[i] = 0;
+            block[i] = dims[i];
+        }
+        start[0] = first;
+        block[0] = count;
+        hid_t mspace = H5Screate_simple(rank, block, NULL);
+        if( H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, NULL, block,
+                                NULL) < 0
+            || H5Dread(dset, H5T_NATIVE_DOUBLE, mspace, fspace, H5P_DEFAULT,
+                       ptr) < 0 ) {
+            err = 1;
+        }
+        H5Sclose(mspace);
+    }
+    if(fspace >= 0) {
+        H5Sclose(fspace);
+    }
+    if(dset >= 0) {
+        H5Dclose(dset);
+    }
+
+    if(err) {
+        print_err("Error: could not read HDF5 dataset %s FILE %s LINE %d\n",
+                  temp, errfile, errline);
+    }
+    return err;
+}
+
+/**
+ * @brief Read double-valued data into every stride'th element of an array.
+ *
+ * Same as hdf5_read_double() except that consecutive elements of the dataset
+ * are stored stride elements apart, i.e. element i is stored in
+ * ptr[i * stride]. This allows reading several datasets directly into an
+ * interleaved array without temporary buffers.
+ *
+ * The file is opened and closed outside of this function.
+ *
+ * @param var "dummy" (otherwise valid but with X's) path to variable
+ * @param ptr pointer where the first element will be stored
+ * @param stride distance between stored elements
+ * @param file HDF5 file
+ * @param qid QID value
+ * @param errfile use macro __FILE__ here to indicate the file this function
+ *        was called
+ * @param errline use macro __LINE__ here to indicate the line this function
+ *        was called
+ *
+ * @return zero if success
+ */
+int hdf5_read_double_strided(const char* var, real* ptr, int stride,
+                             hid_t file, char* qid, const char* errfile,
+                             int errline) {
+    char temp[256];
+    hdf5_gen_path(var, qid, temp);
+
+    int err = 0;
+    hid_t dset   = H5Dopen(file, temp, H5P_DEFAULT);
+    hid_t fspace = dset < 0 ? -1 : H5Dget_space(dset);
+    hssize_t n   = fspace < 0 ? -1 : H5Sget_simple_extent_npoints(fspace);
+    if(n < 1 || stride < 1) {
+        err = 1;
+    }
+
+    if(!err) {
+        hsize_t size = (n - 1) * stride + 1;
+        hsize_t start = 0, step = stride, count = n;
+        hid_t mspace = H5Screate_simple(1, &size, NULL);
+        if( H5Sselect_hyperslab(mspace, H5S_SELECT_SET, &start, &step, &count,
+                                NULL) < 0
+            || H5Dread(dset, H5T_NATIVE_DOUBLE, mspace, fspace, H5P_DEFAULT,
+                       ptr) < 0 ) {
+            err = 1;
+        }
+        H5Sclose(mspace);
+    }
+    if(fspace >= 0) {
+        H5Sclose(fspace);
+    }
+    if(dset >= 0) {
+        H5Dclose(dset);
+    }
+
+    if(err) {
+        print_err("Error: could not read HDF5 dataset %s FILE %s LINE %d\n",
+                  temp, errfile, errline);
+    }
+    return err;
+}
+
 /**
  * @brief Write string attribute with null-padding.
  *
@@ -23,6 +23,12 @@ int hdf5_read_int(const char* var, int* ptr, hid_t file, char* qid,
                   const char* errfile, int errline);
 int hdf5_read_long(const char* var, long* ptr, hid_t file, char* qid,
                    const char* errfile, int errline);
+int hdf5_read_double_slices(const char* var, real* ptr, int first, int count,
+                            hid_t file, char* qid, const char* errfile,
+                            int errline);
+int hdf5_read_double_strided(const char* var, real* ptr, int stride,
+                             hid_t file, char* qid, const char* errfile,
+                             int errline);
 herr_t  hdf5_write_string_attribute(hid_t loc, const char* path,
                                     const char* attrname,  const char* string);
 herr_t hdf5_write_extendible_dataset_double(hid_t group,
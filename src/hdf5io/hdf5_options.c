@@ -77,6 +77,11 @@ int hdf5_options_read(hid_t file, sim_offload_data* sim, char* qid){
     if( hdf5_read_double(OPTPATH "FIXEDSTEP_GYRODEFINED", &tempfloat,
                          file, qid, __FILE__, __LINE__) ) {return 1;}
     sim->fix_gyrodef_nstep = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "FIXEDSTEP_CCOL_NSTEP", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->fix_ccol_nstep = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "FIXEDSTEP_CCOL_TOL", &sim->fix_ccol_tol,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
 
 
     if( hdf5_read_double(OPTPATH "ADAPTIVE_TOL_ORBIT", &sim->ada_tol_orbfol,
@@ -87,6 +92,29 @@ int hdf5_options_read(hid_t file, sim_offload_data* sim, char* qid){
                          file, qid, __FILE__, __LINE__) ) {return 1;}
     if( hdf5_read_double(OPTPATH "ADAPTIVE_MAX_DPHI", &sim->ada_max_dphi,
                          file, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(OPTPATH "BFIELD_SINGLE_PRECISION", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->B_offload_data.single_precision = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "BFIELD_SPLINE_CACHE", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->B_offload_data.spline_cache = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "MARKER_SORTING", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->marker_sorting = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "SIMD_WIDTH", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->simd_width = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "CONVERGENCE_MODE", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->converge_mode = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "CONVERGENCE_TOLERANCE", &sim->converge_tol,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(OPTPATH "CONVERGENCE_BATCH", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->converge_batch = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "CONVERGENCE_MIN_BATCHES", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->converge_min_batches = (int)tempfloat;
 
 
     if( hdf5_read_double(OPTPATH "ENABLE_ORBIT_FOLLOWING", &tempfloat,
@@ -116,6 +144,17 @@ int hdf5_options_read(hid_t file, sim_offload_data* sim, char* qid){
     if( hdf5_read_double(OPTPATH "REVERSE_TIME", &tempfloat,
                          file, qid, __FILE__, __LINE__) ) {return 1;}
     sim->reverse_time = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "ENABLE_SPLITTING", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->enable_split = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "SPLIT_RHO", &sim->split_rho,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    if( hdf5_read_double(OPTPATH "SPLIT_NUMBER", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->split_number = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "SPLIT_MAX_MARKERS", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    sim->split_max_markers = (int)tempfloat;
 
     int ec;
     sim->endcond_active = 0;
@@ -215,6 +254,9 @@ int hdf5_options_read(hid_t file, sim_offload_data* sim, char* qid){
     if( hdf5_read_double(OPTPATH "ENABLE_DIST_COM", &tempfloat,
                          file, qid, __FILE__, __LINE__) ) {return 1;}
     diag->distCOM_collect = (int)tempfloat;
+    if( hdf5_read_double(OPTPATH "ENABLE_WALLLOAD", &tempfloat,
+                         file, qid, __FILE__, __LINE__) ) {return 1;}
+    diag->diagwall_collect = (int)tempfloat;
     if( hdf5_read_double(OPTPATH "ENABLE_ORBITWRITE", &tempfloat,
                          file, qid, __FILE__, __LINE__) ) {return 1;}
     diag->diagorb_collect = (int)tempfloat;
@@ -147,6 +147,12 @@ int hdf5_state_write(hid_t f, char* run, char* state, integer n,
     hdf5_write_extendible_dataset_double(state_group, "cputime", n, data);
     H5LTset_attribute_string(state_group, "cputime", "unit", "s");
 
+    for(i = 0; i < n; i++) {
+        data[i] = p[i].mindt;
+    }
+    hdf5_write_extendible_dataset_double(state_group, "mindt", n, data);
+    H5LTset_attribute_string(state_group, "mindt", "unit", "s");
+
     for(i = 0; i < n; i++) {
         data[i] = p[i].rho;
     }
@@ -207,6 +213,24 @@ int hdf5_state_write(hid_t f, char* run, char* state, integer n,
     hdf5_write_extendible_dataset_long(state_group, "walltile", n, intdata);
     H5LTset_attribute_string(state_group, "walltile", "unit", "1");
 
+    for(i = 0; i < n; i++) {
+        intdata[i] = p[i].nstep;
+    }
+    hdf5_write_extendible_dataset_long(state_group, "nstep", n, intdata);
+    H5LTset_attribute_string(state_group, "nstep", "unit", "1");
+
+    for(i = 0; i < n; i++) {
+        intdata[i] = p[i].nrej;
+    }
+    hdf5_write_extendible_dataset_long(state_group, "nrej", n, intdata);
+    H5LTset_attribute_string(state_group, "nrej", "unit", "1");
+
+    for(i = 0; i < n; i++) {
+        intdata[i] = p[i].mindtlim;
+    }
+    hdf5_write_extendible_dataset_long(state_group, "mindtlim", n, intdata);
+    H5LTset_attribute_string(state_group, "mindtlim", "unit", "1");
+
     free(intdata);
 
     int* intdata32 = (int*) malloc(n * sizeof(int));
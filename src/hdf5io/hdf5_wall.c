@@ -127,32 +127,21 @@ int hdf5_wall_read_3D(hid_t f, wall_3d_offload_data* offload_data,
                       f, qid, __FILE__, __LINE__) ) {return 1;}
     offload_data->n = nelements;
 
-    /* Allocate temporary arrays for x1x2x3, y1y2y3, z1z2z3 for each triangle */
-    real* x1x2x3 = (real*)malloc(3 * nelements * sizeof(real));
-    real* y1y2y3 = (real*)malloc(3 * nelements * sizeof(real));
-    real* z1z2z3 = (real*)malloc(3 * nelements * sizeof(real));
-
-    if( hdf5_read_double(WPATH "x1x2x3", x1x2x3,
-                         f, qid, __FILE__, __LINE__) ) {return 1;}
-    if( hdf5_read_double(WPATH "y1y2y3", y1y2y3,
-                         f, qid, __FILE__, __LINE__) ) {return 1;}
-    if( hdf5_read_double(WPATH "z1z2z3", z1z2z3,
-                         f, qid, __FILE__, __LINE__) ) {return 1;}
-
     /* The data in the offload array is to be in the format
      *  [x1 y1 z1 x2 y2 z2 x3 y3 z3; ... ]
+     * so each coordinate is read directly into every third element.
      */
     *offload_array = (real*)malloc(9 * nelements * sizeof(real));
     offload_data->offload_array_length = 9 * nelements;
-    for(int i = 0; i < nelements; i++) {
-        for(int j = 0; j < 3; j++) {
-            (*offload_array)[i*9 + j*3 + 0] = x1x2x3[3*i+j];
-            (*offload_array)[i*9 + j*3 + 1] = y1y2y3[3*i+j];
-            (*offload_array)[i*9 + j*3 + 2] = z1z2z3[3*i+j];
-        }
+    if( hdf5_read_double_strided(WPATH "x1x2x3", &((*offload_array)[0]), 3,
+                                 f, qid, __FILE__, __LINE__)
+        || hdf5_read_double_strided(WPATH "y1y2y3", &((*offload_array)[1]), 3,
+                                    f, qid, __FILE__, __LINE__)
+        || hdf5_read_double_strided(WPATH "z1z2z3", &((*offload_array)[2]), 3,
+                                    f, qid, __FILE__, __LINE__) ) {
+        free(*offload_array);
+        *offload_array = NULL;
+        return 1;
     }
-    free(x1x2x3);
-    free(y1y2y3);
-    free(z1z2z3);
     return 0;
 }
@@ -0,0 +1,99 @@
+/**
+ * @file hdf5_wallload.c
+ * @brief Module for writing accumulated wall loads to a HDF5 file
+ */
+#include <stdlib.h>
+#include <hdf5.h>
+#include <hdf5_hl.h>
+#include "hdf5_helpers.h"
+#include "../ascot5.h"
+#include "../diag/diag_wall.h"
+#include "hdf5_wallload.h"
+
+/**
+ * @brief Write wall loads to a HDF5 file
+ *
+ * Only the tiles that were hit by at least one marker are written. The
+ * incidence angles are averaged over markers and weighted by deposited power.
+ *
+ * @param f hdf5 file
+ * @param path path to group which is created here and where the data is stored
+ * @param data wall load diagnostics offload data
+ * @param loadarr array storing the accumulated loads
+ *
+ * @return zero on success
+ */
+int hdf5_wallload_write(hid_t f, char* path, diag_wall_offload_data* data,
+                        real* loadarr) {
+    hid_t group = H5Gcreate2(f, path, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if(group < 0) {
+        return 1;
+    }
+
+    int n = data->n_tile;
+    real* nmrk    = &loadarr[0*n];
+    real* pdepo   = &loadarr[1*n];
+    real* emrk    = &loadarr[2*n];
+    real* edepo   = &loadarr[3*n];
+    real* angmrk  = &loadarr[4*n];
+    real* angdepo = &loadarr[5*n];
+
+    /* Find wetted tiles */
+    int datasize = 0;
+    for(int i = 0; i < n; i++) {
+        if(nmrk[i] > 0) {
+            datasize++;
+        }
+    }
+
+    integer* idarr  = (integer*) malloc(datasize * sizeof(integer));
+    real* nmrkarr   = (real*) malloc(datasize * sizeof(real));
+    real* pdepoarr  = (real*) malloc(datasize * sizeof(real));
+    real* edepoarr  = (real*) malloc(datasize * sizeof(real));
+    real* emrkarr   = (real*) malloc(datasize * sizeof(real));
+    real* iangarr   = (real*) malloc(datasize * sizeof(real));
+    real* iangmarr  = (real*) malloc(datasize * sizeof(real));
+    int j = 0;
+    for(int i = 0; i < n; i++) {
+        if(nmrk[i] > 0) {
+            idarr[j]    = i + 1;
+            nmrkarr[j]  = nmrk[i];
+            pdepoarr[j] = pdepo[i];
+            edepoarr[j] = edepo[i];
+            emrkarr[j]  = emrk[i];
+            iangarr[j]  = edepo[i] > 0 ? angdepo[i] / edepo[i] : 0;
+            iangmarr[j] = angmrk[i] / nmrk[i];
+            j++;
+        }
+    }
+
+    hdf5_write_extendible_dataset_long(group, "ids", datasize, idarr);
+    hdf5_write_extendible_dataset_double(group, "nmrk", datasize, nmrkarr);
+    hdf5_write_extendible_dataset_double(group, "pdepo", datasize, pdepoarr);
+    hdf5_write_extendible_dataset_double(group, "edepo", datasize, edepoarr);
+    hdf5_write_extendible_dataset_double(group, "edepo_mrk", datasize,
+                                         emrkarr);
+    hdf5_write_extendible_dataset_double(group, "iangle", datasize, iangarr);
+    hdf5_write_extendible_dataset_double(group, "iangle_mrk", datasize,
+                                         iangmarr);
+    free(idarr);
+    free(nmrkarr);
+    free(pdepoarr);
+    free(edepoarr);
+    free(emrkarr);
+    free(iangarr);
+    free(iangmarr);
+
+    /* Write units */
+    H5LTset_attribute_string(group, "ids",        "unit", "1");
+    H5LTset_attribute_string(group, "nmrk",       "unit", "1");
+    H5LTset_attribute_string(group, "pdepo",      "unit", "markers/s");
+    H5LTset_attribute_string(group, "edepo",      "unit", "W");
+    H5LTset_attribute_string(group, "edepo_mrk",  "unit", "J");
+    H5LTset_attribute_string(group, "iangle",     "unit", "deg");
+    H5LTset_attribute_string(group, "iangle_mrk", "unit", "deg");
+
+    H5Gclose (group);
+
+    return 0;
+}
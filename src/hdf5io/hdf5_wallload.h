@@ -0,0 +1,15 @@
+/**
+ * @file hdf5_wallload.h
+ * @brief Header file for hdf5_wallload.c
+ */
+#ifndef HDF5_WALLLOAD_H
+#define HDF5_WALLLOAD_H
+
+#include <hdf5.h>
+#include "../ascot5.h"
+#include "../diag/diag_wall.h"
+
+int hdf5_wallload_write(hid_t f, char* path, diag_wall_offload_data* data,
+                        real* loadarr);
+
+#endif
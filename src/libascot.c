@@ -22,6 +22,9 @@
 #include "neutral.h"
 #include "boozer.h"
 #include "mhd.h"
+#include "fluxmap.h"
+#include "markergen.h"
+#include "fieldline.h"
 #include "asigma.h"
 #include "consts.h"
 #include "physlib.h"
@@ -173,6 +176,10 @@ void libascot_B_field_get_axis(
  * a given position, the corresponding (R,z) values in the output arrays are
  * not altered.
  *
+ * If map coefficients constructed with libascot_B_field_init_fluxmap() are
+ * given, the interpolated position is used as is when it is within the
+ * tolerance and as the initial guess for the Newton method otherwise.
+ *
  * @param sim_offload_data initialized simulation offload data struct
  * @param B_offload_array initialized magnetic field offload data
  * @param Neval number of query points.
@@ -184,59 +191,141 @@ void libascot_B_field_get_axis(
  * @param tol algorithm is stopped when |rho - rho(r,z)| < tol
  * @param r output array for R coordinates [m].
  * @param z output array for z coordinates [m].
+ * @param n_rho number of rho grid points in the map
+ * @param n_theta number of theta grid points in the map
+ * @param n_phi number of phi grid points in the map
+ * @param rho_max maximum rho in the map
+ * @param map map coefficients or NULL if the map is not used
  */
 void libascot_B_field_rhotheta2rz(
     sim_offload_data* sim_offload_data, real* B_offload_array, int Neval,
     real* rho, real* theta, real* phi, real t, int maxiter, real tol,
-    real* r, real* z) {
+    real* r, real* z, int n_rho, int n_theta, int n_phi, real rho_max,
+    real* map) {
 
     sim_data sim;
     B_field_init(&sim.B_data, &sim_offload_data->B_offload_data,
                  B_offload_array);
+    fluxmap_data fluxmap;
+    if(map != NULL) {
+        fluxmap_init_spline(&fluxmap, map, n_rho, n_theta, n_phi, rho_max);
+    }
 
     #pragma omp parallel for
     for(int j=0; j<Neval; j++) {
-        real axisrz[2];
-        real rhodrho[4];
-        if( B_field_get_axis_rz(axisrz, &sim.B_data, phi[j]) ) {
-            continue;
+        real rz[2];
+        a5err err;
+        if(map != NULL) {
+            err = fluxmap_eval_rz(rz, rho[j], theta[j], phi[j], maxiter, tol,
+                                  &fluxmap, &sim.B_data);
         }
-        if( B_field_eval_rho_drho(rhodrho, axisrz[0], phi[j], axisrz[1],
-                                  &sim.B_data)) {
-            continue;
+        else {
+            err = fluxmap_newton(rz, rho[j], theta[j], phi[j], 1e-1, maxiter,
+                                 tol, &sim.B_data);
         }
-        if( rhodrho[0] > rho[j] ) {
-            /* Due to padding, rho might not be exactly zero on the axis so we
-             * return the axis position for small values of queried rho */
-            r[j] = axisrz[0];
-            z[j] = axisrz[1];
-            continue;
+        if(!err) {
+            r[j] = rz[0];
+            z[j] = rz[1];
         }
+    }
+}
 
-        real x = 1e-1;
-        real rj, zj;
-        real costh = cos(theta[j]);
-        real sinth = sin(theta[j]);
-        for(int i=0; i<maxiter; i++) {
-            rj = axisrz[0] + x * costh;
-            zj = axisrz[1] + x * sinth;
-            if( B_field_eval_rho_drho(rhodrho, rj, phi[j], zj, &sim.B_data) ) {
-                break;
-            }
-            if( fabs(rho[j] - rhodrho[0]) < tol ) {
-                r[j] = rj;
-                z[j] = zj;
-                break;
-            }
+/**
+ * @brief Tabulate the (rho, theta, phi) to (R,z) map.
+ *
+ * @param sim_offload_data initialized simulation offload data struct
+ * @param B_offload_array initialized magnetic field offload data
+ * @param n_rho number of rho grid points
+ * @param n_theta number of theta grid points
+ * @param n_phi number of phi grid points or one for an axisymmetric field
+ * @param rho_max maximum rho in the map
+ * @param map output array of length fluxmap_size() for the coefficients
+ *
+ * @return zero if the map was constructed successfully
+ */
+int libascot_B_field_init_fluxmap(
+    sim_offload_data* sim_offload_data, real* B_offload_array, int n_rho,
+    int n_theta, int n_phi, real rho_max, real* map) {
 
-            real drhodx = costh * rhodrho[1] + sinth * rhodrho[3];
-            x = x - (rhodrho[0] - rho[j]) / drhodx;
-            if( x < 0 ) {
-                /* Try again starting closer from the axis */
-                x = (x + (rhodrho[0] - rho[j]) / drhodx) / 2;
-            }
-        }
+    sim_data sim;
+    B_field_init(&sim.B_data, &sim_offload_data->B_offload_data,
+                 B_offload_array);
+    fluxmap_data fluxmap;
+    return fluxmap_init(&fluxmap, map, n_rho, n_theta, n_phi, rho_max,
+                        &sim.B_data);
+}
+
+/**
+ * @brief Generate markers from 5D marker and particle distributions.
+ *
+ * Markers are sampled from the marker distribution and each marker in a cell
+ * is given an equal share of the physical particles in that cell. See
+ * markergen.c for details on the input layout.
+ *
+ * The magnetic field is only needed for markers sampled from
+ * (rho, theta, phi) or when particle markers are generated. Otherwise it need
+ * not be initialized.
+ *
+ * @param sim_offload_data initialized simulation offload data struct
+ * @param B_offload_array initialized magnetic field offload data
+ * @param nmrk number of markers to be generated
+ * @param n number of cells along each of the five abscissae
+ * @param edges abscissa edges in SI units
+ * @param spatial spatial basis, see markergen_spatial
+ * @param momentum momentum basis, see markergen_momentum
+ * @param mode type of the generated markers, see markergen_mode
+ * @param mass marker mass [kg]
+ * @param markerdist marker distribution
+ * @param particledist particle distribution [number of particles per cell]
+ * @param minweight minimum weight a marker must have or it is rejected
+ * @param seed random number generator seed
+ * @param maxiter maximum number of iterations in Newton algorithm
+ * @param tol algorithm is stopped when |rho - rho(r,z)| < tol
+ * @param r output array for R coordinates [m]
+ * @param phi output array for phi coordinates [rad]
+ * @param z output array for z coordinates [m]
+ * @param c1 output array for energy [J] or vR [m/s]
+ * @param c2 output array for pitch or vphi [m/s]
+ * @param c3 output array for gyroangle [rad] or vz [m/s]
+ * @param weight output array for marker weights
+ * @param icell output array for marker cell indices
+ * @param n_rho number of rho grid points in the map
+ * @param n_theta number of theta grid points in the map
+ * @param n_phi number of phi grid points in the map
+ * @param rho_max maximum rho in the map
+ * @param map map coefficients or NULL if the map is not used
+ *
+ * @return zero if markers were generated successfully
+ */
+int libascot_generate_markers(
+    sim_offload_data* sim_offload_data, real* B_offload_array, int nmrk,
+    int* n, real* edges, int spatial, int momentum, int mode, real mass,
+    real* markerdist, real* particledist, real minweight, int seed,
+    int maxiter, real tol, real* r, real* phi, real* z, real* c1, real* c2,
+    real* c3, real* weight, integer* icell, int n_rho, int n_theta, int n_phi,
+    real rho_max, real* map) {
+
+    sim_data sim;
+    if(spatial == markergen_spatial_rhothetaphi
+       || mode == markergen_mode_prt) {
+        B_field_init(&sim.B_data, &sim_offload_data->B_offload_data,
+                     B_offload_array);
+    }
+    fluxmap_data fluxmap;
+    if(map != NULL) {
+        fluxmap_init_spline(&fluxmap, map, n_rho, n_theta, n_phi, rho_max);
     }
+
+    size_t n_cell = (size_t)n[0] * n[1] * n[2] * n[3] * n[4];
+    if( markergen_sample_cells(nmrk, n_cell, markerdist, particledist,
+                               minweight, seed, icell, weight) ) {
+        return 1;
+    }
+    markergen_sample_coordinates(nmrk, icell, n, edges, spatial, momentum,
+                                 mode, mass, seed, maxiter, tol,
+                                 map != NULL ? &fluxmap : NULL, &sim.B_data,
+                                 r, phi, z, c1, c2, c3);
+    return 0;
 }
 
 /**
@@ -302,6 +391,43 @@ void libascot_B_field_gradient_descent(
     }
 }
 
+/**
+ * @brief Evaluate connection lengths and wall hits of field lines
+ *
+ * See fieldline_connection() for the meaning of the output values.
+ *
+ * @param sim_offload_data initialized simulation offload data struct
+ * @param B_offload_array initialized magnetic field offload data
+ * @param wall_offload_array initialized wall offload data
+ * @param wall_int_offload_array initialized wall int offload data
+ * @param Neval number of starting points
+ * @param R R coordinates of the starting points [m]
+ * @param phi phi coordinates of the starting points [rad]
+ * @param z z coordinates of the starting points [m]
+ * @param t time at which the field is evaluated [s]
+ * @param lmax maximum length of the line in each direction [m]
+ * @param tol relative error tolerance of the integration
+ * @param lfwd output array for the length along the field [m]
+ * @param lbwd output array for the length against the field [m]
+ * @param tfwd output array for the tile hit along the field
+ * @param tbwd output array for the tile hit against the field
+ * @param rhomin output array for the minimum rho on the line
+ */
+void libascot_fieldline_connection(
+    sim_offload_data* sim_offload_data, real* B_offload_array,
+    real* wall_offload_array, int* wall_int_offload_array, int Neval,
+    real* R, real* phi, real* z, real t, real lmax, real tol, real* lfwd,
+    real* lbwd, int* tfwd, int* tbwd, real* rhomin) {
+
+    sim_data sim;
+    B_field_init(&sim.B_data, &sim_offload_data->B_offload_data,
+                 B_offload_array);
+    wall_init(&sim.wall_data, &sim_offload_data->wall_offload_data,
+              wall_offload_array, wall_int_offload_array);
+    fieldline_connection(Neval, R, phi, z, t, lmax, tol, &sim.B_data,
+                         &sim.wall_data, lfwd, lbwd, tfwd, tbwd, rhomin);
+}
+
 /**
  * @brief Evaluate electric field vector at given coordinates.
  *
@@ -893,6 +1019,159 @@ void libascot_eval_collcoefs(
     }
 }
 
+/**
+ * @brief Evaluate moments of a 5D distribution in a single pass.
+ *
+ * The histogram is traversed one spatial cell at a time. Magnetic field,
+ * plasma parameters, and (when power deposition is requested) the collision
+ * coefficients are evaluated once per cell and then reused for every
+ * momentum, charge, and time bin within that cell. Cells are distributed
+ * among OpenMP threads and each cell writes only its own output elements.
+ *
+ * The returned moments are integrated over the cell but not divided by the
+ * cell volume. Moments that depend only on the histogram are always stored.
+ * The toroidal current is left untouched in cells where the magnetic field
+ * could not be evaluated, and the power deposition where the plasma could not
+ * be evaluated (zero if the output arrays were initialized to zero).
+ *
+ * @param sim_offload_data initialized simulation offload data struct
+ * @param B_offload_array initialized magnetic field offload data
+ * @param plasma_offload_array initialized plasma offload data
+ * @param Ncell number of spatial cells
+ * @param R R coordinates of the cell centers [m]
+ * @param phi phi coordinates of the cell centers [rad]
+ * @param z z coordinates of the cell centers [m]
+ * @param t time at which input data is evaluated [s]
+ * @param Nppar number of parallel momentum bins
+ * @param ppar parallel momentum bin centers [kg*m/s]
+ * @param Npperp number of perpendicular momentum bins
+ * @param pperp perpendicular momentum bin centers [kg*m/s]
+ * @param Nq number of charge bins
+ * @param q charge bin centers [C]
+ * @param Ntime number of time bins
+ * @param ma test particle mass [kg]
+ * @param histogram particle weights in each bin, in row-major order
+ *        [cell, ppar, pperp, charge, time]
+ * @param density output array for number of particles
+ * @param chargedensity output array for charge [C]
+ * @param energydensity output array for kinetic energy [J]
+ * @param pressure output array for pressure times volume [J]
+ * @param toroidalcurrent output array for toroidal current times volume [A*m]
+ * @param parallelcurrent output array for parallel current times volume [A*m]
+ * @param powerdep output array for power deposited to plasma [W]
+ * @param electronpowerdep output array for power deposited to electrons [W]
+ * @param ionpowerdep output array for power deposited to ions [W]
+ */
+void libascot_eval_moments(
+    sim_offload_data* sim_offload_data, real* B_offload_array,
+    real* plasma_offload_array, int Ncell, real* R, real* phi, real* z, real t,
+    int Nppar, real* ppar, int Npperp, real* pperp, int Nq, real* q,
+    int Ntime, real ma, real* histogram, real* density, real* chargedensity,
+    real* energydensity, real* pressure, real* toroidalcurrent,
+    real* parallelcurrent, real* powerdep, real* electronpowerdep,
+    real* ionpowerdep) {
+
+    sim_data sim;
+    sim.mccc_data.usetabulated = 0;
+    B_field_init(&sim.B_data, &sim_offload_data->B_offload_data,
+                 B_offload_array);
+    plasma_init(&sim.plasma_data, &sim_offload_data->plasma_offload_data,
+                plasma_offload_array);
+
+    int n_species  = plasma_get_n_species(&sim.plasma_data);
+    const real* qb = plasma_get_species_charge(&sim.plasma_data);
+    const real* mb = plasma_get_species_mass(&sim.plasma_data);
+
+    int evalpower = powerdep != NULL || electronpowerdep != NULL
+        || ionpowerdep != NULL;
+    size_t cellsize = (size_t)Nppar * Npperp * Nq * Ntime;
+
+    #pragma omp parallel for schedule(dynamic)
+    for(int k=0; k<Ncell; k++) {
+        real B[3], psi, rho[2];
+        int Bok = !B_field_eval_B(B, R[k], phi[k], z[k], t, &sim.B_data);
+        int plasmaok = evalpower
+            && !B_field_eval_psi(&psi, R[k], phi[k], z[k], t, &sim.B_data)
+            && !B_field_eval_rho(rho, psi, &sim.B_data);
+        real nb[MAX_SPECIES], Tb[MAX_SPECIES];
+        plasmaok = plasmaok
+            && !plasma_eval_densandtemp(nb, Tb, rho[0], R[k], phi[k], z[k], t,
+                                        &sim.plasma_data);
+
+        real dens = 0, chrg = 0, ekin = 0, pres = 0, jpar = 0;
+        real pdep = 0, pdepe = 0, pdepi = 0;
+        real* h = histogram + k * cellsize;
+        for(int ipa=0; ipa<Nppar; ipa++) {
+            for(int ipe=0; ipe<Npperp; ipe++) {
+                real pnorm = sqrt(ppar[ipa]*ppar[ipa] + pperp[ipe]*pperp[ipe]);
+                real gamma = physlib_gamma_pnorm(ma, pnorm);
+                real va    = pnorm / (gamma * ma);
+                for(int iq=0; iq<Nq; iq++) {
+                    real w = 0;
+                    for(int it=0; it<Ntime; it++) {
+                        w += h[it];
+                    }
+                    h += Ntime;
+                    if(w == 0) {
+                        continue;
+                    }
+                    dens += w;
+                    chrg += w * q[iq];
+                    ekin += w * (gamma - 1.0) * ma * CONST_C2;
+                    pres += w * ma * va * va / 3;
+                    jpar += w * q[iq] * ppar[ipa] / ma;
+
+                    if(!plasmaok) {
+                        continue;
+                    }
+                    real clogab[MAX_SPECIES];
+                    mccc_coefs_clog(clogab, ma, q[iq], va, n_species, mb, qb,
+                                    nb, Tb);
+                    for(int ib=0; ib<n_species; ib++) {
+                        real mufun[3] = {0., 0., 0.};
+                        real vb = sqrt( 2 * Tb[ib] / mb[ib] );
+                        mccc_coefs_mufun(mufun, va / vb, &sim.mccc_data);
+                        real Qb      = mccc_coefs_Q(ma, q[iq], mb[ib], qb[ib],
+                                                    nb[ib], vb, clogab[ib],
+                                                    mufun[0]);
+                        real Dparab  = mccc_coefs_Dpara(ma, q[iq], va, qb[ib],
+                                                        nb[ib], vb, clogab[ib],
+                                                        mufun[0]);
+                        real dDparab = mccc_coefs_dDpara(ma, q[iq], va, qb[ib],
+                                                         nb[ib], vb, clogab[ib],
+                                                         mufun[0], mufun[2]);
+                        real Kb      = mccc_coefs_K(va, Dparab, dDparab, Qb);
+
+                        /* Minus because K is the drag acting on the particle */
+                        real pb = -w * Kb * ma * va;
+                        pdep += pb;
+                        if(ib == 0) {
+                            pdepe += pb;
+                        }
+                        else {
+                            pdepi += pb;
+                        }
+                    }
+                }
+            }
+        }
+
+        if(density != NULL)          { density[k]          = dens;           }
+        if(chargedensity != NULL)    { chargedensity[k]    = chrg;           }
+        if(energydensity != NULL)    { energydensity[k]    = ekin;           }
+        if(pressure != NULL)         { pressure[k]         = pres;           }
+        if(parallelcurrent != NULL)  { parallelcurrent[k]  = jpar;           }
+        if(toroidalcurrent != NULL && Bok) {
+            toroidalcurrent[k] = jpar * B[1] / math_norm(B);
+        }
+        if(plasmaok) {
+            if(powerdep != NULL)         { powerdep[k]         = pdep;  }
+            if(electronpowerdep != NULL) { electronpowerdep[k] = pdepe; }
+            if(ionpowerdep != NULL)      { ionpowerdep[k]      = pdepi; }
+        }
+    }
+}
+
 /**
  * @brief Evaluate atomic reaction rate coefficient.
  *
@@ -938,8 +1217,8 @@ void libascot_eval_ratecoeff(
 
     #pragma omp parallel for
     for (int k=0; k < Neval; k++) {
-        real psi[1], rho[2], T0[1], n[MAX_SPECIES], T[MAX_SPECIES],
-            n0[MAX_SPECIES];
+        real psi[1], rho[2], T0[MAX_SPECIES], n[MAX_SPECIES],
+            T[MAX_SPECIES], n0[MAX_SPECIES];
         if( B_field_eval_psi(psi, R[k], phi[k], z[k], t[k], &sim.B_data) ) {
             continue;
         }
@@ -950,12 +1229,8 @@ void libascot_eval_ratecoeff(
                                     &sim.plasma_data) ) {
             continue;
         }
-        if( neutral_eval_t0(T0, rho[0], R[k], phi[k], z[k], t[k],
-                            &sim.neutral_data) ) {
-            continue;
-        }
-        if( neutral_eval_n0(n0, rho[0], R[k], phi[k], z[k], t[k],
-                            &sim.neutral_data) ) {
+        if( neutral_eval_n0t0(n0, T0, rho[0], R[k], phi[k], z[k], t[k],
+                              &sim.neutral_data) ) {
             continue;
         }
         for (int j=0; j < Nv; j++) {
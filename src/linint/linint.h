@@ -8,6 +8,10 @@
  * The interpolant does not need any initialization on the host. After
  * offloading is done, call linintXD_init() which assigns the values and
  * a pointer to the data to a linint struct.
+ *
+ * Several quantities given on the same grid can be interpolated at once with
+ * linintXD_eval_fn() when their values are stored interleaved so that all
+ * quantities at a grid node are contiguous.
  */
 #ifndef LININT_H
 #define LININT_H
@@ -66,6 +70,26 @@ typedef struct {
     real* c;     /**< pointer to array with interpolant values       */
 } linint3D_data;
 
+/**
+ * @brief Interval search struct for a tabulated, non-decreasing grid.
+ */
+typedef struct {
+    int n_x;     /**< number of grid points                          */
+    int n_bin;   /**< number of search bins or zero if grid uniform  */
+    real x_min;  /**< first grid point                               */
+    real x_bin;  /**< bin width or grid interval if grid is uniform  */
+    real* x;     /**< pointer to array with the grid points          */
+    real* bin;   /**< pointer to array with the first interval index
+                      in each bin                                    */
+} linint_search_data;
+
+int linint_search_nbin(real* x, int n_x);
+
+void linint_search_fill(real* bin, int n_bin, real* x, int n_x);
+
+void linint_search_init(linint_search_data* str, real* x, int n_x,
+                        real* bin, int n_bin);
+
 void linint1D_init(linint1D_data* str, real* c,
                    int n_x, int bc_x,
                    real x_min, real x_max);
@@ -82,9 +106,15 @@ void linint3D_init(linint3D_data* str, real* c,
                    real y_min, real y_max,
                    real z_min, real z_max);
 
+GPU_DECLARE_TARGET_SIMD_UNIFORM(str)
+int linint_search(real x, linint_search_data* str);
+DECLARE_TARGET_END
 GPU_DECLARE_TARGET_SIMD_UNIFORM(str)
 int linint1D_eval_f(real* f, linint1D_data* str, real x);
 DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(str, n_f)
+int linint1D_eval_fn(real* f, int n_f, linint1D_data* str, real x);
+DECLARE_TARGET_END
 GPU_DECLARE_TARGET_SIMD_UNIFORM(str)
 int linint2D_eval_f(real* f, linint2D_data* str, real x, real y);
 DECLARE_TARGET_END
@@ -92,4 +122,8 @@ GPU_DECLARE_TARGET_SIMD_UNIFORM(str)
 int linint3D_eval_f(real* f, linint3D_data* str,
                     real x, real y, real z);
 DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(str, n_f)
+int linint3D_eval_fn(real* f, int n_f, linint3D_data* str,
+                     real x, real y, real z);
+DECLARE_TARGET_END
 #endif
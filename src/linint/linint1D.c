@@ -74,3 +74,53 @@ int linint1D_eval_f(real* f, linint1D_data* str, real x) {
     }
     return err;
 }
+
+/**
+ * @brief Evaluate interpolated values of several 1D scalar fields
+ *
+ * The fields are given on the same grid and their values are stored
+ * interleaved, c[i_x*n_f + k] being the value of k:th field at i_x:th grid
+ * point. The cell search is done once and the result for each field is the
+ * same as given by linint1D_eval_f().
+ *
+ * @param f array of length n_f in which to place the evaluated values
+ * @param n_f number of fields
+ * @param str data struct for data interpolation
+ * @param x x-coordinate
+ *
+ * @return zero on success and one if x point is outside the grid.
+ */
+int linint1D_eval_fn(real* f, int n_f, linint1D_data* str, real x) {
+
+    /* Make sure periodic coordinates are within [max, min] region. */
+    if(str->bc_x == PERIODICBC) {
+        x = fmod(x - str->x_min, str->x_max - str->x_min) + str->x_min;
+        x = x + (x < str->x_min) * (str->x_max - str->x_min);
+    }
+
+    /* index for x variable */
+    int i_x   = (x-str->x_min) / str->x_grid;
+    /**< Normalized x coordinate in current cell */
+    real dx = ( x - (str->x_min + i_x*str->x_grid)) / str->x_grid;
+
+    int x1 = 1;   /* Index jump one x forward */
+
+    int err = 0;
+
+    /* Enforce periodic BC or check that the coordinate is within the grid. */
+    if( str->bc_x == PERIODICBC && i_x == str->n_x-1 ) {
+        x1 = -(str->n_x-1)*x1;
+    }
+    else if( str->bc_x == NATURALBC && !(x >= str->x_min && x <= str->x_max) ) {
+        err = 1;
+    }
+
+    if(!err) {
+        real* c0 = &str->c[i_x*n_f];
+        real* c1 = &str->c[(i_x + x1)*n_f];
+        for(int k = 0; k < n_f; k++) {
+            f[k] = c0[k]*(1 - dx) + c1[k]*dx;
+        }
+    }
+    return err;
+}
@@ -152,3 +152,107 @@ int linint3D_eval_f(real* f, linint3D_data* str, real x, real y, real z) {
 
     return err;
 }
+
+/**
+ * @brief Evaluate interpolated values of several 3D scalar fields
+ *
+ * The fields are given on the same grid and their values are stored
+ * interleaved, so that the n_f values at a grid node are contiguous. The
+ * coordinate wrapping, the cell search and the interpolation weights are
+ * computed once and the result for each field is the same as given by
+ * linint3D_eval_f().
+ *
+ * @param f array of length n_f in which to place the evaluated values
+ * @param n_f number of fields
+ * @param str data struct for data interpolation
+ * @param x x-coordinate
+ * @param y y-coordinate
+ * @param z z-coordinate
+ *
+ * @return zero on success and one if (x,y,z) point is outside the grid.
+ */
+int linint3D_eval_fn(real* f, int n_f, linint3D_data* str,
+                     real x, real y, real z) {
+     /* Make sure periodic coordinates are within [max, min] region. */
+    if(str->bc_x == PERIODICBC) {
+        x = fmod(x - str->x_min, str->x_max - str->x_min) + str->x_min;
+        x = x + (x < str->x_min) * (str->x_max - str->x_min);
+    }
+    if(str->bc_y == PERIODICBC) {
+        y = fmod(y - str->y_min, str->y_max - str->y_min) + str->y_min;
+        y = y + (y < str->y_min) * (str->y_max - str->y_min);
+    }
+    if(str->bc_z == PERIODICBC) {
+        z = fmod(z - str->z_min, str->z_max - str->z_min) + str->z_min;
+        z = z + (z < str->z_min) * (str->z_max - str->z_min);
+    }
+
+    /* index for x variable */
+    int i_x   = (x - str->x_min) / str->x_grid;
+    /* Normalized x coordinate in current cell */
+    real dx   = (x - (str->x_min + i_x*str->x_grid)) / str->x_grid;
+
+    /* index for y variable */
+    int i_y   = (y - str->y_min) / str->y_grid;
+    /* Normalized y coordinate in current cell */
+    real dy   = (y - (str->y_min + i_y*str->y_grid)) / str->y_grid;
+
+    /* index for z variable */
+    int i_z   = (z - str->z_min) / str->z_grid;
+    /* Normalized z coordinate in current cell */
+    real dz   = (z - (str->z_min + i_z*str->z_grid)) / str->z_grid;
+
+    /* Index jump to cell */
+    int n  = i_y*str->n_z*str->n_x + i_z*str->n_x + i_x;
+    int x1 = 1;                 /* Index jump one x forward */
+    int y1 = str->n_z*str->n_x; /* Index jump one y forward */
+    int z1 = str->n_x;          /* Index jump one z forward */
+
+    int err = 0;
+
+    /* Enforce periodic BC or check that the coordinate is within the grid. */
+    if( str->bc_x == PERIODICBC && i_x == str->n_x-1 ) {
+        x1 = -(str->n_x-1)*x1;
+    }
+    else if( str->bc_x == NATURALBC && !(x >= str->x_min && x <= str->x_max) ) {
+        err = 1;
+    }
+    if( str->bc_y == PERIODICBC && i_y == str->n_y-1 ) {
+        y1 = -(str->n_y-1)*y1;
+    }
+    else if( str->bc_y == NATURALBC && !(y >= str->y_min && y <= str->y_max) ) {
+        err = 1;
+    }
+    if( str->bc_z == PERIODICBC && i_z == str->n_z-1 ) {
+        z1 = -(str->n_z-1)*z1;
+    }
+    else if( str->bc_z == NATURALBC && !(z >= str->z_min && z <= str->z_max) ) {
+        err = 1;
+    }
+
+    if(!err) {
+        /* Grid cell corners */
+        real* c000 = &str->c[n*n_f];
+        real* c100 = &str->c[(n + x1)*n_f];
+        real* c001 = &str->c[(n + y1)*n_f];
+        real* c101 = &str->c[(n + y1 + x1)*n_f];
+        real* c010 = &str->c[(n + z1)*n_f];
+        real* c110 = &str->c[(n + z1 + x1)*n_f];
+        real* c011 = &str->c[(n + y1 + z1)*n_f];
+        real* c111 = &str->c[(n + y1 + z1 + x1)*n_f];
+        for(int k = 0; k < n_f; k++) {
+            /* Interpolate along x */
+            real c00 = c000[k]*(1 - dx) + c100[k]*dx;
+            real c01 = c001[k]*(1 - dx) + c101[k]*dx;
+            real c10 = c010[k]*(1 - dx) + c110[k]*dx;
+            real c11 = c011[k]*(1 - dx) + c111[k]*dx;
+            /* Interpolate these values along z */
+            real c0 = c00*(1 - dz) + c10*dz;
+            real c1 = c01*(1 - dz) + c11*dz;
+            /* Finally we interpolate these values along y */
+            f[k] = c0*(1 - dy) + c1*dy;
+        }
+    }
+
+    return err;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file linint_search.c
+ * @brief Interval search on tabulated grids
+ *
+ * Finds the interval i for which x[i] <= x < x[i+1] on a tabulated grid. The
+ * result is the same as given by a linear scan from the start of the grid,
+ * i.e. the last interval i <= n_x - 2 for which x[i] <= x, but it is found in
+ * constant time.
+ *
+ * Uniform grids are indexed directly. For non-uniform grids, the grid range
+ * is divided to uniform bins and a table storing the interval that contains
+ * the lower edge of each bin is precomputed on the host. The search then
+ * starts from the interval stored for the bin and only checks the few grid
+ * points that fall within the bin. The table is stored as reals so that it
+ * can be appended to the offload array of the data that is interpolated.
+ */
+#include <stdlib.h>
+#include <math.h>
+#include "../ascot5.h"
+#include "linint.h"
+
+/**
+ * @brief Find the number of search bins a grid requires
+ *
+ * @param x grid points
+ * @param n_x number of grid points
+ *
+ * @return zero if the grid is uniform, otherwise the number of bins which is
+ *         equal to the number of grid points
+ */
+int linint_search_nbin(real* x, int n_x) {
+    if(n_x < 3) {
+        return 0;
+    }
+    real dx = (x[n_x-1] - x[0]) / (n_x - 1);
+    for(int i = 1; i < n_x - 1; i++) {
+        if( fabs(x[i] - (x[0] + i * dx)) > 1e-3 * dx ) {
+            return n_x;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Fill the search bin table
+ *
+ * @param bin array of length n_bin where the table is stored
+ * @param n_bin number of bins
+ * @param x grid points
+ * @param n_x number of grid points
+ */
+void linint_search_fill(real* bin, int n_bin, real* x, int n_x) {
+    real x_bin = (x[n_x-1] - x[0]) / n_bin;
+    int i = 0;
+    for(int k = 0; k < n_bin; k++) {
+        real xk = x[0] + k * x_bin;
+        while(i < n_x - 2 && x[i+1] <= xk) {
+            i++;
+        }
+        bin[k] = i;
+    }
+}
+
+/**
+ * @brief Initialize interval search struct
+ *
+ * @param str pointer to struct to be initialized
+ * @param x grid points
+ * @param n_x number of grid points
+ * @param bin search bin table or NULL if the grid is uniform
+ * @param n_bin number of bins or zero if the grid is uniform
+ */
+void linint_search_init(linint_search_data* str, real* x, int n_x,
+                        real* bin, int n_bin) {
+    str->n_x   = n_x;
+    str->n_bin = n_bin;
+    str->x_min = x[0];
+    str->x_bin = n_x < 2 ? 1.0
+        : (x[n_x-1] - x[0]) / ( n_bin > 0 ? n_bin : n_x - 1 );
+    str->x     = x;
+    str->bin   = bin;
+}
+
+/**
+ * @brief Find the grid interval containing the given coordinate
+ *
+ * Coordinates outside the grid are placed in the first or the last interval.
+ *
+ * @param x coordinate
+ * @param str pointer to the search struct
+ *
+ * @return index i of the interval
+ */
+int linint_search(real x, linint_search_data* str) {
+    int n_k = str->n_bin > 0 ? str->n_bin : str->n_x - 1;
+    real f = (x - str->x_min) / str->x_bin;
+    int k = 0;
+    if(f >= n_k) {
+        k = n_k - 1;
+    }
+    else if(f > 0) {
+        k = (int) f;
+    }
+
+    int i = str->n_bin > 0 ? (int) str->bin[k] : k;
+    while(i > 0 && str->x[i] > x) {
+        i--;
+    }
+    while(i < str->n_x - 2 && str->x[i+1] <= x) {
+        i++;
+    }
+    return i < 0 ? 0 : i;
+}
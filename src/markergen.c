@@ -0,0 +1,312 @@
+/**
+ * @file markergen.c
+ * @brief Sample markers from 5D histograms
+ *
+ * Markers are sampled from a marker distribution, which is a histogram on a
+ * 5D grid consisting of three spatial and two momentum space abscissae. The
+ * cell of each marker is found by bisecting the cumulative distribution, after
+ * which the marker weight is set to the value of the particle distribution in
+ * that cell divided by the number of markers in the cell. Finally, the marker
+ * coordinates are sampled uniformly within the cell.
+ *
+ * The histograms are in row-major order with the abscissae ordered as
+ * (R, phi, z, mom1, mom2) or (rho, theta, phi, mom1, mom2), where
+ * (mom1, mom2) is either (ppar, pperp) or (ekin, pitch). The abscissa edges
+ * are given in a single array where the edges of each abscissa follow the
+ * previous ones.
+ *
+ * Each thread uses its own random number stream which is seeded from the given
+ * seed and the thread number. Hence, when compiled with one of the random
+ * number generator libraries (see random.h), the result is reproducible for
+ * a given seed and number of threads.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "ascot5.h"
+#include "consts.h"
+#include "math.h"
+#include "physlib.h"
+#include "random.h"
+#include "B_field.h"
+#include "fluxmap.h"
+#include "markergen.h"
+
+/** Maximum number of times rejected markers are resampled */
+#define MARKERGEN_MAXITER 1000
+
+/**
+ * @brief Sample marker cells and weights
+ *
+ * Markers whose weight would be below minweight are rejected and sampled
+ * again until all markers are accepted. Cells where the particle distribution
+ * is below minweight are never sampled as markers in those cells would always
+ * be rejected.
+ *
+ * @param nmrk number of markers to be sampled
+ * @param n_cell number of cells in the histograms
+ * @param markerdist marker distribution (need not be normalized)
+ * @param particledist particle distribution [number of particles per cell]
+ * @param minweight minimum weight a marker must have or it is rejected
+ * @param seed random number generator seed
+ * @param icell output array for the cell index of each marker
+ * @param weight output array for the weight of each marker
+ *
+ * @return zero if sampling succeeded
+ */
+int markergen_sample_cells(int nmrk, size_t n_cell, real* markerdist,
+                           real* particledist, real minweight, int seed,
+                           integer* icell, real* weight) {
+    int n_threads = omp_get_max_threads();
+    real* cdf      = malloc( (n_cell + 1) * sizeof(real) );
+    real* partial  = malloc( (n_threads + 1) * sizeof(real) );
+    int* count     = malloc( n_cell * sizeof(int) );
+    char* rejected = malloc( nmrk * sizeof(char) );
+    random_data* rdata = malloc( n_threads * sizeof(random_data) );
+    if(cdf == NULL || partial == NULL || count == NULL || rejected == NULL
+       || rdata == NULL) {
+        free(cdf);
+        free(partial);
+        free(count);
+        free(rejected);
+        free(rdata);
+        return 1;
+    }
+
+    /* Cumulative distribution: each thread sums its own block and the block
+     * offsets are added once all partial sums are known */
+    cdf[0] = 0;
+    partial[0] = 0;
+    #pragma omp parallel num_threads(n_threads)
+    {
+        int n_t = omp_get_num_threads();
+        int tid = omp_get_thread_num();
+        size_t i0 = n_cell * tid / n_t;
+        size_t i1 = n_cell * (tid + 1) / n_t;
+        random_init(&rdata[tid], seed + tid);
+
+        real sum = 0;
+        for(size_t i = i0; i < i1; i++) {
+            if(markerdist[i] > 0 && particledist[i] >= minweight) {
+                sum += markerdist[i];
+            }
+            cdf[i+1] = sum;
+        }
+        partial[tid+1] = sum;
+
+        #pragma omp barrier
+        #pragma omp single
+        for(int j = 1; j <= n_t; j++) {
+            partial[j] += partial[j-1];
+        }
+
+        for(size_t i = i0; i < i1; i++) {
+            cdf[i+1] += partial[tid];
+        }
+    }
+    real total = cdf[n_cell];
+
+    int iter = 0;
+    int n_rejected = total > 0 ? nmrk : 0;
+    memset(rejected, 1, nmrk * sizeof(char));
+    while(n_rejected > 0 && iter++ < MARKERGEN_MAXITER) {
+        #pragma omp parallel num_threads(n_threads)
+        {
+            #pragma omp for
+            for(int i = 0; i < nmrk; i++) {
+                if(!rejected[i]) {
+                    continue;
+                }
+                real u;
+                do {
+                    u = random_uniform(&rdata[omp_get_thread_num()]) * total;
+                } while(u >= total);
+
+                /* Find the cell for which cdf[i] <= u < cdf[i+1] */
+                size_t lo = 0, hi = n_cell;
+                while(hi - lo > 1) {
+                    size_t mid = lo + (hi - lo) / 2;
+                    if(cdf[mid] <= u) {
+                        lo = mid;
+                    }
+                    else {
+                        hi = mid;
+                    }
+                }
+                icell[i] = lo;
+            }
+
+            #pragma omp for
+            for(size_t i = 0; i < n_cell; i++) {
+                count[i] = 0;
+            }
+
+            #pragma omp for
+            for(int i = 0; i < nmrk; i++) {
+                #pragma omp atomic
+                count[icell[i]]++;
+            }
+        }
+
+        n_rejected = 0;
+        #pragma omp parallel for num_threads(n_threads) \
+            reduction(+:n_rejected)
+        for(int i = 0; i < nmrk; i++) {
+            weight[i]   = particledist[icell[i]] / count[icell[i]];
+            rejected[i] = weight[i] < minweight;
+            n_rejected += rejected[i];
+        }
+    }
+
+    free(cdf);
+    free(partial);
+    free(count);
+    free(rejected);
+    free(rdata);
+    return n_rejected > 0 || total <= 0;
+}
+
+/**
+ * @brief Sample marker coordinates within their cells
+ *
+ * For guiding centers the momentum space coordinates are given as the kinetic
+ * energy, pitch, and a uniformly sampled gyroangle. For particles, the
+ * velocity vector is constructed with a uniformly sampled gyroangle around
+ * the magnetic field at the marker position.
+ *
+ * The spatial coordinates are converted from (rho, theta, phi) to (R, z) with
+ * the Newton method, or with the tabulated map if one is given. Markers whose
+ * coordinates could not be evaluated have their output set to NaN.
+ *
+ * @param nmrk number of markers
+ * @param icell cell index of each marker
+ * @param n number of cells along each abscissa
+ * @param edges abscissa edges
+ * @param spatial spatial basis as in markergen_spatial
+ * @param momentum momentum basis as in markergen_momentum
+ * @param mode type of the generated markers as in markergen_mode
+ * @param mass marker mass [kg]
+ * @param seed random number generator seed
+ * @param maxiter maximum number of iterations in the (rho, theta) to (R, z)
+ *        mapping
+ * @param tol required accuracy in rho when mapping (rho, theta) to (R, z)
+ * @param map pointer to the tabulated map or NULL if not used
+ * @param Bdata pointer to magnetic field data (not used for guiding centers
+ *        sampled from (R, phi, z))
+ * @param r output array for R coordinates [m]
+ * @param phi output array for phi coordinates [rad]
+ * @param z output array for z coordinates [m]
+ * @param c1 output array for energy [J] or R-component of velocity [m/s]
+ * @param c2 output array for pitch or phi-component of velocity [m/s]
+ * @param c3 output array for gyroangle [rad] or z-component of velocity [m/s]
+ */
+void markergen_sample_coordinates(
+    int nmrk, integer* icell, int n[5], real* edges, int spatial, int momentum,
+    int mode, real mass, int seed, int maxiter, real tol, fluxmap_data* map,
+    B_field_data* Bdata, real* r, real* phi, real* z, real* c1, real* c2,
+    real* c3) {
+
+    real* e[5];
+    e[0] = edges;
+    for(int d = 1; d < 5; d++) {
+        e[d] = e[d-1] + n[d-1] + 1;
+    }
+
+    int n_threads = omp_get_max_threads();
+    random_data* rdata = malloc( n_threads * sizeof(random_data) );
+    #pragma omp parallel num_threads(n_threads)
+    {
+        int tid = omp_get_thread_num();
+        random_init(&rdata[tid], seed + n_threads + tid);
+
+        #pragma omp for
+        for(int i = 0; i < nmrk; i++) {
+            /* Uniformly sampled coordinates within the cell */
+            real x[5];
+            integer ic = icell[i];
+            for(int d = 4; d >= 0; d--) {
+                int j = ic % n[d];
+                ic   /= n[d];
+                x[d]  = e[d][j] + (e[d][j+1] - e[d][j])
+                    * random_uniform(&rdata[tid]);
+            }
+            real zeta = CONST_2PI * random_uniform(&rdata[tid]);
+
+            a5err err = 0;
+            if(spatial == markergen_spatial_rphiz) {
+                r[i]   = x[0];
+                phi[i] = x[1];
+                z[i]   = x[2];
+            }
+            else {
+                real rz[2];
+                if(map != NULL) {
+                    err = fluxmap_eval_rz(rz, x[0], x[1], x[2], maxiter, tol,
+                                          map, Bdata);
+                }
+                else {
+                    err = fluxmap_newton(rz, x[0], x[1], x[2], 1e-1, maxiter,
+                                         tol, Bdata);
+                }
+                r[i]   = err ? NAN : rz[0];
+                phi[i] = x[2];
+                z[i]   = err ? NAN : rz[1];
+            }
+
+            real ppar, pperp, pnorm;
+            if(momentum == markergen_momentum_pparpperp) {
+                ppar  = x[3];
+                pperp = x[4];
+                pnorm = sqrt(ppar * ppar + pperp * pperp);
+            }
+            else {
+                real gamma = physlib_gamma_Ekin(mass, x[3]);
+                pnorm = mass * CONST_C * sqrt(gamma * gamma - 1.0);
+                ppar  = x[4] * pnorm;
+                pperp = sqrt(1.0 - x[4] * x[4]) * pnorm;
+            }
+
+            if(mode == markergen_mode_gc) {
+                c1[i] = physlib_Ekin_pnorm(mass, pnorm);
+                c2[i] = pnorm > 0 ? ppar / pnorm : 0.0;
+                c3[i] = zeta;
+                continue;
+            }
+
+            /* Particle velocity from gyroangle and the unit vectors
+             * perpendicular to the magnetic field */
+            real B[3];
+            if(!err) {
+                err = B_field_eval_B(B, r[i], phi[i], z[i], 0.0, Bdata);
+            }
+            if(err) {
+                c1[i] = NAN;
+                c2[i] = NAN;
+                c3[i] = NAN;
+                continue;
+            }
+            real Bnorm = math_norm(B);
+            real bhat[3] = {B[0] / Bnorm, B[1] / Bnorm, B[2] / Bnorm};
+            real e1[3], e2[3];
+            real zhat[3] = {0.0, 0.0, 1.0};
+            math_cross(bhat, zhat, e2);
+            real e2norm = math_norm(e2);
+            e1[0] = e2[0] / e2norm;
+            e1[1] = e2[1] / e2norm;
+            e1[2] = e2[2] / e2norm;
+            math_cross(bhat, e1, e2);
+
+            real gamma = physlib_gamma_pnorm(mass, pnorm);
+            real v[3];
+            for(int k = 0; k < 3; k++) {
+                real perphat = -sin(zeta) * e1[k] - cos(zeta) * e2[k];
+                v[k] = ( bhat[k] * ppar + perphat * pperp ) / ( gamma * mass );
+            }
+            c1[i] = v[0];
+            c2[i] = v[1];
+            c3[i] = v[2];
+        }
+    }
+    free(rdata);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file markergen.h
+ * @brief Header file for markergen.c
+ */
+#ifndef MARKERGEN_H
+#define MARKERGEN_H
+
+#include <stddef.h>
+#include "ascot5.h"
+#include "B_field.h"
+#include "fluxmap.h"
+
+/**
+ * @brief Spatial basis of the sampled distribution
+ */
+typedef enum markergen_spatial {
+    markergen_spatial_rphiz       = 0, /**< (R, phi, z) [m, rad, m]          */
+    markergen_spatial_rhothetaphi = 1  /**< (rho, theta, phi) [1, rad, rad]  */
+} markergen_spatial;
+
+/**
+ * @brief Momentum basis of the sampled distribution
+ */
+typedef enum markergen_momentum {
+    markergen_momentum_pparpperp = 0, /**< (ppar, pperp) [kg*m/s, kg*m/s]    */
+    markergen_momentum_ekinpitch = 1  /**< (ekin, pitch) [J, 1]              */
+} markergen_momentum;
+
+/**
+ * @brief Type of the generated markers
+ */
+typedef enum markergen_mode {
+    markergen_mode_gc  = 0, /**< Guiding centers: energy, pitch, gyroangle   */
+    markergen_mode_prt = 1  /**< Particles: velocity vector                  */
+} markergen_mode;
+
+int markergen_sample_cells(int nmrk, size_t n_cell, real* markerdist,
+                           real* particledist, real minweight, int seed,
+                           integer* icell, real* weight);
+
+void markergen_sample_coordinates(
+    int nmrk, integer* icell, int n[5], real* edges, int spatial, int momentum,
+    int mode, real mass, int seed, int maxiter, real tol, fluxmap_data* map,
+    B_field_data* Bdata, real* r, real* phi, real* z, real* c1, real* c2,
+    real* c3);
+
+#endif
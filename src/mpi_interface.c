@@ -9,11 +9,22 @@
 #endif
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include "ascot5.h"
 #include "diag.h"
 #include "mpi_interface.h"
 #include "particle.h"
 #include "simulate.h"
+#include "offload.h"
+#include "print.h"
+
+#ifdef MPI
+/** @brief Communicator for processes that can share memory, i.e. are on the
+ *         same node */
+static MPI_Comm mpi_node_comm = MPI_COMM_NULL;
+/** @brief Shared memory windows for the real and integer offload arrays */
+static MPI_Win mpi_shmem_win[2];
+#endif
 
 /**
  * @brief Initialize MPI
@@ -118,8 +129,8 @@ void mpi_gather_particlestate(
     particle_state* ps, particle_state** ps_gather, int* n_gather, int n_tot,
     int mpi_rank, int mpi_size, int mpi_root) {
 #ifdef MPI
-    const int n_real = 32;
-    const int n_int = 5;
+    const int n_real = 33;
+    const int n_int = 8;
     const int n_err = 1;
 
     particle_state* ps_all = malloc(n_tot * sizeof(particle_state));
@@ -187,6 +198,10 @@ void mpi_gather_particlestate(
                 ps_all[start_index+j].B_phi_dz   = realdata[29*n+j];
                 ps_all[start_index+j].B_z_dz     = realdata[30*n+j];
                 ps_all[start_index+j].mileage    = realdata[31*n+j];
+                ps_all[start_index+j].mindt      = realdata[32*n+j];
+                ps_all[start_index+j].nstep      = intdata[5*n+j];
+                ps_all[start_index+j].nrej       = intdata[6*n+j];
+                ps_all[start_index+j].mindtlim   = intdata[7*n+j];
                 ps_all[start_index+j].err        = errdata[j];
             }
 
@@ -245,6 +260,10 @@ void mpi_gather_particlestate(
             realdata[29*n+j] = ps[j].B_phi_dz;
             realdata[30*n+j] = ps[j].B_z_dz;
             realdata[31*n+j] = ps[j].mileage;
+            realdata[32*n+j] = ps[j].mindt;
+            intdata[5*n+j]   = ps[j].nstep;
+            intdata[6*n+j]   = ps[j].nrej;
+            intdata[7*n+j]   = ps[j].mindtlim;
             errdata[j] = ps[j].err;
         }
 
@@ -297,7 +316,8 @@ void mpi_gather_diag(diag_offload_data* data, real* offload_array, int ntotal,
 #ifdef MPI
 
     if(data->dist5D_collect || data->distrho5D_collect
-       || data->dist6D_collect || data->distrho6D_collect) {
+       || data->dist6D_collect || data->distrho6D_collect
+       || data->distCOM_collect || data->diagwall_collect) {
         if(mpi_rank == mpi_root) {
             MPI_Reduce(MPI_IN_PLACE, offload_array,
                 data->offload_dist_length, mpi_type_real, MPI_SUM,
@@ -368,3 +388,260 @@ void mpi_gather_diag(diag_offload_data* data, real* offload_array, int ntotal,
 
 #endif
 }
+
+#ifdef MPI
+/**
+ * @brief Broadcast an arbitrarily large byte buffer
+ *
+ * MPI counts are ints, so the buffer is broadcast in chunks of at most 1 GB.
+ *
+ * @param buf pointer to the buffer
+ * @param size size of the buffer in bytes
+ * @param root rank of the process the data is broadcast from
+ * @param comm communicator
+ */
+static void mpi_bcast_bytes(void* buf, size_t size, int root, MPI_Comm comm) {
+    const size_t chunk = (size_t)1 << 30;
+    for(size_t pos = 0; pos < size; pos += chunk) {
+        size_t n = size - pos < chunk ? size - pos : chunk;
+        MPI_Bcast((char*)buf + pos, (int)n, MPI_BYTE, root, comm);
+    }
+}
+#endif
+
+/**
+ * @brief Broadcast the status of an operation done by the root process
+ *
+ * Used before collective operations that depend on the root having succeeded,
+ * so that the other processes can quit instead of waiting for data that never
+ * arrives.
+ *
+ * @param sim pointer to simulation offload data
+ * @param status status on the root process, zero if succesful
+ *
+ * @return status on the root process
+ */
+int mpi_interface_bcast_status(sim_offload_data* sim, int status) {
+#ifdef MPI
+    MPI_Bcast(&status, 1, MPI_INT, sim->mpi_root, MPI_COMM_WORLD);
+#endif
+    return status;
+}
+
+/**
+ * @brief Broadcast input read by the root process to all processes
+ *
+ * Only the root process reads the input file, so that the file system is
+ * accessed once instead of once per process. The root process has read the
+ * options and markers and packed the input data with offload_pack(). The
+ * options and input offload data structs (i.e. the whole simulation offload
+ * data except the process-specific MPI fields) and the markers are broadcast
+ * to all processes.
+ *
+ * The packed offload arrays are broadcast to all processes, or to the node
+ * roots only if the input data is shared within nodes, in which case
+ * mpi_interface_shmem_init() must have been called before this function and
+ * mpi_interface_shmem_share() after it.
+ *
+ * @param sim pointer to simulation offload data
+ * @param o pointer to offload package
+ * @param offload_array pointer to packed offload array which is allocated
+ *        here on processes other than the root
+ * @param int_offload_array pointer to packed integer offload array which is
+ *        allocated here on processes other than the root
+ * @param p pointer to marker input array which is allocated here on processes
+ *        other than the root
+ * @param n_tot pointer to the number of markers
+ */
+void mpi_interface_bcast_input(sim_offload_data* sim, offload_package* o,
+                               real** offload_array, int** int_offload_array,
+                               input_particle** p, int* n_tot) {
+#ifdef MPI
+    int mpi_rank  = sim->mpi_rank;
+    int mpi_size  = sim->mpi_size;
+    int mpi_root  = sim->mpi_root;
+    int mpi_shmem = sim->mpi_shmem;
+    int is_root   = mpi_rank == mpi_root;
+
+    MPI_Bcast(sim, sizeof(sim_offload_data), MPI_BYTE, mpi_root,
+              MPI_COMM_WORLD);
+    sim->mpi_rank  = mpi_rank;
+    sim->mpi_size  = mpi_size;
+    sim->mpi_root  = mpi_root;
+    sim->mpi_shmem = mpi_shmem;
+
+    MPI_Bcast(n_tot, 1, MPI_INT, mpi_root, MPI_COMM_WORLD);
+    if(!is_root) {
+        *p = (input_particle*) malloc(*n_tot * sizeof(input_particle));
+    }
+    mpi_bcast_bytes(*p, *n_tot * sizeof(input_particle), mpi_root,
+                    MPI_COMM_WORLD);
+
+    /* With shared memory, the packed data is only needed on node roots */
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int root = mpi_root;
+    if(mpi_shmem) {
+        int node_rank;
+        MPI_Comm_rank(mpi_node_comm, &node_rank);
+        MPI_Comm_split(MPI_COMM_WORLD, node_rank == 0 ? 0 : MPI_UNDEFINED,
+                       is_root ? -1 : mpi_rank, &comm);
+        if(comm == MPI_COMM_NULL) {
+            return;
+        }
+        root = 0;
+    }
+
+    MPI_Bcast(o, sizeof(offload_package), MPI_BYTE, root, comm);
+    if(!is_root) {
+        *offload_array = (real*) malloc(
+            o->offload_array_length * sizeof(real));
+        *int_offload_array = (int*) malloc(
+            o->int_offload_array_length * sizeof(int));
+    }
+    mpi_bcast_bytes(*offload_array, o->offload_array_length * sizeof(real),
+                    root, comm);
+    mpi_bcast_bytes(*int_offload_array,
+                    o->int_offload_array_length * sizeof(int), root, comm);
+
+    if(comm != MPI_COMM_WORLD) {
+        MPI_Comm_free(&comm);
+    }
+
+    print_out0(VERBOSE_NORMAL, mpi_rank, mpi_root,
+               "Input read by process %d and broadcast to %d processes, "
+               "%.1f MB.\n", mpi_root, mpi_size,
+               ( o->offload_array_length * sizeof(real)
+                 + o->int_offload_array_length * sizeof(int)
+                 + *n_tot * sizeof(input_particle) ) / (1024.0*1024.0));
+#endif
+}
+
+/**
+ * @brief Initialize node-level shared memory
+ *
+ * Processes are split into groups that can share memory, i.e. processes that
+ * are on the same node. The process with node_rank zero reads the input and
+ * shares it with the rest of the node with mpi_interface_shmem_share().
+ *
+ * If compiled without MPI, node_rank is set to zero.
+ *
+ * @param node_rank pointer to the rank of this process within its node
+ */
+void mpi_interface_shmem_init(int* node_rank) {
+#ifdef MPI
+    int mpi_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, mpi_rank,
+                        MPI_INFO_NULL, &mpi_node_comm);
+    MPI_Comm_rank(mpi_node_comm, node_rank);
+#else
+    *node_rank = 0;
+#endif
+}
+
+/**
+ * @brief Share packed input data between processes on the same node
+ *
+ * The node root has read the input and packed it with offload_pack(). Here
+ * the packed arrays are moved to MPI-3 shared memory windows which the other
+ * processes on the node map directly instead of holding copies of their own.
+ * The offload package and input offload data structs are broadcast from the
+ * node root so that the other processes only need to read options and
+ * markers.
+ *
+ * The shared arrays are read-only and must be freed with
+ * mpi_interface_shmem_free() instead of offload_free_offload().
+ *
+ * @param sim pointer to simulation offload data
+ * @param o pointer to offload package
+ * @param offload_array pointer to packed offload array which is replaced with
+ *        the shared array
+ * @param int_offload_array pointer to packed integer offload array which is
+ *        replaced with the shared array
+ */
+void mpi_interface_shmem_share(sim_offload_data* sim, offload_package* o,
+                               real** offload_array, int** int_offload_array) {
+#ifdef MPI
+    int node_rank, node_size;
+    MPI_Comm_rank(mpi_node_comm, &node_rank);
+    MPI_Comm_size(mpi_node_comm, &node_size);
+
+    MPI_Bcast(o, sizeof(offload_package), MPI_BYTE, 0, mpi_node_comm);
+    MPI_Bcast(&sim->B_offload_data, sizeof(B_field_offload_data), MPI_BYTE,
+              0, mpi_node_comm);
+    MPI_Bcast(&sim->E_offload_data, sizeof(E_field_offload_data), MPI_BYTE,
+              0, mpi_node_comm);
+    MPI_Bcast(&sim->plasma_offload_data, sizeof(plasma_offload_data),
+              MPI_BYTE, 0, mpi_node_comm);
+    MPI_Bcast(&sim->neutral_offload_data, sizeof(neutral_offload_data),
+              MPI_BYTE, 0, mpi_node_comm);
+    MPI_Bcast(&sim->wall_offload_data, sizeof(wall_offload_data), MPI_BYTE,
+              0, mpi_node_comm);
+    MPI_Bcast(&sim->boozer_offload_data, sizeof(boozer_offload_data),
+              MPI_BYTE, 0, mpi_node_comm);
+    MPI_Bcast(&sim->mhd_offload_data, sizeof(mhd_offload_data), MPI_BYTE,
+              0, mpi_node_comm);
+    MPI_Bcast(&sim->asigma_offload_data, sizeof(asigma_offload_data),
+              MPI_BYTE, 0, mpi_node_comm);
+
+    /* Only the node root allocates memory, others attach to it */
+    MPI_Aint size     = 0;
+    MPI_Aint int_size = 0;
+    if(node_rank == 0) {
+        size     = o->offload_array_length * sizeof(real);
+        int_size = o->int_offload_array_length * sizeof(int);
+    }
+    real* shared;
+    int* int_shared;
+    MPI_Win_allocate_shared(size, sizeof(real), MPI_INFO_NULL, mpi_node_comm,
+                            &shared, &mpi_shmem_win[0]);
+    MPI_Win_allocate_shared(int_size, sizeof(int), MPI_INFO_NULL,
+                            mpi_node_comm, &int_shared, &mpi_shmem_win[1]);
+
+    if(node_rank == 0) {
+        memcpy(shared, *offload_array, size);
+        memcpy(int_shared, *int_offload_array, int_size);
+        free(*offload_array);
+        free(*int_offload_array);
+    }
+    else {
+        int disp_unit;
+        MPI_Win_shared_query(mpi_shmem_win[0], 0, &size, &disp_unit, &shared);
+        MPI_Win_shared_query(mpi_shmem_win[1], 0, &int_size, &disp_unit,
+                             &int_shared);
+    }
+
+    /* Make sure the data is in place before anyone reads it */
+    MPI_Win_fence(0, mpi_shmem_win[0]);
+    MPI_Win_fence(0, mpi_shmem_win[1]);
+    MPI_Barrier(mpi_node_comm);
+
+    *offload_array     = shared;
+    *int_offload_array = int_shared;
+
+    print_out0(VERBOSE_NORMAL, node_rank, 0,
+               "Input data shared between %d processes on this node, "
+               "%.1f MB per node.\n", node_size,
+               ( o->offload_array_length * sizeof(real)
+                 + o->int_offload_array_length * sizeof(int) )
+               / (1024.0*1024.0));
+#endif
+}
+
+/**
+ * @brief Free shared input data
+ *
+ * Collective over the processes on the same node.
+ *
+ * @param offload_array pointer to shared offload array
+ * @param int_offload_array pointer to shared integer offload array
+ */
+void mpi_interface_shmem_free(real** offload_array, int** int_offload_array) {
+#ifdef MPI
+    MPI_Win_free(&mpi_shmem_win[0]);
+    MPI_Win_free(&mpi_shmem_win[1]);
+    MPI_Comm_free(&mpi_node_comm);
+#endif
+    *offload_array     = NULL;
+    *int_offload_array = NULL;
+}
@@ -10,6 +10,8 @@
 #endif
 #include "diag.h"
 #include "particle.h"
+#include "offload.h"
+#include "simulate.h"
 
 /** @brief ASCOT integer in MPI standard */
 #define mpi_type_integer MPI_LONG
@@ -32,5 +34,13 @@ void mpi_gather_particlestate(
     int mpi_rank, int mpi_size, int mpi_root);
 void mpi_gather_diag(diag_offload_data* data, real* offload_array, int ntotal,
                      int mpi_rank, int mpi_size, int mpi_root);
+int mpi_interface_bcast_status(sim_offload_data* sim, int status);
+void mpi_interface_bcast_input(sim_offload_data* sim, offload_package* o,
+                               real** offload_array, int** int_offload_array,
+                               input_particle** p, int* n_tot);
+void mpi_interface_shmem_init(int* node_rank);
+void mpi_interface_shmem_share(sim_offload_data* sim, offload_package* o,
+                               real** offload_array, int** int_offload_array);
+void mpi_interface_shmem_free(real** offload_array, int** int_offload_array);
 
 #endif
@@ -169,6 +169,51 @@ a5err neutral_eval_n0(real* n0, real rho, real r, real phi, real z, real t,
     return err;
 }
 
+/**
+ * @brief Evaluate neutral density and temperature
+ *
+ * This function evaluates the neutral density n0 and temperature t0 of all
+ * species at the given coordinates with a single interpolation.
+ *
+ * This is a SIMD function.
+ *
+ * @param n0 pointer where neutral densities are stored [m^-3]
+ * @param t0 pointer where neutral temperatures are stored [J]
+ * @param rho normalized poloidal flux coordinate
+ * @param r R coordinate [m]
+ * @param phi phi coordinate [deg]
+ * @param z z coordinate [m]
+ * @param t time coordinate [s]
+ * @param ndata pointer to neutral data struct
+ *
+ * @return Non-zero a5err value if evaluation failed, zero otherwise
+ */
+a5err neutral_eval_n0t0(real* n0, real* t0, real rho, real r, real phi,
+                        real z, real t, neutral_data* ndata) {
+    a5err err = 0;
+
+    switch(ndata->type) {
+        case neutral_type_1D:
+            err = N0_1D_eval_n0t0(n0, t0, rho, &(ndata->N01D));
+            break;
+        case neutral_type_3D:
+            err = N0_3D_eval_n0t0(n0, t0, r, phi, z, &(ndata->N03D));
+            break;
+        default:
+            /* Unregonized input. Produce error. */
+            err = error_raise( ERR_UNKNOWN_INPUT, __LINE__, EF_NEUTRAL);
+            break;
+    }
+
+    if(err) {
+        /* Return some reasonable values to avoid further errors */
+        n0[0] = 0;
+        t0[0] = 1;
+    }
+
+    return err;
+}
+
 /**
  * @brief Evaluate neutral temperature
  *
@@ -67,6 +67,9 @@ DECLARE_TARGET_SIMD_UNIFORM(ndata)
 a5err neutral_eval_n0(real* n0, real rho, real r, real phi, real z, real t,
                       neutral_data* ndata);
 DECLARE_TARGET_SIMD_UNIFORM(ndata)
+a5err neutral_eval_n0t0(real* n0, real* t0, real rho, real r, real phi,
+                        real z, real t, neutral_data* ndata);
+DECLARE_TARGET_SIMD_UNIFORM(ndata)
 a5err neutral_eval_t0(real* t0, real rho, real r, real phi, real z, real t,
                       neutral_data* ndata);
 DECLARE_TARGET_SIMD_UNIFORM(ndata)
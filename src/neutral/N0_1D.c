@@ -16,6 +16,9 @@
 /**
  * @brief Initialize offload data
  *
+ * The offload array is rearranged so that the densities and temperatures of
+ * all species are stored interleaved at each grid node.
+ *
  * @param offload_data pointer to offload data struct
  * @param offload_array pointer to offload data array
  *
@@ -46,6 +49,22 @@ int N0_1D_init_offload(N0_1D_offload_data* offload_data,
                   (int)(offload_data->maxwellian[i]));
     }
 
+    /* Interleave the data so that the densities and temperatures of all
+     * species at a grid node are contiguous */
+    int n_f = 2 * offload_data->n_species;
+    real* data = malloc(offload_data->offload_array_length * sizeof(real));
+    if(data == NULL) {
+        print_err("Error: Failed to allocate memory.");
+        return 1;
+    }
+    for(int j = 0; j < N0_size; j++) {
+        for(int k = 0; k < n_f; k++) {
+            data[j * n_f + k] = (*offload_array)[k * N0_size + j];
+        }
+    }
+    free(*offload_array);
+    *offload_array = data;
+
     return 0;
 }
 
@@ -79,77 +98,79 @@ void N0_1D_free_offload(N0_1D_offload_data* offload_data,
  */
 void N0_1D_init(N0_1D_data* ndata, N0_1D_offload_data* offload_data,
                 real* offload_array) {
-    int N0_size = offload_data->n_rho;
-    int T0_size = offload_data->n_rho;
     ndata->n_species  = offload_data->n_species;
     for(int i = 0; i < offload_data->n_species; i++) {
         ndata->anum[i]       = offload_data->anum[i];
         ndata->znum[i]       = offload_data->znum[i];
         ndata->maxwellian[i] = offload_data->maxwellian[i];
+    }
 
-        linint1D_init(
-            &ndata->n0[i], &offload_array[i * N0_size],
-            offload_data->n_rho, NATURALBC,
-            offload_data->rho_min, offload_data->rho_max);
+    linint1D_init(
+        &ndata->n0t0, offload_array,
+        offload_data->n_rho, NATURALBC,
+        offload_data->rho_min, offload_data->rho_max);
+}
 
-        linint1D_init(
-            &ndata->t0[i],
-            &offload_array[i * T0_size + offload_data->n_species * N0_size],
-            offload_data->n_rho, NATURALBC,
-            offload_data->rho_min, offload_data->rho_max);
+/**
+ * @brief Evaluate neutral density and temperature
+ *
+ * This function evaluates the density and temperature of all neutral species
+ * at the given coordinates using linear interpolation. The interpolation
+ * weights are computed once for all quantities.
+ *
+ * @param n0 array where the density of each species is stored
+ * @param t0 array where the temperature of each species is stored
+ * @param rho normalized poloidal flux coordinate
+ * @param ndata pointer to neutral data struct
+ *
+ * @return zero if evaluation succeeded
+ */
+a5err N0_1D_eval_n0t0(real* n0, real* t0, real rho, N0_1D_data* ndata) {
+    real f[2*MAX_SPECIES];
+    if(linint1D_eval_fn(f, 2 * ndata->n_species, &ndata->n0t0, rho)) {
+        return error_raise(ERR_INPUT_EVALUATION, __LINE__, EF_N0_1D);
     }
+
+    for(int i=0; i<ndata->n_species; i++) {
+        n0[i] = f[i];
+        t0[i] = f[ndata->n_species + i];
+    }
+
+    return 0;
 }
 
 /**
  * @brief Evaluate neutral density
  *
  * This function evaluates the neutral density at the given coordinates using
- * linear interpolation on the 1D neutral density data.
+ * linear interpolation.
  *
- * @param n0 n0 value will be stored in n0[0]
+ * @param n0 array where the density of each species is stored
  * @param rho normalized poloidal flux coordinate
  * @param ndata pointer to neutral data struct
  *
  * @return zero if evaluation succeeded
  */
 a5err N0_1D_eval_n0(real* n0, real rho, N0_1D_data* ndata) {
-    a5err err = 0;
-    int interperr = 0; /* If error happened during interpolation */
-    for(int i=0; i<ndata->n_species; i++) {
-        interperr += linint1D_eval_f(&n0[i], &ndata->n0[i], rho);
-    }
-
-    if(interperr) {
-        return error_raise(ERR_INPUT_EVALUATION, __LINE__, EF_N0_1D);
-    }
-
-    return err;
+    real t0[MAX_SPECIES];
+    return N0_1D_eval_n0t0(n0, t0, rho, ndata);
 }
 
 /**
  * @brief Evaluate neutral temperature
  *
  * This function evaluates the neutral temperature at the given coordinates
- * using linear interpolation on the 1D neutral temperature data.
+ * using linear interpolation.
  *
- * @param t0 t0 value will be stored in t0[0]
+ * @param t0 array where the temperature of each species is stored
  * @param rho normalized poloidal flux coordinate
  * @param ndata pointer to neutral data struct
  *
  * @return zero if evaluation succeeded
  */
 a5err N0_1D_eval_t0(real* t0, real rho, N0_1D_data* ndata) {
-    a5err err = 0;
-    int interperr = 0; /* If error happened during interpolation */
-    for(int i=0; i<ndata->n_species; i++) {
-        interperr += linint1D_eval_f(&t0[i], &ndata->t0[i], rho);
-    }
-
-    if(interperr) {
-        return error_raise(ERR_INPUT_EVALUATION, __LINE__, EF_N0_1D);
-    }
-
-    return err;
+    real n0[MAX_SPECIES];
+    return N0_1D_eval_n0t0(n0, t0, rho, ndata);
 }
 
 /**
@@ -31,10 +31,9 @@ typedef struct {
     int znum[MAX_SPECIES];    /**< Neutral species charge number []           */
     int maxwellian[MAX_SPECIES];    /**< Whether species distribution is
                                        Maxwellian or monoenergetic            */
-    linint1D_data n0[MAX_SPECIES];  /**< Pointer to start of neutral density
-                                       interpolation data struct array        */
-    linint1D_data t0[MAX_SPECIES];  /**< Pointer to start of neutral temperature
-                                       interpolation data struct array        */
+    linint1D_data n0t0;             /**< Interpolation data struct for
+                                       densities and temperatures of all
+                                       species interleaved at grid nodes      */
 } N0_1D_data;
 
 int N0_1D_init_offload(N0_1D_offload_data* offload_data, real** offload_array);
@@ -43,6 +42,8 @@ void N0_1D_free_offload(N0_1D_offload_data* offload_data, real** offload_array);
 void N0_1D_init(N0_1D_data* ndata, N0_1D_offload_data* offload_data,
                 real* offload_array);
 DECLARE_TARGET_SIMD_UNIFORM(ndata)
+a5err N0_1D_eval_n0t0(real* n0, real* t0, real rho, N0_1D_data* ndata);
+DECLARE_TARGET_SIMD_UNIFORM(ndata)
 a5err N0_1D_eval_n0(real* n0, real rho, N0_1D_data* ndata);
 DECLARE_TARGET_SIMD_UNIFORM(ndata)
 a5err N0_1D_eval_t0(real* t0, real rho, N0_1D_data* ndata);
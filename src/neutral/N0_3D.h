@@ -37,10 +37,9 @@ typedef struct {
     int znum[MAX_SPECIES];    /**< Neutral species charge number []           */
     int maxwellian[MAX_SPECIES];    /**< Whether species distribution is
                                        Maxwellian or monoenergetic            */
-    linint3D_data n0[MAX_SPECIES];  /**< Pointer to start of neutral density
-                                       interpolation data struct array        */
-    linint3D_data t0[MAX_SPECIES];  /**< Pointer to start of neutral temperature
-                                       interpolation data struct array        */
+    linint3D_data n0t0;             /**< Interpolation data struct for
+                                       densities and temperatures of all
+                                       species interleaved at grid nodes      */
 } N0_3D_data;
 
 int N0_3D_init_offload(N0_3D_offload_data* offload_data, real** offload_array);
@@ -49,6 +48,9 @@ void N0_3D_free_offload(N0_3D_offload_data* offload_data, real** offload_array);
 void N0_3D_init(N0_3D_data* ndata, N0_3D_offload_data* offload_data,
                 real* offload_array);
 DECLARE_TARGET_SIMD_UNIFORM(ndata)
+a5err N0_3D_eval_n0t0(real* n0, real* t0, real r, real phi, real z,
+                      N0_3D_data* ndata);
+DECLARE_TARGET_SIMD_UNIFORM(ndata)
 a5err N0_3D_eval_n0(real* n0, real r, real phi, real z, N0_3D_data* ndata);
 DECLARE_TARGET_SIMD_UNIFORM(ndata)
 a5err N0_3D_eval_t0(real* t0, real r, real phi, real z, N0_3D_data* ndata);
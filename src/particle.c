@@ -106,6 +106,10 @@ void particle_allocate_fo(particle_simd_fo* p_fo, int nmrk){
 
     /* Meta data */
     p_fo->mileage = malloc(nmrk * sizeof(p_fo->mileage));
+    p_fo->nstep    = malloc(nmrk * sizeof(p_fo->nstep)   );
+    p_fo->nrej     = malloc(nmrk * sizeof(p_fo->nrej)    );
+    p_fo->mindt    = malloc(nmrk * sizeof(p_fo->mindt)   );
+    p_fo->mindtlim = malloc(nmrk * sizeof(p_fo->mindtlim));
 
     p_fo->running = malloc(nmrk * sizeof(p_fo->running));
 
@@ -296,9 +300,17 @@ int particle_cycle_fo(particle_queue* q, particle_simd_fo* p,
             /* Get the next unsimulated marker from the queue */
             int i_prt;
             #pragma omp critical
-            i_prt = q->next++;
+            {
+                /* The queue may grow during the simulation (hybrid mode,
+                 * splitting) so it is checked only here, where q->n cannot
+                 * change, whether there are markers left */
+                i_prt = -1;
+                if(q->next < q->n) {
+                    i_prt = q->next++;
+                }
+            }
 
-            if(i_prt >= q->n) {
+            if(i_prt < 0) {
                 /* The queue is empty, place a dummy marker here */
                 p->running[i] = 0;
                 p->id[i] = -1;
@@ -369,7 +381,7 @@ int particle_cycle_gc(particle_queue* q, particle_simd_gc* p,
 
     /* Loop over markers.
      * A SIMD loop is not possible as we modify the queue. */
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p->n_mrk; i++) {
 
         /* First check whether we should pick a new marker */
         int newmarker = 0;
@@ -395,9 +407,17 @@ int particle_cycle_gc(particle_queue* q, particle_simd_gc* p,
             /* Get the next unsimulated marker from the queue */
             int i_prt;
             #pragma omp critical
-            i_prt = q->next++;
+            {
+                /* The queue may grow during the simulation (hybrid mode,
+                 * splitting) so it is checked only here, where q->n cannot
+                 * change, whether there are markers left */
+                i_prt = -1;
+                if(q->next < q->n) {
+                    i_prt = q->next++;
+                }
+            }
 
-            if(i_prt >= q->n) {
+            if(i_prt < 0) {
                 /* The queue is empty, place a dummy marker here */
                 p->running[i] = 0;
                 p->id[i] = -1;
@@ -426,7 +446,7 @@ int particle_cycle_gc(particle_queue* q, particle_simd_gc* p,
 
     int n_running = 0;
     #pragma omp simd reduction(+:n_running)
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p->n_mrk; i++) {
         n_running += p->running[i];
     }
 
@@ -463,7 +483,7 @@ int particle_cycle_ml(particle_queue* q, particle_simd_ml* p,
 
     /* Loop over markers.
      * A SIMD loop is not possible as we modify the queue. */
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p->n_mrk; i++) {
 
         /* First check whether we should pick a new marker */
         int newmarker = 0;
@@ -520,13 +540,107 @@ int particle_cycle_ml(particle_queue* q, particle_simd_ml* p,
 
     int n_running = 0;
     #pragma omp simd reduction(+:n_running)
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p->n_mrk; i++) {
         n_running += p->running[i];
     }
 
     return n_running;
 }
 
+/**
+ * @brief Pack running GC markers to the lowest lanes of the SIMD array
+ *
+ * Once the queue has been exhausted, finished markers are replaced with
+ * dummies and the remaining lanes would be integrated for nothing until the
+ * last marker in the SIMD array finishes. This function moves the running
+ * markers, preserving their order, to the lowest lanes and reduces the number
+ * of lanes in use accordingly. The vacated lanes are turned into dummies.
+ *
+ * Packing is done only when the queue is empty and at most half of the lanes
+ * in use are running, so the markers are moved at most a few times per
+ * thread. The caller must move any per-lane data it holds in the same way:
+ * after packing, lane i contains the marker that was in lane[i] where
+ * lane[i] >= i.
+ *
+ * @param q pointer to marker queue
+ * @param p pointer to SIMD structure of markers
+ * @param lane pointer to array where the original lane of each marker is
+ *        stored
+ *
+ * @return Non-zero if markers were packed
+ */
+int particle_compact_gc(particle_queue* q, particle_simd_gc* p, int* lane) {
+    int n_running = 0;
+    for(int i = 0; i < p->n_mrk; i++) {
+        n_running += p->running[i];
+    }
+    if(q->next < q->n || n_running == 0 || 2 * n_running > p->n_mrk) {
+        return 0;
+    }
+
+    int j = 0;
+    for(int i = 0; i < p->n_mrk; i++) {
+        if(p->running[i]) {
+            lane[j] = i;
+            if(i != j) {
+                particle_copy_gc(p, i, p, j);
+                p->index[j] = p->index[i];
+                p->err[j]   = p->err[i];
+            }
+            j++;
+        }
+    }
+    for(int i = j; i < p->n_mrk; i++) {
+        p->running[i] = 0;
+        p->id[i]      = -1;
+    }
+    p->n_mrk = j;
+
+    return 1;
+}
+
+/**
+ * @brief Pack running ML markers to the lowest lanes of the SIMD array
+ *
+ * See particle_compact_gc().
+ *
+ * @param q pointer to marker queue
+ * @param p pointer to SIMD structure of markers
+ * @param lane pointer to array where the original lane of each marker is
+ *        stored
+ *
+ * @return Non-zero if markers were packed
+ */
+int particle_compact_ml(particle_queue* q, particle_simd_ml* p, int* lane) {
+    int n_running = 0;
+    for(int i = 0; i < p->n_mrk; i++) {
+        n_running += p->running[i];
+    }
+    if(q->next < q->n || n_running == 0 || 2 * n_running > p->n_mrk) {
+        return 0;
+    }
+
+    int j = 0;
+    for(int i = 0; i < p->n_mrk; i++) {
+        if(p->running[i]) {
+            lane[j] = i;
+            if(i != j) {
+                particle_copy_ml(p, i, p, j);
+                p->index[j] = p->index[i];
+                p->err[j]   = p->err[i];
+            }
+            j++;
+        }
+    }
+    for(int i = j; i < p->n_mrk; i++) {
+        p->running[i] = 0;
+        p->id[i]      = -1;
+    }
+    p->n_mrk = j;
+
+    return 1;
+}
+
 /**
  * @brief Converts input marker to a marker state
  *
@@ -680,6 +794,10 @@ a5err particle_state_to_fo(particle_state* p, int i, particle_simd_fo* p_fo,
         p_fo->endcond[j]    = p->endcond;
         p_fo->walltile[j]   = p->walltile;
         p_fo->mileage[j]    = p->mileage;
+        p_fo->nstep[j]      = p->nstep;
+        p_fo->nrej[j]       = p->nrej;
+        p_fo->mindt[j]      = p->mindt;
+        p_fo->mindtlim[j]   = p->mindtlim;
     }
 
     /* Magnetic field stored in state is for the gc position */
@@ -764,6 +882,10 @@ void particle_fo_to_state(particle_simd_fo* p_fo, int j, particle_state* p,
     p->walltile   = p_fo->walltile[j];
     p->cputime    = p_fo->cputime[j];
     p->mileage    = p_fo->mileage[j];
+    p->nstep      = p_fo->nstep[j];
+    p->nrej       = p_fo->nrej[j];
+    p->mindt      = p_fo->mindt[j];
+    p->mindtlim   = p_fo->mindtlim[j];
 
     /* Particle to guiding center */
     real B_dB[15], psi[1], rho[2];
@@ -891,6 +1013,10 @@ a5err particle_state_to_gc(particle_state* p, int i, particle_simd_gc* p_gc,
         p_gc->endcond[j]    = p->endcond;
         p_gc->walltile[j]   = p->walltile;
         p_gc->mileage[j]    = p->mileage;
+        p_gc->nstep[j]      = p->nstep;
+        p_gc->nrej[j]       = p->nrej;
+        p_gc->mindt[j]      = p->mindt;
+        p_gc->mindtlim[j]   = p->mindtlim;
 
         p_gc->B_r[j]        = p->B_r;
         p_gc->B_r_dr[j]     = p->B_r_dr;
@@ -955,6 +1081,10 @@ void particle_gc_to_state(particle_simd_gc* p_gc, int j, particle_state* p,
     p->endcond    = p_gc->endcond[j];
     p->walltile   = p_gc->walltile[j];
     p->mileage    = p_gc->mileage[j];
+    p->nstep      = p_gc->nstep[j];
+    p->nrej       = p_gc->nrej[j];
+    p->mindt      = p_gc->mindt[j];
+    p->mindtlim   = p_gc->mindtlim[j];
 
     p->B_r        = p_gc->B_r[j];
     p->B_r_dr     = p_gc->B_r_dr[j];
@@ -1068,6 +1198,10 @@ a5err particle_state_to_ml(particle_state* p, int i, particle_simd_ml* p_ml,
         p_ml->endcond[j]    = p->endcond;
         p_ml->walltile[j]   = p->walltile;
         p_ml->mileage[j]    = p->mileage;
+        p_ml->nstep[j]      = p->nstep;
+        p_ml->nrej[j]       = p->nrej;
+        p_ml->mindt[j]      = p->mindt;
+        p_ml->mindtlim[j]   = p->mindtlim;
 
         p_ml->B_r[j]        = p->B_r;
         p_ml->B_r_dr[j]     = p->B_r_dr;
@@ -1142,6 +1276,10 @@ void particle_ml_to_state(particle_simd_ml* p_ml, int j, particle_state* p,
     p->endcond    = p_ml->endcond[j];
     p->walltile   = p_ml->walltile[j];
     p->mileage    = p_ml->mileage[j];
+    p->nstep      = p_ml->nstep[j];
+    p->nrej       = p_ml->nrej[j];
+    p->mindt      = p_ml->mindt[j];
+    p->mindtlim   = p_ml->mindtlim[j];
     p->err        = p_ml->err[j];
 
     p->B_r        = p_ml->B_r[j];
@@ -1207,6 +1345,10 @@ int particle_fo_to_gc(particle_simd_fo* p_fo, int j, particle_simd_gc* p_gc,
         p_gc->weight[j]   = p_fo->weight[j];
         p_gc->time[j]     = p_fo->time[j];
         p_gc->mileage[j]  = p_fo->mileage[j];
+        p_gc->nstep[j]    = p_fo->nstep[j];
+        p_gc->nrej[j]     = p_fo->nrej[j];
+        p_gc->mindt[j]    = p_fo->mindt[j];
+        p_gc->mindtlim[j] = p_fo->mindtlim[j];
         p_gc->endcond[j]  = p_fo->endcond[j];
         p_gc->running[j]  = p_fo->running[j];
         p_gc->walltile[j] = p_fo->walltile[j];
@@ -1309,6 +1451,10 @@ void particle_copy_fo(particle_simd_fo* p1, int i, particle_simd_fo* p2, int j)
 
         p2->time[j]       = p1->time[i];
         p2->mileage[j]    = p1->mileage[i];
+        p2->nstep[j]      = p1->nstep[i];
+        p2->nrej[j]       = p1->nrej[i];
+        p2->mindt[j]      = p1->mindt[i];
+        p2->mindtlim[j]   = p1->mindtlim[i];
         p2->cputime[j]    = p1->cputime[i];
         p2->rho[j]        = p1->rho[i];
         p2->weight[j]     = p1->weight[i];
@@ -1362,6 +1508,10 @@ void particle_copy_gc(particle_simd_gc* p1, int i, particle_simd_gc* p2, int j)
 
     p2->time[j]       = p1->time[i];
     p2->mileage[j]    = p1->mileage[i];
+    p2->nstep[j]      = p1->nstep[i];
+    p2->nrej[j]       = p1->nrej[i];
+    p2->mindt[j]      = p1->mindt[i];
+    p2->mindtlim[j]   = p1->mindtlim[i];
     p2->weight[j]     = p1->weight[i];
     p2->cputime[j]    = p1->cputime[i];
     p2->rho[j]        = p1->rho[i];
@@ -1410,6 +1560,10 @@ void particle_copy_ml(particle_simd_ml* p1, int i, particle_simd_ml* p2,
 
     p2->time[j]       = p1->time[i];
     p2->mileage[j]    = p1->mileage[i];
+    p2->nstep[j]      = p1->nstep[i];
+    p2->nrej[j]       = p1->nrej[i];
+    p2->mindt[j]      = p1->mindt[i];
+    p2->mindtlim[j]   = p1->mindtlim[i];
     p2->cputime[j]    = p1->cputime[i];
     p2->rho[j]        = p1->rho[i];
     p2->weight[j]     = p1->weight[i];
@@ -1468,6 +1622,10 @@ a5err particle_input_p_to_state(particle* p, particle_state* ps,
     ps->theta    = atan2(ps->zprt-axisrz[1], ps->rprt-axisrz[0]);
     ps->id       = p->id;
     ps->mileage  = 0;
+    ps->nstep    = 0;
+    ps->nrej     = 0;
+    ps->mindt    = 0;
+    ps->mindtlim = 0;
     ps->endcond  = 0;
     ps->walltile = 0;
     ps->cputime  = 0;
@@ -1606,6 +1764,10 @@ a5err particle_input_gc_to_state(particle_gc* p, particle_state* ps,
         ps->theta    = atan2(ps->z-axisrz[1], ps->r-axisrz[0]);
         ps->id       = p->id;
         ps->mileage  = 0;
+        ps->nstep    = 0;
+        ps->nrej     = 0;
+        ps->mindt    = 0;
+        ps->mindtlim = 0;
         ps->endcond  = 0;
         ps->walltile = 0;
         ps->cputime  = 0;
@@ -1691,6 +1853,10 @@ a5err particle_input_ml_to_state(particle_ml* p, particle_state* ps,
         ps->walltile   = 0;
         ps->cputime    = 0;
         ps->mileage    = 0;
+        ps->nstep      = 0;
+        ps->nrej       = 0;
+        ps->mindt      = 0;
+        ps->mindtlim   = 0;
 
         ps->r          = p->r;
         ps->phi        = p->phi;
@@ -1733,6 +1899,10 @@ void particle_offload_fo(particle_simd_fo* p) {
 		p->p_phi     [0:p->n_mrk],\
 		p->p_z       [0:p->n_mrk],\
 		p->mileage   [0:p->n_mrk],\
+		p->nstep     [0:p->n_mrk],\
+		p->nrej      [0:p->n_mrk],\
+		p->mindt     [0:p->n_mrk],\
+		p->mindtlim  [0:p->n_mrk],\
 		p->z         [0:p->n_mrk],\
 		p->charge    [0:p->n_mrk],\
 		p->mass      [0:p->n_mrk],\
@@ -24,6 +24,20 @@
 #include "E_field.h"
 #include "error.h"
 
+/**
+ * @brief What limited the time-step
+ *
+ * These enums are stored for each marker to tell what determined the length
+ * of the smallest time-step it took.
+ */
+enum STEP_LIMITER {
+    step_limiter_initial    = 0, /**< Initial or fixed time-step            */
+    step_limiter_orbit      = 1, /**< Orbit-following error tolerance       */
+    step_limiter_collisions = 2, /**< Coulomb collision error tolerance     */
+    step_limiter_drho       = 3, /**< Maximum rho change per time-step      */
+    step_limiter_dphi       = 4  /**< Maximum phi change per time-step      */
+};
+
 /**
  * @brief General representation of a marker
  *
@@ -58,6 +72,11 @@ typedef struct {
     real time;        /**< Marker simulation time [s]                      */
     real mileage;     /**< Duration this marker has been simulated [s]     */
     real cputime;     /**< Marker wall-clock time [s]                      */
+    integer nstep;    /**< Number of accepted time-steps                   */
+    integer nrej;     /**< Number of rejected time-steps                   */
+    real mindt;       /**< Smallest accepted time-step [s]                 */
+    integer mindtlim; /**< What limited the smallest time-step, see
+                           STEP_LIMITER                                    */
     real rho;         /**< Marker rho coordinate                           */
     real theta;       /**< Marker poloidal coordinate [rad]                */
     integer id;       /**< Arbitrary but unique ID for the marker          */
@@ -249,6 +268,10 @@ typedef struct {
 
     /* Meta data */
     real* mileage;    /**< Duration this marker has been simulated [s] */
+    integer* nstep;   /**< Number of accepted time-steps               */
+    integer* nrej;    /**< Number of rejected time-steps               */
+    real* mindt;      /**< Smallest accepted time-step [s]             */
+    integer* mindtlim;/**< What limited the smallest time-step         */
     integer* running; /**< Indicates whether this marker is currently
                            simulated (1) or not  */
     a5err* err;       /**< Error flag, zero if no error    */
@@ -317,10 +340,18 @@ typedef struct {
     /* Meta data */
     real mileage[NSIMD] __memalign__;    /**< Duration this marker has been
                                               simulated [s]                   */
+    integer nstep[NSIMD] __memalign__;   /**< Number of accepted time-steps   */
+    integer nrej[NSIMD] __memalign__;    /**< Number of rejected time-steps   */
+    real mindt[NSIMD] __memalign__;      /**< Smallest accepted time-step [s] */
+    integer mindtlim[NSIMD] __memalign__;/**< What limited the smallest
+                                              time-step                       */
     integer running[NSIMD] __memalign__; /**< Indicates whether this marker is
                                               currently simulated (1) or not  */
     a5err err[NSIMD] __memalign__;       /**< Error flag, zero if no error    */
     integer index[NSIMD] __memalign__;   /**< Marker index at marker queue    */
+
+    int n_mrk; /**< Number of lanes in use, lanes from n_mrk onwards are not
+                    simulated and must not contain running markers            */
 } particle_simd_gc;
 
 /**
@@ -380,10 +411,18 @@ typedef struct {
     /* Meta data */
     real mileage[NSIMD] __memalign__;    /**< Duration this marker has been
                                               simulated [s]                   */
+    integer nstep[NSIMD] __memalign__;   /**< Number of accepted time-steps   */
+    integer nrej[NSIMD] __memalign__;    /**< Number of rejected time-steps   */
+    real mindt[NSIMD] __memalign__;      /**< Smallest accepted time-step [s] */
+    integer mindtlim[NSIMD] __memalign__;/**< What limited the smallest
+                                              time-step                       */
     integer running[NSIMD] __memalign__; /**< Indicates whether this marker is
                                               currently simulated (1) or not  */
     a5err err[NSIMD] __memalign__;       /**< Error flag, zero if no error    */
     integer index[NSIMD] __memalign__;   /**< Marker index at marker queue    */
+
+    int n_mrk; /**< Number of lanes in use, lanes from n_mrk onwards are not
+                    simulated and must not contain running markers            */
 } particle_simd_ml;
 
 
@@ -400,6 +439,8 @@ int particle_cycle_gc(particle_queue* q, particle_simd_gc* p,
                       B_field_data* Bdata, int* cycle);
 int particle_cycle_ml(particle_queue* q, particle_simd_ml* p,
                       B_field_data* Bdata, int* cycle);
+int particle_compact_gc(particle_queue* q, particle_simd_gc* p, int* lane);
+int particle_compact_ml(particle_queue* q, particle_simd_ml* p, int* lane);
 
 void particle_input_to_state(input_particle* p, particle_state* ps,
                              B_field_data* Bdata);
@@ -2,8 +2,11 @@
  * @file plasma_1D.c
  * @brief 1D linearly interpolated plasma
  *
- * Plasma data which is defined in a 1D uniform grid from which the values are
+ * Plasma data which is defined in a 1D grid from which the values are
  * interpolated linearly. The coordinate is the normalized poloidal flux.
+ *
+ * The grid interval is found with linint_search() which indexes uniform grids
+ * directly and uses a precomputed table for non-uniform grids.
  */
 #include <stdio.h>
 #include <stdlib.h>
@@ -28,8 +31,9 @@
  *   -         [n_rho*2 + n_rho*n_ions] = electron density [m^-3]
  *   - [n_rho*2 + n_rho*n_ions + n_rho] = ion density [m^-3]
  *
- * Since this data requires no initialization, the only thing this function does
- * is that it prints some values as sanity check.
+ * If the rho grid is not uniform, the offload array is extended with the
+ * rho search table. Otherwise this function only prints some values as
+ * sanity check.
  *
  * @param offload_data pointer to offload data struct
  * @param offload_array pointer to pointer to offload array
@@ -83,6 +87,22 @@ int plasma_1D_init_offload(plasma_1D_offload_data* offload_data,
     }
     print_out(VERBOSE_IO, "Quasi-neutrality is (electron / ion charge density)"
               " %.2f\n", 1+quasineutrality);
+
+    /* Append the rho search table to the offload array */
+    int n_bin = linint_search_nbin(*offload_array, n_rho);
+    if(n_bin > 0) {
+        real* arr = realloc(*offload_array, sizeof(real)
+                            * (offload_data->offload_array_length + n_bin));
+        if(arr == NULL) {
+            print_err("Error: Failed to allocate memory.");
+            return 1;
+        }
+        *offload_array = arr;
+        linint_search_fill(&arr[offload_data->offload_array_length], n_bin,
+                           arr, n_rho);
+    }
+    offload_data->n_bin_rho = n_bin;
+    offload_data->offload_array_length += n_bin;
     return 0;
 }
 
@@ -127,6 +147,10 @@ void plasma_1D_init(plasma_1D_data* pls_data,
     pls_data->rho  = &offload_array[0];
     pls_data->temp = &offload_array[pls_data->n_rho];
     pls_data->dens = &offload_array[pls_data->n_rho*3];
+    linint_search_init(&pls_data->rho_search, pls_data->rho, pls_data->n_rho,
+                       &offload_array[offload_data->offload_array_length
+                                      - offload_data->n_bin_rho],
+                       offload_data->n_bin_rho);
 }
 
 /**
@@ -153,11 +177,7 @@ a5err plasma_1D_eval_temp(real* temp, real rho, int species,
         err = error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_PLASMA_1D );
     }
     else {
-        int i_rho = 0;
-        while(i_rho < pls_data->n_rho - 1 && pls_data->rho[i_rho] <= rho) {
-            i_rho++;
-        }
-        i_rho--;
+        int i_rho = linint_search(rho, &pls_data->rho_search);
         real t_rho = (rho - pls_data->rho[i_rho])
             / (pls_data->rho[i_rho+1] - pls_data->rho[i_rho]);
 
@@ -193,11 +213,7 @@ a5err plasma_1D_eval_dens(real* dens, real rho, int species,
         err = error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_PLASMA_1D );
     }
     else {
-        int i_rho = 0;
-        while(i_rho < pls_data->n_rho - 1 && pls_data->rho[i_rho] <= rho) {
-            i_rho++;
-        }
-        i_rho--;
+        int i_rho = linint_search(rho, &pls_data->rho_search);
         real t_rho = (rho - pls_data->rho[i_rho])
                  / (pls_data->rho[i_rho+1] - pls_data->rho[i_rho]);
 
@@ -232,11 +248,7 @@ a5err plasma_1D_eval_densandtemp(real* dens, real* temp, real rho,
         err = error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_PLASMA_1D );
     }
     else {
-        int i_rho = 0;
-        while(i_rho < pls_data->n_rho-1 && pls_data->rho[i_rho] <= rho) {
-            i_rho++;
-        }
-        i_rho--;
+        int i_rho = linint_search(rho, &pls_data->rho_search);
 
         real t_rho = (rho - pls_data->rho[i_rho])
                  / (pls_data->rho[i_rho+1] - pls_data->rho[i_rho]);
@@ -6,6 +6,7 @@
 #define PLASMA_1D_H
 #include "../ascot5.h"
 #include "../error.h"
+#include "../linint/linint.h"
 
 /**
  * @brief 1D plasma parameters that will be offloaded to target
@@ -18,6 +19,8 @@ typedef struct {
     real charge[MAX_SPECIES];   /**< plasma species charges [C]          */
     int anum[MAX_SPECIES];      /**< ion species atomic number           */
     int znum[MAX_SPECIES];      /**< ion species charge number           */
+    int n_bin_rho;              /**< number of bins in the rho search
+                                     table (zero if rho grid is uniform) */
     int offload_array_length;   /**< number of elements in offload_array */
 } plasma_1D_offload_data;
 
@@ -36,6 +39,7 @@ typedef struct {
                                    offload_array                       */
     real* temp;               /**< pointer to start of temperatures    */
     real* dens;               /**< pointer to start of densities       */
+    linint_search_data rho_search; /**< rho grid interval search       */
 } plasma_1D_data;
 
 int plasma_1D_init_offload(plasma_1D_offload_data* offload_data,
@@ -1,6 +1,10 @@
 /**
  * @file plasma_1Dt.c
  * @brief 1D time-dependent plasma with linear interpolation
+ *
+ * The rho and time grid intervals are found with linint_search() which
+ * indexes uniform grids directly and uses precomputed tables for non-uniform
+ * grids.
  */
 #include <stdio.h>
 #include <stdlib.h>
@@ -25,8 +29,9 @@
  *   - [n_rho*2 + n_rho*n_ions + n_rho] = ion density [m^-3]
  *   - [i_time*n_species*n_rho+i_species*n_rho] =
  *
- * This function initializes splines to plasma profiles and prints some values
- * as sanity checks.
+ * This function prints some values as sanity checks and extends the offload
+ * array with the rho and time search tables, in that order, for grids that are
+ * not uniform.
  *
  * @param offload_data pointer to offload data struct
  * @param offload_array pointer to pointer to offload array
@@ -89,6 +94,26 @@ int plasma_1Dt_init_offload(plasma_1Dt_offload_data* offload_data,
     }
     print_out(VERBOSE_IO, "Quasi-neutrality is (electron / ion charge density)"
               " %.2f\n", 1+quasineutrality);
+
+    /* Append the rho and time search tables to the offload array */
+    int n_bin_rho  = linint_search_nbin(&(*offload_array)[0], n_rho);
+    int n_bin_time = linint_search_nbin(&(*offload_array)[n_rho], n_time);
+    if(n_bin_rho + n_bin_time > 0) {
+        int n = offload_data->offload_array_length;
+        real* arr = realloc(*offload_array, sizeof(real)
+                            * (n + n_bin_rho + n_bin_time));
+        if(arr == NULL) {
+            print_err("Error: Failed to allocate memory.");
+            return 1;
+        }
+        *offload_array = arr;
+        linint_search_fill(&arr[n], n_bin_rho, &arr[0], n_rho);
+        linint_search_fill(&arr[n + n_bin_rho], n_bin_time, &arr[n_rho],
+                           n_time);
+    }
+    offload_data->n_bin_rho  = n_bin_rho;
+    offload_data->n_bin_time = n_bin_time;
+    offload_data->offload_array_length += n_bin_rho + n_bin_time;
     return 0;
 }
 
@@ -134,6 +159,15 @@ void plasma_1Dt_init(plasma_1Dt_data* pls_data,
     pls_data->temp = &offload_array[pls_data->n_rho+pls_data->n_time];
     pls_data->dens = &offload_array[pls_data->n_rho+pls_data->n_time
                                     +2*pls_data->n_rho*pls_data->n_time];
+
+    real* bin = &offload_array[offload_data->offload_array_length
+                               - offload_data->n_bin_rho
+                               - offload_data->n_bin_time];
+    linint_search_init(&pls_data->rho_search, pls_data->rho, pls_data->n_rho,
+                       bin, offload_data->n_bin_rho);
+    linint_search_init(&pls_data->time_search, pls_data->time,
+                       pls_data->n_time, bin + offload_data->n_bin_rho,
+                       offload_data->n_bin_time);
 }
 
 /**
@@ -216,25 +250,16 @@ a5err plasma_1Dt_eval_densandtemp(real* dens, real* temp, real rho, real t,
         err = error_raise( ERR_INPUT_EVALUATION, __LINE__, EF_PLASMA_1D );
     }
     else {
-        int i_rho = 0;
-        while(i_rho < pls_data->n_rho-1 && pls_data->rho[i_rho] <= rho) {
-            i_rho++;
-        }
-        i_rho--;
+        int i_rho = linint_search(rho, &pls_data->rho_search);
 
         real t_rho = (rho - pls_data->rho[i_rho])
                  / (pls_data->rho[i_rho+1] - pls_data->rho[i_rho]);
 
-        int i_time = 0;
-        while(i_time < pls_data->n_time-1 && pls_data->time[i_time] <= t) {
-            i_time++;
-        }
-        i_time--;
-
+        int i_time = linint_search(t, &pls_data->time_search);
         real t_time = (t - pls_data->time[i_time])
                  / (pls_data->time[i_time+1] - pls_data->time[i_time]);
 
-        if(i_time < 0) {
+        if( !(t >= pls_data->time[0]) ) {
             /* time < t[0], use first profile */
             i_time = 0;
             t_time = 0;
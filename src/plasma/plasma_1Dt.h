@@ -6,6 +6,7 @@
 #define PLASMA_1DT_H
 #include "../ascot5.h"
 #include "../error.h"
+#include "../linint/linint.h"
 
 /**
  * @brief 1D plasma parameters that will be offloaded to target
@@ -19,6 +20,10 @@ typedef struct {
     real charge[MAX_SPECIES];   /**< plasma species charges [C]          */
     int anum[MAX_SPECIES];      /**< ion species atomic number           */
     int znum[MAX_SPECIES];      /**< ion species charge number           */
+    int n_bin_rho;              /**< number of bins in the rho search
+                                     table (zero if rho grid is uniform) */
+    int n_bin_time;             /**< number of bins in the time search
+                                     table (zero if time grid is uniform)*/
     int offload_array_length;   /**< number of elements in offload_array */
 } plasma_1Dt_offload_data;
 
@@ -39,6 +44,8 @@ typedef struct {
     real* time;               /**< pointer to start of time values     */
     real* temp;               /**< pointer to start of temperatures    */
     real* dens;               /**< pointer to start of densities       */
+    linint_search_data rho_search;  /**< rho grid interval search      */
+    linint_search_data time_search; /**< time grid interval search     */
 } plasma_1Dt_data;
 
 int plasma_1Dt_init_offload(plasma_1Dt_offload_data* offload_data,
@@ -11,8 +11,12 @@
  * on the data once it has been initialized. However, threads should only modify
  * marker and diagnostic data.
  */
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <math.h>
+#include "consts.h"
 #include "endcond.h"
 #include "offload.h"
 #include "particle.h"
@@ -29,7 +33,8 @@
 #include "asigma.h"
 #include "copytogpu.h"
 
-void sim_monitor(char* filename, volatile int* n, volatile int* finished);
+void sim_monitor(char* filename, volatile int* n, volatile int* finished,
+                 volatile int* n_hybrid, volatile int* finished_hybrid);
 
 /**
  * @brief Execute marker simulation
@@ -44,27 +49,25 @@ void sim_monitor(char* filename, volatile int* n, volatile int* finished);
  *
  * 2. Meta data (e.g. random number generator) is initialized.
  *
- * 3. Markers are put into simulation queue.
+ * 3. Markers are put into simulation queue. Optionally, the queue is ordered
+ *    so that markers close to each other are simulated at the same time.
  *
  * 4. Threads are spawned. One thread is dedicated for monitoring progress, if
  *    monitoring is active.
  *
  * 5. Other threads execute marker simulation using the mode the user has
- *    chosen.
+ *    chosen. In hybrid mode, markers that meet the hybrid end condition are
+ *    checked for wall collisions and handed over to a second queue by the
+ *    thread that simulated them. Each thread continues with the FO
+ *    simulation of that queue once the GC queue is empty.
  *
  * -  Process continues once all markers have been simulated and each thread has
  *    finished. Monitoring is also terminated.
  *
- * 6. (If hybrid mode is active) Markers with hybrid end condition active are
- *    placed on a new queue, and they have their end condition deactivated and
- *    they are simulated with simulate_fo_fixed.c until they have met some other
- *    end condition. Threads are spawned and progress is monitored as
- *    previously.
- *
- * 7. Simulation data is deallocated except for data that is mapped back to
+ * 6. Simulation data is deallocated except for data that is mapped back to
  *    host.
  *
- * 8. Execution returns to host where this function was called.
+ * 7. Execution returns to host where this function was called.
  *
  * @param id target id where this function is executed, zero if on host
  * @param n_particles total number of markers to be simulated
@@ -82,13 +85,6 @@ void simulate(
     offload_package* offload_data, real* offload_array, int* int_offload_array,
     real* diag_offload_array) {
 
-    // Size = NSIMD on CPU and Size = Total number of particles on GPU
-    int n_queue_size;
-#ifdef GPU
-    n_queue_size = n_particles;
-#else
-    n_queue_size = NSIMD;
-#endif
     /**************************************************************************/
     /* 1. Input offload data is unpacked and initialized by calling           */
     /*    respective init functions.                                          */
@@ -97,6 +93,14 @@ void simulate(
     sim_data sim;
     sim_init(&sim, sim_offload);
 
+    // Size = SIMD width on CPU and Size = Total number of particles on GPU
+    int n_queue_size;
+#ifdef GPU
+    n_queue_size = n_particles;
+#else
+    n_queue_size = sim.simd_width;
+#endif
+
 #ifdef GPU
     if(sim_offload->sim_mode != 1) {
         print_err("Only GO mode ported to GPU. Please set SIM_MODE=1.");
@@ -124,7 +128,29 @@ void simulate(
             "ENABLE_TRANSCOEF=1 not ported to GPU. Please disable it.");
         exit(1);
     }
+    if(sim_offload->enable_split) {
+        print_err("ENABLE_SPLITTING=1 not ported to GPU. Please disable it.");
+        exit(1);
+    }
+    if(sim_offload->converge_mode) {
+        print_err("CONVERGENCE_MODE not ported to GPU. Please set it to 0.");
+        exit(1);
+    }
+    if(sim_offload->fix_ccol_nstep > 1) {
+        print_err(
+            "FIXEDSTEP_CCOL_NSTEP > 1 not ported to GPU. Please set it to 1.");
+        exit(1);
+    }
 #endif
+    /* Split markers are appended to the queue after the input markers while
+     * these diagnostics only have room for the input markers */
+    if(sim_offload->enable_split && sim_offload->sim_mode != simulate_mode_ml
+       && ( sim_offload->diag_offload_data.diagorb_collect
+            || sim_offload->diag_offload_data.diagtrcof_collect ) ) {
+        print_err("ENABLE_SPLITTING=1 cannot be used with ENABLE_ORBITWRITE=1 "
+                  "or ENABLE_TRANSCOEF=1. Please disable either.");
+        exit(1);
+    }
     real* ptr; int* ptrint;
     offload_unpack(offload_data, offload_array,
                    sim_offload->B_offload_data.offload_array_length,
@@ -186,6 +212,19 @@ void simulate(
     /* 3. Markers are put into simulation queue.                              */
     /*                                                                        */
     /**************************************************************************/
+    /* Markers created by splitting are stored in a pool and appended to the
+     * queues, which must therefore have room for them */
+    if(sim.enable_split && sim.sim_mode != simulate_mode_ml) {
+        sim.split_pool_size = sim_offload->split_max_markers;
+        sim.split_pool = (particle_state*) malloc(
+            sim.split_pool_size * sizeof(particle_state));
+        sim.split_factor = (int*) malloc(sim.split_pool_size * sizeof(int));
+        if(sim.split_pool == NULL || sim.split_factor == NULL) {
+            print_err("Could not allocate memory for split markers.\n");
+            sim.split_pool_size = 0;
+        }
+    }
+
     particle_queue pq;
 
     pq.n = 0;
@@ -193,7 +232,8 @@ void simulate(
         pq.n++;
     }
 
-    pq.p = (particle_state**) malloc(pq.n * sizeof(particle_state*));
+    pq.p = (particle_state**) malloc(
+        (pq.n + sim.split_pool_size) * sizeof(particle_state*));
     pq.finished = 0;
 
     pq.next = 0;
@@ -203,6 +243,39 @@ void simulate(
     }
     pq.next = 0;
 
+    /* Dispatch may be stopped when the observable has converged, in which
+     * case the markers that are simulated must not be chosen by position */
+    if(simulate_converge_init(&sim.converge_data, sim_offload->converge_mode,
+                              sim_offload->converge_tol,
+                              sim_offload->converge_batch,
+                              sim_offload->converge_min_batches,
+                              wall_get_n_elements(&sim.wall_data), &pq, p,
+                              sim.split_pool, sim.split_pool_size)) {
+        print_err("Could not allocate memory for convergence monitoring.\n");
+        sim.converge_data.mode = simulate_converge_none;
+    }
+    if(sim.converge_data.mode != simulate_converge_none) {
+        if(sim_offload->marker_sorting != simulate_sort_none) {
+            print_out(VERBOSE_NORMAL, "Marker sorting is disabled as "
+                      "convergence is monitored.\n");
+        }
+    }
+    else {
+        simulate_sort_queue(&pq, sim_offload->marker_sorting);
+    }
+
+    /* In hybrid mode, markers are handed over from GC to FO simulation via
+     * this queue which is filled during the GC simulation */
+    particle_queue pq_hybrid;
+    pq_hybrid.n        = 0;
+    pq_hybrid.next     = 0;
+    pq_hybrid.finished = 0;
+    pq_hybrid.p        = NULL;
+    if(sim.sim_mode == simulate_mode_hybrid) {
+        pq_hybrid.p = (particle_state**) malloc(
+            (pq.n + sim.split_pool_size) * sizeof(particle_state*));
+    }
+
     print_out(VERBOSE_NORMAL, "Simulation begins; %d threads.\n",
               omp_get_max_threads());
 
@@ -225,15 +298,28 @@ void simulate(
             /*    user has chosen.                                            */
             /*                                                                */
             /******************************************************************/
-            if(pq.n > 0 && (sim.sim_mode == simulate_mode_gc
-                        || sim.sim_mode == simulate_mode_hybrid)) {
+            if(pq.n > 0 && sim.sim_mode == simulate_mode_gc) {
                 if(sim.enable_ada) {
                     OMP_PARALLEL_CPU_ONLY
-                    simulate_gc_adaptive(&pq, &sim);
+                    simulate_gc_adaptive(&pq, NULL, &sim);
                 }
                 else {
                     OMP_PARALLEL_CPU_ONLY
-                    simulate_gc_fixed(&pq, &sim);
+                    simulate_gc_fixed(&pq, NULL, &sim);
+                }
+            }
+            else if(pq.n > 0 && sim.sim_mode == simulate_mode_hybrid) {
+                /* Each thread continues with the FO simulation of the
+                 * handed over markers once the GC queue is empty */
+                OMP_PARALLEL_CPU_ONLY
+                {
+                    if(sim.enable_ada) {
+                        simulate_gc_adaptive(&pq, &pq_hybrid, &sim);
+                    }
+                    else {
+                        simulate_gc_fixed(&pq, &pq_hybrid, &sim);
+                    }
+                    simulate_fo_fixed(&pq_hybrid, &sim, n_queue_size);
                 }
             }
             else if(pq.n > 0 && sim.sim_mode == simulate_mode_fo) {
@@ -255,86 +341,259 @@ void simulate(
                 strcpy(outfn, sim_offload->hdf5_out);
                 outfn[strlen(outfn)-3] = '\0';
                 sprintf(filename, "%s_%s.stdout", outfn, sim_offload->qid);
-                sim_monitor(filename, &pq.n, &pq.finished);
+                if(sim.sim_mode == simulate_mode_hybrid) {
+                    sim_monitor(filename, &pq.n, &pq.finished,
+                                &pq_hybrid.n, &pq_hybrid.finished);
+                }
+                else {
+                    sim_monitor(filename, &pq.n, &pq.finished, NULL, NULL);
+                }
             }
         }
     }
 #endif
 
     /**************************************************************************/
-    /* 6. (If hybrid mode is active) Markers with hybrid end condition active */
-    /*    are placed on a new queue, and they have their end condition        */
-    /*    deactivated and they are simulated with simulate_fo_fixed.c until   */
-    /*    they have met some other end condition. Threads are spawned and     */
-    /*    progress is monitored as previously.                                */
-    /*                                                                        */
+    /* 6. Simulation data is deallocated.                                     */
     /**************************************************************************/
-    int n_new = 0;
-    if(sim.sim_mode == simulate_mode_hybrid) {
+    if(sim.split_pool_size > 0) {
+        print_out(VERBOSE_NORMAL, "%d markers were created by splitting.\n",
+                  sim.split_pool_next);
+    }
+    if(sim.converge_data.mode != simulate_converge_none) {
+        if(sim.converge_data.converged) {
+            print_out(VERBOSE_NORMAL,
+                      "Converged to relative error %.3g after %d markers. "
+                      "%d markers were not simulated.\n",
+                      sim.converge_data.relerr, sim.converge_data.n_counted,
+                      sim.converge_data.n_skipped);
+        }
+        else {
+            print_out(VERBOSE_NORMAL,
+                      "Relative error %.3g did not reach the target.\n",
+                      sim.converge_data.relerr);
+        }
+    }
+    simulate_converge_free(&sim.converge_data);
+    free(pq.p);
+    free(pq_hybrid.p);
+    free(sim.split_pool);
+    free(sim.split_factor);
+    diag_free(&sim.diag_data);
 
-        /* Determine the number markers that should be run
-         * in fo after previous gc simulation */
-        for(int i = 0; i < pq.n; i++) {
-            if(pq.p[i]->endcond == endcond_hybrid) {
-                /* Check that there was no wall between when moving from
-                   gc to fo */
-                real w_coll;
-                int tile = wall_hit_wall(pq.p[i]->r, pq.p[i]->phi, pq.p[i]->z,
-                        pq.p[i]->rprt, pq.p[i]->phiprt, pq.p[i]->zprt,
-                                         &sim.wall_data, &w_coll);
-                if(tile > 0) {
-                    pq.p[i]->walltile = tile;
-                    pq.p[i]->endcond |= endcond_wall;
-                }
-                else {
-                    n_new++;
-                }
-            }
+    print_out(VERBOSE_NORMAL, "Simulation complete.\n");
+}
+
+/**
+ * @brief Replace finished GC markers and hand hybrid markers over to FO
+ *
+ * Works as particle_cycle_gc() but markers that finished simulation with
+ * only the hybrid end condition active are checked for a wall collision
+ * between the guiding center and particle positions. If the wall was hit,
+ * the marker is terminated with the wall end condition. Otherwise the end
+ * condition is cleared and the marker is appended to the hybrid queue from
+ * where it is picked up by simulate_fo_fixed(). Markers that met other end
+ * conditions as well are terminated and only the hybrid bit is cleared.
+ *
+ * The handed over markers are counted as finished in the GC queue only after
+ * they have been appended, so that sim_monitor() never sees all GC markers
+ * finished while the hybrid queue is still growing.
+ *
+ * This function is thread-safe.
+ *
+ * @param pq queue of GC markers
+ * @param pq_hybrid queue where markers are handed over for FO simulation
+ * @param p pointer to SIMD structure of markers
+ * @param sim pointer to simulation data
+ * @param cycle pointer to integer array where what was done for each marker
+ *              is stored
+ *
+ * @return number of markers that are still running
+ */
+int simulate_cycle_gc_hybrid(particle_queue* pq, particle_queue* pq_hybrid,
+                             particle_simd_gc* p, sim_data* sim, int* cycle) {
+    /* Marker states are stored only when the SIMD array is cycled, so the
+     * queue indices of the hybrid markers are collected first */
+    int n_hybrid = 0;
+    integer i_hybrid[NSIMD];
+    for(int i = 0; i < p->n_mrk; i++) {
+        if(!p->running[i] && p->id[i] >= 0
+           && p->endcond[i] & endcond_hybrid) {
+            i_hybrid[n_hybrid++] = p->index[i];
         }
     }
-    if(n_new > 0) {
 
-        /* Reset hybrid marker end condition */
-        for(int i = 0; i < pq.n; i++) {
-            if(pq.p[i]->endcond & endcond_hybrid) {
-                pq.p[i]->endcond ^= endcond_hybrid;
-            }
+    if(n_hybrid > 0) {
+        #pragma omp critical
+        pq->finished -= n_hybrid;
+    }
+
+    int n_running = particle_cycle_gc(pq, p, &sim->B_data, cycle);
+
+    for(int i = 0; i < n_hybrid; i++) {
+        particle_state* ps = pq->p[i_hybrid[i]];
+        if(ps->endcond != endcond_hybrid || ps->err) {
+            ps->endcond &= ~endcond_hybrid;
+            continue;
         }
-        pq.next = 0;
-        pq.finished = 0;
 
-#if !defined(GPU) && VERBOSE > 1
-        #pragma omp parallel sections num_threads(2)
-        {
-            #pragma omp section
-#endif
-            {
-                OMP_PARALLEL_CPU_ONLY
-                simulate_fo_fixed(&pq, &sim, n_queue_size);
+        /* Check that there was no wall between when moving from gc to fo */
+        real w_coll;
+        int tile = wall_hit_wall(ps->r, ps->phi, ps->z,
+                                 ps->rprt, ps->phiprt, ps->zprt,
+                                 &sim->wall_data, &w_coll);
+        if(tile > 0) {
+            ps->walltile = tile;
+            ps->endcond  = endcond_wall;
+            continue;
+        }
+
+        ps->endcond = 0;
+        #pragma omp critical
+        pq_hybrid->p[pq_hybrid->n++] = ps;
+    }
+
+    if(n_hybrid > 0) {
+        #pragma omp critical
+        pq->finished += n_hybrid;
+    }
+
+    return n_running;
+}
+
+/**
+ * @brief Element in the array that is sorted by simulate_sort_queue()
+ */
+typedef struct {
+    uint64_t key;       /**< Position of the marker on the Z-order curve */
+    particle_state* ps; /**< Pointer to the marker                       */
+} simulate_sortkey;
+
+/**
+ * @brief Spread the lowest 21 bits of an integer so that there are two zero
+ *        bits between each bit
+ *
+ * @param x integer whose bits are spread
+ *
+ * @return the spread integer
+ */
+static uint64_t simulate_spreadbits(uint64_t x) {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffff;
+    x = (x | x << 16) & 0x1f0000ff0000ff;
+    x = (x | x << 8)  & 0x100f00f00f00f00f;
+    x = (x | x << 4)  & 0x10c30c30c30c30c3;
+    x = (x | x << 2)  & 0x1249249249249249;
+    return x;
+}
+
+/**
+ * @brief Compare two sort keys for qsort()
+ *
+ * Ties are resolved with the marker position in memory so that the order
+ * does not depend on the qsort() implementation.
+ */
+static int simulate_compare_sortkey(const void* a, const void* b) {
+    const simulate_sortkey* ka = a;
+    const simulate_sortkey* kb = b;
+    if(ka->key != kb->key) {
+        return ka->key < kb->key ? -1 : 1;
+    }
+    return (ka->ps > kb->ps) - (ka->ps < kb->ps);
+}
+
+/**
+ * @brief Order markers in the queue along a space-filling curve
+ *
+ * Markers whose coordinates are close to each other end up close in the
+ * queue, so that the markers simulated simultaneously (and those that are
+ * subsequently picked from the queue) interpolate the input data in nearby
+ * locations. This improves the cache hit rate when the input data is large.
+ *
+ * The coordinates are scaled to the range the markers occupy (angles to
+ * [0, 2pi)) and quantized to 21 bits whose interleaving gives the position
+ * along the Z-order curve. The guiding center coordinates are used for all
+ * markers. The order in which markers are stored in the marker array is not
+ * changed.
+ *
+ * @param pq queue of markers that have not been simulated yet
+ * @param sorting how the markers are ordered as in MARKER_SORTING
+ */
+void simulate_sort_queue(particle_queue* pq, int sorting) {
+    if(sorting == simulate_sort_none || pq->n < 2) {
+        return;
+    }
+    simulate_sortkey* keys = malloc(pq->n * sizeof(simulate_sortkey));
+    if(keys == NULL) {
+        return;
+    }
+
+    /* Coordinates (x1, x2, x3) are (R, phi, z) or (rho, theta, phi) and the
+     * angles are mapped to [0, 2pi) */
+    int angle[3] = {0, 1, 0};
+    if(sorting == simulate_sort_rhothetaphi) {
+        angle[2] = 1;
+    }
+    real xmin[3] = {INFINITY, INFINITY, INFINITY};
+    real xmax[3] = {-INFINITY, -INFINITY, -INFINITY};
+    real* x = malloc(3 * pq->n * sizeof(real));
+    if(x == NULL) {
+        free(keys);
+        return;
+    }
+    for(int i = 0; i < pq->n; i++) {
+        particle_state* ps = pq->p[i];
+        real* xi = &x[3*i];
+        if(sorting == simulate_sort_rphiz) {
+            xi[0] = ps->r;
+            xi[1] = ps->phi;
+            xi[2] = ps->z;
+        }
+        else {
+            xi[0] = ps->rho;
+            xi[1] = ps->theta;
+            xi[2] = ps->phi;
+        }
+        for(int k = 0; k < 3; k++) {
+            if(angle[k]) {
+                xi[k] = fmod(xi[k], CONST_2PI);
+                xi[k] = xi[k] < 0 ? xi[k] + CONST_2PI : xi[k];
             }
-#if !defined(GPU) && VERBOSE > 1
-            #pragma omp section
-            {
-                /* Trim .h5 from filename and replace it with _<qid>.stdout */
-                if(id == 0) {
-                    char filename[519], outfn[256];
-                    strcpy(outfn, sim_offload->hdf5_out);
-                    outfn[strlen(outfn)-3] = '\0';
-                    sprintf(filename, "%s_%s.stdout", outfn, sim_offload->qid);
-                    sim_monitor(filename, &pq.n, &pq.finished);
-                }
+            else if(isfinite(xi[k])) {
+                xmin[k] = fmin(xmin[k], xi[k]);
+                xmax[k] = fmax(xmax[k], xi[k]);
             }
         }
-#endif
+    }
+    for(int k = 0; k < 3; k++) {
+        if(angle[k]) {
+            xmin[k] = 0;
+            xmax[k] = CONST_2PI;
+        }
     }
 
-    /**************************************************************************/
-    /* 7. Simulation data is deallocated.                                     */
-    /**************************************************************************/
-    free(pq.p);
-    diag_free(&sim.diag_data);
+    const real nbin = 0x1fffff;
+    for(int i = 0; i < pq->n; i++) {
+        uint64_t key = 0;
+        for(int k = 0; k < 3; k++) {
+            real u = 0;
+            if(xmax[k] > xmin[k]) {
+                u = (x[3*i+k] - xmin[k]) / (xmax[k] - xmin[k]);
+            }
+            /* Negated comparisons catch NaNs */
+            u = !(u > 0) ? 0 : ( !(u < 1) ? 1 : u );
+            key |= simulate_spreadbits( (uint64_t)(u * nbin) ) << (2 - k);
+        }
+        keys[i].key = key;
+        keys[i].ps  = pq->p[i];
+    }
+    free(x);
 
-    print_out(VERBOSE_NORMAL, "Simulation complete.\n");
+    qsort(keys, pq->n, sizeof(simulate_sortkey), simulate_compare_sortkey);
+    for(int i = 0; i < pq->n; i++) {
+        pq->p[i] = keys[i].ps;
+    }
+    free(keys);
 }
 
 /**
@@ -353,6 +612,40 @@ void simulate_init_offload(sim_offload_data* sim) {
     asigma_extrapolate(sim->enable_atomic==2);
 }
 
+/**
+ * @brief Number of markers simulated simultaneously in a SIMD array
+ *
+ * The SIMD arrays have room for NSIMD markers, which is fixed at compile time,
+ * but only the first width lanes are used. When the width is not given, it is
+ * chosen based on the widest vector instruction set the CPU supports so that
+ * the SIMD loops fill two vector registers of doubles. This matches the kernel
+ * variant selected at run time when the code is compiled with MULTIARCH. On
+ * GPU all markers are simulated in a single array and this setting is not
+ * used.
+ *
+ * @param width requested width or zero to select it based on the CPU
+ *
+ * @return width in the range [1, NSIMD]
+ */
+int simulate_simd_width(int width) {
+    if(width <= 0) {
+        width = NSIMD;
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(GPU)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f")) {
+            width = 16;
+        }
+        else if(__builtin_cpu_supports("avx")) {
+            width = 8;
+        }
+        else {
+            width = 4;
+        }
+#endif
+    }
+    return width > NSIMD ? NSIMD : width;
+}
+
 /**
  * @brief Initialize simulation data struct on target
  *
@@ -366,10 +659,13 @@ void sim_init(sim_data* sim, sim_offload_data* offload_data) {
     sim->sim_mode             = offload_data->sim_mode;
     sim->enable_ada           = offload_data->enable_ada;
     sim->record_mode          = offload_data->record_mode;
+    sim->simd_width           = simulate_simd_width(offload_data->simd_width);
 
     sim->fix_usrdef_use       = offload_data->fix_usrdef_use;
     sim->fix_usrdef_val       = offload_data->fix_usrdef_val;
     sim->fix_gyrodef_nstep    = offload_data->fix_gyrodef_nstep;
+    sim->fix_ccol_nstep       = offload_data->fix_ccol_nstep;
+    sim->fix_ccol_tol         = offload_data->fix_ccol_tol;
 
     sim->ada_tol_orbfol       = offload_data->ada_tol_orbfol;
     sim->ada_tol_clmbcol      = offload_data->ada_tol_clmbcol;
@@ -386,6 +682,16 @@ void sim_init(sim_data* sim, sim_offload_data* offload_data) {
     sim->disable_gcdiffccoll  = offload_data->disable_gcdiffccoll;
     sim->reverse_time         = offload_data->reverse_time;
 
+    sim->enable_split         = offload_data->enable_split;
+    sim->split_rho            = offload_data->split_rho;
+    sim->split_number         = offload_data->split_number;
+    sim->split_pool           = NULL;
+    sim->split_factor         = NULL;
+    sim->split_pool_size      = 0;
+    sim->split_pool_next      = 0;
+
+    sim->converge_data.mode   = simulate_converge_none;
+
     sim->endcond_active       = offload_data->endcond_active;
     sim->endcond_lim_simtime  = offload_data->endcond_lim_simtime;
     sim->endcond_max_mileage  = offload_data->endcond_max_mileage;
@@ -414,12 +720,22 @@ void sim_init(sim_data* sim, sim_offload_data* offload_data) {
  * to output file, along with time spent on simulation and estimated time
  * remaining for the simulation to finish.
  *
+ * In hybrid mode the progress covers both queues. The hybrid queue is only
+ * known to be complete once every marker in the GC queue has finished, which
+ * simulate_cycle_gc_hybrid() guarantees by counting handed over markers as
+ * finished only after they have been appended to the hybrid queue.
+ *
  * @param filename pointer to file where progress is written. File is opened and
  *        closed outside this function
  * @param n pointer to number of total markers in simulation queue
  * @param finished pointer to number of finished markers in simulation queue
+ * @param n_hybrid pointer to number of total markers in the hybrid queue or
+ *        NULL if not in hybrid mode
+ * @param finished_hybrid pointer to number of finished markers in the hybrid
+ *        queue or NULL if not in hybrid mode
  */
-void sim_monitor(char* filename, volatile int* n, volatile int* finished) {
+void sim_monitor(char* filename, volatile int* n, volatile int* finished,
+                 volatile int* n_hybrid, volatile int* finished_hybrid) {
     /* Open a file for writing simulation progress */
     FILE *f = fopen(filename, "w");
     if (f == NULL) {
@@ -436,10 +752,20 @@ void sim_monitor(char* filename, volatile int* n, volatile int* finished) {
     while(stopflag) {
         n_temp = *n;
         finished_temp = *finished;
+        int alldone = n_temp == finished_temp;
+        if(n_hybrid != NULL) {
+            /* Read after the GC queue so that the hybrid queue can no
+             * longer grow if the GC queue was found to be complete */
+            int nh_temp = *n_hybrid;
+            int fh_temp = *finished_hybrid;
+            alldone = alldone && nh_temp == fh_temp;
+            n_temp += nh_temp;
+            finished_temp += fh_temp;
+        }
         real fracprog = ((real) finished_temp)/n_temp;
         real timespent = (A5_WTIME)-time_sim_started;
 
-        if(n_temp == finished_temp) {
+        if(alldone) {
             stopflag = 0;
         }
 
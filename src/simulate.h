@@ -21,7 +21,9 @@
 #include "diag.h"
 #include "offload.h"
 #include "random.h"
+#include "particle.h"
 #include "simulate/mccc/mccc.h"
+#include "simulate/simulate_converge.h"
 
 /**
  * @brief Simulaton modes
@@ -36,15 +38,29 @@ enum SIMULATION_MODE {
         simulate_gc_fixed.c or simulate_gc_adaptive.c simulation loops      */
     simulate_mode_gc = 2,
     /** Models markers first like using simulate_mode_gc. Additional end
-        condition is used for markers that get close to wall. After all
-        markers are finished, simulation for markers that were close to the
-        wall is continued with using simulate_mode_fo mode                  */
+        condition is used for markers that get close to wall. Simulation of
+        those markers is continued with simulate_mode_fo mode as soon as the
+        thread simulating them runs out of guiding centers                  */
     simulate_mode_hybrid = 3,
     /** Models markers as field lines using particle_simd_ml struct and
         simulate_ml_adaptive.c simulation loop                              */
     simulate_mode_ml = 4
 };
 
+/**
+ * @brief Marker orderings
+ *
+ * These enums determine the order in which markers are taken from the queue.
+ */
+enum MARKER_SORTING {
+    /** Markers are simulated in the input order                            */
+    simulate_sort_none = 0,
+    /** Markers are ordered along a Z-order curve in (R, phi, z)            */
+    simulate_sort_rphiz = 1,
+    /** Markers are ordered along a Z-order curve in (rho, theta, phi)      */
+    simulate_sort_rhothetaphi = 2
+};
+
 /**
  * @brief Simulation offload struct
  *
@@ -69,12 +85,20 @@ typedef struct {
     int sim_mode;        /**< Which simulation mode is used                   */
     int enable_ada;      /**< Is adaptive time-step used                      */
     int record_mode;     /**< Which record mode is used                       */
+    int marker_sorting;  /**< How markers are ordered before the simulation   */
+    int simd_width;      /**< Number of markers in a SIMD array, zero for
+                              selecting it based on the CPU                   */
 
     /* Options - fixed time-step */
     int fix_usrdef_use;    /**< Use user defined value for (initial) time-step*/
     real fix_usrdef_val;   /**< User defined time-step value                  */
     int fix_gyrodef_nstep; /**< Time-step = gyrotime/fix_gyrodef_nstep if not
                                 explicitly user defined                       */
+    int fix_ccol_nstep;    /**< Maximum number of time-steps between
+                                applications of the collision operator        */
+    real fix_ccol_tol;     /**< Collisions are applied once the accumulated
+                                time-step times collision frequency exceeds
+                                this if nonzero                               */
 
     /* Options - adaptive time-step */
     real ada_tol_orbfol;       /**< Tolerance for relative error in
@@ -102,6 +126,21 @@ typedef struct {
                                     from Coulomb collisions */
     int reverse_time;          /**< Set time running backwards in simulation  */
 
+    /* Options - marker splitting */
+    int enable_split;          /**< Are markers split and rouletted           */
+    real split_rho;            /**< Rho of the surface where markers are split*/
+    int split_number;          /**< Number of markers a marker is split into  */
+    int split_max_markers;     /**< Maximum number of markers created by
+                                    splitting                                 */
+
+    /* Options - convergence */
+    int converge_mode;         /**< Observable whose convergence stops the
+                                    simulation, see CONVERGENCE_MODE          */
+    real converge_tol;         /**< Target relative error of the observable   */
+    int converge_batch;        /**< Number of markers in a batch              */
+    int converge_min_batches;  /**< Number of batches before convergence is
+                                    checked                                   */
+
     /* Options - end conditions */
     int endcond_active;        /**< Bit array notating active end conditions  */
     real endcond_lim_simtime;  /**< Simulation time limit [s]                 */
@@ -125,6 +164,7 @@ typedef struct {
     int mpi_root; /**< Rank of the root process      */
     int mpi_rank; /**< Rank of this MPI process      */
     int mpi_size; /**< Total number of MPI processes */
+    int mpi_shmem;/**< Share input data between processes on the same node */
 
     /* QIDs for inputs if the active inputs are not used */
     char qid_options[256]; /**< Options QID if active not used */
@@ -173,12 +213,18 @@ typedef struct {
     int sim_mode;        /**< Which simulation mode is used                   */
     int enable_ada;      /**< Is adaptive time-step used                      */
     int record_mode;     /**< Which record mode is used                       */
+    int simd_width;      /**< Number of markers in a SIMD array (<= NSIMD)    */
 
     /* Options - fixed time-step */
     int fix_usrdef_use;    /**< Use user defined value for (initial) time-step*/
     real fix_usrdef_val;   /**< User defined time-step value                  */
     int fix_gyrodef_nstep; /**< Time-step = gyrotime/fix_stepsPerGO if not
                                 explicitly user defined                       */
+    int fix_ccol_nstep;    /**< Maximum number of time-steps between
+                                applications of the collision operator        */
+    real fix_ccol_tol;     /**< Collisions are applied once the accumulated
+                                time-step times collision frequency exceeds
+                                this if nonzero                               */
 
     /* Options - adaptive time-step */
     real ada_tol_orbfol;       /**< Tolerance for relative error in
@@ -205,6 +251,20 @@ typedef struct {
                                     from Coulomb collisions */
     int reverse_time;          /**< Set time running backwards in simulation  */
 
+    /* Options - marker splitting */
+    int enable_split;          /**< Are markers split and rouletted           */
+    real split_rho;            /**< Rho of the surface where markers are split*/
+    int split_number;          /**< Number of markers a marker is split into  */
+    particle_state* split_pool;/**< Marker states created by splitting        */
+    int* split_factor;         /**< Number of markers the parent of each state
+                                    in the pool was actually split into       */
+    int split_pool_size;       /**< Number of states in the split pool        */
+    int split_pool_next;       /**< Index of the next free state in the pool  */
+
+    /* Convergence monitoring */
+    simulate_converge_data converge_data; /**< Running estimate of the
+                                               observable that is monitored   */
+
     /* Options - end conditions */
     int endcond_active;       /**< Bit array notating active end conditions  */
     real endcond_lim_simtime; /**< Simulation time limit [s]                 */
@@ -225,10 +285,17 @@ void simulate_init_offload(sim_offload_data* sim);
 
 void sim_init(sim_data* sim, sim_offload_data* sim_offload);
 
+int simulate_simd_width(int width);
+
 void simulate(int id, int n_particles, particle_state* p,
               sim_offload_data* sim_offload,
               offload_package* offload_data,
               real* offload_array, int* int_offload_array,
               real* diag_offload_array);
 
+void simulate_sort_queue(particle_queue* pq, int sorting);
+
+int simulate_cycle_gc_hybrid(particle_queue* pq, particle_queue* pq_hybrid,
+                             particle_simd_gc* p, sim_data* sim, int* cycle);
+
 #endif
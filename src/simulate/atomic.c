@@ -69,7 +69,7 @@ void atomic_fo(particle_simd_fo* p, real* h,
     const int* a_2  = plasma_get_species_anum(p_data);
 
     #pragma omp simd
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p->n_mrk; i++) {
         if(p->running[i]) {
             a5err errflag = 0;
 
@@ -92,14 +92,9 @@ void atomic_fo(particle_simd_fo* p, real* h,
             /* Evaluate neutral density and temperature */
             real n_0[MAX_SPECIES], T_0[MAX_SPECIES];
             if(!errflag) {
-                errflag = neutral_eval_n0(n_0, p->rho[i],
-                                          p->r[i], p->phi[i], p->z[i],
-                                          p->time[i], n_data);
-            }
-            if(!errflag) {
-                errflag = neutral_eval_t0(T_0, p->rho[i],
-                                          p->r[i], p->phi[i], p->z[i],
-                                          p->time[i], n_data);
+                errflag = neutral_eval_n0t0(n_0, T_0, p->rho[i],
+                                            p->r[i], p->phi[i], p->z[i],
+                                            p->time[i], n_data);
             }
 
             /* Evaluate the reaction rates for ionizing (charge-increasing) *
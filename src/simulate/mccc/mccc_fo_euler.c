@@ -17,15 +17,20 @@
 /**
  * @brief Integrate collisions for one time-step
  *
+ * Markers whose time-step is zero are skipped.
+ *
  * @param p fo struct
  * @param h time-steps for NSIMD markers
  * @param pdata pointer to plasma data
  * @param mdata pointer collision data struct
  * @param rnd array of normally distributed random numbers used to resolve
  *        collisions. Values for marker i are rnd[i*NSIMD + j]
+ * @param nucol array where the collision frequency of each marker is stored
+ *        or NULL if it is not needed
  */
+A5_TARGET_CLONES
 void mccc_fo_euler(particle_simd_fo* p, real* h, plasma_data* pdata,
-                   mccc_data* mdata, real* rnd) {
+                   mccc_data* mdata, real* rnd, real* nucol) {
 
     /* Get plasma information before going to the  SIMD loop */
     int n_species  = plasma_get_n_species(pdata);
@@ -35,7 +40,7 @@ void mccc_fo_euler(particle_simd_fo* p, real* h, plasma_data* pdata,
     GPU_DATA_IS_MAPPED(h[0:p->n_mrk], rnd[0:3*p->n_mrk])
     GPU_PARALLEL_LOOP_ALL_LEVELS
     for(int i = 0; i < p->n_mrk; i++) {
-        if(p->running[i]) {
+        if(p->running[i] && h[i] != 0) {
             a5err errflag = 0;
 
             /* These are needed twice to transform velocity to cartesian and *
@@ -86,6 +91,12 @@ void mccc_fo_euler(particle_simd_fo* p, real* h, plasma_data* pdata,
                                           nb[j], vb, clogab[j], mufun[1]);
             }
 
+            /* Fastest of the slowing-down and diffusion rates */
+            if(nucol != NULL) {
+                nucol[i] = fmax( fabs(F) / vin,
+                                 2 * fmax(Dpara, Dperp) / (vin*vin) );
+            }
+
             /* Evaluate collisions */
             real sdt = sqrt(h[i]);
             real dW[3];
@@ -18,6 +18,8 @@
 /**
  * @brief Integrate collisions for one time-step
  *
+ * Markers whose time-step is zero are skipped.
+ *
  * @param p gc struct
  * @param h time-steps for NSIMD markers
  * @param Bdata pointer to magnetic field
@@ -25,9 +27,13 @@
  * @param mdata pointer to collision data struct
  * @param rnd array of normally distributed random numbers used to resolve
  *        collisions. Values for marker i are rnd[i*NSIMD + j]
+ * @param nucol array where the collision frequency of each marker is stored
+ *        or NULL if it is not needed
  */
+A5_TARGET_CLONES
 void mccc_gc_euler(particle_simd_gc* p, real* h, B_field_data* Bdata,
-                   plasma_data* pdata, mccc_data* mdata, real* rnd) {
+                   plasma_data* pdata, mccc_data* mdata, real* rnd,
+                   real* nucol) {
 
     /* Get plasma information before going to the  SIMD loop */
     int n_species  = plasma_get_n_species(pdata);
@@ -35,8 +41,8 @@ void mccc_gc_euler(particle_simd_gc* p, real* h, B_field_data* Bdata,
     const real* mb = plasma_get_species_mass(pdata);
 
     #pragma omp simd
-    for(int i = 0; i < NSIMD; i++) {
-        if(p->running[i]) {
+    for(int i = 0; i < p->n_mrk; i++) {
+        if(p->running[i] && h[i] != 0) {
             a5err errflag = 0;
 
             /* Initial (R,z) position and magnetic field are needed for later */
@@ -99,6 +105,13 @@ void mccc_gc_euler(particle_simd_gc* p, real* h, B_field_data* Bdata,
                 DX    += mccc_coefs_DX(xiin, Dparab, Dperpb, gyrofreq);
             }
 
+            /* Fastest of the slowing-down, energy diffusion and pitch
+             * scattering rates */
+            if(nucol != NULL) {
+                nucol[i] = fmax( fmax( fabs(K) / vin, 2 * Dpara / (vin*vin) ),
+                                 nu );
+            }
+
             /* Evaluate collisions */
             real sdt = sqrt(h[i]);
             real dW[5];
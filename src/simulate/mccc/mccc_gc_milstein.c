@@ -31,6 +31,7 @@
  * @param rnd array of normally distributed random numbers used to resolve
  *        collisions. Values for marker i are rnd[i*NSIMD + j]
  */
+A5_TARGET_CLONES
 void mccc_gc_milstein(particle_simd_gc* p, real* hin, real* hout, real tol,
                       mccc_wienarr* w, B_field_data* Bdata, plasma_data* pdata,
                       mccc_data* mdata, real* rnd) {
@@ -41,7 +42,7 @@ void mccc_gc_milstein(particle_simd_gc* p, real* hin, real* hout, real tol,
     const real* mb = plasma_get_species_mass(pdata);
 
     #pragma omp simd
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p->n_mrk; i++) {
         if(p->running[i]) {
             a5err errflag = 0;
 
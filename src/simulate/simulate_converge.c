@@ -0,0 +1,424 @@
+/**
+ * @file simulate_converge.c
+ * @brief Stop the simulation once an observable has converged
+ *
+ * Input markers are grouped into batches of CONVERGENCE_BATCH markers in the
+ * order they are launched, and markers created by splitting belong to the
+ * batch of their parent. A batch is closed only when all of its markers have
+ * finished, and batches are closed in launch order, so that the batches are
+ * independent samples even though e.g. lost markers finish first. Each batch
+ * gives an estimate of the chosen observable, normalized by the total weight
+ * of the markers in the batch, and the relative error of the observable is the
+ * standard error of the mean of the batch estimates divided by the mean. Once
+ * at least CONVERGENCE_MIN_BATCHES batches have been completed and the
+ * relative error is below CONVERGENCE_TOLERANCE, no more markers are taken
+ * from the queue. The markers being simulated at that point are finished
+ * normally, as are the markers created by splitting, and the input markers
+ * that were never taken from the queue keep their input state without an end
+ * condition.
+ *
+ * The markers that are simulated are the first ones in the queue, so the
+ * result is unbiased only if the input markers are in random order.
+ *
+ * Aborted markers are not counted, and markers terminated in Russian roulette
+ * are counted with zero weight since the survivors carry their weight.
+ * Markers handed over to the particle simulation in hybrid mode are counted
+ * when the particle simulation finishes.
+ */
+#include <stdlib.h>
+#include <math.h>
+#include "../ascot5.h"
+#include "../endcond.h"
+#include "../particle.h"
+#include "../physlib.h"
+#include "simulate_converge.h"
+
+/**
+ * @brief Initialize convergence monitoring
+ *
+ * @param data pointer to the convergence data
+ * @param mode observable whose convergence is monitored
+ * @param tol target relative error
+ * @param batch_size number of markers in a batch
+ * @param min_batches number of batches before convergence is checked
+ * @param n_tile number of wall tiles
+ * @param pq queue whose dispatch is stopped once converged
+ * @param mrk input marker states in the order they are launched
+ * @param pool marker states created by splitting
+ * @param pool_size number of states in the split pool
+ *
+ * @return zero on success
+ */
+int simulate_converge_init(simulate_converge_data* data, int mode, real tol,
+                           int batch_size, int min_batches, int n_tile,
+                           particle_queue* pq, particle_state* mrk,
+                           particle_state* pool, int pool_size) {
+    data->mode        = mode;
+    data->tol         = tol;
+    data->batch_size  = batch_size > 0 ? batch_size : 1;
+    data->min_batches = min_batches > 2 ? min_batches : 2;
+    data->pq          = pq;
+    data->n_input     = pq->n;
+    data->n_skipped   = 0;
+
+    data->mrk        = mrk;
+    data->pool       = pool;
+    data->pool_size  = pool_size;
+    data->n_batches  = data->n_input / data->batch_size;
+    data->batch      = 0;
+    data->check      = 0;
+    data->slot_batch = NULL;
+    data->done       = NULL;
+    data->child_head = NULL;
+    data->child_next = NULL;
+
+    data->w_batch   = 0;
+    data->x_batch   = 0;
+    data->n_batch   = 0;
+    data->s1        = 0;
+    data->s2        = 0;
+    data->n_counted = 0;
+    data->relerr    = INFINITY;
+    data->converged = 0;
+
+    data->n_tile     = 0;
+    data->n_touched  = 0;
+    data->tile_max   = 0;
+    data->touched    = NULL;
+    data->tile_batch = NULL;
+    data->tile_s1    = NULL;
+    data->tile_s2    = NULL;
+    if(mode == simulate_converge_none) {
+        return 0;
+    }
+
+    int n_slot = data->n_input + pool_size;
+    data->slot_batch = malloc(n_slot * sizeof(int));
+    data->done       = calloc(n_slot, sizeof(char));
+    data->child_head = malloc(data->n_batches * sizeof(int));
+    data->child_next = malloc(pool_size * sizeof(int));
+    if(data->slot_batch == NULL || data->done == NULL
+       || ( data->n_batches > 0 && data->child_head == NULL )
+       || ( pool_size > 0 && data->child_next == NULL ) ) {
+        simulate_converge_free(data);
+        return 1;
+    }
+    for(int i = 0; i < n_slot; i++) {
+        data->slot_batch[i] = i < data->n_batches * data->batch_size ?
+            i / data->batch_size : -1;
+    }
+    for(int b = 0; b < data->n_batches; b++) {
+        data->child_head[b] = -1;
+    }
+
+    if(mode == simulate_converge_wallload && n_tile > 0) {
+        data->n_tile     = n_tile;
+        data->touched    = malloc(n_tile * sizeof(int));
+        data->tile_batch = calloc(n_tile, sizeof(real));
+        data->tile_s1    = calloc(n_tile, sizeof(real));
+        data->tile_s2    = calloc(n_tile, sizeof(real));
+        if(data->touched == NULL || data->tile_batch == NULL
+           || data->tile_s1 == NULL || data->tile_s2 == NULL) {
+            simulate_converge_free(data);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Free convergence monitoring data
+ *
+ * @param data pointer to the convergence data
+ */
+void simulate_converge_free(simulate_converge_data* data) {
+    free(data->slot_batch);
+    free(data->done);
+    free(data->child_head);
+    free(data->child_next);
+    data->slot_batch = NULL;
+    data->done       = NULL;
+    data->child_head = NULL;
+    data->child_next = NULL;
+    free(data->touched);
+    free(data->tile_batch);
+    free(data->tile_s1);
+    free(data->tile_s2);
+    data->touched    = NULL;
+    data->tile_batch = NULL;
+    data->tile_s1    = NULL;
+    data->tile_s2    = NULL;
+    data->n_tile     = 0;
+}
+
+/**
+ * @brief Relative standard error of the mean of batch estimates
+ *
+ * @param s1 sum of batch estimates
+ * @param s2 sum of squared batch estimates
+ * @param n number of batches
+ *
+ * @return relative error or infinity if the mean is zero
+ */
+static real simulate_converge_relerr(real s1, real s2, int n) {
+    real mean = s1 / n;
+    if(n < 2 || mean <= 0) {
+        return INFINITY;
+    }
+    real var = ( s2 - n * mean * mean ) / ( n - 1 );
+    if(var < 0) {
+        var = 0;
+    }
+    return sqrt( var / n ) / mean;
+}
+
+/**
+ * @brief Close the current batch and update the error estimate
+ *
+ * @param data pointer to the convergence data
+ */
+static void simulate_converge_batch(simulate_converge_data* data) {
+    data->n_batch++;
+    if(data->mode == simulate_converge_loss) {
+        real x = data->x_batch / data->w_batch;
+        data->s1 += x;
+        data->s2 += x * x;
+        data->relerr = simulate_converge_relerr(data->s1, data->s2,
+                                                data->n_batch);
+    }
+    else if(data->n_tile > 0) {
+        for(int k = 0; k < data->n_touched; k++) {
+            int j = data->touched[k];
+            real x = data->tile_batch[j] / data->w_batch;
+            data->tile_s1[j] += x;
+            data->tile_s2[j] += x * x;
+            data->tile_batch[j] = 0;
+            if(data->tile_s1[j] > data->tile_s1[data->tile_max]) {
+                data->tile_max = j;
+            }
+        }
+        data->n_touched = 0;
+        data->relerr = simulate_converge_relerr(
+            data->tile_s1[data->tile_max], data->tile_s2[data->tile_max],
+            data->n_batch);
+    }
+
+    data->w_batch = 0;
+    data->x_batch = 0;
+    if(data->n_batch >= data->min_batches && data->relerr <= data->tol) {
+        data->converged = 1;
+    }
+}
+
+/**
+ * @brief Collect queue indices of markers that have finished simulation
+ *
+ * This must be called before the SIMD array is cycled as cycling replaces
+ * the finished markers.
+ *
+ * @param n_mrk number of markers in the SIMD array
+ * @param running running flags of the markers in the SIMD array
+ * @param id identifiers of the markers in the SIMD array
+ * @param index queue indices of the markers in the SIMD array
+ * @param i_done array where the queue indices of finished markers are stored
+ *
+ * @return number of finished markers
+ */
+int simulate_converge_collect(int n_mrk, integer* running, integer* id,
+                              integer* index, integer* i_done) {
+    int n_done = 0;
+    for(int i = 0; i < n_mrk; i++) {
+        if(!running[i] && id[i] >= 0) {
+            i_done[n_done++] = index[i];
+        }
+    }
+    return n_done;
+}
+
+/**
+ * @brief Index of a marker state among the input and pool markers
+ *
+ * @param data pointer to the convergence data
+ * @param ps marker state
+ *
+ * @return index of the marker or -1 if it is neither an input nor a pool marker
+ */
+static int simulate_converge_slot(simulate_converge_data* data,
+                                  particle_state* ps) {
+    if(ps >= data->mrk && ps < data->mrk + data->n_input) {
+        return ps - data->mrk;
+    }
+    if(ps >= data->pool && ps < data->pool + data->pool_size) {
+        return data->n_input + (ps - data->pool);
+    }
+    return -1;
+}
+
+/**
+ * @brief Check whether a marker has finished simulation
+ *
+ * Markers that could not be initialized are finished by the queue without
+ * passing through simulate_converge_update(), so they are recognized by the
+ * error flag.
+ *
+ * @param data pointer to the convergence data
+ * @param slot index of the marker
+ * @param ps marker state
+ *
+ * @return non-zero if the marker has finished
+ */
+static int simulate_converge_done(simulate_converge_data* data, int slot,
+                                  particle_state* ps) {
+    return data->done[slot] || ps->err;
+}
+
+/**
+ * @brief Add a finished marker to the current batch
+ *
+ * @param data pointer to the convergence data
+ * @param ps marker state
+ */
+static void simulate_converge_add(simulate_converge_data* data,
+                                  particle_state* ps) {
+    if(ps->err || !ps->endcond) {
+        return;
+    }
+    data->n_counted++;
+    if(ps->endcond & endcond_roul) {
+        return;
+    }
+    data->w_batch += ps->weight;
+
+    if(ps->endcond & endcond_wall) {
+        data->x_batch += ps->weight;
+        int j = ps->walltile - 1;
+        if(data->n_tile > 0 && j >= 0 && j < data->n_tile && ps->mass > 0) {
+            real pnorm = sqrt(ps->p_r * ps->p_r + ps->p_phi * ps->p_phi
+                              + ps->p_z * ps->p_z);
+            real power = ps->weight * physlib_Ekin_pnorm(ps->mass, pnorm);
+            if(power > 0) {
+                if(data->tile_batch[j] == 0) {
+                    data->touched[data->n_touched++] = j;
+                }
+                data->tile_batch[j] += power;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Close the batches whose markers have all finished
+ *
+ * Batches are closed in launch order so that a batch is never skipped
+ * because some of its markers take longer to simulate.
+ *
+ * @param data pointer to the convergence data
+ */
+static void simulate_converge_close(simulate_converge_data* data) {
+    while(!data->converged && data->batch < data->n_batches) {
+        int end = ( data->batch + 1 ) * data->batch_size;
+        while(data->check < end
+              && simulate_converge_done(data, data->check,
+                                        &data->mrk[data->check])) {
+            data->check++;
+        }
+        if(data->check < end) {
+            return;
+        }
+        for(int s = data->child_head[data->batch]; s >= 0;
+            s = data->child_next[s]) {
+            if(!simulate_converge_done(data, data->n_input + s,
+                                       &data->pool[s])) {
+                return;
+            }
+        }
+
+        for(int i = data->batch * data->batch_size; i < end; i++) {
+            simulate_converge_add(data, &data->mrk[i]);
+        }
+        for(int s = data->child_head[data->batch]; s >= 0;
+            s = data->child_next[s]) {
+            simulate_converge_add(data, &data->pool[s]);
+        }
+        data->batch++;
+        if(data->w_batch > 0) {
+            simulate_converge_batch(data);
+        }
+        else {
+            data->x_batch   = 0;
+            data->n_touched = 0;
+        }
+    }
+}
+
+/**
+ * @brief Register finished markers and stop dispatch if converged
+ *
+ * This must be called after the SIMD array is cycled so that the marker
+ * states in the queue are up to date. This function is thread-safe.
+ *
+ * @param data pointer to the convergence data
+ * @param pq queue the finished markers belong to
+ * @param i_done queue indices of the finished markers
+ * @param n_done number of finished markers
+ */
+void simulate_converge_update(simulate_converge_data* data,
+                              particle_queue* pq, integer* i_done,
+                              int n_done) {
+    #pragma omp critical
+    {
+        for(int k = 0; k < n_done && !data->converged; k++) {
+            particle_state* ps = pq->p[i_done[k]];
+            int slot = simulate_converge_slot(data, ps);
+            /* Markers handed over in hybrid mode have no end condition yet */
+            if(slot >= 0 && ( ps->endcond || ps->err )) {
+                data->done[slot] = 1;
+            }
+        }
+        simulate_converge_close(data);
+
+        /* Input markers that have not been taken from the queue are left
+         * there. Markers appended to the queue by splitting are placed after
+         * the input markers and they are still simulated. */
+        particle_queue* q = data->pq;
+        if(data->converged && q->next < data->n_input) {
+            data->n_skipped = data->n_input - q->next;
+            for(int i = data->n_input; i < q->n; i++) {
+                q->p[i - data->n_skipped] = q->p[i];
+            }
+            q->n -= data->n_skipped;
+            data->n_input = q->next;
+        }
+    }
+}
+
+/**
+ * @brief Assign markers created by splitting to the batch of their parent
+ *
+ * This function is thread-safe.
+ *
+ * @param data pointer to the convergence data
+ * @param parent state of the marker that was split
+ * @param children states of the markers created by the split
+ * @param n number of markers created by the split
+ */
+void simulate_converge_split(simulate_converge_data* data,
+                             particle_state* parent, particle_state* children,
+                             int n) {
+    if(data->mode == simulate_converge_none) {
+        return;
+    }
+    #pragma omp critical
+    if(!data->converged) {
+        int slot = simulate_converge_slot(data, parent);
+        int b = slot >= 0 ? data->slot_batch[slot] : -1;
+        for(int k = 0; k < n; k++) {
+            int s = children + k - data->pool;
+            data->slot_batch[data->n_input + s] = b;
+            if(b >= 0) {
+                data->child_next[s] = data->child_head[b];
+                data->child_head[b] = s;
+            }
+        }
+    }
+}
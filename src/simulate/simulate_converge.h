@@ -0,0 +1,93 @@
+/**
+ * @file simulate_converge.h
+ * @brief Header file for simulate_converge.c
+ */
+#ifndef SIMULATE_CONVERGE_H
+#define SIMULATE_CONVERGE_H
+
+#include "../ascot5.h"
+#include "../particle.h"
+
+/**
+ * @brief Observables whose convergence can be used to stop the simulation
+ */
+enum CONVERGENCE_MODE {
+    /** Simulation continues until the queue is empty                       */
+    simulate_converge_none     = 0,
+    /** Fraction of the marker weight that is lost to the wall              */
+    simulate_converge_loss     = 1,
+    /** Power deposited on the most loaded wall tile                        */
+    simulate_converge_wallload = 2
+};
+
+/**
+ * @brief Running batch-means estimate of the convergence observable
+ *
+ * Input markers are grouped into batches in the order they are launched and
+ * markers created by splitting belong to the batch of their parent. A batch is
+ * closed once all of its markers have finished, and batches are closed in
+ * order. Each batch gives an estimate of the observable normalized by the
+ * batch weight, and the standard error of the mean of these estimates gives
+ * the error of the observable.
+ */
+typedef struct {
+    int mode;            /**< Observable, see CONVERGENCE_MODE              */
+    real tol;            /**< Target relative error                         */
+    int batch_size;      /**< Number of markers in a batch                  */
+    int min_batches;     /**< Number of batches before convergence is
+                              checked                                       */
+    particle_queue* pq;  /**< Queue whose dispatch is stopped at convergence*/
+    int n_input;         /**< Number of input markers in the queue          */
+    int n_skipped;       /**< Number of input markers that were not taken
+                              from the queue                                */
+
+    particle_state* mrk; /**< Input marker states in launch order           */
+    particle_state* pool;/**< Marker states created by splitting            */
+    int pool_size;       /**< Number of states in the split pool            */
+    int n_batches;       /**< Number of full batches in the input markers   */
+    int batch;           /**< Batch that is closed next                     */
+    int check;           /**< Next marker to check in that batch            */
+    int* slot_batch;     /**< Batch of each input and pool marker or -1     */
+    char* done;          /**< Flag for each input and pool marker that has
+                              finished                                      */
+    int* child_head;     /**< First pool marker of each batch or -1         */
+    int* child_next;     /**< Next pool marker in the same batch or -1      */
+
+    real w_batch;        /**< Weight of the markers in the current batch    */
+    real x_batch;        /**< Lost weight in the current batch              */
+    int n_batch;         /**< Number of completed batches                   */
+    real s1;             /**< Sum of batch estimates                        */
+    real s2;             /**< Sum of squared batch estimates                */
+
+    int n_tile;          /**< Number of wall tiles                          */
+    int n_touched;       /**< Number of tiles hit in the current batch      */
+    int* touched;        /**< Tiles hit in the current batch                */
+    real* tile_batch;    /**< Power on each tile in the current batch       */
+    real* tile_s1;       /**< Sum of batch estimates for each tile          */
+    real* tile_s2;       /**< Sum of squared batch estimates for each tile  */
+    int tile_max;        /**< Tile with the largest sum of estimates        */
+
+    int n_counted;       /**< Number of markers that have been counted      */
+    real relerr;         /**< Relative error after the last batch           */
+    int converged;       /**< Flag indicating the target has been reached   */
+} simulate_converge_data;
+
+int simulate_converge_init(simulate_converge_data* data, int mode, real tol,
+                           int batch_size, int min_batches, int n_tile,
+                           particle_queue* pq, particle_state* mrk,
+                           particle_state* pool, int pool_size);
+
+void simulate_converge_free(simulate_converge_data* data);
+
+int simulate_converge_collect(int n_mrk, integer* running, integer* id,
+                              integer* index, integer* i_done);
+
+void simulate_converge_update(simulate_converge_data* data,
+                              particle_queue* pq, integer* i_done,
+                              int n_done);
+
+void simulate_converge_split(simulate_converge_data* data,
+                             particle_state* parent, particle_state* children,
+                             int n);
+
+#endif
@@ -24,6 +24,8 @@
 #include "step/step_fo_vpa.h"
 #include "mccc/mccc.h"
 #include "atomic.h"
+#include "simulate_split.h"
+#include "simulate_converge.h"
 
 DECLARE_TARGET_SIMD_UNIFORM(sim)
 real simulate_fo_fixed_inidt(sim_data* sim, particle_simd_fo* p, int i);
@@ -41,7 +43,9 @@ real simulate_fo_fixed_inidt(sim_data* sim, particle_simd_fo* p, int i);
  * is stored in the diagnostic array.
  *
  * The time-step is user-defined: either a directly given fixed value
- * or a given fraction of gyrotime.
+ * or a given fraction of gyrotime. Collisions can be applied every
+ * fix_ccol_nstep steps with the accumulated time-step, or earlier if the
+ * accumulated time-step exceeds fix_ccol_tol times the collision time.
  *
  * @param pq particles to be simulated
  * @param sim simulation data struct
@@ -50,6 +54,10 @@ real simulate_fo_fixed_inidt(sim_data* sim, particle_simd_fo* p, int i);
 void simulate_fo_fixed(particle_queue* pq, sim_data* sim, int mrk_array_size) {
     int cycle[mrk_array_size];// Indicates whether a new marker was initialized
     real hin[mrk_array_size];// Time step
+    integer i_done[mrk_array_size];// Queue index of a finished marker
+    real hcol[mrk_array_size];// Time-step accumulated for collisions
+    int ncol[mrk_array_size];// Steps since collisions were applied
+    real nucol[mrk_array_size];// Collision frequency
 
     real cputime, cputime_last; // Global cpu time: recent and previous record
 
@@ -71,8 +79,10 @@ void simulate_fo_fixed(particle_queue* pq, sim_data* sim, int mrk_array_size) {
     #pragma omp simd
     for(int i = 0; i < mrk_array_size; i++) {
         if(cycle[i] > 0) {
-            hin[i] = simulate_fo_fixed_inidt(sim, &p, i);
-
+            hin[i]   = simulate_fo_fixed_inidt(sim, &p, i);
+            hcol[i]  = 0;
+            ncol[i]  = 0;
+            nucol[i] = INFINITY;
         }
     }
 
@@ -131,7 +141,29 @@ void simulate_fo_fixed(particle_queue* pq, sim_data* sim, int mrk_array_size) {
         /* Euler-Maruyama for Coulomb collisions */
         if(sim->enable_clmbcol) {
             random_normal_simd(&sim->random_data, 3*p.n_mrk, rnd);
-            mccc_fo_euler(p_ptr, hin, &sim->plasma_data, &sim->mccc_data, rnd);
+            if(sim->fix_ccol_nstep > 1) {
+                /* Markers not due for collisions get zero time-step */
+                real hc[mrk_array_size];
+                #pragma omp simd
+                for(int i = 0; i < p.n_mrk; i++) {
+                    hcol[i] += hin[i];
+                    ncol[i]++;
+                    hc[i] = 0;
+                    if(ncol[i] >= sim->fix_ccol_nstep
+                       || ( sim->fix_ccol_tol > 0
+                            && hcol[i] * nucol[i] > sim->fix_ccol_tol ) ) {
+                        hc[i]   = hcol[i];
+                        hcol[i] = 0;
+                        ncol[i] = 0;
+                    }
+                }
+                mccc_fo_euler(p_ptr, hc, &sim->plasma_data, &sim->mccc_data,
+                              rnd, nucol);
+            }
+            else {
+                mccc_fo_euler(p_ptr, hin, &sim->plasma_data, &sim->mccc_data,
+                              rnd, NULL);
+            }
         }
         /* Atomic reactions */
         if(sim->enable_atomic) {
@@ -149,6 +181,9 @@ void simulate_fo_fixed(particle_queue* pq, sim_data* sim, int mrk_array_size) {
                 p.time[i]    += ( 1.0 - 2.0 * ( sim->reverse_time > 0 ) ) * hin[i];
                 p.mileage[i] += hin[i];
                 p.cputime[i] += cputime - cputime_last;
+                if(p.nstep[i]++ == 0 || hin[i] < p.mindt[i]) {
+                    p.mindt[i] = hin[i];
+                }
             }
         }
         cputime_last = cputime;
@@ -167,6 +202,8 @@ void simulate_fo_fixed(particle_queue* pq, sim_data* sim, int mrk_array_size) {
             // Dummy guiding centers
             particle_simd_gc gc_f;
             particle_simd_gc gc_i;
+            gc_f.n_mrk = p.n_mrk;
+            gc_i.n_mrk = p.n_mrk;
 
             /* Particle to guiding center transformation */
             #pragma omp simd
@@ -189,6 +226,11 @@ void simulate_fo_fixed(particle_queue* pq, sim_data* sim, int mrk_array_size) {
             diag_update_gc(&sim->diag_data, &sim->B_data, &gc_f, &gc_i);
         }
 
+        /* Split and roulette markers crossing the split surface */
+        if(sim->enable_split) {
+            simulate_split_fo(pq, p_ptr, p0_ptr, sim);
+        }
+
         /* Update running particles */
 #ifdef GPU
         n_running = 0;
@@ -198,14 +240,25 @@ void simulate_fo_fixed(particle_queue* pq, sim_data* sim, int mrk_array_size) {
             if(p_ptr->running[i] > 0) n_running++;
         }
 #else
+        int n_done = 0;
+        if(sim->converge_data.mode) {
+            n_done = simulate_converge_collect(p.n_mrk, p.running, p.id,
+                                               p.index, i_done);
+        }
         n_running = particle_cycle_fo(pq, &p, &sim->B_data, cycle);
+        if(n_done > 0) {
+            simulate_converge_update(&sim->converge_data, pq, i_done, n_done);
+        }
 #endif
 #ifndef GPU
         /* Determine simulation time-step for new particles */
         GPU_PARALLEL_LOOP_ALL_LEVELS
         for(int i = 0; i < p.n_mrk; i++) {
             if(cycle[i] > 0) {
-                hin[i] = simulate_fo_fixed_inidt(sim, &p, i);
+                hin[i]   = simulate_fo_fixed_inidt(sim, &p, i);
+                hcol[i]  = 0;
+                ncol[i]  = 0;
+                nucol[i] = INFINITY;
             }
         }
 #endif
@@ -25,6 +25,8 @@
 #include "simulate_gc_adaptive.h"
 #include "step/step_gc_cashkarp.h"
 #include "mccc/mccc.h"
+#include "simulate_split.h"
+#include "simulate_converge.h"
 #include "mccc/mccc_wiener.h"
 
 DECLARE_TARGET_SIMD_UNIFORM(sim)
@@ -49,10 +51,13 @@ real simulate_gc_adaptive_inidt(sim_data* sim, particle_simd_gc* p, int i);
  * marker state can change during a single time-step.
  *
  * @param pq particles to be simulated
+ * @param pq_hybrid queue where markers meeting the hybrid end condition are
+ *        handed over for FO simulation or NULL if not in hybrid mode
  * @param sim simulation data
  *
  */
-void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
+void simulate_gc_adaptive(particle_queue* pq, particle_queue* pq_hybrid,
+                          sim_data* sim) {
 
     /* Wiener arrays needed for the adaptive time step */
     mccc_wienarr wienarr[NSIMD];
@@ -64,9 +69,19 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
     real hout_col[NSIMD] __memalign__;
     real hnext[NSIMD]    __memalign__;
 
+    /* What limited the current and the next time step (see STEP_LIMITER) */
+    int hlim[NSIMD]      __memalign__;
+    int hlimnext[NSIMD]  __memalign__;
+
     /* Flag indicateing whether a new marker was initialized */
     int cycle[NSIMD]     __memalign__;
 
+    /* Original lane of each marker when the SIMD array is packed */
+    int lane[NSIMD];
+
+    /* Queue indices of the markers that finished during the time-step */
+    integer i_done[NSIMD];
+
     real tol_col = sim->ada_tol_clmbcol;
     real tol_orb = sim->ada_tol_orbfol;
 
@@ -75,19 +90,25 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
     particle_simd_gc p;  // This array holds current states
     particle_simd_gc p0; // This array stores previous states
 
+    /* First stage derivatives reused when a rejected step is repeated */
+    step_gc_cashkarp_cache ck_cache;
+    step_gc_cashkarp_cache_init(&ck_cache);
+
     for(int i=0; i< NSIMD; i++) {
         p.id[i] = -1;
         p.running[i] = 0;
     }
+    p.n_mrk = sim->simd_width;
 
     /* Initialize running particles */
     int n_running = particle_cycle_gc(pq, &p, &sim->B_data, cycle);
 
     #pragma omp simd
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p.n_mrk; i++) {
         if(cycle[i] > 0) {
             /* Determine initial time-step */
-            hin[i] = simulate_gc_adaptive_inidt(sim, &p, i);
+            hin[i]  = simulate_gc_adaptive_inidt(sim, &p, i);
+            hlim[i] = step_limiter_initial;
             if(sim->enable_clmbcol) {
                 /* Allocate array storing the Wiener processes */
                 mccc_wiener_initialize(&(wienarr[i]), p.time[i]);
@@ -112,7 +133,7 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
 
         /* Store marker states in case time step will be rejected */
         #pragma omp simd
-        for(int i = 0; i < NSIMD; i++) {
+        for(int i = 0; i < p.n_mrk; i++) {
             particle_copy_gc(&p, i, &p0, i);
             hout_orb[i] = DUMMY_TIMESTEP_VAL;
             hout_col[i] = DUMMY_TIMESTEP_VAL;
@@ -123,7 +144,7 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
 
         /* Set time-step negative if tracing backwards in time */
         #pragma omp simd
-        for(int i = 0; i < NSIMD; i++) {
+        for(int i = 0; i < p.n_mrk; i++) {
             if(sim->reverse_time) {
                 hin[i]  = -hin[i];
             }
@@ -132,17 +153,17 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
         /* Cash-Karp method for orbit-following */
         if(sim->enable_orbfol) {
             if(sim->enable_mhd) {
-                step_gc_cashkarp_mhd(&p, hin, hout_orb, tol_orb,
+                step_gc_cashkarp_mhd(&p, hin, hout_orb, tol_orb, &ck_cache,
                                      &sim->B_data, &sim->E_data,
                                      &sim->boozer_data, &sim->mhd_data);
             }
             else {
-                step_gc_cashkarp(&p, hin, hout_orb, tol_orb,
+                step_gc_cashkarp(&p, hin, hout_orb, tol_orb, &ck_cache,
                                  &sim->B_data, &sim->E_data);
             }
             /* Check whether time step was rejected */
             #pragma omp simd
-            for(int i = 0; i < NSIMD; i++) {
+            for(int i = 0; i < p.n_mrk; i++) {
                 /* Switch sign of the time-step again if it was reverted earlier */
                 if(sim->reverse_time) {
                     hout_orb[i] = -hout_orb[i];
@@ -150,7 +171,8 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
                 }
                 if(p.running[i] && hout_orb[i] < 0){
                     p.running[i] = 0;
-                    hnext[i] = hout_orb[i];
+                    hnext[i]    = hout_orb[i];
+                    hlimnext[i] = step_limiter_orbit;
                 }
             }
         }
@@ -164,10 +186,11 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
 
             /* Check whether time step was rejected */
             #pragma omp simd
-            for(int i = 0; i < NSIMD; i++) {
+            for(int i = 0; i < p.n_mrk; i++) {
                 if(p.running[i] && hout_col[i] < 0){
                     p.running[i] = 0;
-                    hnext[i] = hout_col[i];
+                    hnext[i]    = hout_col[i];
+                    hlimnext[i] = step_limiter_collisions;
                 }
             }
         }
@@ -176,7 +199,7 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
 
         cputime = A5_WTIME;
         #pragma omp simd
-        for(int i = 0; i < NSIMD; i++) {
+        for(int i = 0; i < p.n_mrk; i++) {
             if(p.id[i] > 0 && !p.err[i]) {
                 /* Check other time step limitations */
                 if(hnext[i] > 0) {
@@ -184,10 +207,12 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
                     real drho = fabs(p0.rho[i]-p.rho[i]) / sim->ada_max_drho;
 
                     if(dphi > 1 && dphi > drho) {
-                        hnext[i] = -hin[i]/dphi;
+                        hnext[i]    = -hin[i]/dphi;
+                        hlimnext[i] = step_limiter_dphi;
                     }
                     else if(drho > 1 && drho > dphi) {
-                        hnext[i] = -hin[i]/drho;
+                        hnext[i]    = -hin[i]/drho;
+                        hlimnext[i] = step_limiter_drho;
                     }
                 }
 
@@ -204,22 +229,30 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
                     if(hnext[i] < 0){
                         /* Time step was rejected, use the suggestion given by
                            integrator */
-                        hin[i] = -hnext[i];
+                        hin[i]  = -hnext[i];
+                        hlim[i] = hlimnext[i];
+                        p.nrej[i]++;
                     }
                     else {
                         p.time[i] += ( 1.0 - 2.0 * ( sim->reverse_time > 0 ) )
                             * hin[i];
                         p.mileage[i] += hin[i];
+                        if(p.nstep[i]++ == 0 || hin[i] < p.mindt[i]) {
+                            p.mindt[i]    = hin[i];
+                            p.mindtlim[i] = hlim[i];
+                        }
 
                         if(hnext[i] > hout_orb[i]) {
                             /* Use time step suggested by the orbit-following
                                integrator */
                             hnext[i] = hout_orb[i];
+                            hlim[i]  = step_limiter_orbit;
                         }
                         if(hnext[i] > hout_col[i]) {
                             /* Use time step suggested by the collision
                                integrator */
                             hnext[i] = hout_col[i];
+                            hlim[i]  = step_limiter_collisions;
                         }
                         if(hnext[i] == 1.0) {
                             /* Time step is unchanged (happens when no physics
@@ -245,20 +278,52 @@ void simulate_gc_adaptive(particle_queue* pq, sim_data* sim) {
         /* Update diagnostics */
         diag_update_gc(&sim->diag_data, &sim->B_data, &p, &p0);
 
+        /* Split and roulette markers crossing the split surface */
+        if(sim->enable_split) {
+            simulate_split_gc(pq, &p, &p0, sim);
+        }
+
         /* Update number of running particles */
-        n_running = particle_cycle_gc(pq, &p, &sim->B_data, cycle);
+        int n_done = 0;
+        if(sim->converge_data.mode) {
+            n_done = simulate_converge_collect(p.n_mrk, p.running, p.id,
+                                               p.index, i_done);
+        }
+        if(pq_hybrid == NULL) {
+            n_running = particle_cycle_gc(pq, &p, &sim->B_data, cycle);
+        }
+        else {
+            n_running = simulate_cycle_gc_hybrid(pq, pq_hybrid, &p, sim,
+                                                 cycle);
+        }
+        if(n_done > 0) {
+            simulate_converge_update(&sim->converge_data, pq, i_done, n_done);
+        }
 
         /* Determine simulation time-step for new particles */
         #pragma omp simd
-        for(int i = 0; i < NSIMD; i++) {
+        for(int i = 0; i < p.n_mrk; i++) {
             if(cycle[i] > 0) {
-                hin[i] = simulate_gc_adaptive_inidt(sim, &p, i);
+                hin[i]  = simulate_gc_adaptive_inidt(sim, &p, i);
+                hlim[i] = step_limiter_initial;
                 if(sim->enable_clmbcol) {
                     /* Re-allocate array storing the Wiener processes */
                     mccc_wiener_initialize(&(wienarr[i]), p.time[i]);
                 }
             }
         }
+
+        /* Pack the remaining markers once the queue is empty */
+        if(particle_compact_gc(pq, &p, lane)) {
+            for(int i = 0; i < p.n_mrk; i++) {
+                hin[i]  = hin[lane[i]];
+                hlim[i] = hlim[lane[i]];
+                step_gc_cashkarp_cache_move(&ck_cache, lane[i], i);
+                if(sim->enable_clmbcol) {
+                    wienarr[i] = wienarr[lane[i]];
+                }
+            }
+        }
     }
 
     /* All markers simulated! */
@@ -9,6 +9,7 @@
 #include "../simulate.h"
 #include "../particle.h"
 
-void simulate_gc_adaptive(particle_queue* pq, sim_data* sim);
+void simulate_gc_adaptive(particle_queue* pq, particle_queue* pq_hybrid,
+                          sim_data* sim);
 
 #endif
@@ -21,6 +21,8 @@
 #include "simulate_gc_fixed.h"
 #include "step/step_gc_rk4.h"
 #include "mccc/mccc.h"
+#include "simulate_split.h"
+#include "simulate_converge.h"
 
 DECLARE_TARGET_SIMD_UNIFORM(sim)
 real simulate_gc_fixed_inidt(sim_data* sim, particle_simd_gc* p, int i);
@@ -38,14 +40,24 @@ real simulate_gc_fixed_inidt(sim_data* sim, particle_simd_gc* p, int i);
  * is stored in the diagnostic array.
  *
  * The time-step is user-defined either directly or as a fraction of
- * gyrotime.
+ * gyrotime. Collisions can be applied every fix_ccol_nstep steps with the
+ * accumulated time-step, or earlier if the accumulated time-step exceeds
+ * fix_ccol_tol times the collision time.
  *
  * @param pq particles to be simulated
+ * @param pq_hybrid queue where markers meeting the hybrid end condition are
+ *        handed over for FO simulation or NULL if not in hybrid mode
  * @param sim simulation data
  */
-void simulate_gc_fixed(particle_queue* pq, sim_data* sim) {
+void simulate_gc_fixed(particle_queue* pq, particle_queue* pq_hybrid,
+                       sim_data* sim) {
     int cycle[NSIMD]  __memalign__; // Flag indigating whether a new marker was initialized
     real hin[NSIMD]  __memalign__;  // Time step
+    int lane[NSIMD];                // Original lane of a packed marker
+    integer i_done[NSIMD];          // Queue index of a finished marker
+    real hcol[NSIMD]  __memalign__; // Time-step accumulated for collisions
+    int ncol[NSIMD];                // Steps since collisions were applied
+    real nucol[NSIMD] __memalign__; // Collision frequency
 
     real cputime, cputime_last; // Global cpu time: recent and previous record
 
@@ -57,15 +69,19 @@ void simulate_gc_fixed(particle_queue* pq, sim_data* sim) {
         p.id[i] = -1;
         p.running[i] = 0;
     }
+    p.n_mrk = sim->simd_width;
 
     /* Initialize running particles */
     int n_running = particle_cycle_gc(pq, &p, &sim->B_data, cycle);
 
     /* Determine simulation time-step */
     #pragma omp simd
-    for(int i = 0; i < NSIMD; i++) {
+    for(int i = 0; i < p.n_mrk; i++) {
         if(cycle[i] > 0) {
-            hin[i] = simulate_gc_fixed_inidt(sim, &p, i);
+            hin[i]   = simulate_gc_fixed_inidt(sim, &p, i);
+            hcol[i]  = 0;
+            ncol[i]  = 0;
+            nucol[i] = INFINITY;
         }
     }
 
@@ -83,7 +99,7 @@ void simulate_gc_fixed(particle_queue* pq, sim_data* sim) {
 
         /* Store marker states */
         #pragma omp simd
-        for(int i = 0; i < NSIMD; i++) {
+        for(int i = 0; i < p.n_mrk; i++) {
             particle_copy_gc(&p, i, &p0, i);
         }
 
@@ -91,7 +107,7 @@ void simulate_gc_fixed(particle_queue* pq, sim_data* sim) {
 
         /* Set time-step negative if tracing backwards in time */
         #pragma omp simd
-        for(int i = 0; i < NSIMD; i++) {
+        for(int i = 0; i < p.n_mrk; i++) {
             if(sim->reverse_time) {
                 hin[i]  = -hin[i];
             }
@@ -110,7 +126,7 @@ void simulate_gc_fixed(particle_queue* pq, sim_data* sim) {
 
         /* Switch sign of the time-step again if it was reverted earlier */
         #pragma omp simd
-        for(int i = 0; i < NSIMD; i++) {
+        for(int i = 0; i < p.n_mrk; i++) {
             if(sim->reverse_time) {
                 hin[i]  = -hin[i];
             }
@@ -120,8 +136,29 @@ void simulate_gc_fixed(particle_queue* pq, sim_data* sim) {
         if(sim->enable_clmbcol) {
             real rnd[5*NSIMD];
             random_normal_simd(&sim->random_data, 5*NSIMD, rnd);
-            mccc_gc_euler(&p, hin, &sim->B_data, &sim->plasma_data,
-                          &sim->mccc_data, rnd);
+            if(sim->fix_ccol_nstep > 1) {
+                /* Markers not due for collisions get zero time-step */
+                real hc[NSIMD];
+                #pragma omp simd
+                for(int i = 0; i < p.n_mrk; i++) {
+                    hcol[i] += hin[i];
+                    ncol[i]++;
+                    hc[i] = 0;
+                    if(ncol[i] >= sim->fix_ccol_nstep
+                       || ( sim->fix_ccol_tol > 0
+                            && hcol[i] * nucol[i] > sim->fix_ccol_tol ) ) {
+                        hc[i]   = hcol[i];
+                        hcol[i] = 0;
+                        ncol[i] = 0;
+                    }
+                }
+                mccc_gc_euler(&p, hc, &sim->B_data, &sim->plasma_data,
+                              &sim->mccc_data, rnd, nucol);
+            }
+            else {
+                mccc_gc_euler(&p, hin, &sim->B_data, &sim->plasma_data,
+                              &sim->mccc_data, rnd, NULL);
+            }
         }
 
         /**********************************************************************/
@@ -130,11 +167,14 @@ void simulate_gc_fixed(particle_queue* pq, sim_data* sim) {
         /* Update simulation and cpu times */
         cputime = A5_WTIME;
         #pragma omp simd
-        for(int i = 0; i < NSIMD; i++) {
+        for(int i = 0; i < p.n_mrk; i++) {
             if(p.running[i]) {
                 p.time[i]    += ( 1.0 - 2.0 * ( sim->reverse_time > 0 ) ) * hin[i];
                 p.mileage[i] += hin[i];
                 p.cputime[i] += cputime - cputime_last;
+                if(p.nstep[i]++ == 0 || hin[i] < p.mindt[i]) {
+                    p.mindt[i] = hin[i];
+                }
             }
         }
         cputime_last = cputime;
@@ -145,17 +185,48 @@ void simulate_gc_fixed(particle_queue* pq, sim_data* sim) {
         /* Update diagnostics */
         diag_update_gc(&sim->diag_data, &sim->B_data, &p, &p0);
 
+        /* Split and roulette markers crossing the split surface */
+        if(sim->enable_split) {
+            simulate_split_gc(pq, &p, &p0, sim);
+        }
+
         /* Update running particles */
-        n_running = particle_cycle_gc(pq, &p, &sim->B_data, cycle);
+        int n_done = 0;
+        if(sim->converge_data.mode) {
+            n_done = simulate_converge_collect(p.n_mrk, p.running, p.id,
+                                               p.index, i_done);
+        }
+        if(pq_hybrid == NULL) {
+            n_running = particle_cycle_gc(pq, &p, &sim->B_data, cycle);
+        }
+        else {
+            n_running = simulate_cycle_gc_hybrid(pq, pq_hybrid, &p, sim,
+                                                 cycle);
+        }
+        if(n_done > 0) {
+            simulate_converge_update(&sim->converge_data, pq, i_done, n_done);
+        }
 
         /* Determine simulation time-step */
         #pragma omp simd
-        for(int i = 0; i < NSIMD; i++) {
+        for(int i = 0; i < p.n_mrk; i++) {
             if(cycle[i] > 0) {
-                hin[i] = simulate_gc_fixed_inidt(sim, &p, i);
+                hin[i]   = simulate_gc_fixed_inidt(sim, &p, i);
+                hcol[i]  = 0;
+                ncol[i]  = 0;
+                nucol[i] = INFINITY;
             }
         }
 
+        /* Pack the remaining markers once the queue is empty */
+        if(particle_compact_gc(pq, &p, lane)) {
+            for(int i = 0; i < p.n_mrk; i++) {
+                hin[i]   = hin[lane[i]];
+                hcol[i]  = hcol[lane[i]];
+                ncol[i]  = ncol[lane[i]];
+                nucol[i] = nucol[lane[i]];
+            }
+        }
     }
 
     /* All markers simulated! */
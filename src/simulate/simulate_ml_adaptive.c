@@ -15,6 +15,7 @@
 #include "../E_field.h"
 #include "simulate_ml_adaptive.h"
 #include "step/step_ml_cashkarp.h"
+#include "simulate_converge.h"
 #include "../endcond.h"
 #include "../math.h"
 #include "../consts.h"
@@ -56,6 +57,10 @@ void simulate_ml_adaptive(particle_queue* pq, sim_data* sim) {
     real hout[NSIMD] __memalign__;  // Suggestion for next time step, negative value indicates rejected step
     real hnext[NSIMD] __memalign__; // Next time step
     int cycle[NSIMD] __memalign__;  // Flag indigating whether a new marker was initialized
+    int hlim[NSIMD] __memalign__;     // What limited the current time step
+    int hlimnext[NSIMD] __memalign__; // What limited the next time step
+    int lane[NSIMD];                  // Original lane of a packed marker
+    integer i_done[NSIMD];            // Queue index of a finished marker
 
     real cputime, cputime_last; // Global cpu time: recent and previous record
 
@@ -65,20 +70,26 @@ void simulate_ml_adaptive(particle_queue* pq, sim_data* sim) {
     particle_simd_ml p;  // This array holds current states
     particle_simd_ml p0; // This array stores previous states
 
+    /* First stage derivatives reused when a rejected step is repeated */
+    step_ml_cashkarp_cache ck_cache;
+    step_ml_cashkarp_cache_init(&ck_cache);
+
     for(i=0; i< NSIMD; i++) {
         p.id[i] = -1;
         p.running[i] = 0;
     }
+    p.n_mrk = sim->simd_width;
 
     /* Initialize running particles */
     int n_running = particle_cycle_ml(pq, &p, &sim->B_data, cycle);
 
     /* Determine simulation time-step */
     #pragma omp simd
-    for(i = 0; i < NSIMD; i++) {
+    for(i = 0; i < p.n_mrk; i++) {
         if(cycle[i] > 0) {
             /* Determine initial time-step */
-            hin[i] = simulate_ml_adaptive_inidt(sim, &p, i);
+            hin[i]  = simulate_ml_adaptive_inidt(sim, &p, i);
+            hlim[i] = step_limiter_initial;
         }
     }
 
@@ -99,7 +110,7 @@ void simulate_ml_adaptive(particle_queue* pq, sim_data* sim) {
 
         /* Store marker states in case time step will be rejected */
         #pragma omp simd
-        for(i = 0; i < NSIMD; i++) {
+        for(i = 0; i < p.n_mrk; i++) {
             particle_copy_ml(&p, i, &p0, i);
 
             hout[i] = DUMMY_STEP_VAL;
@@ -113,15 +124,16 @@ void simulate_ml_adaptive(particle_queue* pq, sim_data* sim) {
 
             /* Set time-step negative if tracing backwards in time */
             #pragma omp simd
-            for(i = 0; i < NSIMD; i++) {
+            for(i = 0; i < p.n_mrk; i++) {
                 if(sim->reverse_time) {
                     hin[i]  = -hin[i];
                 }
             }
 
             if(sim->enable_mhd) {
-                step_ml_cashkarp_mhd(&p, hin, hout, tol, &sim->B_data,
-                                     &sim->boozer_data, &sim->mhd_data);
+                step_ml_cashkarp_mhd(&p, hin, hout, tol, &ck_cache,
+                                     &sim->B_data, &sim->boozer_data,
+                                     &sim->mhd_data);
             }
             else {
                 step_ml_cashkarp(&p, hin, hout, tol, &sim->B_data);
@@ -129,7 +141,7 @@ void simulate_ml_adaptive(particle_queue* pq, sim_data* sim) {
 
             /* Check whether time step was rejected */
             #pragma omp simd
-            for(i = 0; i < NSIMD; i++) {
+            for(i = 0; i < p.n_mrk; i++) {
                 /* Switch sign of the time-step again if it was reverted earlier */
                 if(sim->reverse_time) {
                     hout[i] = -hout[i];
@@ -138,7 +150,8 @@ void simulate_ml_adaptive(particle_queue* pq, sim_data* sim) {
 
                 if(p.running[i] && hout[i] < 0){
                     p.running[i] = 0;
-                    hnext[i] = hout[i];
+                    hnext[i]    = hout[i];
+                    hlimnext[i] = step_limiter_orbit;
                 }
             }
         }
@@ -148,7 +161,7 @@ void simulate_ml_adaptive(particle_queue* pq, sim_data* sim) {
 
         cputime = A5_WTIME;
         #pragma omp simd
-        for(i = 0; i < NSIMD; i++) {
+        for(i = 0; i < p.n_mrk; i++) {
             if(!p.err[i]) {
                 /* Check other time step limitations */
                 if(hnext[i] > 0) {
@@ -156,10 +169,12 @@ void simulate_ml_adaptive(particle_queue* pq, sim_data* sim) {
                     real drho = fabs(p0.rho[i]-p.rho[i]) / sim->ada_max_drho;
 
                     if(dphi > 1 && dphi > drho) {
-                        hnext[i] = -hin[i]/dphi;
+                        hnext[i]    = -hin[i]/dphi;
+                        hlimnext[i] = step_limiter_dphi;
                     }
                     else if(drho > 1 && drho > dphi) {
-                        hnext[i] = -hin[i]/drho;
+                        hnext[i]    = -hin[i]/drho;
+                        hlimnext[i] = step_limiter_drho;
                     }
                 }
 
@@ -174,15 +189,22 @@ void simulate_ml_adaptive(particle_queue* pq, sim_data* sim) {
                     /* Advance time (if time step was accepted) and determine next time step */
                     if(hnext[i] < 0){
                         /* Time step was rejected, use the suggestion given by integrator */
-                        hin[i] = -hnext[i];
+                        hin[i]  = -hnext[i];
+                        hlim[i] = hlimnext[i];
+                        p.nrej[i]++;
                     }
                     else {
                         /* Mileage measures seconds but hin is in meters */
                         p.mileage[i] += hin[i] / CONST_C;
+                        if(p.nstep[i]++ == 0 || hin[i] / CONST_C < p.mindt[i]) {
+                            p.mindt[i]    = hin[i] / CONST_C;
+                            p.mindtlim[i] = hlim[i];
+                        }
 
                         if(hnext[i] > hout[i]) {
                             /* Use time step suggested by the integrator */
                             hnext[i] = hout[i];
+                            hlim[i]  = step_limiter_orbit;
                         }
                         else if(hnext[i] == DUMMY_STEP_VAL) {
                             /* Time step is unchanged (happens when no physics are enabled) */
@@ -204,13 +226,31 @@ void simulate_ml_adaptive(particle_queue* pq, sim_data* sim) {
         diag_update_ml(&sim->diag_data, &p, &p0);
 
         /* Update running particles */
+        int n_done = 0;
+        if(sim->converge_data.mode) {
+            n_done = simulate_converge_collect(p.n_mrk, p.running, p.id,
+                                               p.index, i_done);
+        }
         n_running = particle_cycle_ml(pq, &p, &sim->B_data, cycle);
+        if(n_done > 0) {
+            simulate_converge_update(&sim->converge_data, pq, i_done, n_done);
+        }
 
         /* Determine simulation time-step for new particles */
         #pragma omp simd
-        for(i = 0; i < NSIMD; i++) {
+        for(i = 0; i < p.n_mrk; i++) {
             if(cycle[i] > 0) {
-                hin[i] = simulate_ml_adaptive_inidt(sim, &p, i);
+                hin[i]  = simulate_ml_adaptive_inidt(sim, &p, i);
+                hlim[i] = step_limiter_initial;
+            }
+        }
+
+        /* Pack the remaining markers once the queue is empty */
+        if(particle_compact_ml(pq, &p, lane)) {
+            for(i = 0; i < p.n_mrk; i++) {
+                hin[i]  = hin[lane[i]];
+                hlim[i] = hlim[lane[i]];
+                step_ml_cashkarp_cache_move(&ck_cache, lane[i], i);
             }
         }
     }
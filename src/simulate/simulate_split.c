@@ -0,0 +1,195 @@
+/**
+ * @file simulate_split.c
+ * @brief Marker splitting and Russian roulette
+ *
+ * Markers that cross the flux surface rho = SPLIT_RHO outwards are split into
+ * SPLIT_NUMBER markers which share the weight of the original marker. The
+ * marker continues its simulation and the new markers, which are identical
+ * to it at the moment of splitting, are appended to the queue. Markers that
+ * cross the surface inwards play Russian roulette if they have been split:
+ * they survive with probability 1/SPLIT_NUMBER in which case their weight is
+ * multiplied by SPLIT_NUMBER, and otherwise they are terminated with
+ * endcond_roul. Markers that start outside the surface are not rouletted when
+ * they move inside as their weight is already that of the inner region.
+ *
+ * Both operations preserve the expected weight, so all diagnostics remain
+ * unbiased while the region rho > SPLIT_RHO is sampled by more markers. The
+ * markers diverge only through the stochastic processes (collisions and
+ * atomic reactions), so splitting is of no use without them.
+ *
+ * The new markers are stored in a pool allocated in simulate(). When the pool
+ * runs short, a marker is split into fewer markers and the roulette uses the
+ * actual split factor. Once the pool has been used up, markers are no longer
+ * split but roulette continues. The
+ * end states of the split markers are not stored in the output; the original
+ * markers are. Hence quantities such as wall loads should be taken from the
+ * diagnostics (ENABLE_WALLLOAD) rather than from the end states.
+ */
+#include "../ascot5.h"
+#include "../endcond.h"
+#include "../particle.h"
+#include "../random.h"
+#include "../simulate.h"
+#include "simulate_converge.h"
+#include "simulate_split.h"
+
+/**
+ * @brief Reserve states from the pool for the markers created by a split
+ *
+ * @param sim pointer to simulation data
+ * @param i_pool pointer where the index of the first reserved state is stored
+ *
+ * @return number of reserved states which may be less than SPLIT_NUMBER - 1
+ *         if the pool is running out
+ */
+static int simulate_split_reserve(sim_data* sim, int* i_pool) {
+    int n_new;
+    #pragma omp critical
+    {
+        *i_pool = sim->split_pool_next;
+        n_new   = sim->split_pool_size - sim->split_pool_next;
+        if(n_new > sim->split_number - 1) {
+            n_new = sim->split_number - 1;
+        }
+        sim->split_pool_next += n_new;
+    }
+    return n_new;
+}
+
+/**
+ * @brief Append new markers to the queue
+ *
+ * @param pq queue the markers are appended to
+ * @param ps array of marker states
+ * @param n number of marker states
+ */
+static void simulate_split_append(particle_queue* pq, particle_state* ps,
+                                  int n) {
+    #pragma omp critical
+    for(int k = 0; k < n; k++) {
+        pq->p[pq->n++] = &ps[k];
+    }
+}
+
+/**
+ * @brief Play Russian roulette with a marker if it has been split
+ *
+ * A marker has been split if its weight is below the weight it had when its
+ * simulation began, or below the weight of its parent for markers created by
+ * splitting. The survival probability is the ratio of these weights, which is
+ * the actual split factor even if the pool ran short when the marker was split.
+ *
+ * @param ps marker state in the queue
+ * @param weight pointer to marker weight
+ * @param running pointer to marker running flag
+ * @param endcond pointer to marker end condition
+ * @param sim pointer to simulation data
+ */
+static void simulate_split_roulette(particle_state* ps, real* weight,
+                                    integer* running, integer* endcond,
+                                    sim_data* sim) {
+    real weight0 = ps->weight;
+    if(ps >= sim->split_pool && ps < sim->split_pool + sim->split_pool_size) {
+        weight0 *= sim->split_factor[ps - sim->split_pool];
+    }
+    if(*weight >= weight0) {
+        return;
+    }
+    if(random_uniform(&sim->random_data) * weight0 < *weight) {
+        *weight = weight0;
+    }
+    else {
+        *endcond |= endcond_roul;
+        *running  = 0;
+    }
+}
+
+/**
+ * @brief Split or roulette guiding centers that crossed the split surface
+ *
+ * Called after the end conditions have been checked and the diagnostics
+ * updated, so the step that crossed the surface is recorded with the original
+ * weight.
+ *
+ * @param pq queue of the markers being simulated
+ * @param p pointer to SIMD structure of markers after the time-step
+ * @param p0 pointer to SIMD structure of markers before the time-step
+ * @param sim pointer to simulation data
+ */
+void simulate_split_gc(particle_queue* pq, particle_simd_gc* p,
+                       particle_simd_gc* p0, sim_data* sim) {
+    for(int i = 0; i < p->n_mrk; i++) {
+        if(!p->running[i]) {
+            continue;
+        }
+        if(p0->rho[i] < sim->split_rho && p->rho[i] >= sim->split_rho) {
+            int i_pool;
+            int n_new = simulate_split_reserve(sim, &i_pool);
+            if(n_new == 0) {
+                continue;
+            }
+            p->weight[i] /= n_new + 1;
+
+            particle_state* ps = &sim->split_pool[i_pool];
+            ps[0] = *pq->p[p->index[i]];
+            particle_gc_to_state(p, i, &ps[0], &sim->B_data);
+            for(int k = 1; k < n_new; k++) {
+                ps[k] = ps[0];
+            }
+            for(int k = 0; k < n_new; k++) {
+                sim->split_factor[i_pool + k] = n_new + 1;
+            }
+            simulate_split_append(pq, ps, n_new);
+            simulate_converge_split(&sim->converge_data,
+                                    pq->p[p->index[i]], ps, n_new);
+        }
+        else if(p0->rho[i] >= sim->split_rho && p->rho[i] < sim->split_rho) {
+            simulate_split_roulette(pq->p[p->index[i]], &p->weight[i],
+                                    &p->running[i], &p->endcond[i], sim);
+        }
+    }
+}
+
+/**
+ * @brief Split or roulette particles that crossed the split surface
+ *
+ * See simulate_split_gc().
+ *
+ * @param pq queue of the markers being simulated
+ * @param p pointer to SIMD structure of markers after the time-step
+ * @param p0 pointer to SIMD structure of markers before the time-step
+ * @param sim pointer to simulation data
+ */
+void simulate_split_fo(particle_queue* pq, particle_simd_fo* p,
+                       particle_simd_fo* p0, sim_data* sim) {
+    for(int i = 0; i < p->n_mrk; i++) {
+        if(!p->running[i]) {
+            continue;
+        }
+        if(p0->rho[i] < sim->split_rho && p->rho[i] >= sim->split_rho) {
+            int i_pool;
+            int n_new = simulate_split_reserve(sim, &i_pool);
+            if(n_new == 0) {
+                continue;
+            }
+            p->weight[i] /= n_new + 1;
+
+            particle_state* ps = &sim->split_pool[i_pool];
+            ps[0] = *pq->p[p->index[i]];
+            particle_fo_to_state(p, i, &ps[0], &sim->B_data);
+            for(int k = 1; k < n_new; k++) {
+                ps[k] = ps[0];
+            }
+            for(int k = 0; k < n_new; k++) {
+                sim->split_factor[i_pool + k] = n_new + 1;
+            }
+            simulate_split_append(pq, ps, n_new);
+            simulate_converge_split(&sim->converge_data,
+                                    pq->p[p->index[i]], ps, n_new);
+        }
+        else if(p0->rho[i] >= sim->split_rho && p->rho[i] < sim->split_rho) {
+            simulate_split_roulette(pq->p[p->index[i]], &p->weight[i],
+                                    &p->running[i], &p->endcond[i], sim);
+        }
+    }
+}
@@ -0,0 +1,17 @@
+/**
+ * @file simulate_split.h
+ * @brief Header file for simulate_split.c
+ */
+#ifndef SIMULATE_SPLIT_H
+#define SIMULATE_SPLIT_H
+
+#include "../ascot5.h"
+#include "../simulate.h"
+#include "../particle.h"
+
+void simulate_split_gc(particle_queue* pq, particle_simd_gc* p,
+                       particle_simd_gc* p0, sim_data* sim);
+void simulate_split_fo(particle_queue* pq, particle_simd_fo* p,
+                       particle_simd_fo* p0, sim_data* sim);
+
+#endif
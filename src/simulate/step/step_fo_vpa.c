@@ -32,6 +32,7 @@
  * @param Bdata pointer to magnetic field data
  * @param Edata pointer to electric field data
  */
+A5_TARGET_CLONES
 void step_fo_vpa(particle_simd_fo* p, real* h, B_field_data* Bdata,
                  E_field_data* Edata) {
     GPU_DATA_IS_MAPPED(h[0:p->n_mrk])
@@ -209,13 +210,14 @@ void step_fo_vpa(particle_simd_fo* p, real* h, B_field_data* Bdata,
  * @param boozer pointer to boozer data
  * @param mhd pointer to MHD data
  */
+A5_TARGET_CLONES
 void step_fo_vpa_mhd(particle_simd_fo* p, real* h, B_field_data* Bdata,
                      E_field_data* Edata, boozer_data* boozer, mhd_data* mhd) {
 
     int i;
     /* Following loop will be executed simultaneously for all i */
     #pragma omp simd  aligned(h : 64)
-    for(i = 0; i < NSIMD; i++) {
+    for(i = 0; i < p->n_mrk; i++) {
         if(p->running[i]) {
             a5err errflag = 0;
 
@@ -16,6 +16,100 @@
 #include "step_gceom.h"
 #include "step_gceom_mhd.h"
 
+/**
+ * @brief Cash-Karp tableau coefficients for the intermediate stages
+ *
+ * Row s contains the weights of the preceding stages when evaluating the
+ * position where the stage s derivative is evaluated.
+ */
+static const real step_gc_cashkarp_a[6][5] = {
+    {0, 0, 0, 0, 0},
+    {1.0/5, 0, 0, 0, 0},
+    {3.0/40, 9.0/40, 0, 0, 0},
+    {3.0/10, -9.0/10, 6.0/5, 0, 0},
+    {-11.0/54, 5.0/2, -70.0/27, 35.0/27, 0},
+    {1631.0/55296, 175.0/512, 575.0/13824, 44275.0/110592, 253.0/4096}
+};
+
+/**
+ * @brief Cash-Karp tableau nodes, i.e. fraction of time step at each stage
+ */
+static const real step_gc_cashkarp_c[6] = {
+    0, 1.0/5, 3.0/10, 3.0/5, 1.0, 7.0/8
+};
+
+/**
+ * @brief Invalidate all entries in the first stage derivative cache
+ *
+ * @param cache pointer to the cache
+ */
+void step_gc_cashkarp_cache_init(step_gc_cashkarp_cache* cache) {
+    for(int i = 0; i < NSIMD; i++) {
+        cache->id[i] = -1;
+    }
+}
+
+/**
+ * @brief Move a cache entry to another lane
+ *
+ * Used when the markers are packed to the lowest lanes of the SIMD array so
+ * that the cached derivatives follow their markers.
+ *
+ * @param cache pointer to the cache
+ * @param from lane the entry is moved from
+ * @param to lane the entry is moved to
+ */
+void step_gc_cashkarp_cache_move(step_gc_cashkarp_cache* cache, int from,
+                                 int to) {
+    cache->id[to]   = cache->id[from];
+    cache->time[to] = cache->time[from];
+    for(int j = 0; j < 6; j++) {
+        cache->y[j][to]  = cache->y[j][from];
+        cache->k1[j][to] = cache->k1[j][from];
+    }
+}
+
+/**
+ * @brief Check whether the cached first stage derivative is valid for a marker
+ *
+ * @param cache pointer to the cache
+ * @param i index of the marker
+ * @param id marker ID
+ * @param t marker time [s]
+ * @param y marker coordinates (R, phi, z, ppar, mu, zeta)
+ *
+ * @return non-zero if the cached value can be used
+ */
+static int step_gc_cashkarp_cache_hit(step_gc_cashkarp_cache* cache, int i,
+                                      integer id, real t, real y[6]) {
+    int hit = cache->id[i] == id && cache->time[i] == t;
+    for(int j = 0; j < 6; j++) {
+        hit = hit && cache->y[j][i] == y[j];
+    }
+    return hit;
+}
+
+/**
+ * @brief Store the first stage derivative of a marker in the cache
+ *
+ * @param cache pointer to the cache
+ * @param i index of the marker
+ * @param id marker ID
+ * @param t marker time [s]
+ * @param y marker coordinates (R, phi, z, ppar, mu, zeta)
+ * @param k1 first stage derivative
+ */
+static void step_gc_cashkarp_cache_store(step_gc_cashkarp_cache* cache, int i,
+                                         integer id, real t, real y[6],
+                                         real k1[6]) {
+    cache->id[i]   = id;
+    cache->time[i] = t;
+    for(int j = 0; j < 6; j++) {
+        cache->y[j][i]  = y[j];
+        cache->k1[j][i] = k1[j];
+    }
+}
+
 /**
  * @brief Integrate a guiding center step for a struct of markers
  *
@@ -25,185 +119,161 @@
  * directly without gather and scatter operations. Informs whther time step was accepted or
  * rejected and provides a suggestion for the next time step.
  *
+ * The step is advanced stage by stage for all markers at once so that the
+ * magnetic field is evaluated with a single B_field_eval_B_dB_simd() call per
+ * stage.
+ *
+ * The field at the first stage is taken from the marker struct, and the first
+ * stage derivative is cached so that a step repeated after rejection does not
+ * evaluate the fields at the initial position again. Markers whose step is
+ * rejected are not moved, and no fields are evaluated at their end point.
+ *
  * @param p marker struct that will be updated
  * @param h array containing time step lengths
  * @param hnext suggestion for the next time step. Negative sign indicates current step was rejected
  * @param tol error tolerance
+ * @param cache first stage derivatives from previous steps
  * @param Bdata pointer to magnetic field data
  * @param Edata pointer to electric field data
  */
+A5_TARGET_CLONES
 void step_gc_cashkarp(particle_simd_gc* p, real* h, real* hnext, real tol,
+                      step_gc_cashkarp_cache* cache,
                       B_field_data* Bdata, E_field_data* Edata) {
 
+    /* Stage derivatives k[stage][coordinate][lane] */
+    real k[6][6][NSIMD];
+    real yprev[6][NSIMD];
+    real tempy[6][NSIMD];
+    real tstage[NSIMD];
+    real B_dB[15*NSIMD];
+    real R0[NSIMD];
+    real z0[NSIMD];
+    integer accepted[NSIMD];
+    a5err errflag[NSIMD];
+
     int i;
-    /* Following loop will be executed simultaneously for all i */
-    #pragma omp simd aligned(h, hnext : 64)
-    for(i = 0; i < NSIMD; i++) {
+    int n_mrk = p->n_mrk; /* Number of lanes in use */
+    #pragma omp simd aligned(h : 64)
+    for(i = 0; i < n_mrk; i++) {
+        errflag[i]  = 0;
+        accepted[i] = 0;
         if(p->running[i]) {
-            a5err errflag = 0;
-
-            real k1[6], k2[6], k3[6], k4[6], k5[6], k6[6];
-            real tempy[6];
-            real yprev[6];
-
-            real mass   = p->mass[i];;
-            real charge = p->charge[i];
-
-            real B_dB[15];
-            real E[3];
-
-            real R0 = p->r[i];
-            real z0 = p->z[i];
-            real t0 = p->time[i];
+            R0[i] = p->r[i];
+            z0[i] = p->z[i];
 
             /* Coordinates are copied from the struct into an array to make
              * passing parameters easier */
-            yprev[0] = p->r[i];
-            yprev[1] = p->phi[i];
-            yprev[2] = p->z[i];
-            yprev[3] = p->ppar[i];
-            yprev[4] = p->mu[i];
-            yprev[5] = p->zeta[i];
+            yprev[0][i] = p->r[i];
+            yprev[1][i] = p->phi[i];
+            yprev[2][i] = p->z[i];
+            yprev[3][i] = p->ppar[i];
+            yprev[4][i] = p->mu[i];
+            yprev[5][i] = p->zeta[i];
 
             /* Magnetic field at initial position already known */
-            B_dB[0] = p->B_r[i];
-            B_dB[1] = p->B_r_dr[i];
-            B_dB[2] = p->B_r_dphi[i];
-            B_dB[3] = p->B_r_dz[i];
-
-            B_dB[4] = p->B_phi[i];
-            B_dB[5] = p->B_phi_dr[i];
-            B_dB[6] = p->B_phi_dphi[i];
-            B_dB[7] = p->B_phi_dz[i];
-
-            B_dB[8] = p->B_z[i];
-            B_dB[9] = p->B_z_dr[i];
-            B_dB[10] = p->B_z_dphi[i];
-            B_dB[11] = p->B_z_dz[i];
-
-            if(!errflag) {
-                errflag = E_field_eval_E(E, yprev[0], yprev[1], yprev[2],
-                                         t0, Edata, Bdata);
-            }
-            if(!errflag) {
-                step_gceom(k1, yprev, mass, charge, B_dB, E);
-            }
-            for(int j = 0; j < 6; j++) {
-                tempy[j] = yprev[j]
-                    + h[i]*(
-                        (1.0/5) * k1[j] );
-            }
-
-
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, tempy[0], tempy[1], tempy[2],
-                                            t0 + (1.0/5)*h[i], Bdata);
-            }
-            if(!errflag) {
-                errflag = E_field_eval_E(E, tempy[0], tempy[1], tempy[2],
-                                         t0 + (1.0/5)*h[i], Edata, Bdata);
-            }
-            if(!errflag) {
-                step_gceom(k2, tempy, mass, charge, B_dB, E);
-            }
-            for(int j = 0; j < 6; j++) {
-                tempy[j] = yprev[j]
-                    + h[i]*(
-                          (3.0/40) * k1[j]
-                        + (9.0/40) * k2[j] );
-            }
-
+            B_dB[ 0*n_mrk + i] = p->B_r[i];
+            B_dB[ 1*n_mrk + i] = p->B_r_dr[i];
+            B_dB[ 2*n_mrk + i] = p->B_r_dphi[i];
+            B_dB[ 3*n_mrk + i] = p->B_r_dz[i];
+
+            B_dB[ 4*n_mrk + i] = p->B_phi[i];
+            B_dB[ 5*n_mrk + i] = p->B_phi_dr[i];
+            B_dB[ 6*n_mrk + i] = p->B_phi_dphi[i];
+            B_dB[ 7*n_mrk + i] = p->B_phi_dz[i];
+
+            B_dB[ 8*n_mrk + i] = p->B_z[i];
+            B_dB[ 9*n_mrk + i] = p->B_z_dr[i];
+            B_dB[10*n_mrk + i] = p->B_z_dphi[i];
+            B_dB[11*n_mrk + i] = p->B_z_dz[i];
+        }
+    }
 
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, tempy[0], tempy[1], tempy[2],
-                                            t0 + (3.0/10)*h[i], Bdata);
-            }
-            if(!errflag) {
-                errflag = E_field_eval_E(E, tempy[0], tempy[1], tempy[2],
-                                         t0 + (3.0/10)*h[i], Edata, Bdata);
-            }
-            if(!errflag) {
-                step_gceom(k3, tempy, mass, charge, B_dB, E);
-            }
-            for(int j = 0; j < 6; j++) {
-                tempy[j] = yprev[j]
-                    + h[i]*(
-                          ( 3.0/10) * k1[j]
-                        + (-9.0/10) * k2[j]
-                        + ( 6.0/5 ) * k3[j] );
+    for(int s = 0; s < 6; s++) {
+        /* Position where the stage derivative is evaluated */
+        #pragma omp simd aligned(h : 64)
+        for(i = 0; i < n_mrk; i++) {
+            if(p->running[i] && !errflag[i]) {
+                for(int j = 0; j < 6; j++) {
+                    real dy = 0;
+                    for(int m = 0; m < s; m++) {
+                        dy += step_gc_cashkarp_a[s][m] * k[m][j][i];
+                    }
+                    tempy[j][i] = yprev[j][i] + h[i]*dy;
+                }
+                tstage[i] = p->time[i] + step_gc_cashkarp_c[s]*h[i];
             }
+        }
 
+        /* Field at the first stage is known */
+        if(s > 0) {
+            B_field_eval_B_dB_simd(n_mrk, B_dB, tempy[0], tempy[1], tempy[2],
+                                   tstage, p->running, errflag, Bdata);
+        }
 
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, tempy[0], tempy[1], tempy[2],
-                                            t0 + (3.0/5)*h[i], Bdata);
-            }
-            if(!errflag) {
-                errflag = E_field_eval_E(E, tempy[0], tempy[1], tempy[2],
-                                         t0 + (3.0/5)*h[i], Edata, Bdata);
-            }
-            if(!errflag) {
-                step_gceom(k4, tempy, mass, charge, B_dB, E);
-            }
-            for(int j = 0; j < 6; j++) {
-                tempy[j] = yprev[j]
-                    + h[i]*(
-                          (-11.0/54) * k1[j]
-                        + (  5.0/2 ) * k2[j]
-                        + (-70.0/27) * k3[j]
-                        + ( 35.0/27) * k4[j] );
+        #pragma omp simd
+        for(i = 0; i < n_mrk; i++) {
+            if(p->running[i] && !errflag[i]) {
+                real y[6], ydot[6], B_dB_i[15], E[3];
+                for(int j = 0; j < 6; j++) {
+                    y[j] = tempy[j][i];
+                }
+                if(s == 0 && step_gc_cashkarp_cache_hit(cache, i, p->id[i],
+                                                        tstage[i], y)) {
+                    for(int j = 0; j < 6; j++) {
+                        k[0][j][i] = cache->k1[j][i];
+                    }
+                }
+                else {
+                    for(int j = 0; j < 15; j++) {
+                        B_dB_i[j] = B_dB[j*n_mrk + i];
+                    }
+                    errflag[i] = E_field_eval_E(E, y[0], y[1], y[2],
+                                                tstage[i], Edata, Bdata);
+                    if(!errflag[i]) {
+                        step_gceom(ydot, y, p->mass[i], p->charge[i], B_dB_i,
+                                   E);
+                        for(int j = 0; j < 6; j++) {
+                            k[s][j][i] = ydot[j];
+                        }
+                        if(s == 0) {
+                            step_gc_cashkarp_cache_store(cache, i, p->id[i],
+                                                         tstage[i], y, ydot);
+                        }
+                    }
+                }
             }
+        }
+    }
 
-
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, tempy[0], tempy[1], tempy[2],
-                                            t0 + h[i], Bdata);
-            }
-            if(!errflag) {
-                errflag = E_field_eval_E(E, tempy[0], tempy[1], tempy[2],
-                                         t0 + h[i], Edata, Bdata);
-            }
-            if(!errflag) {
-                step_gceom(k5, tempy, mass, charge, B_dB, E);
-            }
+    #pragma omp simd aligned(h, hnext : 64)
+    for(i = 0; i < n_mrk; i++) {
+        if(p->running[i]) {
+            real k1[6], k3[6], k4[6], k5[6], k6[6], y0[6];
             for(int j = 0; j < 6; j++) {
-                tempy[j] = yprev[j]
-                    + h[i]*(
-                          ( 1631.0/55296 ) * k1[j]
-                        + (  175.0/512   ) * k2[j]
-                        + (  575.0/13824 ) * k3[j]
-                        + (44275.0/110592) * k4[j]
-                        + (  253.0/4096  ) * k5[j] );
-            }
-
-
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, tempy[0], tempy[1], tempy[2],
-                                            t0 + (7.0/8)*h[i], Bdata);
-            }
-            if(!errflag) {
-                errflag = E_field_eval_E(E, tempy[0], tempy[1], tempy[2],
-                                         t0 + (7.0/8)*h[i], Edata, Bdata);
-            }
-            if(!errflag) {
-                step_gceom(k6, tempy, mass, charge, B_dB, E);
+                y0[j] = yprev[j][i];
+                k1[j] = k[0][j][i];
+                k3[j] = k[2][j][i];
+                k4[j] = k[3][j][i];
+                k5[j] = k[4][j][i];
+                k6[j] = k[5][j][i];
             }
 
             /* Error estimate is a difference between RK4 and RK5 solutions. If
              * time-step is accepted, the RK5 solution will be used to advance
              * marker. */
             real rk5[6], rk4[6];
-            if(!errflag) {
+            if(!errflag[i]) {
                 real err = 0.0;
                 for(int j = 0; j < 6; j++) {
-                    rk5[j] = yprev[j]
+                    rk5[j] = y0[j]
                         + h[i]*(
                               ( 37.0/378 ) * k1[j]
                             + (250.0/621 ) * k3[j]
                             + (125.0/594 ) * k4[j]
                             + (512.0/1771) * k6[j] );
 
-                    rk4[j] = yprev[j] +
+                    rk4[j] = y0[j] +
                         h[i]*(
                               ( 2825.0/27648) * k1[j]
                             + (18575.0/48384) * k3[j]
@@ -212,7 +282,7 @@ void step_gc_cashkarp(particle_simd_gc* p, real* h, real* hnext, real tol,
                             + (    1.0/4    ) * k6[j] );
                     if(j==3) {
                         real yerr = fabs(rk5[j] - rk4[j]);
-                        real ytol = fabs(yprev[j]) + fabs(k1[j]*h[i])
+                        real ytol = fabs(y0[j]) + fabs(k1[j]*h[i])
                                     + DBL_EPSILON;
                         err = fmax( err, yerr/ytol );
                     }
@@ -223,9 +293,9 @@ void step_gc_cashkarp(particle_simd_gc* p, real* h, real* hnext, real tol,
                             - 2 * rk5[0] * rk4[0] * cos(rk5[1] - rk4[1])
                               + ( rk5[2] - rk4[2] ) * ( rk5[2] - rk4[2] );
                         real ytol =
-                              yprev[0] * yprev[0] + rk1[0] * rk1[0]
-                            - 2 * yprev[0] * rk1[0] * cos(yprev[1] - rk1[1])
-                            + ( yprev[2] - rk1[2] ) * ( yprev[2] - rk1[2] )
+                              y0[0] * y0[0] + rk1[0] * rk1[0]
+                            - 2 * y0[0] * rk1[0] * cos(y0[1] - rk1[1])
+                            + ( y0[2] - rk1[2] ) * ( y0[2] - rk1[2] )
                             + DBL_EPSILON;
                         err = fmax( err, sqrt(yerr/ytol) );
                     }
@@ -235,6 +305,7 @@ void step_gc_cashkarp(particle_simd_gc* p, real* h, real* hnext, real tol,
                 if(err <= 1){
                     /* Time step accepted */
                     hnext[i] = 0.85*h[i]*pow(err,-0.2);
+                    accepted[i] = 1;
 
                     /* Make sure we don't make a huge jump */
                     if(hnext[i] > 1.5*h[i]) {
@@ -248,21 +319,22 @@ void step_gc_cashkarp(particle_simd_gc* p, real* h, real* hnext, real tol,
             }
 
             /* Test that results are physical */
-            if(!errflag && fabs(hnext[i]) < A5_EXTREMELY_SMALL_TIMESTEP) {
-                errflag = error_raise(
+            if(!errflag[i] && fabs(hnext[i]) < A5_EXTREMELY_SMALL_TIMESTEP) {
+                errflag[i] = error_raise(
                     ERR_INVALID_TIMESTEP, __LINE__, EF_STEP_GC_CASHKARP);
             }
-            else if(!errflag && rk5[0] <= 0) {
-                errflag = error_raise(
+            else if(!errflag[i] && rk5[0] <= 0) {
+                errflag[i] = error_raise(
                     ERR_INTEGRATION, __LINE__, EF_STEP_GC_CASHKARP);
             }
-            else if(!errflag && rk5[4] < 0) {
-                errflag = error_raise(
+            else if(!errflag[i] && rk5[4] < 0) {
+                errflag[i] = error_raise(
                     ERR_INTEGRATION, __LINE__, EF_STEP_GC_CASHKARP);
             }
 
-            /* Update gc phase space position */
-            if(!errflag) {
+            /* Update gc phase space position if the step was accepted */
+            accepted[i] = accepted[i] && !errflag[i];
+            if(accepted[i]) {
                 p->r[i]     = rk5[0];
                 p->phi[i]   = rk5[1];
                 p->z[i]     = rk5[2];
@@ -273,51 +345,57 @@ void step_gc_cashkarp(particle_simd_gc* p, real* h, real* hnext, real tol,
                     p->zeta[i] = CONST_2PI + p->zeta[i];
                 }
             }
+            tstage[i] = p->time[i] + h[i];
+        }
+    }
 
-            /* Evaluate magnetic field (and gradient) and rho at new position */
+    /* Evaluate magnetic field (and gradient) and rho at new position */
+    B_field_eval_B_dB_simd(n_mrk, B_dB, p->r, p->phi, p->z, tstage,
+                           accepted, errflag, Bdata);
+
+    #pragma omp simd aligned(h, hnext : 64)
+    for(i = 0; i < n_mrk; i++) {
+        if(p->running[i]) {
             real psi[1];
             real rho[2];
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, p->r[i], p->phi[i], p->z[i],
-                                            p->time[i] + h[i], Bdata);
+            if(!errflag[i] && accepted[i]) {
+                errflag[i] = B_field_eval_psi(psi, p->r[i], p->phi[i], p->z[i],
+                                              tstage[i], Bdata);
             }
-            if(!errflag) {
-                errflag = B_field_eval_psi(psi, p->r[i], p->phi[i], p->z[i],
-                                           p->time[i] + h[i], Bdata);
-            }
-            if(!errflag) {
-                errflag = B_field_eval_rho(rho, psi[0], Bdata);
+            if(!errflag[i] && accepted[i]) {
+                errflag[i] = B_field_eval_rho(rho, psi[0], Bdata);
             }
 
-            if(!errflag) {
-                p->B_r[i]        = B_dB[0];
-                p->B_r_dr[i]     = B_dB[1];
-                p->B_r_dphi[i]   = B_dB[2];
-                p->B_r_dz[i]     = B_dB[3];
+            if(!errflag[i] && accepted[i]) {
+                p->B_r[i]        = B_dB[ 0*n_mrk + i];
+                p->B_r_dr[i]     = B_dB[ 1*n_mrk + i];
+                p->B_r_dphi[i]   = B_dB[ 2*n_mrk + i];
+                p->B_r_dz[i]     = B_dB[ 3*n_mrk + i];
 
-                p->B_phi[i]      = B_dB[4];
-                p->B_phi_dr[i]   = B_dB[5];
-                p->B_phi_dphi[i] = B_dB[6];
-                p->B_phi_dz[i]   = B_dB[7];
+                p->B_phi[i]      = B_dB[ 4*n_mrk + i];
+                p->B_phi_dr[i]   = B_dB[ 5*n_mrk + i];
+                p->B_phi_dphi[i] = B_dB[ 6*n_mrk + i];
+                p->B_phi_dz[i]   = B_dB[ 7*n_mrk + i];
 
-                p->B_z[i]        = B_dB[8];
-                p->B_z_dr[i]     = B_dB[9];
-                p->B_z_dphi[i]   = B_dB[10];
-                p->B_z_dz[i]     = B_dB[11];
+                p->B_z[i]        = B_dB[ 8*n_mrk + i];
+                p->B_z_dr[i]     = B_dB[ 9*n_mrk + i];
+                p->B_z_dphi[i]   = B_dB[10*n_mrk + i];
+                p->B_z_dz[i]     = B_dB[11*n_mrk + i];
                 p->rho[i] = rho[0];
 
                 /* Evaluate theta angle so that it is cumulative */
                 real axisrz[2];
-                errflag = B_field_get_axis_rz(axisrz, Bdata, p->phi[i]);
-                p->theta[i] += atan2(   (R0-axisrz[0]) * (p->z[i]-axisrz[1])
-                                      - (z0-axisrz[1]) * (p->r[i]-axisrz[0]),
-                                        (R0-axisrz[0]) * (p->r[i]-axisrz[0])
-                                      + (z0-axisrz[1]) * (p->z[i]-axisrz[1]) );
+                errflag[i] = B_field_get_axis_rz(axisrz, Bdata, p->phi[i]);
+                p->theta[i] += atan2(
+                      (R0[i]-axisrz[0]) * (p->z[i]-axisrz[1])
+                    - (z0[i]-axisrz[1]) * (p->r[i]-axisrz[0]),
+                      (R0[i]-axisrz[0]) * (p->r[i]-axisrz[0])
+                    + (z0[i]-axisrz[1]) * (p->z[i]-axisrz[1]) );
             }
 
             /* Error handling */
-            if(errflag) {
-                p->err[i]     = errflag;
+            if(errflag[i]) {
+                p->err[i]     = errflag[i];
                 p->running[i] = 0;
                 hnext[i]      = h[i];
             }
@@ -332,23 +410,29 @@ void step_gc_cashkarp(particle_simd_gc* p, real* h, real* hnext, real tol,
  * sign is only used to indicate a rejected step and absolute value should be
  * used for the next time-step.
  *
+ * As in step_gc_cashkarp(), the first stage derivative is cached and reused
+ * when a rejected step is repeated, and rejected markers are not moved.
+ *
  * @param p marker struct that will be updated
  * @param h array containing time step lengths
  * @param hnext suggestion for the next time step.
  * @param tol error tolerance
+ * @param cache first stage derivatives from previous steps
  * @param Bdata pointer to magnetic field data
  * @param Edata pointer to electric field data
  * @param boozer pointer to Boozer data
  * @param mhd pointer to MHD data
  */
+A5_TARGET_CLONES
 void step_gc_cashkarp_mhd(particle_simd_gc* p, real* h, real* hnext, real tol,
+                          step_gc_cashkarp_cache* cache,
                           B_field_data* Bdata, E_field_data* Edata,
                           boozer_data* boozer, mhd_data* mhd) {
 
     int i;
     /* Following loop will be executed simultaneously for all i */
 #pragma omp simd aligned(h, hnext : 64)
-    for(i = 0; i < NSIMD; i++) {
+    for(i = 0; i < p->n_mrk; i++) {
         if(p->running[i]) {
             a5err errflag = 0;
 
@@ -392,16 +476,27 @@ void step_gc_cashkarp_mhd(particle_simd_gc* p, real* h, real* hnext, real tol,
             B_dB[10] = p->B_z_dphi[i];
             B_dB[11] = p->B_z_dz[i];
 
-            if(!errflag) {
-                errflag = E_field_eval_E(E, yprev[0], yprev[1], yprev[2],
-                                         t0, Edata, Bdata);
-            }
-            if(!errflag) {
-                errflag = mhd_eval(mhd_dmhd, yprev[0], yprev[1], yprev[2],
-                                   t0, MHD_INCLUDE_ALL, boozer, mhd, Bdata);
+            if(step_gc_cashkarp_cache_hit(cache, i, p->id[i], t0, yprev)) {
+                for(int j = 0; j < 6; j++) {
+                    k1[j] = cache->k1[j][i];
+                }
             }
-            if(!errflag) {
-                step_gceom_mhd(k1, yprev, mass, charge, B_dB, E, mhd_dmhd);
+            else {
+                if(!errflag) {
+                    errflag = E_field_eval_E(E, yprev[0], yprev[1], yprev[2],
+                                             t0, Edata, Bdata);
+                }
+                if(!errflag) {
+                    errflag = mhd_eval(mhd_dmhd, yprev[0], yprev[1], yprev[2],
+                                       t0, MHD_INCLUDE_ALL, boozer, mhd,
+                                       Bdata);
+                }
+                if(!errflag) {
+                    step_gceom_mhd(k1, yprev, mass, charge, B_dB, E,
+                                   mhd_dmhd);
+                    step_gc_cashkarp_cache_store(cache, i, p->id[i], t0, yprev,
+                                                 k1);
+                }
             }
             for(int j = 0; j < 6; j++) {
                 tempy[j] = yprev[j]
@@ -533,6 +628,7 @@ void step_gc_cashkarp_mhd(particle_simd_gc* p, real* h, real* hnext, real tol,
              * time-step is accepted, the RK5 solution will be used to advance
              * marker. */
             real rk5[6], rk4[6];
+            int accepted = 0;
             if(!errflag) {
                 real err = 0.0;
                 for(int j = 0; j < 5; j++) {
@@ -575,6 +671,7 @@ void step_gc_cashkarp_mhd(particle_simd_gc* p, real* h, real* hnext, real tol,
                 if(err <= 1){
                     /* Time step accepted */
                     hnext[i] = 0.85*h[i]*pow(err,-0.2);
+                    accepted = 1;
 
                     /* Make sure we don't make a huge jump */
                     if(hnext[i] > 1.5*h[i]) {
@@ -587,8 +684,8 @@ void step_gc_cashkarp_mhd(particle_simd_gc* p, real* h, real* hnext, real tol,
                 }
             }
 
-            /* Update gc phase space position */
-            if(!errflag) {
+            /* Update gc phase space position if the step was accepted */
+            if(!errflag && accepted) {
                 p->r[i]     = rk5[0];
                 p->phi[i]   = rk5[1];
                 p->z[i]     = rk5[2];
@@ -603,19 +700,19 @@ void step_gc_cashkarp_mhd(particle_simd_gc* p, real* h, real* hnext, real tol,
             /* Evaluate magnetic field (and gradient) and rho at new position */
             real psi[1];
             real rho[2];
-            if(!errflag) {
+            if(!errflag && accepted) {
                 errflag = B_field_eval_B_dB(B_dB, p->r[i], p->phi[i], p->z[i],
                                             p->time[i] + h[i], Bdata);
             }
-            if(!errflag) {
+            if(!errflag && accepted) {
                 errflag = B_field_eval_psi(psi, p->r[i], p->phi[i], p->z[i],
                                            p->time[i] + h[i], Bdata);
             }
-            if(!errflag) {
+            if(!errflag && accepted) {
                 errflag = B_field_eval_rho(rho, psi[0], Bdata);
             }
 
-            if(!errflag) {
+            if(!errflag && accepted) {
                 p->B_r[i]        = B_dB[0];
                 p->B_r_dr[i]     = B_dB[1];
                 p->B_r_dphi[i]   = B_dB[2];
@@ -11,9 +11,30 @@
 #include "../../mhd.h"
 #include "../../particle.h"
 
+/**
+ * @brief First stage derivatives cached between Cash-Karp steps
+ *
+ * The first stage derivative depends only on the marker state at the beginning
+ * of the step. When a step is rejected and the marker is restored to its
+ * previous state, the cached derivative is used instead of evaluating the
+ * fields again. An entry is valid only if the marker ID, time, and phase-space
+ * coordinates match exactly those stored here.
+ */
+typedef struct {
+    integer id[NSIMD]; /**< ID of the marker the entry belongs to             */
+    real time[NSIMD];  /**< Marker time at which k1 was evaluated [s]         */
+    real y[6][NSIMD];  /**< Coordinates (R, phi, z, ppar, mu, zeta) at k1     */
+    real k1[6][NSIMD]; /**< First stage derivatives                           */
+} step_gc_cashkarp_cache;
+
+void step_gc_cashkarp_cache_init(step_gc_cashkarp_cache* cache);
+void step_gc_cashkarp_cache_move(step_gc_cashkarp_cache* cache, int from,
+                                 int to);
 void step_gc_cashkarp(particle_simd_gc* p, real* h, real* hnext, real tol,
+                      step_gc_cashkarp_cache* cache,
                       B_field_data* Bdata, E_field_data* Edata);
 void step_gc_cashkarp_mhd(particle_simd_gc* p, real* h, real* hnext, real tol,
+                          step_gc_cashkarp_cache* cache,
                           B_field_data* Bdata, E_field_data* Edata,
                           boozer_data* boozer, mhd_data* mhd);
 
@@ -17,6 +17,21 @@
 #include "step_gceom_mhd.h"
 #include "step_gc_rk4.h"
 
+/**
+ * @brief RK4 tableau coefficients for the intermediate stages
+ */
+static const real step_gc_rk4_a[4][3] = {
+    {0, 0, 0},
+    {1.0/2, 0, 0},
+    {0, 1.0/2, 0},
+    {0, 0, 1.0}
+};
+
+/**
+ * @brief RK4 tableau nodes, i.e. fraction of time step at each stage
+ */
+static const real step_gc_rk4_c[4] = {0, 1.0/2, 1.0/2, 1.0};
+
 /**
  * @brief Integrate a guiding center step for a struct of markers with RK4
  *
@@ -25,134 +40,133 @@
  * function are of NSIMD length so vectorization can be performed directly
  * without gather and scatter operations.
  *
+ * The step is advanced stage by stage for all markers at once so that the
+ * magnetic field is evaluated with a single B_field_eval_B_dB_simd() call per
+ * stage.
+ *
  * @param p simd_gc struct that will be updated
  * @param h pointer to array containing time steps
  * @param Bdata pointer to magnetic field data
  * @param Edata pointer to electric field data
  */
+A5_TARGET_CLONES
 void step_gc_rk4(particle_simd_gc* p, real* h, B_field_data* Bdata,
                  E_field_data* Edata) {
 
+    /* Stage derivatives k[stage][coordinate][lane] */
+    real k[4][6][NSIMD];
+    real yprev[6][NSIMD];
+    real tempy[6][NSIMD];
+    real tstage[NSIMD];
+    real B_dB[15*NSIMD];
+    real R0[NSIMD];
+    real z0[NSIMD];
+    a5err errflag[NSIMD];
+
     int i;
-    /* Following loop will be executed simultaneously for all i */
-    #pragma omp simd aligned(h : 64)
-    for(i = 0; i < NSIMD; i++) {
+    int n_mrk = p->n_mrk; /* Number of lanes in use */
+    #pragma omp simd
+    for(i = 0; i < n_mrk; i++) {
+        errflag[i] = 0;
         if(p->running[i]) {
-            a5err errflag = 0;
-
-            real k1[6], k2[6], k3[6], k4[6];
-            real tempy[6];
-            real yprev[6];
-            real y[6];
-
-            real mass   = p->mass[i];
-            real charge = p->charge[i];
-
-            real B_dB[15];
-            real E[3];
-
-            real R0   = p->r[i];
-            real z0   = p->z[i];
-            real t0   = p->time[i];
+            R0[i] = p->r[i];
+            z0[i] = p->z[i];
 
             /* Coordinates are copied from the struct into an array to make
              * passing parameters easier */
-            yprev[0] = p->r[i];
-            yprev[1] = p->phi[i];
-            yprev[2] = p->z[i];
-            yprev[3] = p->ppar[i];
-            yprev[4] = p->mu[i];
-            yprev[5] = p->zeta[i];
+            yprev[0][i] = p->r[i];
+            yprev[1][i] = p->phi[i];
+            yprev[2][i] = p->z[i];
+            yprev[3][i] = p->ppar[i];
+            yprev[4][i] = p->mu[i];
+            yprev[5][i] = p->zeta[i];
 
             /* Magnetic field at initial position already known */
-            B_dB[0]  = p->B_r[i];
-            B_dB[1]  = p->B_r_dr[i];
-            B_dB[2]  = p->B_r_dphi[i];
-            B_dB[3]  = p->B_r_dz[i];
-
-            B_dB[4]  = p->B_phi[i];
-            B_dB[5]  = p->B_phi_dr[i];
-            B_dB[6]  = p->B_phi_dphi[i];
-            B_dB[7]  = p->B_phi_dz[i];
-
-            B_dB[8]  = p->B_z[i];
-            B_dB[9]  = p->B_z_dr[i];
-            B_dB[10] = p->B_z_dphi[i];
-            B_dB[11] = p->B_z_dz[i];
-
-            if(!errflag) {
-                errflag = E_field_eval_E(E, yprev[0], yprev[1], yprev[2],
-                                         t0, Edata, Bdata);
-            }
-            if(!errflag) {
-                step_gceom(k1, yprev, mass, charge, B_dB, E);
-            }
-
-
-            /* particle coordinates for the subsequent ydot evaluations are
-             * stored in tempy */
-            for(int j = 0; j < 6; j++) {
-                tempy[j] = yprev[j] + h[i]*k1[j]/2.0;
-            }
-
+            B_dB[ 0*n_mrk + i] = p->B_r[i];
+            B_dB[ 1*n_mrk + i] = p->B_r_dr[i];
+            B_dB[ 2*n_mrk + i] = p->B_r_dphi[i];
+            B_dB[ 3*n_mrk + i] = p->B_r_dz[i];
+
+            B_dB[ 4*n_mrk + i] = p->B_phi[i];
+            B_dB[ 5*n_mrk + i] = p->B_phi_dr[i];
+            B_dB[ 6*n_mrk + i] = p->B_phi_dphi[i];
+            B_dB[ 7*n_mrk + i] = p->B_phi_dz[i];
+
+            B_dB[ 8*n_mrk + i] = p->B_z[i];
+            B_dB[ 9*n_mrk + i] = p->B_z_dr[i];
+            B_dB[10*n_mrk + i] = p->B_z_dphi[i];
+            B_dB[11*n_mrk + i] = p->B_z_dz[i];
+        }
+    }
 
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, tempy[0], tempy[1], tempy[2],
-                                            t0 + h[i]/2.0, Bdata);
-            }
-            if(!errflag) {
-                errflag = E_field_eval_E(E, tempy[0], tempy[1], tempy[2],
-                                         t0 + h[i]/2.0, Edata, Bdata);
-            }
-            if(!errflag) {
-                step_gceom(k2, tempy, mass, charge, B_dB, E);
-            }
-            for(int j = 0; j < 6; j++) {
-                tempy[j] = yprev[j] + h[i]*k2[j]/2.0;
+    for(int s = 0; s < 4; s++) {
+        /* Position where the stage derivative is evaluated */
+        #pragma omp simd aligned(h : 64)
+        for(i = 0; i < n_mrk; i++) {
+            if(p->running[i] && !errflag[i]) {
+                for(int j = 0; j < 6; j++) {
+                    real dy = 0;
+                    for(int m = 0; m < s; m++) {
+                        dy += step_gc_rk4_a[s][m] * k[m][j][i];
+                    }
+                    tempy[j][i] = yprev[j][i] + h[i]*dy;
+                }
+                tstage[i] = p->time[i] + step_gc_rk4_c[s]*h[i];
             }
+        }
 
+        /* Field at the first stage is known */
+        if(s > 0) {
+            B_field_eval_B_dB_simd(n_mrk, B_dB, tempy[0], tempy[1], tempy[2],
+                                   tstage, p->running, errflag, Bdata);
+        }
 
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, tempy[0], tempy[1], tempy[2],
-                                            t0 + h[i]/2.0, Bdata);
-            }
-            if(!errflag) {
-                errflag = E_field_eval_E(E, tempy[0], tempy[1], tempy[2],
-                                         t0 + h[i]/2.0, Edata, Bdata);
-            }
-            if(!errflag) {
-                step_gceom(k3, tempy, mass, charge, B_dB, E);
-            }
-            for(int j = 0; j < 6; j++) {
-                tempy[j] = yprev[j] + h[i]*k3[j];
+        #pragma omp simd
+        for(i = 0; i < n_mrk; i++) {
+            if(p->running[i] && !errflag[i]) {
+                real y[6], ydot[6], B_dB_i[15], E[3];
+                for(int j = 0; j < 6; j++) {
+                    y[j] = tempy[j][i];
+                }
+                for(int j = 0; j < 15; j++) {
+                    B_dB_i[j] = B_dB[j*n_mrk + i];
+                }
+                errflag[i] = E_field_eval_E(E, y[0], y[1], y[2], tstage[i],
+                                            Edata, Bdata);
+                if(!errflag[i]) {
+                    step_gceom(ydot, y, p->mass[i], p->charge[i], B_dB_i, E);
+                    for(int j = 0; j < 6; j++) {
+                        k[s][j][i] = ydot[j];
+                    }
+                }
             }
+        }
+    }
 
-
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, tempy[0], tempy[1], tempy[2],
-                                            t0 + h[i], Bdata);
-            }
-            if(!errflag) {
-                errflag = E_field_eval_E(E, tempy[0], tempy[1], tempy[2],
-                                         t0 + h[i], Edata, Bdata);}
-            if(!errflag) {step_gceom(k4, tempy, mass, charge, B_dB, E);
-            }
-            for(int j = 0; j < 6; j++) {
-                y[j] = yprev[j]
-                    + h[i]/6.0 * (k1[j] + 2*k2[j] + 2*k3[j] + k4[j]);
+    #pragma omp simd aligned(h : 64)
+    for(i = 0; i < n_mrk; i++) {
+        if(p->running[i]) {
+            real y[6];
+            if(!errflag[i]) {
+                for(int j = 0; j < 6; j++) {
+                    y[j] = yprev[j][i]
+                        + h[i]/6.0 * (k[0][j][i] + 2*k[1][j][i]
+                                      + 2*k[2][j][i] + k[3][j][i]);
+                }
             }
 
-
             /* Test that results are physical */
-            if(!errflag && y[0] <= 0) {
-                errflag = error_raise(ERR_INTEGRATION, __LINE__, EF_STEP_GC_RK4);
+            if(!errflag[i] && y[0] <= 0) {
+                errflag[i] = error_raise(ERR_INTEGRATION, __LINE__,
+                                         EF_STEP_GC_RK4);
             }
-            if(!errflag && y[4] < 0) {
-                errflag = error_raise(ERR_INTEGRATION, __LINE__, EF_STEP_GC_RK4);
+            if(!errflag[i] && y[4] < 0) {
+                errflag[i] = error_raise(ERR_INTEGRATION, __LINE__,
+                                         EF_STEP_GC_RK4);
             }
 
             /* Update gc phase space position */
-            if(!errflag) {
+            if(!errflag[i]) {
                 p->r[i]    = y[0];
                 p->phi[i]  = y[1];
                 p->z[i]    = y[2];
@@ -163,52 +177,58 @@ void step_gc_rk4(particle_simd_gc* p, real* h, B_field_data* Bdata,
                     p->zeta[i] = CONST_2PI + p->zeta[i];
                 }
             }
+            tstage[i] = p->time[i] + h[i];
+        }
+    }
 
-            /* Evaluate magnetic field (and gradient) and rho at new position */
+    /* Evaluate magnetic field (and gradient) and rho at new position */
+    B_field_eval_B_dB_simd(n_mrk, B_dB, p->r, p->phi, p->z, tstage,
+                           p->running, errflag, Bdata);
+
+    #pragma omp simd
+    for(i = 0; i < n_mrk; i++) {
+        if(p->running[i]) {
             real psi[1];
             real rho[2];
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, p->r[i], p->phi[i], p->z[i],
-                                            t0 + h[i], Bdata);
+            if(!errflag[i]) {
+                errflag[i] = B_field_eval_psi(psi, p->r[i], p->phi[i], p->z[i],
+                                              tstage[i], Bdata);
             }
-            if(!errflag) {
-                errflag = B_field_eval_psi(psi, p->r[i], p->phi[i], p->z[i],
-                                           t0 + h[i], Bdata);
-            }
-            if(!errflag) {
-                errflag = B_field_eval_rho(rho, psi[0], Bdata);
+            if(!errflag[i]) {
+                errflag[i] = B_field_eval_rho(rho, psi[0], Bdata);
             }
 
-            if(!errflag) {
-                p->B_r[i]        = B_dB[0];
-                p->B_r_dr[i]     = B_dB[1];
-                p->B_r_dphi[i]   = B_dB[2];
-                p->B_r_dz[i]     = B_dB[3];
+            if(!errflag[i]) {
+                p->B_r[i]        = B_dB[ 0*n_mrk + i];
+                p->B_r_dr[i]     = B_dB[ 1*n_mrk + i];
+                p->B_r_dphi[i]   = B_dB[ 2*n_mrk + i];
+                p->B_r_dz[i]     = B_dB[ 3*n_mrk + i];
 
-                p->B_phi[i]      = B_dB[4];
-                p->B_phi_dr[i]   = B_dB[5];
-                p->B_phi_dphi[i] = B_dB[6];
-                p->B_phi_dz[i]   = B_dB[7];
+                p->B_phi[i]      = B_dB[ 4*n_mrk + i];
+                p->B_phi_dr[i]   = B_dB[ 5*n_mrk + i];
+                p->B_phi_dphi[i] = B_dB[ 6*n_mrk + i];
+                p->B_phi_dz[i]   = B_dB[ 7*n_mrk + i];
 
-                p->B_z[i]        = B_dB[8];
-                p->B_z_dr[i]     = B_dB[9];
-                p->B_z_dphi[i]   = B_dB[10];
-                p->B_z_dz[i]     = B_dB[11];
+                p->B_z[i]        = B_dB[ 8*n_mrk + i];
+                p->B_z_dr[i]     = B_dB[ 9*n_mrk + i];
+                p->B_z_dphi[i]   = B_dB[10*n_mrk + i];
+                p->B_z_dz[i]     = B_dB[11*n_mrk + i];
 
                 p->rho[i] = rho[0];
 
                 /* Evaluate theta angle so that it is cumulative */
                 real axisrz[2];
-                errflag = B_field_get_axis_rz(axisrz, Bdata, p->phi[i]);
-                p->theta[i] += atan2(   (R0-axisrz[0]) * (p->z[i]-axisrz[1])
-                                      - (z0-axisrz[1]) * (p->r[i]-axisrz[0]),
-                                        (R0-axisrz[0]) * (p->r[i]-axisrz[0])
-                                      + (z0-axisrz[1]) * (p->z[i]-axisrz[1]) );
+                errflag[i] = B_field_get_axis_rz(axisrz, Bdata, p->phi[i]);
+                p->theta[i] += atan2(
+                      (R0[i]-axisrz[0]) * (p->z[i]-axisrz[1])
+                    - (z0[i]-axisrz[1]) * (p->r[i]-axisrz[0]),
+                      (R0[i]-axisrz[0]) * (p->r[i]-axisrz[0])
+                    + (z0[i]-axisrz[1]) * (p->z[i]-axisrz[1]) );
             }
 
             /* Error handling */
-            if(errflag) {
-                p->err[i]     = errflag;
+            if(errflag[i]) {
+                p->err[i]     = errflag[i];
                 p->running[i] = 0;
             }
         }
@@ -227,13 +247,14 @@ void step_gc_rk4(particle_simd_gc* p, real* h, B_field_data* Bdata,
  * @param boozer pointer to boozer data
  * @param mhd pointer to MHD data
  */
+A5_TARGET_CLONES
 void step_gc_rk4_mhd(particle_simd_gc* p, real* h, B_field_data* Bdata,
                      E_field_data* Edata, boozer_data* boozer, mhd_data* mhd) {
 
     int i;
     /* Following loop will be executed simultaneously for all i */
     #pragma omp simd aligned(h : 64)
-    for(i = 0; i < NSIMD; i++) {
+    for(i = 0; i < p->n_mrk; i++) {
         if(p->running[i]) {
             a5err errflag = 0;
 
@@ -13,6 +13,37 @@
 #include "../../mhd.h"
 #include "step_ml_cashkarp.h"
 
+/**
+ * @brief Invalidate all entries in the first stage derivative cache
+ *
+ * @param cache pointer to the cache
+ */
+void step_ml_cashkarp_cache_init(step_ml_cashkarp_cache* cache) {
+    for(int i = 0; i < NSIMD; i++) {
+        cache->id[i] = -1;
+    }
+}
+
+/**
+ * @brief Move a cache entry to another lane
+ *
+ * Used when the markers are packed to the lowest lanes of the SIMD array so
+ * that the cached derivatives follow their markers.
+ *
+ * @param cache pointer to the cache
+ * @param from lane the entry is moved from
+ * @param to lane the entry is moved to
+ */
+void step_ml_cashkarp_cache_move(step_ml_cashkarp_cache* cache, int from,
+                                 int to) {
+    cache->id[to]   = cache->id[from];
+    cache->time[to] = cache->time[from];
+    for(int j = 0; j < 3; j++) {
+        cache->y[j][to]  = cache->y[j][from];
+        cache->k1[j][to] = cache->k1[j][from];
+    }
+}
+
 /**
  * @brief Integrate a magnetic field line step for a struct of markers
  *
@@ -21,7 +52,8 @@
  * All arrays in the function are of NSIMD length so vectorization can be
  * performed directly without gather and scatter operations. Informs whether
  * time step was accepted or rejected and provides a suggestion for the next
- * time step.
+ * time step. Markers whose step is rejected are not moved, and no fields are
+ * evaluated at their end point.
  *
  * @param p marker struct that will be integrated
  * @param h NSIMD length array containing time step lengths
@@ -29,13 +61,14 @@
  * @param tol error tolerance
  * @param Bdata pointer to magnetic field data
  */
+A5_TARGET_CLONES
 void step_ml_cashkarp(particle_simd_ml* p, real* h, real* hnext, real tol,
                       B_field_data* Bdata) {
 
     int i;
     /* Following loop will be executed simultaneously for all i */
     #pragma omp simd
-    for(i = 0; i < NSIMD; i++) {
+    for(i = 0; i < p->n_mrk; i++) {
         if(p->running[i]) {
             a5err errflag = 0;
 
@@ -183,7 +216,8 @@ void step_ml_cashkarp(particle_simd_ml* p, real* h, real* hnext, real tol,
             }
 
             err = err/tol;
-            if(err <= 1){
+            int accepted = err <= 1;
+            if(accepted){
                 /* Time step accepted */
                 hnext[i] = 0.85*h[i]*pow(err,-0.2);
 
@@ -194,51 +228,54 @@ void step_ml_cashkarp(particle_simd_ml* p, real* h, real* hnext, real tol,
 
             }
 
-            p->r[i]   = rk5[0];
-            p->phi[i] = rk5[1];
-            p->z[i]   = rk5[2];
-
-            /* Evaluate magnetic field (and gradient) and rho at new position */
-            real B_dB[15];
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, p->r[i], p->phi[i], p->z[i],
-                                            p->time[i] + h[i], Bdata);
-            }
-            p->B_r[i]        = B_dB[0];
-            p->B_r_dr[i]     = B_dB[1];
-            p->B_r_dphi[i]   = B_dB[2];
-            p->B_r_dz[i]     = B_dB[3];
-
-            p->B_phi[i]      = B_dB[4];
-            p->B_phi_dr[i]   = B_dB[5];
-            p->B_phi_dphi[i] = B_dB[6];
-            p->B_phi_dz[i]   = B_dB[7];
-
-            p->B_z[i]        = B_dB[8];
-            p->B_z_dr[i]     = B_dB[9];
-            p->B_z_dphi[i]   = B_dB[10];
-            p->B_z_dz[i]     = B_dB[11];
-
-
-            real psi[1];
-            real rho[2];
-            if(!errflag) {
-                errflag = B_field_eval_psi(psi, p->r[i], p->phi[i], p->z[i],
-                                           p->time[i] + h[i], Bdata);
+            /* Move the marker only if the step was accepted */
+            if(accepted) {
+                p->r[i]   = rk5[0];
+                p->phi[i] = rk5[1];
+                p->z[i]   = rk5[2];
+
+                /* Evaluate magnetic field (and gradient) and rho at new position */
+                real B_dB[15];
+                if(!errflag) {
+                    errflag = B_field_eval_B_dB(B_dB, p->r[i], p->phi[i], p->z[i],
+                                                p->time[i] + h[i], Bdata);
+                }
+                p->B_r[i]        = B_dB[0];
+                p->B_r_dr[i]     = B_dB[1];
+                p->B_r_dphi[i]   = B_dB[2];
+                p->B_r_dz[i]     = B_dB[3];
+
+                p->B_phi[i]      = B_dB[4];
+                p->B_phi_dr[i]   = B_dB[5];
+                p->B_phi_dphi[i] = B_dB[6];
+                p->B_phi_dz[i]   = B_dB[7];
+
+                p->B_z[i]        = B_dB[8];
+                p->B_z_dr[i]     = B_dB[9];
+                p->B_z_dphi[i]   = B_dB[10];
+                p->B_z_dz[i]     = B_dB[11];
+
+
+                real psi[1];
+                real rho[2];
+                if(!errflag) {
+                    errflag = B_field_eval_psi(psi, p->r[i], p->phi[i], p->z[i],
+                                               p->time[i] + h[i], Bdata);
+                }
+                if(!errflag) {
+                    errflag = B_field_eval_rho(rho, psi[0], Bdata);
+                }
+                p->rho[i] = rho[0];
+
+
+                /* Evaluate theta angle so that it is cumulative */
+                real axisrz[2];
+                errflag  = B_field_get_axis_rz(axisrz, Bdata, p->phi[i]);
+                p->theta[i] += atan2(   (R0-axisrz[0]) * (p->z[i]-axisrz[1])
+                                      - (z0-axisrz[1]) * (p->r[i]-axisrz[0]),
+                                        (R0-axisrz[0]) * (p->r[i]-axisrz[0])
+                                      + (z0-axisrz[1]) * (p->z[i]-axisrz[1]) );
             }
-            if(!errflag) {
-                errflag = B_field_eval_rho(rho, psi[0], Bdata);
-            }
-            p->rho[i] = rho[0];
-
-
-            /* Evaluate theta angle so that it is cumulative */
-            real axisrz[2];
-            errflag  = B_field_get_axis_rz(axisrz, Bdata, p->phi[i]);
-            p->theta[i] += atan2(   (R0-axisrz[0]) * (p->z[i]-axisrz[1])
-                                  - (z0-axisrz[1]) * (p->r[i]-axisrz[0]),
-                                    (R0-axisrz[0]) * (p->r[i]-axisrz[0])
-                                  + (z0-axisrz[1]) * (p->z[i]-axisrz[1]) );
 
         }
     }
@@ -254,22 +291,29 @@ void step_ml_cashkarp(particle_simd_ml* p, real* h, real* hnext, real tol,
  * time step was accepted or rejected and provides a suggestion for the next
  * time step.
  *
+ * The first stage derivative is cached and reused when a rejected step is
+ * repeated, so that the perturbations are not evaluated again at the initial
+ * position.
+ *
  * @param p marker struct that will be integrated
  * @param h NSIMD length array containing time step lengths
  * @param hnext suggestion for the next time step. Negative if rejected.
  * @param tol error tolerance
+ * @param cache first stage derivatives from previous steps
  * @param Bdata pointer to magnetic field data
  * @param boozerdata pointer to Boozer data
  * @param mhddata pointer to MHD data
  */
+A5_TARGET_CLONES
 void step_ml_cashkarp_mhd(particle_simd_ml* p, real* h, real* hnext, real tol,
+                          step_ml_cashkarp_cache* cache,
                           B_field_data* Bdata, boozer_data* boozerdata,
                           mhd_data* mhddata) {
 
     int i;
     /* Following loop will be executed simultaneously for all i */
     #pragma omp simd
-    for(i = 0; i < NSIMD; i++) {
+    for(i = 0; i < p->n_mrk; i++) {
         if(p->running[i]) {
             a5err errflag = 0;
 
@@ -298,21 +342,41 @@ void step_ml_cashkarp_mhd(particle_simd_ml* p, real* h, real* hnext, real tol,
             yprev[1] = p->phi[i];
             yprev[2] = p->z[i];
 
-            if(!errflag) {
-                errflag = mhd_perturbations(pert_field, p->r[i], p->phi[i],
-                                            p->z[i], p->time[i], pertonly,
-                                            MHD_INCLUDE_ALL, boozerdata,
-                                            mhddata, Bdata);
+            int cached = cache->id[i] == p->id[i] && cache->time[i] == t0;
+            for(int j = 0; j < 3; j++) {
+                cached = cached && cache->y[j][i] == yprev[j];
+            }
+            if(cached) {
+                for(int j = 0; j < 3; j++) {
+                    k1[j] = cache->k1[j][i];
+                }
+            }
+            else {
+                if(!errflag) {
+                    errflag = mhd_perturbations(pert_field, p->r[i], p->phi[i],
+                                                p->z[i], p->time[i], pertonly,
+                                                MHD_INCLUDE_ALL, boozerdata,
+                                                mhddata, Bdata);
+                }
+                k1[0] = pert_field[0];
+                k1[1] = pert_field[1];
+                k1[2] = pert_field[2];
+
+                normB = (math_normc(k1[0], k1[1], k1[2])) * direction;
+                k1[0] /= normB;
+                k1[1] /= normB;
+                k1[2] /= normB;
+                k1[1] /= yprev[0];
+
+                if(!errflag) {
+                    cache->id[i]   = p->id[i];
+                    cache->time[i] = t0;
+                    for(int j = 0; j < 3; j++) {
+                        cache->y[j][i]  = yprev[j];
+                        cache->k1[j][i] = k1[j];
+                    }
+                }
             }
-            k1[0] = pert_field[0];
-            k1[1] = pert_field[1];
-            k1[2] = pert_field[2];
-
-            normB = (math_normc(k1[0], k1[1], k1[2])) * direction;
-            k1[0] /= normB;
-            k1[1] /= normB;
-            k1[2] /= normB;
-            k1[1] /= yprev[0];
 
             for(int j = 0; j < 3; j++) {
                 tempy[j] = yprev[j]
@@ -455,7 +519,8 @@ void step_ml_cashkarp_mhd(particle_simd_ml* p, real* h, real* hnext, real tol,
             }
 
             err = err/tol;
-            if(err <= 1){
+            int accepted = err <= 1;
+            if(accepted){
                 /* Time step accepted */
                 hnext[i] = 0.85*h[i]*pow(err,-0.2);
 
@@ -466,51 +531,54 @@ void step_ml_cashkarp_mhd(particle_simd_ml* p, real* h, real* hnext, real tol,
 
             }
 
-            p->r[i]   = rk5[0];
-            p->phi[i] = rk5[1];
-            p->z[i]   = rk5[2];
-
-            /* Evaluate magnetic field (and gradient) and rho at new position */
-            real B_dB[15];
-            if(!errflag) {
-                errflag = B_field_eval_B_dB(B_dB, p->r[i], p->phi[i], p->z[i],
-                                            p->time[i] + h[i], Bdata);
-            }
-            p->B_r[i]        = B_dB[0];
-            p->B_r_dr[i]     = B_dB[1];
-            p->B_r_dphi[i]   = B_dB[2];
-            p->B_r_dz[i]     = B_dB[3];
-
-            p->B_phi[i]      = B_dB[4];
-            p->B_phi_dr[i]   = B_dB[5];
-            p->B_phi_dphi[i] = B_dB[6];
-            p->B_phi_dz[i]   = B_dB[7];
-
-            p->B_z[i]        = B_dB[8];
-            p->B_z_dr[i]     = B_dB[9];
-            p->B_z_dphi[i]   = B_dB[10];
-            p->B_z_dz[i]     = B_dB[11];
-
-
-            real psi[1];
-            real rho[2];
-            if(!errflag) {
-                errflag = B_field_eval_psi(psi, p->r[i], p->phi[i], p->z[i],
-                                           p->time[i] + h[i], Bdata);
-            }
-            if(!errflag) {
-                errflag = B_field_eval_rho(rho, psi[0], Bdata);
+            /* Move the marker only if the step was accepted */
+            if(accepted) {
+                p->r[i]   = rk5[0];
+                p->phi[i] = rk5[1];
+                p->z[i]   = rk5[2];
+
+                /* Evaluate magnetic field (and gradient) and rho at new position */
+                real B_dB[15];
+                if(!errflag) {
+                    errflag = B_field_eval_B_dB(B_dB, p->r[i], p->phi[i], p->z[i],
+                                                p->time[i] + h[i], Bdata);
+                }
+                p->B_r[i]        = B_dB[0];
+                p->B_r_dr[i]     = B_dB[1];
+                p->B_r_dphi[i]   = B_dB[2];
+                p->B_r_dz[i]     = B_dB[3];
+
+                p->B_phi[i]      = B_dB[4];
+                p->B_phi_dr[i]   = B_dB[5];
+                p->B_phi_dphi[i] = B_dB[6];
+                p->B_phi_dz[i]   = B_dB[7];
+
+                p->B_z[i]        = B_dB[8];
+                p->B_z_dr[i]     = B_dB[9];
+                p->B_z_dphi[i]   = B_dB[10];
+                p->B_z_dz[i]     = B_dB[11];
+
+
+                real psi[1];
+                real rho[2];
+                if(!errflag) {
+                    errflag = B_field_eval_psi(psi, p->r[i], p->phi[i], p->z[i],
+                                               p->time[i] + h[i], Bdata);
+                }
+                if(!errflag) {
+                    errflag = B_field_eval_rho(rho, psi[0], Bdata);
+                }
+                p->rho[i] = rho[0];
+
+
+                /* Evaluate theta angle so that it is cumulative */
+                real axisrz[2];
+                errflag  = B_field_get_axis_rz(axisrz, Bdata, p->phi[i]);
+                p->theta[i] += atan2(   (R0-axisrz[0]) * (p->z[i]-axisrz[1])
+                                      - (z0-axisrz[1]) * (p->r[i]-axisrz[0]),
+                                        (R0-axisrz[0]) * (p->r[i]-axisrz[0])
+                                      + (z0-axisrz[1]) * (p->z[i]-axisrz[1]) );
             }
-            p->rho[i] = rho[0];
-
-
-            /* Evaluate theta angle so that it is cumulative */
-            real axisrz[2];
-            errflag  = B_field_get_axis_rz(axisrz, Bdata, p->phi[i]);
-            p->theta[i] += atan2(   (R0-axisrz[0]) * (p->z[i]-axisrz[1])
-                                  - (z0-axisrz[1]) * (p->r[i]-axisrz[0]),
-                                    (R0-axisrz[0]) * (p->r[i]-axisrz[0])
-                                  + (z0-axisrz[1]) * (p->z[i]-axisrz[1]) );
 
         }
     }
@@ -10,10 +10,27 @@
 #include "../../mhd.h"
 #include "../../particle.h"
 
+/**
+ * @brief First stage derivatives cached between Cash-Karp steps
+ *
+ * See step_gc_cashkarp_cache. Only used when MHD is included since otherwise
+ * the first stage is evaluated from the field stored in the marker struct.
+ */
+typedef struct {
+    integer id[NSIMD]; /**< ID of the marker the entry belongs to             */
+    real time[NSIMD];  /**< Marker time at which k1 was evaluated [s]         */
+    real y[3][NSIMD];  /**< Coordinates (R, phi, z) at k1                     */
+    real k1[3][NSIMD]; /**< First stage derivatives                           */
+} step_ml_cashkarp_cache;
+
+void step_ml_cashkarp_cache_init(step_ml_cashkarp_cache* cache);
+void step_ml_cashkarp_cache_move(step_ml_cashkarp_cache* cache, int from,
+                                 int to);
 void step_ml_cashkarp(particle_simd_ml* p, real* h, real* hnext,
                       real tol, B_field_data* Bdata);
 void step_ml_cashkarp_mhd(particle_simd_ml* p, real* h, real* hnext,
-                          real tol, B_field_data* Bdata,
+                          real tol, step_ml_cashkarp_cache* cache,
+                          B_field_data* Bdata,
                           boozer_data* boozerdata,
                           mhd_data* mhddata);
 
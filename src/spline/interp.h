@@ -23,6 +23,12 @@
  * - 1D compact  2, explicit 4
  * - 2D compact  4, explicit 16
  * - 3D compact  8, explicit 64
+ *
+ * Compact 3D coefficients can optionally be stored in single precision to
+ * halve the memory footprint and bandwidth of large 3D data. The evaluation
+ * is still done in double precision. To use this, compress the coefficients
+ * with interp3Dcomp_compress_coeff() and after init_spline() assign the
+ * compressed array to interp3D_data.cf.
  */
 #ifndef INTERP_H
 #define INTERP_H
@@ -99,6 +105,8 @@ typedef struct {
     real z_max;  /**< maximum z coordinate in the grid               */
     real z_grid; /**< interval between two adjacent points in z grid */
     real* c;     /**< pointer to array with spline coefficients      */
+    float* cf;   /**< single precision coefficients used instead of c
+                      if not NULL (compact form only)                */
 } interp3D_data;
 
 int interp1Dcomp_init_coeff(real* c, real* f,
@@ -149,6 +157,11 @@ void interp3Dcomp_init_spline(interp3D_data* str, real* c,
                               real y_min, real y_max,
                               real z_min, real z_max);
 
+int interp3Dcomp_compress_coeff(float* cf, real* c, int n);
+
+void interp3Dcomp_compress_error(real err[3], interp3D_data* str,
+                                 interp3D_data* str_f);
+
 void interp1Dexpl_init_spline(interp1D_data* str, real* c,
                               int n_x, int bc_x,
                               real x_min, real x_max);
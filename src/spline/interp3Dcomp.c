@@ -10,6 +10,16 @@
 #include "interp.h"
 #include "spline.h"
 
+/**
+ * @brief Fetch i:th coefficient from double or single precision storage
+ */
+#define COEFF(i) ( str->cf == NULL ? str->c[i] : (real)str->cf[i] )
+
+/**
+ * @brief Number of z-lines solved together when initializing coefficients
+ */
+#define INTERP3DCOMP_BLOCK 64
+
 /**
  * @brief Calculate tricubic spline interpolation coefficients for 3D data
  *
@@ -67,117 +77,108 @@ int interp3Dcomp_init_coeff(real* c, real* f,
         return 1;
     }
 
-    /* Allocate helper quantities */
-    real* f_x = malloc(n_x*sizeof(real));
-    real* f_y = malloc(n_y*sizeof(real));
-    real* f_z = malloc(n_z*sizeof(real));
-    real* c_x = malloc(n_x*NSIZE_COMP1D*sizeof(real));
-    real* c_y = malloc(n_y*NSIZE_COMP1D*sizeof(real));
-    real* c_z = malloc(n_z*NSIZE_COMP1D*sizeof(real));
-
-    if(f_x == NULL || f_y == NULL || f_z == NULL ||
-       c_x == NULL || c_y == NULL || c_z == NULL) {
-        return 1;
-    }
-
     /* Calculate tricubic spline volume coefficients, i.e. second derivatives.
        For each grid cell (i_x, i_y, i_z), there are eight coefficients:
        [f, fxx, fyy, fzz, fxxyy, fxxzz, fyyzz, fxxyyzz]. Note how we account
-       for normalized grid intervals. */
+       for normalized grid intervals.
+
+       All lines along a given axis share the tridiagonal system, so they are
+       solved together with splinecomp_lines. The xy-slabs, and afterwards the
+       blocks of z-lines, are independent and distributed among threads. */
+    size_t n_xy = (size_t)n_x * n_y;
+    int err = 0;
 
     /* Bicubic spline surfaces over xy-grid for each z */
+    #pragma omp parallel for reduction(|:err)
     for(int i_z=0; i_z<n_z; i_z++) {
+        real* f_s = &f[i_z*n_xy];
+        real* c_s = &c[i_z*n_xy*8];
+        real* buf = malloc(n_xy*sizeof(real));
+        real* D   = malloc(n_xy*sizeof(real));
+        if(buf == NULL || D == NULL) {
+            free(buf);
+            free(D);
+            err = 1;
+            continue;
+        }
 
-        /* Cubic spline along x for each y, using f values to get fxx */
+        /* Cubic spline along x for each y, using f values to get fxx. The
+           slab is transposed so that the lines are contiguous. */
         for(int i_y=0; i_y<n_y; i_y++) {
-            /* fxx */
             for(int i_x=0; i_x<n_x; i_x++) {
-                f_x[i_x] = f[i_z*n_y*n_x + i_y*n_x + i_x];
+                buf[i_x*n_y + i_y] = f_s[i_y*n_x + i_x];
             }
-            splinecomp(f_x, n_x, bc_x, c_x);
+        }
+        splinecomp_lines(buf, n_x, bc_x, n_y, D);
+        for(int i_y=0; i_y<n_y; i_y++) {
             for(int i_x=0; i_x<n_x; i_x++) {
-                c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8    ] = c_x[i_x*2];
-                c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8 + 1] = c_x[i_x*2 + 1]
-                                                           / (x_grid*x_grid);
+                c_s[(i_y*n_x + i_x)*8    ] = f_s[i_y*n_x + i_x];
+                c_s[(i_y*n_x + i_x)*8 + 1] = D[i_x*n_y + i_y]
+                                             / (x_grid*x_grid);
             }
         }
 
         /* Two cubic splines along y for each x, one using f values to
            get fyy, and the other using fxx values to get fxxyy */
-        for(int i_x=0; i_x<n_x; i_x++) {
-            /* fyy */
-            for(int i_y=0; i_y<n_y; i_y++) {
-                f_y[i_y] = f[i_z*n_y*n_x + i_y*n_x + i_x];
-            }
-            splinecomp(f_y, n_y, bc_y, c_y);
-            for(int i_y=0; i_y<n_y; i_y++) {
-                c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8 + 2] = c_y[i_y*2 + 1]
-                                                           / (y_grid*y_grid);
-            }
-            /* fxxyy */
-            for(int i_y=0; i_y<n_y; i_y++) {
-                f_y[i_y] = c[i_z*n_y*n_x*8 + i_y*n_x*8+i_x*8 + 1];
-            }
-            splinecomp(f_y, n_y, bc_y, c_y);
-            for(int i_y=0; i_y<n_y; i_y++) {
-                c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8 + 4] = c_y[i_y*2 + 1]
-                                                           / (y_grid*y_grid);
-            }
+        splinecomp_lines(f_s, n_y, bc_y, n_x, D);
+        for(size_t i=0; i<n_xy; i++) {
+            c_s[i*8 + 2] = D[i] / (y_grid*y_grid);
+            buf[i]       = c_s[i*8 + 1];
+        }
+        splinecomp_lines(buf, n_y, bc_y, n_x, D);
+        for(size_t i=0; i<n_xy; i++) {
+            c_s[i*8 + 4] = D[i] / (y_grid*y_grid);
         }
 
+        free(buf);
+        free(D);
+    }
+    if(err) {
+        return 1;
     }
 
     /* Four cubic splines along z for each xy-pair, one using f values to get
        fzz, one using fxx to get fxxzz, one using fyy to get fyyzz, and one
-       using fxxyy to get fxxyyzz */
-    for(int i_y=0; i_y<n_y; i_y++) {
-        for(int i_x=0; i_x<n_x; i_x++) {
-            /* fzz */
-            for(int i_z=0; i_z<n_z; i_z++) {
-                f_z[i_z] = f[i_z*n_y*n_x + i_y*n_x + i_x];
-            }
-            splinecomp(f_z, n_z, bc_z, c_z);
-            for(int i_z=0; i_z<n_z; i_z++) {
-                c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8 + 3] = c_z[i_z*2 + 1]
-                                                           / (z_grid*z_grid);
-            }
-            /* fxxzz */
-            for(int i_z=0; i_z<n_z; i_z++) {
-                f_z[i_z] = c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8 + 1];
-            }
-            splinecomp(f_z, n_z, bc_z, c_z);
-            for(int i_z=0; i_z<n_z; i_z++) {
-                c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8 + 5] = c_z[i_z*2 + 1]
-                                                           / (z_grid*z_grid);
-            }
-            /* fyyzz */
-            for(int i_z=0; i_z<n_z; i_z++) {
-                f_z[i_z] = c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8 + 2];
-            }
-            splinecomp(f_z, n_z, bc_z, c_z);
-            for(int i_z=0; i_z<n_z; i_z++) {
-                c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8 + 6] = c_z[i_z*2+1]
-                                                           / (z_grid*z_grid);
-            }
-            /* fxxyyzz */
+       using fxxyy to get fxxyyzz. The xy-pairs are processed in blocks of
+       INTERP3DCOMP_BLOCK lines. */
+    const int k_in[4]  = {-1, 1, 2, 4};
+    const int k_out[4] = { 3, 5, 6, 7};
+    size_t n_block = (n_xy + INTERP3DCOMP_BLOCK - 1) / INTERP3DCOMP_BLOCK;
+    #pragma omp parallel for reduction(|:err)
+    for(size_t i_b=0; i_b<n_block; i_b++) {
+        size_t i0 = i_b * INTERP3DCOMP_BLOCK;
+        int m = n_xy - i0 < INTERP3DCOMP_BLOCK ? n_xy - i0 : INTERP3DCOMP_BLOCK;
+        real* buf = malloc(n_z*m*sizeof(real));
+        real* D   = malloc(n_z*m*sizeof(real));
+        if(buf == NULL || D == NULL) {
+            free(buf);
+            free(D);
+            err = 1;
+            continue;
+        }
+
+        for(int k=0; k<4; k++) {
             for(int i_z=0; i_z<n_z; i_z++) {
-                f_z[i_z] = c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8 + 4];
+                for(int j=0; j<m; j++) {
+                    size_t i = i_z*n_xy + i0 + j;
+                    buf[i_z*m + j] = k_in[k] < 0 ? f[i] : c[i*8 + k_in[k]];
+                }
             }
-            splinecomp(f_z, n_z, bc_z, c_z);
+            splinecomp_lines(buf, n_z, bc_z, m, D);
             for(int i_z=0; i_z<n_z; i_z++) {
-                c[i_z*n_y*n_x*8 + i_y*n_x*8 + i_x*8 + 7] = c_z[i_z*2+1]
-                                                           / (z_grid*z_grid);
+                for(int j=0; j<m; j++) {
+                    size_t i = i_z*n_xy + i0 + j;
+                    c[i*8 + k_out[k]] = D[i_z*m + j] / (z_grid*z_grid);
+                }
             }
         }
-    }
 
-    /* Free allocated memory */
-    free(f_x);
-    free(f_y);
-    free(f_z);
-    free(c_x);
-    free(c_y);
-    free(c_z);
+        free(buf);
+        free(D);
+    }
+    if(err) {
+        return 1;
+    }
 
     return 0;
 }
@@ -231,6 +232,77 @@ void interp3Dcomp_init_spline(interp3D_data* str, real* c,
     str->z_max  = z_max;
     str->z_grid = z_grid;
     str->c      = c;
+    str->cf     = NULL;
+}
+
+/**
+ * @brief Convert compact 3D spline coefficients to single precision
+ *
+ * Rounding each coefficient to single precision introduces a relative error
+ * of at most 2^-24 per coefficient. Since the interpolated value is a linear
+ * combination of coefficients, the error in the evaluated value is of the
+ * same relative order with respect to the local magnitude of the data. Use
+ * interp3Dcomp_compress_error() to measure the actual error.
+ *
+ * @param cf allocated array of length n to store the compressed coefficients
+ * @param c coefficients evaluated with interp3Dcomp_init_coeff()
+ * @param n number of coefficients, i.e. n_z*n_y*n_x*8
+ *
+ * @return zero if all coefficients are representable in single precision
+ */
+int interp3Dcomp_compress_coeff(float* cf, real* c, int n) {
+    int err = 0;
+    for(int i = 0; i < n; i++) {
+        cf[i] = (float)c[i];
+        if( !isfinite(cf[i]) && isfinite(c[i]) ) {
+            err = 1;
+        }
+    }
+    return err;
+}
+
+/**
+ * @brief Measure the error caused by single precision coefficients
+ *
+ * Both splines are evaluated at the center of each grid cell (at most ~10^5
+ * cells are sampled with a uniform stride) and the maximum differences are
+ * returned as:
+ * - err[0] = max |f - f_single|
+ * - err[1] = max |grad f - grad f_single| (componentwise)
+ * - err[2] = max |f|
+ *
+ * @param err array where the errors are stored
+ * @param str spline with double precision coefficients
+ * @param str_f the same spline with single precision coefficients
+ */
+void interp3Dcomp_compress_error(real err[3], interp3D_data* str,
+                                 interp3D_data* str_f) {
+    err[0] = 0;
+    err[1] = 0;
+    err[2] = 0;
+
+    int n_cell = str->n_x * str->n_y * str->n_z;
+    int stride = n_cell / 100000 + 1;
+    for(int i = 0; i < n_cell; i += stride) {
+        int i_x = i % str->n_x;
+        int i_y = ( i / str->n_x ) % str->n_y;
+        int i_z = i / ( str->n_x * str->n_y );
+        real x = str->x_min + (i_x + 0.5) * str->x_grid;
+        real y = str->y_min + (i_y + 0.5) * str->y_grid;
+        real z = str->z_min + (i_z + 0.5) * str->z_grid;
+
+        real f_df[10], f_df_f[10];
+        if( interp3Dcomp_eval_df(f_df,   str,   x, y, z) ||
+            interp3Dcomp_eval_df(f_df_f, str_f, x, y, z) ) {
+            /* Last cell on a natural boundary is outside the grid */
+            continue;
+        }
+        err[0] = fmax(err[0], fabs(f_df[0] - f_df_f[0]));
+        for(int k = 1; k < 4; k++) {
+            err[1] = fmax(err[1], fabs(f_df[k] - f_df_f[k]));
+        }
+        err[2] = fmax(err[2], fabs(f_df[0]));
+    }
 }
 
 /**
@@ -326,60 +398,60 @@ a5err interp3Dcomp_eval_f(real* f, interp3D_data* str, real x, real y, real z) {
         /* Evaluate spline value */
         *f = (
             dzi*(
-                dxi*(dyi*str->c[n+0]+dy*str->c[n+y1+0])
-                +dx*(dyi*str->c[n+x1+0]+dy*str->c[n+y1+x1+0]))
+                dxi*(dyi*COEFF(n+0)+dy*COEFF(n+y1+0))
+                +dx*(dyi*COEFF(n+x1+0)+dy*COEFF(n+y1+x1+0)))
             +dz*(
-                dxi*(dyi*str->c[n+z1+0]+dy*str->c[n+y1+z1+0])
-                +dx*(dyi*str->c[n+x1+z1+0]+dy*str->c[n+y1+z1+x1+0])))
+                dxi*(dyi*COEFF(n+z1+0)+dy*COEFF(n+y1+z1+0))
+                +dx*(dyi*COEFF(n+x1+z1+0)+dy*COEFF(n+y1+z1+x1+0))))
             +xg2/6*(
                 dzi*(
-                    dxi3*(dyi*str->c[n+1]+dy*str->c[n+y1+1])
-                    +dx3*(dyi*str->c[n+x1+1]+dy*str->c[n+y1+x1+1]))
+                    dxi3*(dyi*COEFF(n+1)+dy*COEFF(n+y1+1))
+                    +dx3*(dyi*COEFF(n+x1+1)+dy*COEFF(n+y1+x1+1)))
                 +dz*(
-                    dxi3*(dyi*str->c[n+z1+1]+dy*str->c[n+y1+z1+1])
-                    +dx3*(dyi*str->c[n+x1+z1+1]+dy*str->c[n+y1+z1+x1+1])))
+                    dxi3*(dyi*COEFF(n+z1+1)+dy*COEFF(n+y1+z1+1))
+                    +dx3*(dyi*COEFF(n+x1+z1+1)+dy*COEFF(n+y1+z1+x1+1))))
             +yg2/6*(
                 dzi*(
-                    dxi*(dyi3*str->c[n+2]+dy3*str->c[n+y1+2])
-                    +dx*(dyi3*str->c[n+x1+2]+dy3*str->c[n+y1+x1+2]))
+                    dxi*(dyi3*COEFF(n+2)+dy3*COEFF(n+y1+2))
+                    +dx*(dyi3*COEFF(n+x1+2)+dy3*COEFF(n+y1+x1+2)))
                 +dz*(
-                    dxi*(dyi3*str->c[n+z1+2]+dy3*str->c[n+y1+z1+2])
-                    +dx*(dyi3*str->c[n+x1+z1+2]+dy3*str->c[n+y1+z1+x1+2])))
+                    dxi*(dyi3*COEFF(n+z1+2)+dy3*COEFF(n+y1+z1+2))
+                    +dx*(dyi3*COEFF(n+x1+z1+2)+dy3*COEFF(n+y1+z1+x1+2))))
             +zg2/6*(
                 dzi3*(
-                    dxi*(dyi*str->c[n+3]+dy*str->c[n+y1+3])
-                    +dx*(dyi*str->c[n+x1+3]+dy*str->c[n+y1+x1+3]))
+                    dxi*(dyi*COEFF(n+3)+dy*COEFF(n+y1+3))
+                    +dx*(dyi*COEFF(n+x1+3)+dy*COEFF(n+y1+x1+3)))
                 +dz3*(
-                    dxi*(dyi*str->c[n+z1+3]+dy*str->c[n+y1+z1+3])
-                    +dx*(dyi*str->c[n+x1+z1+3]+dy*str->c[n+y1+z1+x1+3])))
+                    dxi*(dyi*COEFF(n+z1+3)+dy*COEFF(n+y1+z1+3))
+                    +dx*(dyi*COEFF(n+x1+z1+3)+dy*COEFF(n+y1+z1+x1+3))))
             +xg2*yg2/36*(
                 dzi*(
-                    dxi3*(dyi3*str->c[n+4]+dy3*str->c[n+y1+4])
-                    +dx3*(dyi3*str->c[n+x1+4]+dy3*str->c[n+y1+x1+4]))
+                    dxi3*(dyi3*COEFF(n+4)+dy3*COEFF(n+y1+4))
+                    +dx3*(dyi3*COEFF(n+x1+4)+dy3*COEFF(n+y1+x1+4)))
                 +dz*(
-                    dxi3*(dyi3*str->c[n+z1+4]+dy3*str->c[n+y1+z1+4])
-                    +dx3*(dyi3*str->c[n+x1+z1+4]+dy3*str->c[n+y1+z1+x1+4])))
+                    dxi3*(dyi3*COEFF(n+z1+4)+dy3*COEFF(n+y1+z1+4))
+                    +dx3*(dyi3*COEFF(n+x1+z1+4)+dy3*COEFF(n+y1+z1+x1+4))))
             +xg2*zg2/36*(
                 dzi3*(
-                    dxi3*(dyi*str->c[n+5]+dy*str->c[n+y1+5])
-                    +dx3*(dyi*str->c[n+x1+5]+dy*str->c[n+y1+x1+5]))
+                    dxi3*(dyi*COEFF(n+5)+dy*COEFF(n+y1+5))
+                    +dx3*(dyi*COEFF(n+x1+5)+dy*COEFF(n+y1+x1+5)))
                 +dz3*(
-                    dxi3*(dyi*str->c[n+z1+5]+dy*str->c[n+y1+z1+5])
-                    +dx3*(dyi*str->c[n+x1+z1+5]+dy*str->c[n+y1+z1+x1+5])))
+                    dxi3*(dyi*COEFF(n+z1+5)+dy*COEFF(n+y1+z1+5))
+                    +dx3*(dyi*COEFF(n+x1+z1+5)+dy*COEFF(n+y1+z1+x1+5))))
             +yg2*zg2/36*(
                 dzi3*(
-                    dxi*(dyi3*str->c[n+6]+dy3*str->c[n+y1+6])
-                    +dx*(dyi3*str->c[n+x1+6]+dy3*str->c[n+y1+x1+6]))
+                    dxi*(dyi3*COEFF(n+6)+dy3*COEFF(n+y1+6))
+                    +dx*(dyi3*COEFF(n+x1+6)+dy3*COEFF(n+y1+x1+6)))
                 +dz3*(
-                    dxi*(dyi3*str->c[n+z1+6]+dy3*str->c[n+y1+z1+6])
-                    +dx*(dyi3*str->c[n+x1+z1+6]+dy3*str->c[n+y1+z1+x1+6])))
+                    dxi*(dyi3*COEFF(n+z1+6)+dy3*COEFF(n+y1+z1+6))
+                    +dx*(dyi3*COEFF(n+x1+z1+6)+dy3*COEFF(n+y1+z1+x1+6))))
             +xg2*yg2*zg2/216*(
                 dzi3*(
-                    dxi3*(dyi3*str->c[n+7]+dy3*str->c[n+y1+7])
-                    +dx3*(dyi3*str->c[n+x1+7]+dy3*str->c[n+y1+x1+7]))
+                    dxi3*(dyi3*COEFF(n+7)+dy3*COEFF(n+y1+7))
+                    +dx3*(dyi3*COEFF(n+x1+7)+dy3*COEFF(n+y1+x1+7)))
                 +dz3*(
-                    dxi3*(dyi3*str->c[n+z1+7]+dy3*str->c[n+y1+z1+7])
-                    +dx3*(dyi3*str->c[n+x1+z1+7]+dy3*str->c[n+y1+z1+x1+7])));
+                    dxi3*(dyi3*COEFF(n+z1+7)+dy3*COEFF(n+y1+z1+7))
+                    +dx3*(dyi3*COEFF(n+x1+z1+7)+dy3*COEFF(n+y1+z1+x1+7))));
 
     }
 
@@ -507,77 +579,77 @@ a5err interp3Dcomp_eval_df(real* f_df, interp3D_data* str,
            will be used multiple times. This is to decrease computational time,
            by exploiting simultaneous extraction of adjacent memory and by
            avoiding going through the long str->c array repeatedly. */
-        real c0000 = str->c[n+0];
-        real c0001 = str->c[n+1];
-        real c0002 = str->c[n+2];
-        real c0003 = str->c[n+3];
-        real c0004 = str->c[n+4];
-        real c0005 = str->c[n+5];
-        real c0006 = str->c[n+6];
-        real c0007 = str->c[n+7];
-
-        real c0010 = str->c[n+x1+0];
-        real c0011 = str->c[n+x1+1];
-        real c0012 = str->c[n+x1+2];
-        real c0013 = str->c[n+x1+3];
-        real c0014 = str->c[n+x1+4];
-        real c0015 = str->c[n+x1+5];
-        real c0016 = str->c[n+x1+6];
-        real c0017 = str->c[n+x1+7];
-
-        real c0100 = str->c[n+y1+0];
-        real c0101 = str->c[n+y1+1];
-        real c0102 = str->c[n+y1+2];
-        real c0103 = str->c[n+y1+3];
-        real c0104 = str->c[n+y1+4];
-        real c0105 = str->c[n+y1+5];
-        real c0106 = str->c[n+y1+6];
-        real c0107 = str->c[n+y1+7];
-
-        real c1000 = str->c[n+z1+0];
-        real c1001 = str->c[n+z1+1];
-        real c1002 = str->c[n+z1+2];
-        real c1003 = str->c[n+z1+3];
-        real c1004 = str->c[n+z1+4];
-        real c1005 = str->c[n+z1+5];
-        real c1006 = str->c[n+z1+6];
-        real c1007 = str->c[n+z1+7];
-
-        real c0110 = str->c[n+y1+x1+0];
-        real c0111 = str->c[n+y1+x1+1];
-        real c0112 = str->c[n+y1+x1+2];
-        real c0113 = str->c[n+y1+x1+3];
-        real c0114 = str->c[n+y1+x1+4];
-        real c0115 = str->c[n+y1+x1+5];
-        real c0116 = str->c[n+y1+x1+6];
-        real c0117 = str->c[n+y1+x1+7];
-
-        real c1010 = str->c[n+z1+x1+0];
-        real c1011 = str->c[n+z1+x1+1];
-        real c1012 = str->c[n+z1+x1+2];
-        real c1013 = str->c[n+z1+x1+3];
-        real c1014 = str->c[n+z1+x1+4];
-        real c1015 = str->c[n+z1+x1+5];
-        real c1016 = str->c[n+z1+x1+6];
-        real c1017 = str->c[n+z1+x1+7];
-
-        real c1100 = str->c[n+z1+y1+0];
-        real c1101 = str->c[n+z1+y1+1];
-        real c1102 = str->c[n+z1+y1+2];
-        real c1103 = str->c[n+z1+y1+3];
-        real c1104 = str->c[n+z1+y1+4];
-        real c1105 = str->c[n+z1+y1+5];
-        real c1106 = str->c[n+z1+y1+6];
-        real c1107 = str->c[n+z1+y1+7];
-
-        real c1110 = str->c[n+z1+y1+x1+0];
-        real c1111 = str->c[n+z1+y1+x1+1];
-        real c1112 = str->c[n+z1+y1+x1+2];
-        real c1113 = str->c[n+z1+y1+x1+3];
-        real c1114 = str->c[n+z1+y1+x1+4];
-        real c1115 = str->c[n+z1+y1+x1+5];
-        real c1116 = str->c[n+z1+y1+x1+6];
-        real c1117 = str->c[n+z1+y1+x1+7];
+        real c0000 = COEFF(n+0);
+        real c0001 = COEFF(n+1);
+        real c0002 = COEFF(n+2);
+        real c0003 = COEFF(n+3);
+        real c0004 = COEFF(n+4);
+        real c0005 = COEFF(n+5);
+        real c0006 = COEFF(n+6);
+        real c0007 = COEFF(n+7);
+
+        real c0010 = COEFF(n+x1+0);
+        real c0011 = COEFF(n+x1+1);
+        real c0012 = COEFF(n+x1+2);
+        real c0013 = COEFF(n+x1+3);
+        real c0014 = COEFF(n+x1+4);
+        real c0015 = COEFF(n+x1+5);
+        real c0016 = COEFF(n+x1+6);
+        real c0017 = COEFF(n+x1+7);
+
+        real c0100 = COEFF(n+y1+0);
+        real c0101 = COEFF(n+y1+1);
+        real c0102 = COEFF(n+y1+2);
+        real c0103 = COEFF(n+y1+3);
+        real c0104 = COEFF(n+y1+4);
+        real c0105 = COEFF(n+y1+5);
+        real c0106 = COEFF(n+y1+6);
+        real c0107 = COEFF(n+y1+7);
+
+        real c1000 = COEFF(n+z1+0);
+        real c1001 = COEFF(n+z1+1);
+        real c1002 = COEFF(n+z1+2);
+        real c1003 = COEFF(n+z1+3);
+        real c1004 = COEFF(n+z1+4);
+        real c1005 = COEFF(n+z1+5);
+        real c1006 = COEFF(n+z1+6);
+        real c1007 = COEFF(n+z1+7);
+
+        real c0110 = COEFF(n+y1+x1+0);
+        real c0111 = COEFF(n+y1+x1+1);
+        real c0112 = COEFF(n+y1+x1+2);
+        real c0113 = COEFF(n+y1+x1+3);
+        real c0114 = COEFF(n+y1+x1+4);
+        real c0115 = COEFF(n+y1+x1+5);
+        real c0116 = COEFF(n+y1+x1+6);
+        real c0117 = COEFF(n+y1+x1+7);
+
+        real c1010 = COEFF(n+z1+x1+0);
+        real c1011 = COEFF(n+z1+x1+1);
+        real c1012 = COEFF(n+z1+x1+2);
+        real c1013 = COEFF(n+z1+x1+3);
+        real c1014 = COEFF(n+z1+x1+4);
+        real c1015 = COEFF(n+z1+x1+5);
+        real c1016 = COEFF(n+z1+x1+6);
+        real c1017 = COEFF(n+z1+x1+7);
+
+        real c1100 = COEFF(n+z1+y1+0);
+        real c1101 = COEFF(n+z1+y1+1);
+        real c1102 = COEFF(n+z1+y1+2);
+        real c1103 = COEFF(n+z1+y1+3);
+        real c1104 = COEFF(n+z1+y1+4);
+        real c1105 = COEFF(n+z1+y1+5);
+        real c1106 = COEFF(n+z1+y1+6);
+        real c1107 = COEFF(n+z1+y1+7);
+
+        real c1110 = COEFF(n+z1+y1+x1+0);
+        real c1111 = COEFF(n+z1+y1+x1+1);
+        real c1112 = COEFF(n+z1+y1+x1+2);
+        real c1113 = COEFF(n+z1+y1+x1+3);
+        real c1114 = COEFF(n+z1+y1+x1+4);
+        real c1115 = COEFF(n+z1+y1+x1+5);
+        real c1116 = COEFF(n+z1+y1+x1+6);
+        real c1117 = COEFF(n+z1+y1+x1+7);
 
         /* Evaluate spline values */
 
@@ -181,6 +181,7 @@ void interp3Dexpl_init_spline(interp3D_data* str, real* c,
     str->z_max  = z_max;
     str->z_grid = z_grid;
     str->c      = c;
+    str->cf     = NULL;
 }
 
 /**
@@ -8,4 +8,5 @@
 
 void splineexpl(real* f, int n, int bc, real* c);
 void splinecomp(real* f, int n, int bc, real* c);
+void splinecomp_lines(real* f, int n, int bc, int m, real* D);
 #endif
@@ -128,3 +128,131 @@ void splinecomp(real* f, int n, int bc, real* c) {
     free(p);
     free(D);
 }
+
+/**
+ * @brief Calculate second derivatives of several compact cubic splines at once
+ *
+ * Solves the same tridiagonal system as splinecomp() for m data sets that
+ * share the number of points and the boundary condition. The elimination
+ * factors depend only on these, so they are evaluated once and the lines are
+ * processed together in SIMD loops. The data is stored so that the values of
+ * all lines at a given point are contiguous, i.e. the value of line j at point
+ * i is f[i*m + j]. The arithmetic per line is identical to that of
+ * splinecomp(), so are the results.
+ *
+ * @param f data to be interpolated, n*m values
+ * @param n number of data points on each line
+ * @param bc boundary condition flag
+ * @param m number of lines
+ * @param D array of length n*m where the second derivatives are stored in
+ *        the same layout as f
+ */
+void splinecomp_lines(real* f, int n, int bc, int m, real* D) {
+
+    /* Elimination factors (superdiagonal and right column values) */
+    real* p = malloc(n*sizeof(real));
+    real* r = malloc(n*sizeof(real));
+
+    /* The right hand side is stored in D and solved in place */
+    real* Y = D;
+
+    if(bc == NATURALBC) {
+        /* Initialize RHS of equation */
+        #pragma omp simd
+        for(int j=0; j<m; j++) {
+            Y[j]         = 0.0;
+            Y[(n-1)*m+j] = 0.0;
+        }
+        for(int i=1; i<n-1; i++) {
+            #pragma omp simd
+            for(int j=0; j<m; j++) {
+                Y[i*m+j] = 6 * (f[(i+1)*m+j] - 2 * f[i*m+j] + f[(i-1)*m+j]);
+            }
+        }
+
+        /* Forward sweep */
+        p[0] = 0.0;
+        #pragma omp simd
+        for(int j=0; j<m; j++) {
+            Y[j] = Y[j] / 2;
+        }
+        for(int i=1; i<n-1; i++) {
+            p[i] = 1 / (4 - p[i-1]);
+            #pragma omp simd
+            for(int j=0; j<m; j++) {
+                Y[i*m+j] = (Y[i*m+j] - Y[(i-1)*m+j]) / (4 - p[i-1]);
+            }
+        }
+
+        /* Back substitution, D[n-1] = Y[n-1] = 0 */
+        for(int i=n-2; i>-1; i--) {
+            #pragma omp simd
+            for(int j=0; j<m; j++) {
+                D[i*m+j] = Y[i*m+j] - p[i] * D[(i+1)*m+j];
+            }
+        }
+    }
+    else if(bc == PERIODICBC) {
+        real l     = 1.0;
+        real dlast = 4.0;
+        real blast;
+
+        /* Initialize RHS of equation */
+        #pragma omp simd
+        for(int j=0; j<m; j++) {
+            Y[j]         = 6 * (f[m+j] - 2 * f[j] + f[(n-1)*m+j]);
+            Y[(n-1)*m+j] = 6 * (f[j] - 2 * f[(n-1)*m+j] + f[(n-2)*m+j]);
+        }
+        for(int i=1; i<n-1; i++) {
+            #pragma omp simd
+            for(int j=0; j<m; j++) {
+                Y[i*m+j] = 6 * (f[(i+1)*m+j] - 2 * f[i*m+j] + f[(i-1)*m+j]);
+            }
+        }
+
+        /* Forward sweep */
+        p[0] = 1.0 / 4;
+        r[0] = 1.0 / 4;
+        #pragma omp simd
+        for(int j=0; j<m; j++) {
+            Y[j] = Y[j] / 4;
+        }
+        for(int i=1; i<n-2; i++) {
+            dlast = dlast - l * r[i-1];
+            #pragma omp simd
+            for(int j=0; j<m; j++) {
+                Y[(n-1)*m+j] = Y[(n-1)*m+j] - l * Y[(i-1)*m+j];
+                Y[i*m+j]     = (Y[i*m+j] - Y[(i-1)*m+j]) / (4 - p[i-1]);
+            }
+            l    = -l * p[i-1];
+            p[i] =       1 / (4 - p[i-1]);
+            r[i] = -r[i-1] / (4 - p[i-1]);
+        }
+        blast = 1.0 - l * p[n-3];
+        dlast = dlast - l * r[n-3];
+        p[n-2] = (1 - r[n-3]) / (4 - p[n-3]);
+        #pragma omp simd
+        for(int j=0; j<m; j++) {
+            Y[(n-1)*m+j] = Y[(n-1)*m+j] - l * Y[(n-3)*m+j];
+            Y[(n-2)*m+j] = (Y[(n-2)*m+j] - Y[(n-3)*m+j]) / (4 - p[n-3]);
+            Y[(n-1)*m+j] = (Y[(n-1)*m+j] - blast * Y[(n-2)*m+j])
+                / (dlast - blast * p[n-2]);
+        }
+
+        /* Back substitution */
+        #pragma omp simd
+        for(int j=0; j<m; j++) {
+            D[(n-2)*m+j] = Y[(n-2)*m+j] - p[n-2] * D[(n-1)*m+j];
+        }
+        for(int i=n-3; i>-1; i--) {
+            #pragma omp simd
+            for(int j=0; j<m; j++) {
+                D[i*m+j] = Y[i*m+j] - p[i] * D[(i+1)*m+j]
+                    - r[i] * D[(n-1)*m+j];
+            }
+        }
+    }
+
+    free(p);
+    free(r);
+}
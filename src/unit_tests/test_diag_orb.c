@@ -119,6 +119,8 @@ int test_update_gc(){
     real offload_array[nData];
     real correct, got;
     particle_simd_gc p_f, p_i;
+    p_f.n_mrk = NSIMD;
+    p_i.n_mrk = NSIMD;
 
     printf("Testing update_gc in poincare mode for radial steps.\n");
 
@@ -0,0 +1,134 @@
+/**
+ * @file test_interp3Dsingle.c
+ * @brief Test and benchmark single precision tricubic spline coefficients
+ *
+ * Constructs a tricubic spline on a large grid, compresses its coefficients to
+ * single precision, and checks that the interpolation error stays within
+ * INTERP_SINGLE_PRECISION_TOL. Then both splines are evaluated at random
+ * points and the evaluation times are compared. The grid is large enough that
+ * the evaluations are dominated by cache misses, so the single precision
+ * spline should be faster as it fetches half the data.
+ *
+ * Make (compile) and run from ascot5/ folder by:
+ *     >> make test_interp3Dsingle
+ *     >> ./test_interp3Dsingle [n_grid]
+ *
+ * where n_grid is the number of grid points in R and z (default 200, phi uses
+ * n_grid/4). Returns non-zero value if the error check fails.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <omp.h>
+#include "../ascot5.h"
+#include "../consts.h"
+#include "../spline/interp.h"
+
+/**
+ * @brief Evaluate splines at given points and return time per evaluation
+ */
+double time_eval(interp3D_data* str, int n, real* x, real* y, real* z,
+                 real* sum) {
+    double best = 1e30;
+    for(int rep = 0; rep < 5; rep++) {
+        double t0 = A5_WTIME;
+        #pragma omp parallel for reduction(+:sum[0])
+        for(int i = 0; i < n; i++) {
+            real f_df[10];
+            interp3Dcomp_eval_df(f_df, str, x[i], y[i], z[i]);
+            sum[0] += f_df[0];
+        }
+        double t1 = A5_WTIME;
+        best = fmin(best, t1 - t0);
+    }
+    return best / n;
+}
+
+/**
+ * @brief Main function
+ */
+int main(int argc, char** argv) {
+    int n_x = argc > 1 ? atoi(argv[1]) : 200;
+    int n_y = n_x / 4;
+    int n_z = n_x;
+    int n_rnd = 1000000;
+    real x_min = 1.0, x_max = 3.0;
+    real y_min = 0.0, y_max = 2*CONST_PI;
+    real z_min = -1.0, z_max = 1.0;
+
+    /* Smooth test data with some structure in all directions */
+    size_t n_data = (size_t)n_x * n_y * n_z;
+    real* f = malloc(n_data * sizeof(real));
+    for(int k = 0; k < n_z; k++) {
+        for(int j = 0; j < n_y; j++) {
+            for(int i = 0; i < n_x; i++) {
+                real x = x_min + i * (x_max - x_min) / (n_x - 1);
+                real y = y_min + j * (y_max - y_min) / n_y;
+                real z = z_min + k * (z_max - z_min) / (n_z - 1);
+                f[(size_t)k*n_y*n_x + j*n_x + i] =
+                    5.0 / x + 0.1 * sin(5*x) * cos(3*y) * exp(-z*z);
+            }
+        }
+    }
+
+    real* c   = malloc(NSIZE_COMP3D * n_data * sizeof(real));
+    float* cf = malloc(NSIZE_COMP3D * n_data * sizeof(float));
+    if( interp3Dcomp_init_coeff(c, f, n_x, n_y, n_z,
+                                NATURALBC, PERIODICBC, NATURALBC,
+                                x_min, x_max, y_min, y_max, z_min, z_max) ) {
+        printf("Failed to initialize splines\n");
+        return 1;
+    }
+    free(f);
+    if( interp3Dcomp_compress_coeff(cf, c, NSIZE_COMP3D * n_data) ) {
+        printf("Failed to compress coefficients\n");
+        return 1;
+    }
+
+    interp3D_data str, str_f;
+    interp3Dcomp_init_spline(&str, c, n_x, n_y, n_z,
+                             NATURALBC, PERIODICBC, NATURALBC,
+                             x_min, x_max, y_min, y_max, z_min, z_max);
+    str_f    = str;
+    str_f.c  = NULL;
+    str_f.cf = cf;
+
+    /* Error check */
+    real err[3];
+    interp3Dcomp_compress_error(err, &str, &str_f);
+    printf("Grid %d x %d x %d, coefficients %.1f MB (double) %.1f MB "
+           "(single)\n", n_x, n_y, n_z,
+           NSIZE_COMP3D * n_data * sizeof(real) / (1024.0*1024.0),
+           NSIZE_COMP3D * n_data * sizeof(float) / (1024.0*1024.0));
+    printf("Max error: value %.3e (relative %.3e) derivatives %.3e\n",
+           err[0], err[0] / err[2], err[1]);
+    int fail = err[0] > INTERP_SINGLE_PRECISION_TOL * err[2];
+
+    /* Benchmark at random points */
+    real* x = malloc(n_rnd * sizeof(real));
+    real* y = malloc(n_rnd * sizeof(real));
+    real* z = malloc(n_rnd * sizeof(real));
+    srand(1);
+    for(int i = 0; i < n_rnd; i++) {
+        x[i] = x_min + (x_max - x_min) * rand() / RAND_MAX;
+        y[i] = y_min + (y_max - y_min) * rand() / RAND_MAX;
+        z[i] = z_min + (z_max - z_min) * rand() / RAND_MAX;
+    }
+    real sum[1] = {0};
+    double t_double = time_eval(&str,   n_rnd, x, y, z, sum);
+    double t_single = time_eval(&str_f, n_rnd, x, y, z, sum);
+    printf("Threads %d, time per evaluation: %.1f ns (double) %.1f ns "
+           "(single) speedup %.2f\n", omp_get_max_threads(),
+           t_double*1e9, t_single*1e9, t_double / t_single);
+
+    free(x);
+    free(y);
+    free(z);
+    free(c);
+    free(cf);
+
+    if(fail) {
+        printf("FAILED: error exceeds tolerance\n");
+    }
+    return fail;
+}
@@ -13,10 +13,23 @@ int main(int argc, char** argv) {
     real wall_z[] = {-4.25, -4.25, -3.5, -1.1, 1.75, 2.5, 3.6, 3.6, 2.4, -1.5,
         -3.25, -4.25};
 
-    wall_2d_data wdata;
-    wdata.n = 12;
-    wdata.wall_r = wall_r;
-    wdata.wall_z = wall_z;
+    wall_2d_offload_data offload_data;
+    offload_data.n = 12;
+    offload_data.offload_array_length = 2 * offload_data.n;
+    real* offload_array = malloc(offload_data.offload_array_length
+                                 * sizeof(real));
+    int* int_offload_array;
+    for(int i = 0; i < offload_data.n; i++) {
+        offload_array[i] = wall_r[i];
+        offload_array[offload_data.n + i] = wall_z[i];
+    }
+    wall_2d_init_offload(&offload_data, &offload_array, &int_offload_array);
+
+    /* The search grid is compared against checking every wall segment */
+    wall_2d_data wdata, wdata_nogrid;
+    wall_2d_init(&wdata, &offload_data, offload_array, int_offload_array);
+    wdata_nogrid = wdata;
+    wdata_nogrid.n_r = 0;
 
     srand(0);
 
@@ -25,13 +38,31 @@ int main(int argc, char** argv) {
     real zmin = -6;
     real zmax = 6;
 
-    int i;
+    int i, failed = 0;
     for(i = 0; i < 1000; i++) {
         real r = ((real)rand()/(real)RAND_MAX)*(rmax-rmin) + rmin;
         real z = ((real)rand()/(real)RAND_MAX)*(zmax-zmin) + zmin;
         int inside = wall_2d_inside(r, z, &wdata);
         printf("%lf, %lf, %d\n", r, z, inside);
+        failed += inside != wall_2d_inside(r, z, &wdata_nogrid);
+    }
+
+    for(i = 0; i < 1000; i++) {
+        real r1 = ((real)rand()/(real)RAND_MAX)*(rmax-rmin) + rmin;
+        real z1 = ((real)rand()/(real)RAND_MAX)*(zmax-zmin) + zmin;
+        real r2 = r1 + ((real)rand()/(real)RAND_MAX - 0.5);
+        real z2 = z1 + ((real)rand()/(real)RAND_MAX - 0.5);
+        real w, w_nogrid;
+        int tile = wall_2d_find_intersection(r1, z1, r2, z2, &wdata, &w);
+        int tile_nogrid = wall_2d_find_intersection(r1, z1, r2, z2,
+                                                    &wdata_nogrid, &w_nogrid);
+        failed += tile != tile_nogrid || (tile > 0 && w != w_nogrid);
     }
 
+    wall_2d_free_offload(&offload_data, &offload_array, &int_offload_array);
+    if(failed) {
+        printf("Search grid and full search differ in %d cases\n", failed);
+        return 1;
+    }
     return 0;
 }
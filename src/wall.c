@@ -12,15 +12,35 @@
  * The interface checks which instance given data corresponds to from the
  * "type"-field in wall_offload_data or wall_data that is given as an
  * argument, and calls the relevant function for that instance.
+ *
+ * Most markers are far from the wall for most of their time-steps. To avoid
+ * the exact collision check for those, a coarse distance map is evaluated at
+ * initialization. The map covers the wall with a uniform grid in (x, y, z)
+ * for 3D walls and in (R, z) for 2D walls, and each cell stores a lower bound
+ * for the distance from any point in the cell to the wall (clearance). A
+ * segment whose length is below the clearance at its starting point cannot
+ * hit the wall, so wall_hit_wall() returns immediately. The result is the same
+ * as with the exact check.
+ *
+ * The clearance is found by marking every cell a wall element passes through,
+ * evaluating the Euclidean distance transform of the marked cells, and
+ * subtracting the cell diagonal from the distance between cell centers.
  */
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
 #include "ascot5.h"
+#include "math.h"
 #include "print.h"
 #include "wall.h"
 #include "wall/wall_2d.h"
 #include "wall/wall_3d.h"
 
+/** Squared distance [cells^2] of cells that have no wall within the map */
+#define WALL_DMAP_FAR 1e12
+
+int wall_init_dmap(wall_offload_data* offload_data, real** offload_array);
+
 /**
  * @brief Load wall data and prepare parameters
  *
@@ -47,10 +67,12 @@ int wall_init_offload(wall_offload_data* offload_data, real** offload_array,
     switch(offload_data->type) {
 
         case wall_type_2D:
-            err = wall_2d_init_offload(&(offload_data->w2d), offload_array);
+            err = wall_2d_init_offload(&(offload_data->w2d), offload_array,
+                                       int_offload_array);
             offload_data->offload_array_length =
                 offload_data->w2d.offload_array_length;
-            offload_data->int_offload_array_length = 0;
+            offload_data->int_offload_array_length =
+                offload_data->w2d.int_offload_array_length;
             break;
 
         case wall_type_3D:
@@ -68,6 +90,9 @@ int wall_init_offload(wall_offload_data* offload_data, real** offload_array,
             err = 1;
             break;
     }
+    if(!err) {
+        err = wall_init_dmap(offload_data, offload_array);
+    }
     if(!err) {
         print_out(VERBOSE_IO, "Estimated memory usage %.1f MB\n",
                   offload_data->offload_array_length
@@ -92,7 +117,8 @@ void wall_free_offload(wall_offload_data* offload_data, real** offload_array,
                        int** int_offload_array) {
     switch(offload_data->type) {
         case wall_type_2D:
-            wall_2d_free_offload(&(offload_data->w2d), offload_array);
+            wall_2d_free_offload(&(offload_data->w2d), offload_array,
+                                 int_offload_array);
             break;
 
         case wall_type_3D:
@@ -119,14 +145,18 @@ void wall_free_offload(wall_offload_data* offload_data, real** offload_array,
 int wall_init(wall_data* w, wall_offload_data* offload_data,
               real* offload_array, int* int_offload_array) {
     int err = 0;
+    int dmap_offset = 0;
     switch(offload_data->type) {
         case wall_type_2D:
-            wall_2d_init(&(w->w2d), &(offload_data->w2d), offload_array);
+            wall_2d_init(&(w->w2d), &(offload_data->w2d), offload_array,
+                         int_offload_array);
+            dmap_offset = offload_data->w2d.offload_array_length;
             break;
 
         case wall_type_3D:
             wall_3d_init(&(w->w3d), &(offload_data->w3d), offload_array,
                          int_offload_array);
+            dmap_offset = offload_data->w3d.offload_array_length;
             break;
         default:
             /* Unregonized input. Produce error. */
@@ -135,6 +165,17 @@ int wall_init(wall_data* w, wall_offload_data* offload_data,
     }
     w->type = offload_data->type;
 
+    /* The distance map follows the model data in the offload array */
+    w->dmap = NULL;
+    if(offload_data->dmap_n[0] > 0) {
+        w->dmap = &(offload_array[dmap_offset]);
+    }
+    for(int i = 0; i < 3; i++) {
+        w->dmap_n[i]   = offload_data->dmap_n[i];
+        w->dmap_min[i] = offload_data->dmap_min[i];
+    }
+    w->dmap_h = offload_data->dmap_h;
+
     return err;
 }
 
@@ -163,6 +204,38 @@ int wall_init(wall_data* w, wall_offload_data* offload_data,
 int wall_hit_wall(real r1, real phi1, real z1, real r2, real phi2, real z2,
                   wall_data* w, real* w_coll) {
     int ret = 0;
+
+    /* No collision is possible if the segment is shorter than the clearance
+     * at its starting point */
+    if(w->dmap != NULL) {
+        real p1[3], ds2;
+        if(w->type == wall_type_2D) {
+            p1[0] = r1;
+            p1[1] = w->dmap_min[1];
+            p1[2] = z1;
+            ds2 = (r2 - r1) * (r2 - r1) + (z2 - z1) * (z2 - z1);
+        }
+        else {
+            real rpz1[3] = {r1, phi1, z1}, rpz2[3] = {r2, phi2, z2}, p2[3];
+            math_rpz2xyz(rpz1, p1);
+            math_rpz2xyz(rpz2, p2);
+            ds2 = (p2[0] - p1[0]) * (p2[0] - p1[0])
+                + (p2[1] - p1[1]) * (p2[1] - p1[1])
+                + (p2[2] - p1[2]) * (p2[2] - p1[2]);
+        }
+        int i[3];
+        for(int k = 0; k < 3; k++) {
+            i[k] = (int) floor( (p1[k] - w->dmap_min[k]) / w->dmap_h );
+        }
+        if( i[0] >= 0 && i[0] < w->dmap_n[0] && i[1] >= 0
+            && i[1] < w->dmap_n[1] && i[2] >= 0 && i[2] < w->dmap_n[2] ) {
+            real c = w->dmap[(i[0]*w->dmap_n[1] + i[1])*w->dmap_n[2] + i[2]];
+            if(ds2 < c * c) {
+                return 0;
+            }
+        }
+    }
+
     switch(w->type) {
         case wall_type_2D:
             ret = wall_2d_hit_wall(r1, phi1, z1, r2, phi2, z2, &(w->w2d),
@@ -197,3 +270,287 @@ int wall_get_n_elements(wall_data* w) {
     }
     return ret;
 }
+
+/**
+ * @brief Get unit normal vector of a wall element
+ *
+ * @param n pointer to array where normal [n_r, n_phi, n_z] is stored
+ * @param tile index of the wall element (as returned by wall_hit_wall)
+ * @param phi toroidal angle where the normal is evaluated [rad]
+ * @param w pointer to wall data struct on target
+ */
+void wall_get_normal(real n[3], int tile, real phi, wall_data* w) {
+    switch(w->type) {
+        case wall_type_2D:
+            wall_2d_get_normal(n, tile, &(w->w2d));
+            break;
+
+        case wall_type_3D:
+            wall_3d_get_normal(n, tile, phi, &(w->w3d));
+            break;
+    }
+}
+
+/**
+ * @brief Mark distance map cells that overlap a box
+ *
+ * @param d distance map
+ * @param n number of cells along each axis
+ * @param min corner of the distance map grid [m]
+ * @param h cell width [m]
+ * @param lo lower corner of the box [m]
+ * @param hi upper corner of the box [m]
+ */
+static void wall_dmap_mark(real* d, int n[3], real min[3], real h, real lo[3],
+                           real hi[3]) {
+    int i0[3], i1[3];
+    for(int k = 0; k < 3; k++) {
+        i0[k] = (int) floor( (lo[k] - min[k]) / h );
+        i1[k] = (int) floor( (hi[k] - min[k]) / h );
+        i0[k] = i0[k] < 0 ? 0 : i0[k];
+        i1[k] = i1[k] > n[k] - 1 ? n[k] - 1 : i1[k];
+    }
+    for(int i = i0[0]; i <= i1[0]; i++) {
+        for(int j = i0[1]; j <= i1[1]; j++) {
+            for(int k = i0[2]; k <= i1[2]; k++) {
+                d[(i*n[1] + j)*n[2] + k] = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Squared Euclidean distance transform along one grid line
+ *
+ * The lower envelope of parabolas rooted at each point (Felzenszwalb and
+ * Huttenlocher) is constructed in linear time.
+ *
+ * @param f squared distances which are updated in place, f[i*stride]
+ * @param n number of points on the line
+ * @param stride distance between consecutive points in f
+ * @param g work array of length n
+ * @param v work array of length n
+ * @param zv work array of length n+1
+ */
+static void wall_dmap_edt(real* f, int n, int stride, real* g, int* v,
+                          real* zv) {
+    for(int q = 0; q < n; q++) {
+        g[q] = f[q*stride];
+    }
+
+    int k = 0;
+    v[0]  = 0;
+    zv[0] = -INFINITY;
+    zv[1] =  INFINITY;
+    for(int q = 1; q < n; q++) {
+        real s = ( (g[q] + q*q) - (g[v[k]] + v[k]*v[k]) ) / ( 2*q - 2*v[k] );
+        while(s <= zv[k]) {
+            k--;
+            s = ( (g[q] + q*q) - (g[v[k]] + v[k]*v[k]) ) / ( 2*q - 2*v[k] );
+        }
+        k++;
+        v[k]    = q;
+        zv[k]   = s;
+        zv[k+1] = INFINITY;
+    }
+
+    k = 0;
+    for(int q = 0; q < n; q++) {
+        while(zv[k+1] < q) {
+            k++;
+        }
+        f[q*stride] = (q - v[k]) * (q - v[k]) + g[v[k]];
+    }
+}
+
+/**
+ * @brief Evaluate the wall distance map and append it to the offload array
+ *
+ * The grid covers the wall with WALL_DMAP_NCELL cubic (3D) or square (2D)
+ * cells and one cell of padding on each side. The clearance in a cell is a
+ * lower bound for the distance from any point in the cell to the wall.
+ * Points outside the grid have no clearance.
+ *
+ * This function is host only.
+ *
+ * @param offload_data pointer to offload data struct whose model specific
+ *        data has been initialized
+ * @param offload_array pointer to offload array which is reallocated here
+ *
+ * @return zero if initialization succeeded
+ */
+int wall_init_dmap(wall_offload_data* offload_data, real** offload_array) {
+    offload_data->dmap_n[0] = 0;
+    offload_data->dmap_n[1] = 0;
+    offload_data->dmap_n[2] = 0;
+    if(WALL_DMAP_NCELL <= 0) {
+        return 0;
+    }
+
+    /* Wall extent and the number of dimensions */
+    int dim = 3, n_elem = 0;
+    real lo[3], hi[3];
+    if(offload_data->type == wall_type_2D) {
+        dim = 2;
+        n_elem = offload_data->w2d.n;
+        real* wr = *offload_array;
+        real* wz = *offload_array + n_elem;
+        lo[0] = wr[0]; hi[0] = wr[0];
+        lo[2] = wz[0]; hi[2] = wz[0];
+        for(int i = 0; i < n_elem; i++) {
+            lo[0] = fmin(lo[0], wr[i]);
+            hi[0] = fmax(hi[0], wr[i]);
+            lo[2] = fmin(lo[2], wz[i]);
+            hi[2] = fmax(hi[2], wz[i]);
+        }
+        lo[1] = 0;
+        hi[1] = 0;
+    }
+    else {
+        n_elem = offload_data->w3d.n;
+        lo[0] = offload_data->w3d.xmin; hi[0] = offload_data->w3d.xmax;
+        lo[1] = offload_data->w3d.ymin; hi[1] = offload_data->w3d.ymax;
+        lo[2] = offload_data->w3d.zmin; hi[2] = offload_data->w3d.zmax;
+    }
+    real vol = (hi[0] - lo[0]) * (hi[2] - lo[2]);
+    if(dim == 3) {
+        vol *= hi[1] - lo[1];
+    }
+    real h = pow(vol / WALL_DMAP_NCELL, 1.0 / dim);
+    if(n_elem < 2 || !(h > 0)) {
+        return 0;
+    }
+
+    int n[3];
+    real min[3];
+    for(int k = 0; k < 3; k++) {
+        n[k]   = (int) ceil( (hi[k] - lo[k]) / h ) + 2;
+        min[k] = lo[k] - h;
+    }
+    if(dim == 2) {
+        n[1]   = 1;
+        min[1] = 0;
+    }
+    size_t n_cell = (size_t)n[0] * n[1] * n[2];
+    int length = offload_data->offload_array_length;
+    real* arr = realloc(*offload_array, (length + n_cell) * sizeof(real));
+    if(arr == NULL) {
+        print_err("Error: Failed to allocate wall distance map.\n");
+        return 1;
+    }
+    *offload_array = arr;
+    real* d = &(arr[length]);
+    for(size_t i = 0; i < n_cell; i++) {
+        d[i] = WALL_DMAP_FAR;
+    }
+
+    /* Mark the cells wall elements pass through. The elements are divided to
+     * pieces smaller than a cell and the bounding box of each piece is
+     * marked. */
+    if(dim == 2) {
+        real* wr = arr;
+        real* wz = arr + n_elem;
+        for(int i = 0; i < n_elem; i++) {
+            int j = (i + 1) % n_elem;
+            real len = sqrt( (wr[j] - wr[i]) * (wr[j] - wr[i])
+                             + (wz[j] - wz[i]) * (wz[j] - wz[i]) );
+            int m = (int) ceil(len / h) + 1;
+            for(int l = 0; l < m; l++) {
+                real r0 = wr[i] + (wr[j] - wr[i]) * l / m;
+                real r1 = wr[i] + (wr[j] - wr[i]) * (l + 1) / m;
+                real z0 = wz[i] + (wz[j] - wz[i]) * l / m;
+                real z1 = wz[i] + (wz[j] - wz[i]) * (l + 1) / m;
+                real blo[3] = {fmin(r0, r1), 0, fmin(z0, z1)};
+                real bhi[3] = {fmax(r0, r1), 0, fmax(z0, z1)};
+                wall_dmap_mark(d, n, min, h, blo, bhi);
+            }
+        }
+    }
+    else {
+        for(int i = 0; i < n_elem; i++) {
+            real* t = &(arr[9*i]);
+            real len = 0;
+            for(int e = 0; e < 3; e++) {
+                real* a = &t[3*e];
+                real* b = &t[3*((e+1)%3)];
+                len = fmax(len, sqrt( (b[0] - a[0]) * (b[0] - a[0])
+                                      + (b[1] - a[1]) * (b[1] - a[1])
+                                      + (b[2] - a[2]) * (b[2] - a[2]) ));
+            }
+            int m = (int) ceil(len / h) + 1;
+
+            /* Sub-triangles with vertices on a barycentric grid */
+            for(int a = 0; a < m; a++) {
+                for(int b = 0; b < m - a; b++) {
+                    real p[4][3];
+                    int ab[4][2] = {{a, b}, {a+1, b}, {a, b+1}, {a+1, b+1}};
+                    int np = a + b < m - 1 ? 4 : 3;
+                    for(int v = 0; v < np; v++) {
+                        for(int k = 0; k < 3; k++) {
+                            p[v][k] = t[k]
+                                + (t[3+k] - t[k]) * ab[v][0] / m
+                                + (t[6+k] - t[k]) * ab[v][1] / m;
+                        }
+                    }
+                    real blo[3], bhi[3];
+                    for(int k = 0; k < 3; k++) {
+                        blo[k] = p[0][k];
+                        bhi[k] = p[0][k];
+                        for(int v = 1; v < np; v++) {
+                            blo[k] = fmin(blo[k], p[v][k]);
+                            bhi[k] = fmax(bhi[k], p[v][k]);
+                        }
+                    }
+                    wall_dmap_mark(d, n, min, h, blo, bhi);
+                }
+            }
+        }
+    }
+
+    /* Squared distance to the nearest marked cell, one axis at a time */
+    int n_max = n[0] > n[1] ? n[0] : n[1];
+    n_max = n_max > n[2] ? n_max : n[2];
+    real* g  = malloc(n_max * sizeof(real));
+    real* zv = malloc((n_max + 1) * sizeof(real));
+    int* v   = malloc(n_max * sizeof(int));
+    for(int i = 0; i < n[0]; i++) {
+        for(int j = 0; j < n[1]; j++) {
+            wall_dmap_edt(&d[(i*n[1] + j)*n[2]], n[2], 1, g, v, zv);
+        }
+    }
+    if(n[1] > 1) {
+        for(int i = 0; i < n[0]; i++) {
+            for(int k = 0; k < n[2]; k++) {
+                wall_dmap_edt(&d[i*n[1]*n[2] + k], n[1], n[2], g, v, zv);
+            }
+        }
+    }
+    for(int j = 0; j < n[1]; j++) {
+        for(int k = 0; k < n[2]; k++) {
+            wall_dmap_edt(&d[j*n[2] + k], n[0], n[1]*n[2], g, v, zv);
+        }
+    }
+    free(g);
+    free(zv);
+    free(v);
+
+    /* Clearance is the distance between the cell centers minus the diagonal,
+     * which accounts for both endpoints lying anywhere within their cells */
+    real diag = sqrt(dim);
+    size_t n_clear = 0;
+    for(size_t i = 0; i < n_cell; i++) {
+        d[i] = fmax( 0.0, h * ( sqrt(d[i]) - diag ) );
+        n_clear += d[i] > 0;
+    }
+
+    for(int k = 0; k < 3; k++) {
+        offload_data->dmap_n[k]   = n[k];
+        offload_data->dmap_min[k] = min[k];
+    }
+    offload_data->dmap_h = h;
+    offload_data->offload_array_length = length + n_cell;
+    print_out(VERBOSE_IO, "Wall distance map: %zu cells of %.3f m, "
+              "%.0f%% away from the wall\n",
+              n_cell, h, 100.0 * n_clear / n_cell);
+    return 0;
+}
@@ -39,6 +39,10 @@ typedef struct {
     wall_type type;               /**< Wall model type wrapped by this struct */
     wall_2d_offload_data w2d;     /**< 2D model or NULL if not active         */
     wall_3d_offload_data w3d;     /**< 3D model or NULL if not active         */
+    int dmap_n[3];                /**< Number of distance map cells along
+                                       x, y, z (3D) or R, -, z (2D) axes      */
+    real dmap_min[3];             /**< Corner of the distance map grid [m]    */
+    real dmap_h;                  /**< Distance map cell width [m]            */
     int offload_array_length;     /**< Allocated offload array length         */
     int int_offload_array_length; /**< Allocated int offload array length     */
 } wall_offload_data;
@@ -56,6 +60,10 @@ typedef struct {
     wall_type type;   /**< Wall model type wrapped by this struct */
     wall_2d_data w2d; /**< 2D model or NULL if not active         */
     wall_3d_data w3d; /**< 3D model or NULL if not active         */
+    int dmap_n[3];    /**< Number of distance map cells           */
+    real dmap_min[3]; /**< Corner of the distance map grid [m]    */
+    real dmap_h;      /**< Distance map cell width [m]            */
+    real* dmap;       /**< Clearance in each cell [m] or NULL     */
 } wall_data;
 
 int wall_init_offload(wall_offload_data* offload_data, real** offload_array,
@@ -74,4 +82,8 @@ DECLARE_TARGET_END
 GPU_DECLARE_TARGET_SIMD_UNIFORM(w)
 int wall_get_n_elements(wall_data* w);
 DECLARE_TARGET_END
+
+GPU_DECLARE_TARGET_SIMD_UNIFORM(w)
+void wall_get_normal(real n[3], int tile, real phi, wall_data* w);
+DECLARE_TARGET_END
 #endif
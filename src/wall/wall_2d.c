@@ -9,6 +9,12 @@
 #include "../print.h"
 #include "wall_2d.h"
 
+/** Target number of wall segments per search grid cell */
+#define WALL_2D_CELL_SEGMENTS 2
+
+/** Maximum number of search grid cells */
+#define WALL_2D_MAX_NCELL 262144
+
 /**
  * @brief Load 2D wall data and prepare parameters
  *
@@ -18,26 +24,37 @@
  * &(*offload_array)[0] = Wall polygon R coordinates
  * &(*offload_array)[n] = Wall polygon z coordinates
  *
- * Since this data requires no initialization, the only thing this function does
- * is that it prints some values as sanity check.
+ * A uniform (R, z) search grid covering the wall is constructed and stored in
+ * the int offload array. Each cell lists the wall segments passing through
+ * it, and cells with no segments are marked as being inside or outside the
+ * wall. The cell width is chosen so that there are about
+ * WALL_2D_CELL_SEGMENTS segments in each cell that the wall passes through,
+ * while the grid has at most WALL_2D_MAX_NCELL cells.
  *
  * @param offload_data pointer to offload data struct
  * @param offload_array pointer to pointer to offload array
+ * @param int_offload_array pointer to pointer to int offload array which is
+ *        allocated here
  *
  * @return zero to indicate success
  */
 int wall_2d_init_offload(wall_2d_offload_data* offload_data,
-                         real** offload_array) {
-    // Do no initialization
+                         real** offload_array, int** int_offload_array) {
 
     int n = offload_data->n;
-    real rmin = (*offload_array)[0], rmax = (*offload_array)[0];
-    real zmin = (*offload_array)[n], zmax = (*offload_array)[n];
+    real* wr = &(*offload_array)[0];
+    real* wz = &(*offload_array)[n];
+    real rmin = wr[0], rmax = wr[0];
+    real zmin = wz[0], zmax = wz[0];
+    real perimeter = 0;
     for(int i=0; i<n; i++) {
-        rmin = fmin(rmin, (*offload_array)[i]);
-        rmax = fmax(rmax, (*offload_array)[i]);
-        zmin = fmin(zmin, (*offload_array)[n+i]);
-        zmax = fmax(zmax, (*offload_array)[n+i]);
+        int j = i == n - 1 ? 0 : i + 1;
+        rmin = fmin(rmin, wr[i]);
+        rmax = fmax(rmax, wr[i]);
+        zmin = fmin(zmin, wz[i]);
+        zmax = fmax(zmax, wz[i]);
+        perimeter += sqrt( (wr[j] - wr[i]) * (wr[j] - wr[i])
+                           + (wz[j] - wz[i]) * (wz[j] - wz[i]) );
     }
 
     print_out(VERBOSE_IO, "\n2D wall model (wall_2D)\n");
@@ -45,6 +62,125 @@ int wall_2d_init_offload(wall_2d_offload_data* offload_data,
               " R extend = [%2.2f, %2.2f], z extend = [%2.2f, %2.2f]\n",
               n, rmin, rmax, zmin, zmax);
 
+    offload_data->n_r = 0;
+    offload_data->n_z = 0;
+    offload_data->int_offload_array_length = 0;
+    *int_offload_array = NULL;
+    real h = fmax( WALL_2D_CELL_SEGMENTS * perimeter / n,
+                   sqrt( (rmax - rmin) * (zmax - zmin) / WALL_2D_MAX_NCELL ) );
+    if( n < 3 || !(h > 0) ) {
+        return 0;
+    }
+
+    /* Grid with one cell of padding on each side */
+    int n_r = (int) ceil( (rmax - rmin) / h ) + 2;
+    int n_z = (int) ceil( (zmax - zmin) / h ) + 2;
+    int n_cell = n_r * n_z;
+    offload_data->rmin = rmin - h;
+    offload_data->zmin = zmin - h;
+    offload_data->h    = h;
+
+    /* Find the cells each segment passes through. The segment is divided to
+     * pieces shorter than a cell, and the cells overlapping the slightly
+     * enlarged bounding box of each piece are taken. This is done twice, first
+     * to count the segments in each cell and then to store them. */
+    int* count = calloc(n_cell, sizeof(int));
+    int* stamp = malloc(n_cell * sizeof(int));
+    int* grid  = NULL;
+    int length = 3 * n_cell;
+    for(int pass = 0; pass < 2; pass++) {
+        for(int c = 0; c < n_cell; c++) {
+            stamp[c] = -1;
+        }
+        for(int i = 0; i < n; i++) {
+            int j = i == n - 1 ? 0 : i + 1;
+            real len = sqrt( (wr[j] - wr[i]) * (wr[j] - wr[i])
+                             + (wz[j] - wz[i]) * (wz[j] - wz[i]) );
+            int m = (int) ceil(len / h) + 1;
+            for(int l = 0; l < m; l++) {
+                real r0 = wr[i] + (wr[j] - wr[i]) * l / m;
+                real r1 = wr[i] + (wr[j] - wr[i]) * (l + 1) / m;
+                real z0 = wz[i] + (wz[j] - wz[i]) * l / m;
+                real z1 = wz[i] + (wz[j] - wz[i]) * (l + 1) / m;
+                int ir0 = (int) floor( (fmin(r0, r1) - offload_data->rmin) / h
+                                       - 1e-6 );
+                int ir1 = (int) floor( (fmax(r0, r1) - offload_data->rmin) / h
+                                       + 1e-6 );
+                int iz0 = (int) floor( (fmin(z0, z1) - offload_data->zmin) / h
+                                       - 1e-6 );
+                int iz1 = (int) floor( (fmax(z0, z1) - offload_data->zmin) / h
+                                       + 1e-6 );
+                for(int iz = iz0; iz <= iz1; iz++) {
+                    for(int ir = ir0; ir <= ir1; ir++) {
+                        int c = iz * n_r + ir;
+                        if(stamp[c] == i) {
+                            continue;
+                        }
+                        stamp[c] = i;
+                        if(pass == 0) {
+                            count[c]++;
+                            length++;
+                        }
+                        else {
+                            int* list = &grid[grid[n_cell + c]];
+                            list[++list[0]] = i;
+                        }
+                    }
+                }
+            }
+        }
+
+        if(pass == 0) {
+            grid = malloc(length * sizeof(int));
+            int pos = 2 * n_cell;
+            for(int c = 0; c < n_cell; c++) {
+                grid[c] = -1;
+                grid[n_cell + c] = pos;
+                grid[pos] = 0;
+                pos += 1 + count[c];
+            }
+        }
+    }
+
+    /* Cells with no segments are either inside or outside the wall. Their
+     * status is found row by row from the crossings of the row center line
+     * and the wall, which are counted as in wall_2d_inside(). */
+    real* cross = malloc(n * sizeof(real));
+    for(int iz = 0; iz < n_z; iz++) {
+        real zc = offload_data->zmin + (iz + 0.5) * h;
+        int n_cross = 0;
+        for(int i = 0; i < n; i++) {
+            int j = i == n - 1 ? 0 : i + 1;
+            real wz1 = wz[i] - zc;
+            real wz2 = wz[j] - zc;
+            if(wz1 * wz2 < 0) {
+                cross[n_cross++] = wr[i] + (wz1*(wr[j]-wr[i])) / (wz1-wz2);
+            }
+        }
+        for(int ir = 0; ir < n_r; ir++) {
+            int c = iz * n_r + ir;
+            if(count[c] > 0) {
+                continue;
+            }
+            real rc = offload_data->rmin + (ir + 0.5) * h;
+            int hits = 0;
+            for(int k = 0; k < n_cross; k++) {
+                hits += cross[k] > rc;
+            }
+            grid[c] = hits % 2;
+        }
+    }
+    free(cross);
+    free(count);
+    free(stamp);
+
+    offload_data->n_r = n_r;
+    offload_data->n_z = n_z;
+    offload_data->int_offload_array_length = length;
+    *int_offload_array = grid;
+    print_out(VERBOSE_IO, "Search grid %d x %d cells of %.3f m\n",
+              n_r, n_z, h);
+
     return 0;
 }
 
@@ -57,12 +193,15 @@ int wall_2d_init_offload(wall_2d_offload_data* offload_data,
  *
  * @param offload_data pointer to offload data struct
  * @param offload_array pointer to pointer to offload array
+ * @param int_offload_array pointer to pointer to int offload array
  */
-
 void wall_2d_free_offload(wall_2d_offload_data* offload_data,
-                          real** offload_array) {
+                          real** offload_array, int** int_offload_array) {
     free(*offload_array);
     *offload_array = NULL;
+
+    free(*int_offload_array);
+    *int_offload_array = NULL;
 }
 
 /**
@@ -74,12 +213,21 @@ void wall_2d_free_offload(wall_2d_offload_data* offload_data,
  * @param w pointer to data struct on target
  * @param offload_data pointer to offload data struct
  * @param offload_array the offload array
+ * @param int_offload_array the int offload array
  */
 void wall_2d_init(wall_2d_data* w, wall_2d_offload_data* offload_data,
-                  real* offload_array) {
+                  real* offload_array, int* int_offload_array) {
     w->n = offload_data->n;
     w->wall_r = &offload_array[0];
     w->wall_z = &offload_array[offload_data->n];
+
+    w->rmin = offload_data->rmin;
+    w->zmin = offload_data->zmin;
+    w->h    = offload_data->h;
+    w->n_r  = offload_data->n_r;
+    w->n_z  = offload_data->n_z;
+    w->grid_array_size = offload_data->int_offload_array_length;
+    w->grid_array = int_offload_array;
 }
 
 /**
@@ -90,6 +238,12 @@ void wall_2d_init(wall_2d_data* w, wall_2d_offload_data* offload_data,
  * to the coordinates and the number of wall segments crossing the positive
  * r-axis are calculated. If this is odd, the point is inside the polygon.
  *
+ * With the search grid, only the segments in the cells between the point and
+ * the first cell on the positive r-axis not containing any segments are
+ * checked, and the status of that cell is used for the rest of the axis.
+ * A crossing is counted only in the cell where it is located so that segments
+ * listed in several cells are counted once.
+ *
  * [1] D.G. Alciatore, R. Miranda. A Winding Number and Point-in-Polygon
  *     Algorithm. Technical report, Colorado State University, 1995.
  *     https://www.engr.colostate.edu/~dga/documents/papers/point_in_polygon.pdf
@@ -100,6 +254,37 @@ void wall_2d_init(wall_2d_data* w, wall_2d_offload_data* offload_data,
  */
 int wall_2d_inside(real r, real z, wall_2d_data* w) {
     int hits = 0;
+    if(w->n_r > 0) {
+        int ir = (int) floor( (r - w->rmin) / w->h );
+        int iz = (int) floor( (z - w->zmin) / w->h );
+        if(ir < 0 || ir >= w->n_r || iz < 0 || iz >= w->n_z) {
+            return 0;
+        }
+        int n_cell = w->n_r * w->n_z;
+        for(int j = ir; j < w->n_r; j++) {
+            int c = iz * w->n_r + j;
+            if(w->grid_array[c] >= 0) {
+                return (hits + w->grid_array[c]) % 2;
+            }
+            int* list = &(w->grid_array[w->grid_array[n_cell + c]]);
+            for(int l = 1; l <= list[0]; l++) {
+                int i  = list[l];
+                int i1 = i == w->n - 1 ? 0 : i + 1;
+                real wz1 = w->wall_z[i]  - z;
+                real wz2 = w->wall_z[i1] - z;
+                real wr1 = w->wall_r[i]  - r;
+                real wr2 = w->wall_r[i1] - r;
+                if(wz1 * wz2 < 0) {
+                    real ri = wr1 + (wz1*(wr2-wr1)) / (wz1-wz2);
+                    if(ri > 0 && (int) floor( (r + ri - w->rmin) / w->h ) == j) {
+                        hits++;
+                    }
+                }
+            }
+        }
+        return hits % 2;
+    }
+
     for(int i = 0; i < w->n; i++) {
         real wr1, wr2, wz1, wz2;
         if(i == w->n - 1) {
@@ -148,11 +333,46 @@ int wall_2d_hit_wall(real r1, real phi1, real z1, real r2, real phi2, real z2,
     return tile;
 }
 
+/**
+ * @brief Find intersection between a line segment and a wall segment
+ *
+ * @param r1 R1 coordinate of the line segment [P1,P2] [m]
+ * @param z1 z1 coordinate of the line segment [P1,P2] [m]
+ * @param r2 R2 coordinate of the line segment [P1,P2] [m]
+ * @param z2 z2 coordinate of the line segment [P1,P2] [m]
+ * @param i index of the wall segment
+ * @param w pointer to the wall data
+ *
+ * @return parameter t in P = P1 + t * (P2-P1) at the intersection or a value
+ *         larger than one if the segments do not intersect
+ */
+static real wall_2d_segment_intersection(real r1, real z1, real r2, real z2,
+                                         int i, wall_2d_data* w) {
+    int i1 = i == w->n - 1 ? 0 : i + 1;
+    real r3 = w->wall_r[i];
+    real z3 = w->wall_z[i];
+    real r4 = w->wall_r[i1];
+    real z4 = w->wall_z[i1];
+
+    real div = (r1 - r2) * (z3 - z4) - (z1 - z2) * (r3 - r4);
+    real t   = ( (r1 - r3) * (z3 - z4) - (z1 - z3) * (r3 - r4) ) / div;
+    real u   = ( (r1 - r3) * (z1 - z2) - (z1 - z3) * (r1 - r2) ) / div;
+    if(0 <= t && t <= 1.0 && 0 <= u && u <= 1.0) {
+        return t;
+    }
+    return 2.0;
+}
+
 /**
  * @brief Find intersection between the wall element and line segment
  *
  * If there are multiple intersections, the one that is closest to P1
- * is returned.
+ * is returned (and the one with the lowest index if there are several at the
+ * same distance).
+ *
+ * With the search grid, only the segments in the cells overlapping the
+ * bounding box of [P1,P2] are checked unless the box covers more cells than
+ * there are wall segments.
  *
  * @param r1 R1 coordinate of the line segment [P1,P2] [m]
  * @param z1 z1 coordinate of the line segment [P1,P2] [m]
@@ -168,24 +388,44 @@ int wall_2d_find_intersection(real r1, real z1, real r2, real z2,
                               wall_2d_data* w, real* w_coll) {
     int tile = 0;
     real t0 = 2.0; // Helper variable to pick the closest intersection
-    for(int i=0; i<w->n; i++) {
-        real r3, z3, r4, z4;
-        if(i == w->n-1) {
-            r3 = w->wall_r[i];
-            z3 = w->wall_z[i];
-            r4 = w->wall_r[0];
-            z4 = w->wall_z[0];
-        } else {
-            r3 = w->wall_r[i];
-            z3 = w->wall_z[i];
-            r4 = w->wall_r[i+1];
-            z4 = w->wall_z[i+1];
+    if(w->n_r > 0) {
+        int ir0 = (int) floor( (fmin(r1, r2) - w->rmin) / w->h );
+        int ir1 = (int) floor( (fmax(r1, r2) - w->rmin) / w->h );
+        int iz0 = (int) floor( (fmin(z1, z2) - w->zmin) / w->h );
+        int iz1 = (int) floor( (fmax(z1, z2) - w->zmin) / w->h );
+        ir0 = ir0 < 0 ? 0 : ir0;
+        iz0 = iz0 < 0 ? 0 : iz0;
+        ir1 = ir1 > w->n_r - 1 ? w->n_r - 1 : ir1;
+        iz1 = iz1 > w->n_z - 1 ? w->n_z - 1 : iz1;
+        if( ir1 < ir0 || iz1 < iz0
+            || (real)(ir1 - ir0 + 1) * (iz1 - iz0 + 1) <= w->n ) {
+            int n_cell = w->n_r * w->n_z;
+            for(int iz = iz0; iz <= iz1; iz++) {
+                for(int ir = ir0; ir <= ir1; ir++) {
+                    int c = iz * w->n_r + ir;
+                    if(w->grid_array[c] >= 0) {
+                        continue;
+                    }
+                    int* list = &(w->grid_array[w->grid_array[n_cell + c]]);
+                    for(int l = 1; l <= list[0]; l++) {
+                        int i = list[l];
+                        real t = wall_2d_segment_intersection(
+                            r1, z1, r2, z2, i, w);
+                        if(t <= 1.0 && (t < t0 || (t == t0 && i + 1 < tile))) {
+                            t0   = t;
+                            tile = i + 1;
+                        }
+                    }
+                }
+            }
+            *w_coll = t0;
+            return tile;
         }
+    }
 
-        real div = (r1 - r2) * (z3 - z4) - (z1 - z2) * (r3 - r4);
-        real t   = ( (r1 - r3) * (z3 - z4) - (z1 - z3) * (r3 - r4) ) / div;
-        real u   = ( (r1 - r3) * (z1 - z2) - (z1 - z3) * (r1 - r2) ) / div;
-        if(0 <= t && t <= 1.0 && 0 <= u && u <= 1.0 && t < t0) {
+    for(int i=0; i<w->n; i++) {
+        real t = wall_2d_segment_intersection(r1, z1, r2, z2, i, w);
+        if(t < t0) {
             t0   = t;
             tile = i + 1;
         }
@@ -193,3 +433,25 @@ int wall_2d_find_intersection(real r1, real z1, real r2, real z2,
     *w_coll = t0;
     return tile;
 }
+
+/**
+ * @brief Get unit normal vector of a wall segment
+ *
+ * The normal is given in cylindrical basis and it lies on the poloidal plane.
+ * Its direction (inward or outward) depends on the orientation of the wall
+ * polygon.
+ *
+ * @param n pointer to array where normal [n_r, n_phi, n_z] is stored
+ * @param tile index of the wall segment (as returned by wall_2d_hit_wall)
+ * @param w pointer to 2D wall data
+ */
+void wall_2d_get_normal(real n[3], int tile, wall_2d_data* w) {
+    int i0 = tile - 1;
+    int i1 = tile == w->n ? 0 : tile;
+    real dr = w->wall_r[i1] - w->wall_r[i0];
+    real dz = w->wall_z[i1] - w->wall_z[i0];
+    real norm = sqrt(dr*dr + dz*dz);
+    n[0] =  dz / norm;
+    n[1] =  0.0;
+    n[2] = -dr / norm;
+}
@@ -11,8 +11,14 @@
  * @brief 2D wall offload data
  */
 typedef struct {
-    int n;                    /**< Number of points in the wall polygon */
-    int offload_array_length; /**< Length of the offload array          */
+    int n;                    /**< Number of points in the wall polygon       */
+    real rmin;                /**< Minimum R of the search grid [m]           */
+    real zmin;                /**< Minimum z of the search grid [m]           */
+    real h;                   /**< Search grid cell width [m]                 */
+    int n_r;                  /**< Number of search grid cells in R           */
+    int n_z;                  /**< Number of search grid cells in z           */
+    int offload_array_length; /**< Length of the offload array                */
+    int int_offload_array_length; /**< Length of the int offload array        */
 } wall_2d_offload_data;
 
 /**
@@ -24,15 +30,33 @@ typedef struct {
     int n;          /**< Number of points in the wall polygon           */
     real* wall_r;   /**< R coordinates for the wall polygon points      */
     real* wall_z;   /**< z coordinates for the wall polygon points      */
+    real rmin;      /**< Minimum R of the search grid [m]               */
+    real zmin;      /**< Minimum z of the search grid [m]               */
+    real h;         /**< Search grid cell width [m]                     */
+    int n_r;        /**< Number of search grid cells in R, zero if the
+                         grid is not used                               */
+    int n_z;        /**< Number of search grid cells in z               */
+
+    /**@brief Array storing the search grid
+     *
+     * The first ncell elements store whether cell icell = i_z * n_r + i_r is
+     * inside (1) or outside (0) the wall, or whether wall segments pass
+     * through it (-1). The next ncell elements store the array position where
+     * the segment list of the cell begins. The first element of the list,
+     * grid_array[grid_array[ncell + icell]], is the number of segments in the
+     * cell and the next elements are the segment indices.
+     */
+    int* grid_array;
+    int grid_array_size; /**< Number of elements in grid_array          */
 } wall_2d_data;
 
 int wall_2d_init_offload(wall_2d_offload_data* offload_data,
-                         real** offload_array);
+                         real** offload_array, int** int_offload_array);
 void wall_2d_free_offload(wall_2d_offload_data* offload_data,
-                          real** offload_array);
+                          real** offload_array, int** int_offload_array);
 
 void wall_2d_init(wall_2d_data* w, wall_2d_offload_data* offload_data,
-                  real* offload_array);
+                  real* offload_array, int* int_offload_array);
 GPU_DECLARE_TARGET_SIMD_UNIFORM(w)
 int wall_2d_inside(real r, real z, wall_2d_data* w);
 DECLARE_TARGET_END
@@ -43,4 +67,7 @@ GPU_DECLARE_TARGET_SIMD_UNIFORM(w)
 int wall_2d_find_intersection(real r1, real z1, real r2, real z2,
                               wall_2d_data* w, real* w_coll);
 DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(w)
+void wall_2d_get_normal(real n[3], int tile, wall_2d_data* w);
+DECLARE_TARGET_END
 #endif
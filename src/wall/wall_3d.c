@@ -624,3 +624,28 @@ int wall_3d_quad_collision(real q1[3], real q2[3], real t1[3], real t2[3],
     else
         return 0;
 }
+
+/**
+ * @brief Get unit normal vector of a wall triangle
+ *
+ * The normal is computed from the triangle vertices and transformed to
+ * cylindrical basis at the given toroidal angle. Its direction depends on the
+ * order of the vertices.
+ *
+ * @param n pointer to array where normal [n_r, n_phi, n_z] is stored
+ * @param tile index of the triangle (as returned by wall_3d_hit_wall)
+ * @param phi toroidal angle where the normal is evaluated [rad]
+ * @param w pointer to 3D wall data
+ */
+void wall_3d_get_normal(real n[3], int tile, real phi, wall_3d_data* w) {
+    real* t = &w->wall_tris[9*(tile-1)];
+    real e1[3] = {t[3] - t[0], t[4] - t[1], t[5] - t[2]};
+    real e2[3] = {t[6] - t[0], t[7] - t[1], t[8] - t[2]};
+    real nxyz[3];
+    math_cross(e1, e2, nxyz);
+    real norm = math_norm(nxyz);
+    nxyz[0] /= norm;
+    nxyz[1] /= norm;
+    nxyz[2] /= norm;
+    math_vec_xyz2rpz(nxyz, n, phi);
+}
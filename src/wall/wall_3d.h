@@ -80,6 +80,9 @@ GPU_DECLARE_TARGET_SIMD_UNIFORM(w)
 int wall_3d_hit_wall_full(real r1, real phi1, real z1, real r2, real phi2,
                           real z2, wall_3d_data* w, real* w_coll);
 DECLARE_TARGET_END
+GPU_DECLARE_TARGET_SIMD_UNIFORM(w)
+void wall_3d_get_normal(real n[3], int tile, real phi, wall_3d_data* w);
+DECLARE_TARGET_END
 GPU_DECLARE_TARGET_SIMD
 double wall_3d_tri_collision(real q1[3], real q2[3], real t1[3], real t2[3],
                              real t3[3]);